@@ -28,6 +28,9 @@ private:
 	void HierachyWindow();
 	void DetailsWindow();
 
+	// Selects the model under the cursor when clicking outside of the editor windows //
+	void ViewportPicking();
+
 	void TextureColumnHighlight(Texture* texture, std::string name);
 
 	void LoadModelFilePaths(std::string path, std::string originalPath);
@@ -49,4 +52,7 @@ private:
 	// Scene Hierachy //
 	Model* hierachySelectedModel = nullptr;
 
+	// Lights //
+	std::vector<unsigned int> litModels;
+
 };
\ No newline at end of file
@@ -13,7 +13,8 @@ class ShadowStage;
 class SceneStage;
 class ScreenStage;
 class SkydomeStage;
-class HDRIConvolutionStage;
+
+class DXFrameGraph;
 
 class Renderer
 {
@@ -35,7 +36,12 @@ private:
 	SceneStage* sceneStage;
 	ScreenStage* screenStage;
 	SkydomeStage* skydomeStage;
-	HDRIConvolutionStage* convolutionStage;
+
+	// Orders the stages & transitions the resources between them //
+	DXFrameGraph* frameGraph;
+	unsigned int renderBufferResource;
+	unsigned int screenBufferResource;
+	unsigned int depthBufferResource;
 
 	Scene* scene;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <d3d12.h>
@@ -9,34 +10,51 @@ using namespace Microsoft::WRL;
 
 #include "Graphics/Lights.h"
 #include "Graphics/Camera.h"
+#include "Graphics/BVH.h"
 
 class Model;
+struct ModelAsset;
 
 class Scene
 {
 public:
 	Scene(unsigned int windowWidth, unsigned int windowHeight);
+	~Scene(); // Only once the GPU is done with the scene's meshes
 
 	void Update(float deltaTime);
 
-	void AddModel(const std::string& filePath);
+	// False when the model couldn't be loaded, nothing gets added then //
+	bool AddModel(const std::string& filePath);
+
+	// Refits the hierarchy around models that moved since the last update, rebuilds it once that got too loose //
+	void UpdateHierarchy();
+
+	// Closest model along the ray, tested against the boxes of its meshes. nullptr when nothing gets hit //
+	Model* PickModel(const glm::vec3& origin, const glm::vec3& direction);
+	void QueryModels(const BoundingSphere& sphere, std::vector<unsigned int>& modelIndices);
 
 	Camera& GetCamera();
 	const std::vector<Model*>& GetModels();
-	CD3DX12_GPU_DESCRIPTOR_HANDLE GetLightBufferHandle();
+	const LightData& GetLightData();
+	BVH& GetHierarchy();
 
 private:
-	void UpdateLightBuffer();
+	BoundingBox GetWorldBounds(unsigned int modelIndex);
 
 private:
 	Camera* camera;
 	std::vector<Model*> models;
 
-	// Light info //
+	// Every file that got loaded, shared by the models placed from it. Held here so they outlive every model //
+	std::vector<std::shared_ptr<ModelAsset>> assets;
+
+	// Hierarchy over the world space box of every model, items are indices into 'models' //
+	BVH hierarchy;
+	std::vector<glm::vec3> fittedTransforms; // Position, rotation & scale of every model when the hierarchy was last fit
+	bool rebuildHierarchy = false;
+
+	// Light info, gets copied into the constant ring every frame //
 	LightData lights;
-	ComPtr<ID3D12Resource> lightBuffer;
-	int lightCBVIndex = -1;
-	bool lightsEdited = false;
 
 	float sceneRuntime = 0.0f;
 
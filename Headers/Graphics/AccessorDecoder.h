@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+// Describes where the elements of a glTF accessor live in memory //
+struct AccessorView
+{
+	const unsigned char* Data = nullptr;
+	size_t Stride = 0;
+	size_t Count = 0;
+
+	int ComponentType = 0;
+	unsigned int ComponentCount = 0;
+	bool Normalized = false;
+};
+
+/// <summary>
+/// Converts glTF accessor data into the layouts the engine uses. Every combination of
+/// component type, normalization and component count has its own kernel generated at compile time,
+/// so the per element loop doesn't branch. Quantized input ( KHR_mesh_quantization ) gets
+/// dequantized with SSE, sparse accessors are applied on top of the decoded data.
+/// </summary>
+class AccessorDecoder
+{
+public:
+	// Writes up to 'destinationComponents' floats per element, the element
+	// is placed every 'destinationStride' bytes, e.g. a member of an interleaved vertex.
+	static bool DecodeFloats(const AccessorView& accessor, unsigned char* destination,
+		size_t destinationStride, unsigned int destinationComponents);
+
+	static bool DecodeIndices(const AccessorView& accessor, unsigned int* destination);
+
+	// Replaces the elements listed in 'indices' with 'values', 'elementCount' being the size of the destination //
+	static bool ApplySparseFloats(const AccessorView& indices, const AccessorView& values, unsigned char* destination,
+		size_t destinationStride, unsigned int destinationComponents, size_t elementCount);
+};
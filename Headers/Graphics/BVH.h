@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Graphics/Bounds.h"
+#include "Graphics/FrustumCuller.h"
+
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+// 32 bytes, siblings are stored next to each other so a pair fills a single cache line //
+struct BVHNode
+{
+	glm::vec3 Min;
+	unsigned int LeftFirst; // Interior: index of the left child, the right child follows it. Leaf: first entry in the item list
+	glm::vec3 Max;
+	unsigned int Count; // Items in the leaf, 0 for interior nodes
+};
+
+struct RayHit
+{
+	unsigned int Item = ~0u;
+	float Distance = FLT_MAX;
+};
+
+/// <summary>
+/// Bounding volume hierarchy over a list of boxes ( items ), used to find which of them are in a frustum, overlap
+/// a volume or are hit by a ray without touching every one of them. Built top-down with a binned surface area heuristic,
+/// big subtrees get built on the ThreadPool. Moving items only refits the nodes above them, which loosens the tree over time,
+/// 'GetCost' against 'GetBuildCost' tells when it's worth rebuilding. Doesn't know about the backend, the benchmark
+/// runs headless on synthetic scenes.
+/// </summary>
+class BVH
+{
+public:
+	void Build(const std::vector<BoundingBox>& boxes, ThreadPool* threadPool = nullptr);
+	void Rebuild(ThreadPool* threadPool = nullptr); // With the boxes the items have now
+
+	// Only marks the item's leaf, 'Refit' brings the nodes above it up to date //
+	void UpdateItem(unsigned int item, const BoundingBox& box);
+	void Refit();
+
+	// Items get appended, in no particular order //
+	void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& items);
+	void QueryBox(const BoundingBox& box, std::vector<unsigned int>& items);
+	void QuerySphere(const BoundingSphere& sphere, std::vector<unsigned int>& items);
+
+	// 'test' gets called for items whose box the ray enters before the closest hit so far, with the distance to that box.
+	// It can reject the item, or push the distance further, like when testing the item's actual shape //
+	RayHit Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX,
+		const std::function<bool(unsigned int, float&)>& test = nullptr);
+
+	const BoundingBox& GetItemBounds(unsigned int item);
+	BoundingBox GetBounds();
+
+	float GetCost(); // Surface area heuristic, relative to the root
+	float GetBuildCost(); // Cost right after the last build
+	unsigned int GetItemCount();
+	unsigned int GetNodeCount();
+
+	// Build, refit & query timings on 10k, 100k & 1M items, queries get checked against a brute force pass //
+	static void RunBenchmark();
+
+	static const unsigned int MaxLeafSize = 4;
+
+	// Copy of an item's box the build sorts around directly, so splitting a node reads memory in order //
+	struct BuildItem
+	{
+		glm::vec3 Min;
+		unsigned int Item;
+		glm::vec3 Max;
+		float Padding;
+	};
+
+private:
+	void BuildNode(unsigned int nodeIndex, unsigned int first, unsigned int count, unsigned int rangeStart,
+		unsigned int depth, ThreadPool* threadPool);
+	bool FindSplit(const BoundingBox& centroidBounds, unsigned int first, unsigned int count, int& axis, unsigned int& bin);
+	void Compact();
+
+	void RefitNode(unsigned int nodeIndex);
+	void AddSubtree(unsigned int nodeIndex, std::vector<unsigned int>& items);
+
+	BVHNode* GetNodes();
+
+private:
+	struct alignas(64) NodePair
+	{
+		BVHNode Nodes[2];
+	};
+
+	// Node 0 is the root, node 1 is unused so every pair of siblings starts at an even index //
+	std::vector<NodePair> nodePairs;
+	unsigned int nodeCount = 0;
+
+	std::vector<BoundingBox> itemBounds;
+	std::vector<unsigned int> itemIndices; // Leaves point into this, grouping the items of a leaf
+	std::vector<unsigned int> itemLeaves;
+
+	std::vector<unsigned int> parents;
+	std::vector<unsigned int> dirtyLeaves;
+	std::vector<unsigned char> dirtyFlags;
+
+	std::vector<BuildItem> buildItems;
+	std::vector<BVHNode> buildNodes; // Scratch space for the parallel build, in the order the subtrees got reserved
+	float buildCost = 0.0f;
+};
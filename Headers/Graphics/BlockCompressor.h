@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Layout of the pixels stored for a texture, BC formats are made out of 4x4 blocks //
+enum class TextureFormat
+{
+	RGBA8, // Uncompressed, 4 bytes per pixel
+	BC1, // RGB, 8 bytes per block
+	BC3, // RGB + alpha, 16 bytes per block
+	BC4, // R, 8 bytes per block
+	BC5, // RG, 16 bytes per block
+	BC7, // RGBA, 16 bytes per block, highest quality
+
+	// HDR formats, created from RGBA32F pixels //
+	RGBA16F, // Uncompressed half floats, 8 bytes per pixel
+	RGBA32F, // Uncompressed floats, 16 bytes per pixel
+	BC6H // Unsigned half float RGB, 16 bytes per block
+};
+
+enum class CompressionQuality
+{
+	None, // Keep textures uncompressed
+	Fast, // Bounding box endpoints, color textures use BC1/BC3 instead of BC7
+	Balanced, // Principal axis endpoints, refined once
+	High // Several refinement passes & exhaustive endpoint/p-bit search
+};
+
+/// <summary>
+/// CPU block compression encoder, used while importing so the GPU gets textures that take
+/// 4-8x less memory and bandwidth. Blocks are encoded in parallel on the ThreadPool, palette
+/// searches are done on 4 pixels at once with SSE. BC7 only uses mode 6 ( single subset, RGBA ),
+/// which keeps the encoder small while still doing better than BC1/BC3 on most content.
+/// BC6H likewise only uses mode 11 ( single region, 10 bit endpoints ).
+/// BC formats need the top level to be a multiple of 4, callers should keep other textures uncompressed.
+/// </summary>
+class BlockCompressor
+{
+public:
+	// Replaces a tightly packed RGBA8 mip chain ( see MipGenerator ) with its compressed blocks //
+	static bool Compress(std::vector<unsigned char>& pixels, int width, int height, int mipCount,
+		TextureFormat format, CompressionQuality quality);
+
+	// Converts a tightly packed RGBA32F mip chain into one of the HDR formats //
+	static bool CompressHDR(const std::vector<float>& pixels, int width, int height, int mipCount,
+		TextureFormat format, CompressionQuality quality, std::vector<unsigned char>& output);
+
+	// Decodes a single level back into RGBA8 or RGBA32F, only BC7 mode 6 & BC6H mode 11 blocks are supported //
+	static void Decompress(const unsigned char* blocks, int width, int height, TextureFormat format, unsigned char* pixels);
+	static void DecompressHDR(const unsigned char* blocks, int width, int height, TextureFormat format, float* pixels);
+
+	static bool CanCompress(int width, int height);
+	static bool IsHDRFormat(TextureFormat format);
+	static int GetChannelCount(TextureFormat format);
+
+	// Sizes in bytes, levels are tightly packed after each other //
+	static size_t GetRowPitch(TextureFormat format, int width);
+	static size_t GetLevelSize(TextureFormat format, int width, int height);
+	static size_t GetLevelOffset(TextureFormat format, int width, int height, int level);
+
+	// Peak signal-to-noise ratio in dB over the first 'channelCount' channels of two RGBA8 images //
+	static float ComputePSNR(const unsigned char* reference, const unsigned char* pixels, size_t pixelCount, int channelCount);
+
+	// Headless benchmark, logs PSNR & throughput of every format and quality for each image //
+	static void RunBenchmark(const std::vector<std::string>& imagePaths);
+
+	static const char* GetFormatName(TextureFormat format);
+	static const char* GetQualityName(CompressionQuality quality);
+
+private:
+	// 'pixels' are RGBA8 for LDR formats and RGBA32F for BC6H //
+	static void CompressLevel(const void* pixels, int width, int height,
+		TextureFormat format, CompressionQuality quality, unsigned char* blocks);
+
+	static void RunHDRBenchmark(const std::string& imagePath);
+};
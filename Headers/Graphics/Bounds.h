@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Framework/Mathematics.h"
+
+#include <cfloat>
+#include <cstddef>
+
+// Bounding volumes, in the space of whatever they were computed from, kept on the CPU for culling //
+struct BoundingBox
+{
+	glm::vec3 Min = glm::vec3(FLT_MAX);
+	glm::vec3 Max = glm::vec3(-FLT_MAX);
+};
+
+struct BoundingSphere
+{
+	glm::vec3 Center = glm::vec3(0.0f);
+	float Radius = 0.0f;
+};
+
+// 'stride' is the distance in bytes between positions, so they can be read straight from interleaved vertices //
+BoundingBox ComputeBoundingBox(const glm::vec3* positions, size_t count, size_t stride = sizeof(glm::vec3));
+
+// Centered on the box, only as large as the furthest position, which is usually tighter than the box corners //
+BoundingSphere ComputeBoundingSphere(const glm::vec3* positions, size_t count, const BoundingBox& box,
+	size_t stride = sizeof(glm::vec3));
+
+BoundingBox MergeBoundingBoxes(const BoundingBox& a, const BoundingBox& b);
+BoundingSphere MergeBoundingSpheres(const BoundingSphere& a, const BoundingSphere& b);
+
+// Box around the transformed box, spheres are scaled by the largest axis scale //
+BoundingBox TransformBoundingBox(const BoundingBox& box, const glm::mat4& transform);
+BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const glm::mat4& transform);
+
+bool IsBoundingBoxValid(const BoundingBox& box);
+float GetSurfaceArea(const BoundingBox& box);
+
+bool Overlaps(const BoundingBox& a, const BoundingBox& b);
+bool Overlaps(const BoundingBox& box, const BoundingSphere& sphere);
+
+// Slab test, 'distance' is where the ray enters the box, 0 when it starts inside. 'inverseDirection' is 1 / direction //
+bool IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+	float& distance);
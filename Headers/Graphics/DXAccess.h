@@ -2,8 +2,16 @@
 
 class DXDevice;
 class DXCommands;
+class DXUploadQueue;
+class DXMemoryAllocator;
+class DXConstantRing;
+class DXBarrierBatcher;
+class DXFrameScheduler;
+class MaterialTable;
+class RenderQueue;
 class DXDescriptorHeap;
 class Texture;
+class TextureRegistry;
 class Window;
 
 #include <wrl.h>
@@ -13,11 +21,20 @@ using namespace Microsoft::WRL;
 namespace DXAccess
 {
 	DXCommands* GetCommands(D3D12_COMMAND_LIST_TYPE type);
+	DXUploadQueue* GetUploadQueue();
+	DXMemoryAllocator* GetMemoryAllocator();
+	DXConstantRing* GetConstantRing();
+	DXBarrierBatcher* GetBarrierBatcher(); // For the direct command list
+	DXFrameScheduler* GetFrameScheduler();
+	MaterialTable* GetMaterialTable();
+	RenderQueue* GetRenderQueue(); // Draw order of the scene stage
 	ComPtr<ID3D12Device2> GetDevice();
 	DXDescriptorHeap* GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type);
 	Window* GetWindow();
 
 	unsigned int GetCurrentBackBufferIndex();
+	unsigned int GetCurrentFrameIndex(); // Frame in flight, resources are versioned with this, not the back buffer
 	Texture* GetDefaultTexture();
+	TextureRegistry* GetTextureRegistry();
 
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <d3d12.h>
+#include <unordered_map>
+#include <vector>
+
+struct BarrierStatistics
+{
+	unsigned int Requested = 0; // Transitions asked for, split ones count once
+	unsigned int Recorded = 0; // Barriers that made it into a ResourceBarrier call
+	unsigned int Calls = 0;
+};
+
+/// <summary>
+/// Collects barriers for a command list & records them with a single ResourceBarrier call on Flush.
+/// Tracked resources remember their state, so a transition only needs the state it goes to. Transitions
+/// into the state a resource is already in are dropped, & transitions of the same resource within a
+/// batch are merged, ( A -> B, B -> C ) becomes ( A -> C ), ( A -> B, B -> A ) disappears.
+/// Split transitions begin in one batch & end in a later one, the resource can't be used in between.
+/// States are tracked for the whole resource, every barrier covers all subresources.
+/// </summary>
+class DXBarrierBatcher
+{
+public:
+	// 'state' is the state the resource is in right now, usually the one it was created in //
+	void Track(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	void Untrack(ID3D12Resource* resource);
+	bool IsTracked(ID3D12Resource* resource);
+
+	// Includes everything that's queued, but not flushed yet //
+	D3D12_RESOURCE_STATES GetState(ID3D12Resource* resource);
+
+	void Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	void BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state);
+	void EndTransition(ID3D12Resource* resource);
+
+	// For resources that aren't tracked, whose state is guaranteed otherwise, like decaying to COMMON after a copy queue //
+	void Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after);
+
+	void Aliasing(ID3D12Resource* before, ID3D12Resource* after);
+	void UAV(ID3D12Resource* resource);
+
+	void Flush(ID3D12GraphicsCommandList* commandList);
+
+	BarrierStatistics GetStatistics();
+	void ResetStatistics();
+
+private:
+	struct TrackedResource
+	{
+		D3D12_RESOURCE_STATES State;
+		D3D12_RESOURCE_STATES SplitState; // State a begun split transition goes to
+		bool Splitting = false;
+	};
+
+	TrackedResource* GetTrackedResource(ID3D12Resource* resource);
+	void Erase(size_t index);
+
+private:
+	std::unordered_map<ID3D12Resource*, TrackedResource> resources;
+
+	std::vector<D3D12_RESOURCE_BARRIER> pending;
+	std::unordered_map<ID3D12Resource*, size_t> pendingTransitions; // Last queued transition of each resource in 'pending'
+
+	BarrierStatistics statistics;
+};
@@ -6,7 +6,14 @@ using namespace Microsoft::WRL;
 
 #include <d3d12.h>
 #include <cstdint>
+#include <functional>
+#include <vector>
 
+/// <summary>
+/// Owns a command queue & the lists recorded for it. A frame records into lists taken from a pool in order,
+/// all of them get executed with a single ExecuteCommandLists call. Every list has its own allocator for each
+/// of the 'commandAllocatorCount' frames in flight, so lists recorded on other threads never share one.
+/// </summary>
 class DXCommands
 {
 public:
@@ -16,26 +23,44 @@ public:
 	void ExecuteCommandList(int allocatorIndex = 0);
 	void ResetCommandList(int allocatorIndex = 0);
 
+	// Lists to record in parallel, they execute in order, after everything recorded so far. Recording continues
+	// in a new list afterwards, so GetGraphicsCommandList has to be called again once they've ended //
+	const std::vector<ID3D12GraphicsCommandList2*>& BeginParallelLists(unsigned int count);
+	void EndParallelLists();
+
+	// Called on every list that gets opened, for state that has to be set on each list, like descriptor heaps //
+	void SetListInitializer(const std::function<void(ID3D12GraphicsCommandList2*)>& initializer);
+
 	void Signal();
 	void Flush();
 	void WaitForFenceValue(unsigned int allocatorIndex = 0);
+	bool IsFenceValueComplete(unsigned int allocatorIndex = 0); // Without waiting
 
 	ComPtr<ID3D12CommandQueue> GetCommandQueue();
 	ComPtr<ID3D12CommandList> GetCommandList();
 	ComPtr<ID3D12GraphicsCommandList2> GetGraphicsCommandList();
 
 private:
-	void CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type);
-	void CreateCommandList();
-	void CreateCommandAllocators();
+	void CreateCommandQueue();
 	void CreateSynchronizationObjects();
 
+	// Takes the next list from the pool & adds it to this frame's submission //
+	ID3D12GraphicsCommandList2* OpenCommandList();
+
 private:
 	ComPtr<ID3D12Device2> device;
+	D3D12_COMMAND_LIST_TYPE type;
 
 	ComPtr<ID3D12CommandQueue> commandQueue;
-	ComPtr<ID3D12GraphicsCommandList2> commandList;
-	ComPtr<ID3D12CommandAllocator> commandAllocators[Window::BackBufferCount];
+	ComPtr<ID3D12GraphicsCommandList2> commandList; // The list recording continues in
+
+	std::vector<ComPtr<ID3D12GraphicsCommandList2>> commandLists;
+	std::vector<std::vector<ComPtr<ID3D12CommandAllocator>>> commandAllocators; // For every frame, one for every list
+	std::vector<ID3D12CommandList*> submission;
+	std::vector<ID3D12GraphicsCommandList2*> parallelLists;
+	std::function<void(ID3D12GraphicsCommandList2*)> listInitializer;
+	unsigned int currentAllocator = 0;
+	unsigned int openedListCount = 0;
 
 	// CPU-GPU Synchronization //
 	unsigned int commandAllocatorCount = 0;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <wrl.h>
+using namespace Microsoft::WRL;
+
+#include <d3d12.h>
+#include <cstring>
+#include <vector>
+
+struct ConstantAllocation
+{
+	unsigned char* CPU = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS GPU = 0;
+};
+
+/// <summary>
+/// Persistently mapped upload buffer for constant data that changes from frame to frame, like materials & lights.
+/// The buffer is split into a region per frame in flight, allocations are 256-byte aligned & linearly
+/// allocated within the region of the current frame. A region gets reused once BeginFrame is called
+/// for it again, which has to happen after the GPU finished the frame that used it last.
+/// Data is written every frame it's used, so an update is a memcpy & binding the GPU address as a root CBV.
+/// A frame that needs more than its region gets extra upload buffers, released when its region is reused.
+/// </summary>
+class DXConstantRing
+{
+public:
+	DXConstantRing(unsigned int frameCount, unsigned int frameSize);
+	~DXConstantRing();
+
+	void BeginFrame(unsigned int frameIndex);
+	ConstantAllocation Allocate(unsigned int size);
+
+	// Copies 'data' into the current frame, returns the address to bind it with //
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS Push(const T& data)
+	{
+		ConstantAllocation allocation = Allocate(sizeof(T));
+		memcpy(allocation.CPU, &data, sizeof(T));
+		return allocation.GPU;
+	}
+
+	unsigned int GetUsedSize(); // Includes the overflow of the current frame
+	unsigned int GetFrameSize();
+
+	static const unsigned int Alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+private:
+	ConstantAllocation AllocateOverflow(unsigned int alignedSize);
+
+private:
+	// Buffer of its own for allocations that didn't fit in a frame's region, linearly allocated like the region //
+	struct OverflowPage
+	{
+		ComPtr<ID3D12Resource> Buffer;
+		unsigned char* CPU = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS GPU = 0;
+		unsigned int Size = 0;
+		unsigned int Offset = 0;
+	};
+
+	ComPtr<ID3D12Resource> buffer;
+	unsigned char* mappedData = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+
+	unsigned int frameCount;
+	unsigned int frameSize;
+	unsigned int frameIndex = 0;
+	unsigned int frameStart = 0;
+	unsigned int frameOffset = 0;
+
+	std::vector<std::vector<OverflowPage>> overflowPages; // For every frame
+};
@@ -6,11 +6,19 @@ using namespace Microsoft::WRL;
 #include <d3d12.h>
 #include <d3dx12.h>
 
+#include "Graphics/DescriptorAllocator.h"
+
+/// <summary>
+/// Descriptor heap with its indices managed by a DescriptorAllocator.
+/// Persistent descriptors are allocated as contiguous ranges & can be freed again, shader visible heaps
+/// can also reserve 'transientDescriptors' for every frame in flight, for tables that only live for a frame.
+/// </summary>
 class DXDescriptorHeap
 {
 public:
 	DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, unsigned int numberOfDescriptors, 
-		D3D12_DESCRIPTOR_HEAP_FLAGS flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE);
+		D3D12_DESCRIPTOR_HEAP_FLAGS flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
+		unsigned int transientDescriptors = 0, unsigned int frameCount = 1);
 
 	ComPtr<ID3D12DescriptorHeap> Get();
 	ID3D12DescriptorHeap* GetAddress();
@@ -19,10 +27,22 @@ public:
 
 	unsigned int GetNextAvailableIndex();
 
+	// Returns the first of 'count' adjacent descriptors, for tables //
+	unsigned int AllocateRange(unsigned int count);
+
+	// Shader visible descriptors are only reused once the frames in flight are done with them //
+	void Free(unsigned int index);
+
+	// Resets the transient descriptors of 'frameIndex', the GPU has to be done with its previous use //
+	void BeginFrame(unsigned int frameIndex);
+	unsigned int AllocateTransient(unsigned int count);
+
+	DescriptorAllocatorStatistics GetStatistics();
+
 private:
 	ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+	DescriptorAllocator allocator;
 
 	unsigned int descriptorSize;
-	unsigned int descriptorCount;
-	unsigned int currentDescriptorIndex = 0;
-};
\ No newline at end of file
+	bool isShaderVisible;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include "Graphics/FrameGraph.h"
+
+#include <d3d12.h>
+#include <wrl.h>
+using namespace Microsoft::WRL;
+
+#include <string>
+#include <vector>
+
+class RenderStage;
+class DXBarrierBatcher;
+class DXCommands;
+
+/// <summary>
+/// Executes a FrameGraph with D3D12, every pass of the graph is a RenderStage that declares its own resources.
+/// Imported resources are bound with SetResource before executing, since window buffers change every frame.
+/// Transient textures get placed in a single heap at the offsets the graph assigns them, so textures that
+/// are never alive at the same time share memory. Barriers go through the DXBarrierBatcher of the direct
+/// command list, each batch is flushed with a single call, split transitions span the levels in between.
+/// </summary>
+class DXFrameGraph
+{
+public:
+	unsigned int ImportResource(const std::string& name, ID3D12Resource* resource, ResourceUsage usage);
+	void ExportResource(unsigned int resource);
+
+	// Render target & depth textures only, they can't share a heap with other textures on every device //
+	unsigned int CreateTexture(const std::string& name, const D3D12_RESOURCE_DESC& description);
+
+	// Calls DeclareResources on the stage, stages that use each other's resources have to be added in order //
+	void AddStage(const std::string& name, RenderStage* stage, bool hasSideEffects = false);
+
+	void Read(unsigned int pass, unsigned int resource, ResourceUsage usage);
+	void Write(unsigned int pass, unsigned int resource, ResourceUsage usage);
+	void ReadWrite(unsigned int pass, unsigned int resource, ResourceUsage usage);
+	unsigned int LookupResource(const std::string& name);
+
+	// Compiles the graph & (re)creates the transient textures //
+	void Compile();
+	void Execute(DXCommands* commands);
+
+	void SetResource(unsigned int resource, ID3D12Resource* physicalResource);
+	ID3D12Resource* GetResource(unsigned int resource);
+	FrameGraph& GetGraph();
+
+private:
+	void CreateTransientTextures();
+	void QueueBarrier(const FrameGraphBarrier& barrier, DXBarrierBatcher* barriers);
+
+private:
+	FrameGraph graph;
+	std::vector<RenderStage*> stages; // For every pass
+
+	std::vector<ID3D12Resource*> physicalResources; // For every resource
+	std::vector<D3D12_RESOURCE_DESC> descriptions;
+	std::vector<ComPtr<ID3D12Resource>> transientTextures;
+
+	ComPtr<ID3D12Heap> transientHeap;
+	uint64_t transientHeapSize = 0;
+	bool compiled = false;
+};
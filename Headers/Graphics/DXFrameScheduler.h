@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Graphics/Window.h"
+
+#include <cstdint>
+
+class DXCommands;
+
+struct FrameStatistics
+{
+	float FenceWait = 0.0f; // Milliseconds BeginFrame waited for the GPU
+	float LatencyWait = 0.0f; // Milliseconds BeginFrame waited for the swap chain
+	unsigned int QueuedFrames = 0; // Frames the GPU hadn't finished yet when this one began
+};
+
+/// <summary>
+/// Lets the CPU record the next frame while the GPU still works on the previous ones. Per-frame resources like
+/// the command allocators, the DXConstantRing & transient descriptors are versioned by the frame index BeginFrame
+/// returns, which cycles through all MaxFramesInFlight slots, independent of the swap chain's back buffer index.
+/// The latency budget is enforced separately, BeginFrame waits until at most 'framesInFlight' - 1 earlier frames
+/// are still on the GPU, so it can change at any time without flushing or skipping a slot.
+/// </summary>
+class DXFrameScheduler
+{
+public:
+	DXFrameScheduler(DXCommands* commands, Window* window, unsigned int framesInFlight);
+
+	// Blocks until the frame can be recorded, returns the frame index to version resources with //
+	unsigned int BeginFrame();
+
+	// After the frame's commands have been executed with ExecuteCommandList( frame index ) //
+	void EndFrame();
+
+	void SetFramesInFlight(unsigned int framesInFlight);
+	unsigned int GetFramesInFlight();
+	unsigned int GetFrameIndex();
+	const FrameStatistics& GetStatistics();
+
+	static const unsigned int MaxFramesInFlight = Window::BackBufferCount;
+
+private:
+	DXCommands* commands;
+	Window* window;
+
+	unsigned int framesInFlight;
+	uint64_t frameNumber = 0;
+	FrameStatistics statistics;
+};
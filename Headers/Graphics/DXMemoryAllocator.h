@@ -0,0 +1,95 @@
+#pragma once
+#include "Graphics/HeapAllocator.h"
+
+#include <wrl.h>
+using namespace Microsoft::WRL;
+
+#include <d3d12.h>
+#include <vector>
+
+enum class MemoryPool
+{
+	Buffers,
+	Upload,
+	Textures
+};
+
+struct BufferAllocation
+{
+	ID3D12Resource* Resource = nullptr; // The heap wide buffer, or the dedicated one
+	uint64_t Offset = 0; // Within 'Resource'
+	D3D12_GPU_VIRTUAL_ADDRESS GPU = 0;
+	unsigned char* CPU = nullptr; // Only set for upload memory, which stays mapped
+
+	MemoryPool Pool = MemoryPool::Buffers;
+	HeapAllocation Allocation;
+	ComPtr<ID3D12Resource> Dedicated; // Committed resource for allocations that don't fit in a heap
+
+	bool IsValid() const { return Resource != nullptr; }
+};
+
+/// <summary>
+/// Places resources in large ID3D12Heaps instead of giving every resource its own committed allocation.
+/// The offsets within the heaps are managed by a HeapAllocator per pool, which only does the bookkeeping.
+/// Buffer pools create a single buffer spanning every heap, allocations are ranges within it, so small
+/// vertex & index buffers cost neither a resource nor 64 KB. Textures are placed resources, using the
+/// 4 KB alignment when the device allows it. Render target & depth textures, and anything larger
+/// than a heap, still get a committed resource. Heaps are kept for the lifetime of the allocator.
+/// Freeing doesn't wait for the GPU, the owner has to make sure the memory isn't in use anymore.
+/// </summary>
+class DXMemoryAllocator
+{
+public:
+	DXMemoryAllocator();
+
+	// Default heap memory, in COMMON, buffers get promoted to whichever state they're used in //
+	BufferAllocation AllocateBuffer(uint64_t size);
+
+	// Upload heap memory, mapped & aligned for texture copies //
+	BufferAllocation AllocateUpload(uint64_t size);
+	void FreeBuffer(BufferAllocation& allocation);
+
+	// The returned allocation is invalid when the texture ended up as a committed resource //
+	HeapAllocation CreateTexture(const D3D12_RESOURCE_DESC& description, D3D12_RESOURCE_STATES state,
+		ComPtr<ID3D12Resource>& resource);
+	void FreeTexture(HeapAllocation& allocation);
+
+	HeapAllocatorStatistics GetStatistics(MemoryPool pool);
+
+	// Resources that fell back to a committed allocation so far //
+	unsigned int GetDedicatedCount();
+	uint64_t GetDedicatedSize();
+
+	static const uint64_t HeapSize = 64ull << 20;
+
+private:
+	struct Pool
+	{
+		Pool(D3D12_HEAP_TYPE type, D3D12_HEAP_FLAGS flags, uint64_t granularity, uint64_t maxSizeClass);
+
+		HeapAllocator Allocator;
+		D3D12_HEAP_TYPE Type;
+		D3D12_HEAP_FLAGS Flags;
+
+		std::vector<ComPtr<ID3D12Heap>> Heaps;
+		std::vector<ComPtr<ID3D12Resource>> Buffers; // Buffer spanning each heap, only for buffer pools
+		std::vector<unsigned char*> MappedData;
+	};
+
+	BufferAllocation AllocateBuffer(Pool& pool, MemoryPool poolType, uint64_t size, uint64_t alignment);
+	ComPtr<ID3D12Resource> CreateDedicatedBuffer(D3D12_HEAP_TYPE type, uint64_t size);
+
+	// Creates the device heaps for any heaps the allocator added //
+	void CreateHeaps(Pool& pool);
+	Pool& GetPool(MemoryPool pool);
+
+private:
+	ComPtr<ID3D12Device2> device;
+
+	Pool bufferPool;
+	Pool uploadPool;
+	Pool texturePool;
+
+	unsigned int dedicatedCount = 0;
+	uint64_t dedicatedSize = 0;
+};
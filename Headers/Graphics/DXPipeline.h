@@ -17,7 +17,8 @@ struct DXPipelineDescription
 	DXGI_FORMAT RenderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 
 	bool UsePixelShader = true;
-	bool DoAlphaBlending = false;
+	bool DoAlphaBlending = false; // Straight alpha, the pixel shader doesn't premultiply
+	bool DoDepthWrite = true; // Depth is tested either way
 	bool DoBackCulling = false;
 };
 
@@ -0,0 +1,89 @@
+#pragma once
+#include "Graphics/UploadQueue.h"
+#include "Graphics/DXMemoryAllocator.h"
+
+#include <wrl.h>
+using namespace Microsoft::WRL;
+
+#include <d3d12.h>
+#include <deque>
+#include <vector>
+
+class DXCommands;
+class DXBarrierBatcher;
+
+/// <summary>
+/// D3D12 backend of the UploadQueue, copies get recorded into a single open command list that is
+/// executed on the queue of the passed DXCommands ( the copy queue ) once the batch gets submitted.
+/// Every batch has its own command allocator, allocators are reused once their batch retired.
+/// Resources leave the copy queue in COMMON, the queue that uses them waits on the upload fence
+/// and transitions textures to a pixel shader resource itself, see Synchronize.
+/// Staging memory is sub-allocated from the upload heaps of the DXMemoryAllocator, it also holds a reference
+/// to the destination, so a resource released during loading stays alive until the copy into it has finished.
+/// Destinations are created by the caller, placed memory has to stay allocated until the ticket completed.
+/// </summary>
+class DXUploadQueue : public UploadBackend
+{
+public:
+	DXUploadQueue(DXCommands* commands);
+	~DXUploadQueue();
+
+	// Destinations have to be in COMMON, buffers get promoted on first use, textures become pixel shader resources in Synchronize //
+	UploadTicket UploadBuffer(const BufferAllocation& destination, const void* data, unsigned int size);
+	UploadTicket UploadTexture(const ComPtr<ID3D12Resource>& destination, const D3D12_SUBRESOURCE_DATA* subresources,
+		unsigned int subresourceCount);
+
+	// Submits everything recorded so far & lets 'waitingQueue' wait on the GPU until it's copied, the CPU doesn't block.
+	// Transitions of the uploaded textures get queued in 'barriers', whose command list has to execute on 'waitingQueue'.
+	void Synchronize(ID3D12CommandQueue* waitingQueue, DXBarrierBatcher& barriers);
+
+	// Has to be called by textures destroyed before their upload got synchronized, so no barrier gets queued for a
+	// resource whose memory could already be handed out again //
+	void RemovePendingTexture(ID3D12Resource* texture);
+
+	UploadQueue& GetQueue();
+
+	// UploadBackend //
+	StagingBuffer CreateStaging(uint64_t size) override;
+	void ReleaseStaging(StagingBuffer& staging) override;
+	void Submit(uint64_t fenceValue) override;
+	uint64_t GetCompletedValue() override;
+	void WaitForValue(uint64_t fenceValue) override;
+
+private:
+	ID3D12GraphicsCommandList2* GetCommandList();
+	void CreateCommandAllocator(ComPtr<ID3D12CommandAllocator>& allocator);
+
+private:
+	struct DXStagingBuffer
+	{
+		BufferAllocation Upload;
+		ComPtr<ID3D12Resource> Destination;
+	};
+
+	struct CommandAllocator
+	{
+		ComPtr<ID3D12CommandAllocator> Allocator;
+		uint64_t FenceValue;
+	};
+
+	ComPtr<ID3D12Device2> device;
+	DXMemoryAllocator* memoryAllocator;
+	ComPtr<ID3D12CommandQueue> commandQueue;
+	D3D12_COMMAND_LIST_TYPE type;
+
+	ComPtr<ID3D12GraphicsCommandList2> commandList;
+	ComPtr<ID3D12CommandAllocator> recordingAllocator;
+	std::deque<CommandAllocator> submittedAllocators;
+	bool isRecording = false;
+
+	// Copy queues can't transition to shader resource states, so this is done by the queue using the textures //
+	std::vector<ComPtr<ID3D12Resource>> pendingTextures;
+	std::vector<ComPtr<ID3D12Resource>> handedOverTextures; // Referenced by queued barriers until the next Synchronize
+
+	ComPtr<ID3D12Fence> fence;
+	HANDLE fenceEvent;
+
+	// Declared last, so it gets destroyed before the objects it submits through //
+	UploadQueue uploadQueue;
+};
@@ -14,6 +14,7 @@
 #include "Graphics/DXAccess.h"
 #include "Graphics/DXCommands.h"
 #include "Graphics/DXDescriptorHeap.h"
+#include "Graphics/BlockCompressor.h"
 #include "Window.h"
 
 inline void ThrowIfFailed(HRESULT hr)
@@ -24,11 +25,29 @@ inline void ThrowIfFailed(HRESULT hr)
 	}
 }
 
-inline void TransitionResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after)
+inline DXGI_FORMAT GetDXGIFormat(TextureFormat format)
 {
-	ComPtr<ID3D12GraphicsCommandList2> commandList = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->GetGraphicsCommandList();
-	CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(resource, before, after);
-	commandList->ResourceBarrier(1, &barrier);
+	switch(format)
+	{
+	case TextureFormat::BC1:
+		return DXGI_FORMAT_BC1_UNORM;
+	case TextureFormat::BC3:
+		return DXGI_FORMAT_BC3_UNORM;
+	case TextureFormat::BC4:
+		return DXGI_FORMAT_BC4_UNORM;
+	case TextureFormat::BC5:
+		return DXGI_FORMAT_BC5_UNORM;
+	case TextureFormat::BC7:
+		return DXGI_FORMAT_BC7_UNORM;
+	case TextureFormat::RGBA16F:
+		return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case TextureFormat::RGBA32F:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case TextureFormat::BC6H:
+		return DXGI_FORMAT_BC6H_UF16;
+	default:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
 }
 
 // UpdateBufferResource Process:
@@ -75,44 +94,6 @@ inline void UpdateBufferResource(ComPtr<ID3D12GraphicsCommandList2> commandList,
 	UpdateSubresources(commandList.Get(), *destinationResource, *intermediateResource, 0, 0, 1, &subresourceData);
 }
 
-inline void UploadPixelShaderResource(ComPtr<ID3D12Resource>& destinationResource, ComPtr<ID3D12Resource>& intermediateResource, D3D12_RESOURCE_DESC& resourceDescription, 
-	D3D12_SUBRESOURCE_DATA& subresource)
-{
-	ComPtr<ID3D12Device2> device = DXAccess::GetDevice();
-	DXCommands* copyCommands = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_COPY);
-	ComPtr<ID3D12GraphicsCommandList2> commandList = copyCommands->GetGraphicsCommandList();
-
-	D3D12_HEAP_PROPERTIES gpuHeap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-	D3D12_HEAP_PROPERTIES uploadHeap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-
-	// 1.a Allocate heap on the GPU to upload the texture  //
-	ThrowIfFailed(device->CreateCommittedResource(&gpuHeap, D3D12_HEAP_FLAG_NONE,
-		&resourceDescription, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&destinationResource)));
-
-	// 1.b Allocate heap in RAM to upload the texture to //
-	unsigned int size = GetRequiredIntermediateSize(destinationResource.Get(), 0, 1);
-	D3D12_RESOURCE_DESC bufferDescription = CD3DX12_RESOURCE_DESC::Buffer(size);
-
-	ThrowIfFailed(device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE,
-		&bufferDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&intermediateResource)));
-
-	// 2. Prepare barriers & record commands //
-	CD3DX12_RESOURCE_BARRIER copyBarrier = CD3DX12_RESOURCE_BARRIER::Transition(destinationResource.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-	CD3DX12_RESOURCE_BARRIER pixelBarrier = CD3DX12_RESOURCE_BARRIER::Transition(destinationResource.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-	
-	copyCommands->Flush();
-	copyCommands->ResetCommandList();
-
-	commandList->ResourceBarrier(1, &copyBarrier);
-	UpdateSubresources(commandList.Get(), destinationResource.Get(), intermediateResource.Get(), 0, 0, 1, &subresource);
-	commandList->ResourceBarrier(1, &pixelBarrier);
-
-	// 3. Execute upload and wait until it's finished // 
-	copyCommands->ExecuteCommandList();
-	copyCommands->Signal();
-	copyCommands->WaitForFenceValue();
-}
-
 // Ensures that the direct queue is paused so that a resource and its data can be updated 
 inline void UpdateInFlightCBV(ComPtr<ID3D12Resource>& destinationResource, unsigned int CBVIndex, unsigned int numberOfElements, 
 	unsigned int elementSize, const void* bufferData, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE)
@@ -134,15 +115,15 @@ inline void UpdateInFlightCBV(ComPtr<ID3D12Resource>& destinationResource, unsig
 	DXCommands* directCommands = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
 	directCommands->Flush();
 
+	directCommands->ResetCommandList(DXAccess::GetCurrentFrameIndex());
 	ComPtr<ID3D12GraphicsCommandList2> commandList = directCommands->GetGraphicsCommandList();
-	directCommands->ResetCommandList(DXAccess::GetCurrentBackBufferIndex());
 
 	ComPtr<ID3D12Resource> intermediateResource;
 	UpdateBufferResource(commandList, &destinationResource, &intermediateResource, numberOfElements, elementSize, bufferData, flags);
 
-	directCommands->ExecuteCommandList(DXAccess::GetCurrentBackBufferIndex());
+	directCommands->ExecuteCommandList(DXAccess::GetCurrentFrameIndex());
 	directCommands->Signal();
-	directCommands->WaitForFenceValue(DXAccess::GetCurrentBackBufferIndex());
+	directCommands->WaitForFenceValue(DXAccess::GetCurrentFrameIndex());
 
 	ComPtr<ID3D12Device2> device = DXAccess::GetDevice();
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+struct DescriptorAllocatorStatistics
+{
+	unsigned int PersistentCapacity = 0;
+	unsigned int PersistentAllocated = 0;
+	unsigned int PendingFrees = 0; // Freed, but still waiting for the GPU to finish with them
+	unsigned int FreeRangeCount = 0;
+	unsigned int LargestFreeRange = 0;
+
+	unsigned int TransientCapacity = 0; // Per frame
+	unsigned int TransientAllocated = 0; // Within the current frame
+};
+
+/// <summary>
+/// Hands out index ranges within a descriptor heap, only does the bookkeeping so it doesn't need a device.
+/// The front of the heap holds persistent descriptors, allocated as contiguous ranges from a free list
+/// ( first fit, neighbouring free ranges get merged ). Freed ranges might still be used by frames in flight,
+/// so they only return to the free list once BeginFrame is called for the frame they were freed in again.
+/// The back of the heap is split into a region per frame in flight for transient tables, which are
+/// allocated linearly & reset with BeginFrame, following the DXConstantRing.
+/// </summary>
+class DescriptorAllocator
+{
+public:
+	DescriptorAllocator(unsigned int persistentCount, unsigned int transientCount = 0, unsigned int frameCount = 1);
+
+	// Returns the first index of 'count' adjacent descriptors, InvalidIndex when there's no range large enough //
+	unsigned int Allocate(unsigned int count = 1);
+
+	// Returns the range once the current frame comes around again //
+	void Free(unsigned int index);
+
+	// Only for descriptors the GPU never reads from the heap itself, like RTVs & DSVs //
+	void FreeImmediate(unsigned int index);
+
+	// Has to be called once the GPU is done with the previous use of 'frameIndex' //
+	void BeginFrame(unsigned int frameIndex);
+	unsigned int AllocateTransient(unsigned int count);
+
+	unsigned int GetDescriptorCount();
+	DescriptorAllocatorStatistics GetStatistics();
+
+	static const unsigned int InvalidIndex = ~0u;
+
+private:
+	unsigned int persistentCount;
+	unsigned int transientCount;
+	unsigned int frameCount;
+
+	std::map<unsigned int, unsigned int> freeRanges; // First index & size of every free range, ordered so neighbours can merge
+	std::unordered_map<unsigned int, unsigned int> allocatedRanges;
+	std::vector<std::vector<unsigned int>> pendingFrees; // For every frame in flight
+	unsigned int allocatedCount = 0;
+
+	unsigned int currentFrame = 0;
+	unsigned int transientOffset = 0;
+};
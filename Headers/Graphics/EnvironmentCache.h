@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/SphericalHarmonics.h"
+
+// Environment map ready to be uploaded, Data contains the full mip chain in 'Format' //
+// Irradiance & the specular chain are baked from the uncompressed environment, before encoding //
+struct EnvironmentData
+{
+	int Width = 0;
+	int Height = 0;
+	int MipCount = 1;
+	TextureFormat Format = TextureFormat::RGBA32F;
+	CompressionQuality Quality = CompressionQuality::None;
+	std::vector<unsigned char> Data;
+	SHIrradiance Irradiance = {};
+
+	// GGX prefiltered reflections, level i is filtered for roughness i / ( SpecularMipCount - 1 ) //
+	int SpecularWidth = 0;
+	int SpecularHeight = 0;
+	int SpecularMipCount = 1;
+	TextureFormat SpecularFormat = TextureFormat::RGBA32F;
+	std::vector<unsigned char> Specular;
+};
+
+/// <summary>
+/// Stores encoded HDRIs on disk, so mip generation & BC6H encoding only happen the first time an
+/// environment gets loaded. Works like the ModelCache, an entry is only used while the source file is
+/// unchanged and it was encoded with the requested format & quality.
+/// </summary>
+class EnvironmentCache
+{
+public:
+	EnvironmentCache(const std::string& cacheDirectory = "Cache/Environments/");
+
+	bool Load(const std::string& filePath, TextureFormat format, CompressionQuality quality, EnvironmentData& environment);
+	bool Store(const std::string& filePath, const EnvironmentData& environment);
+
+	// The BRDF lookup table doesn't depend on any environment, so it gets its own entry ( RGBA16F ) //
+	bool LoadBRDF(int size, int sampleCount, std::vector<unsigned char>& data);
+	bool StoreBRDF(int size, int sampleCount, const std::vector<unsigned char>& data);
+
+private:
+	std::string GetCachePath(const std::string& filePath);
+	std::string GetBRDFCachePath(int size);
+
+private:
+	std::string cacheDirectory;
+};
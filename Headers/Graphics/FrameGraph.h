@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// How a pass uses a resource, the backend maps these onto its own resource states //
+enum class ResourceUsage
+{
+	Common,
+	RenderTarget,
+	DepthWrite,
+	DepthRead,
+	ShaderResource,
+	UnorderedAccess,
+	CopySource,
+	CopyDestination,
+	Present
+};
+
+// Transitions with idle levels between the last & next use are split, the begin half is issued right
+// after the last use, so the GPU can do the transition while the levels in between execute //
+enum class BarrierSplit
+{
+	None,
+	Begin,
+	End
+};
+
+struct FrameGraphBarrier
+{
+	unsigned int Resource;
+	ResourceUsage Before;
+	ResourceUsage After;
+
+	// First use of a transient resource that shares its memory with other transients //
+	bool Aliasing = false;
+	BarrierSplit Split = BarrierSplit::None;
+};
+
+struct CompiledPass
+{
+	unsigned int Pass; // Index returned by AddPass
+	unsigned int Level; // Passes on the same level don't depend on each other
+
+	// Transitions to issue before the pass, every pass of a level shares one batch on its first pass.
+	// Includes the begin halves of split transitions that end on a later level //
+	std::vector<FrameGraphBarrier> Barriers;
+};
+
+/// <summary>
+/// Orders the passes of a frame from the resources they declare to read & write, without knowing about the backend.
+/// Compile culls passes whose output is never used, puts every pass on the earliest level its dependencies allow,
+/// and records the transitions between usages, batched per level & split when levels pass between uses. Imported resources live outside of the graph & start
+/// and end the frame in a fixed usage, exporting one keeps its writers alive. Transient resources only live within
+/// the frame, they're given offsets in a shared block of memory, where resources that are never alive at the same
+/// time overlap. The graph can be compiled once & executed every frame, the backend binds the actual resources.
+/// </summary>
+class FrameGraph
+{
+public:
+	// 'usage' is the state the resource is in before the frame, & returns to afterwards //
+	unsigned int ImportResource(const std::string& name, ResourceUsage usage);
+	unsigned int CreateTransient(const std::string& name, uint64_t size, uint64_t alignment);
+
+	// Read after the frame, like a swap chain buffer getting presented //
+	void ExportResource(unsigned int resource);
+
+	// Passes with side effects are never culled //
+	unsigned int AddPass(const std::string& name, bool hasSideEffects = false);
+
+	// A write doesn't keep the previous contents, anything that draws on top of them is a ReadWrite //
+	void Read(unsigned int pass, unsigned int resource, ResourceUsage usage);
+	void Write(unsigned int pass, unsigned int resource, ResourceUsage usage);
+	void ReadWrite(unsigned int pass, unsigned int resource, ResourceUsage usage);
+
+	void Compile();
+
+	const std::vector<CompiledPass>& GetCompiledPasses();
+	const std::vector<FrameGraphBarrier>& GetFinalBarriers(); // Returns resources to their usage outside of the frame
+	bool IsPassCulled(unsigned int pass);
+
+	unsigned int LookupResource(const std::string& name);
+	const std::string& GetResourceName(unsigned int resource);
+	const std::string& GetPassName(unsigned int pass);
+	bool IsTransient(unsigned int resource);
+	ResourceUsage GetInitialUsage(unsigned int resource);
+
+	uint64_t GetTransientOffset(unsigned int resource);
+	uint64_t GetTransientMemorySize(); // With aliasing
+	uint64_t GetUnaliasedMemorySize();
+
+	unsigned int GetPassCount();
+	unsigned int GetResourceCount();
+	unsigned int GetLevelCount();
+
+	// Compile times of synthetic graphs with hundreds of passes //
+	static void RunBenchmark();
+
+	static constexpr unsigned int InvalidIndex = ~0u;
+
+private:
+	enum class Access
+	{
+		Read,
+		Write,
+		ReadWrite
+	};
+
+	struct ResourceAccess
+	{
+		unsigned int Resource;
+		ResourceUsage Usage;
+		Access Type;
+	};
+
+	struct Pass
+	{
+		std::string Name;
+		bool HasSideEffects;
+		std::vector<ResourceAccess> Accesses;
+	};
+
+	struct Resource
+	{
+		std::string Name;
+		bool Transient;
+		bool Exported = false;
+		ResourceUsage Usage; // Outside of the frame, for transients it's the usage of their first access
+		uint64_t Size = 0;
+		uint64_t Alignment = 1;
+		uint64_t Offset = 0;
+	};
+
+	void AddAccess(unsigned int pass, unsigned int resource, ResourceUsage usage, Access type);
+
+	void CullPasses();
+	void AssignLevels();
+	void RecordBarriers();
+	void PlaceTransients();
+
+private:
+	std::vector<Pass> passes;
+	std::vector<Resource> resources;
+	std::unordered_map<std::string, unsigned int> resourceLookup;
+
+	std::vector<bool> culled;
+	std::vector<CompiledPass> compiledPasses;
+	std::vector<FrameGraphBarrier> finalBarriers;
+	std::vector<bool> aliased; // Per resource, whether its first use needs an aliasing barrier
+
+	unsigned int levelCount = 0;
+	uint64_t transientMemorySize = 0;
+	uint64_t unaliasedMemorySize = 0;
+};
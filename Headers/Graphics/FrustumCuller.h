@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Graphics/Bounds.h"
+
+#include <vector>
+
+// Planes point inwards, a point is inside a plane when dot( plane.xyz, point ) + plane.w >= 0 //
+struct Frustum
+{
+	glm::vec4 Planes[6];
+};
+
+/// <summary>
+/// Tests bounding volumes against a frustum, four at a time with SSE, or eight at a time with AVX when the build enables it.
+/// Volumes are stored as a structure of arrays ( every center x, then every center y... ), so a single load fetches the same
+/// component of several volumes. A volume is culled once it's completely behind one of the planes, which is conservative,
+/// volumes just outside of a frustum corner can still be reported as visible. Doesn't know about the backend, the
+/// benchmark runs headless against a scalar reference.
+/// </summary>
+class FrustumCuller
+{
+public:
+	// Works for both [0, 1] & [-1, 1] depth, the near plane is placed as if depth went down to -1 //
+	static Frustum ExtractFrustum(const glm::mat4& viewProjection);
+
+	void Clear();
+	void AddBox(const BoundingBox& box);
+	void AddSphere(const BoundingSphere& sphere);
+
+	// 'visibility' gets an entry for every volume, in the order they were added, 1 when it's ( partially ) inside.
+	// Returns the amount of visible volumes //
+	unsigned int CullBoxes(const Frustum& frustum, std::vector<unsigned char>& visibility);
+	unsigned int CullSpheres(const Frustum& frustum, std::vector<unsigned char>& visibility);
+
+	unsigned int GetBoxCount();
+	unsigned int GetSphereCount();
+
+	// Nanoseconds per volume of scalar, SSE & AVX culling, on a few hundred thousand boxes & spheres //
+	static void RunBenchmark();
+
+	// Arrays are padded to a multiple of the widest path, so the last group never reads past the end //
+	static const unsigned int GroupSize = 8;
+
+private:
+	std::vector<float> boxCenterX, boxCenterY, boxCenterZ;
+	std::vector<float> boxExtentX, boxExtentY, boxExtentZ;
+	unsigned int boxCount = 0;
+
+	std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+	unsigned int sphereCount = 0;
+};
@@ -5,22 +5,30 @@
 #include <wrl.h>
 using namespace Microsoft::WRL;
 
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/SphericalHarmonics.h"
+
 class DXRootSignature;
 class DXPipeline;
+struct EnvironmentData;
 
 class HDRI 
 {
 public:
-	HDRI(const std::string& filePath);
+	// The environment gets stored as BC6H ( or RGBA16F ), diffuse irradiance
+	// is stored as spherical harmonics & reflections as a GGX prefiltered chain,
+	// both baked on the CPU while loading.
+	HDRI(const std::string& filePath, TextureFormat format = TextureFormat::BC6H);
 
 	int GetHDRiSRVIndex();
-	int GetIrradianceSRVIndex();
 
 	CD3DX12_GPU_DESCRIPTOR_HANDLE GetHDRISRVHandle();
-	CD3DX12_CPU_DESCRIPTOR_HANDLE GetIraddianceRTVHandle();
+	CD3DX12_GPU_DESCRIPTOR_HANDLE GetSpecularSRVHandle();
+	CD3DX12_GPU_DESCRIPTOR_HANDLE GetBRDFSRVHandle();
+	CD3DX12_GPU_DESCRIPTOR_HANDLE GetIrradianceCBVHandle();
+	const SHIrradiance& GetIrradiance();
 
 	ComPtr<ID3D12Resource> GetHDRiResource();
-	ComPtr<ID3D12Resource> GetIrradianceResource();
 
 	void HDRIDebugWindow();
 
@@ -28,21 +36,26 @@ public:
 	int GetHeight();
 
 private:
-	void UploadBuffer(float* data, int width, int height, 
-		ComPtr<ID3D12Resource>& resource, int& index);
+	bool LoadEnvironment(const std::string& filePath, TextureFormat format, EnvironmentData& environment);
+	void LoadBRDF(std::vector<unsigned char>& data);
 
-public:
-	bool IsConvoluted = false;
+	void UploadBuffer(const unsigned char* data, int width, int height, int mipCount, TextureFormat format,
+		ComPtr<ID3D12Resource>& resource, int& index);
 
 private:
 	ComPtr<ID3D12Resource> hdriResource;
-	ComPtr<ID3D12Resource> irradianceResource;
+	ComPtr<ID3D12Resource> specularResource;
+	ComPtr<ID3D12Resource> brdfResource;
+	ComPtr<ID3D12Resource> irradianceBuffer;
 
 	int hdriIndex = 0;
-	int irradianceIndex = 0;
+	int specularIndex = 0;
+	int brdfIndex = 0;
+	int irradianceCBVIndex = 0;
 
-	int irradianceRTVIndex = 0;
+	SHIrradiance irradiance;
 
 	int width = 0;
 	int height = 0;
+	TextureFormat format = TextureFormat::RGBA32F;
 };
\ No newline at end of file
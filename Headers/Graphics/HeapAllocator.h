@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Two level segregated fit ( TLSF ) allocator over a range of 'capacity' bytes, only does the bookkeeping of offsets.
+/// Free blocks are kept in buckets, a power of two range split into 16 linear steps, with a bitmap of the non-empty ones,
+/// so finding a block & freeing one ( merging it with free neighbours ) take constant time.
+/// Sizes are rounded up to 'granularity', alignments above it are handled by splitting off the front of a block.
+/// Unlike a buddy scheme, blocks don't need to be a power of two, so a mip chain doesn't waste a third of its block.
+/// </summary>
+class TLSFAllocator
+{
+public:
+	// 'granularity' has to be a power of two //
+	TLSFAllocator(uint64_t capacity, uint64_t granularity);
+
+	bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+	void Free(uint64_t offset);
+
+	// Size of the free block an allocation would be taken from, 0 if it doesn't fit //
+	uint64_t GetFittingBlockSize(uint64_t size, uint64_t alignment);
+
+	uint64_t GetCapacity();
+	uint64_t GetAllocatedSize(); // Includes rounding up to the granularity
+	uint64_t GetLargestFreeBlock();
+	unsigned int GetAllocationCount();
+
+	static const unsigned int SecondLevelCount = 16;
+
+private:
+	struct Block
+	{
+		uint64_t Offset;
+		uint64_t Size;
+		bool IsFree;
+
+		// Neighbours in memory & within the free list of its bucket, -1 when there is none //
+		int PreviousPhysical;
+		int NextPhysical;
+		int PreviousFree;
+		int NextFree;
+	};
+
+	void GetBucket(uint64_t size, unsigned int& firstLevel, unsigned int& secondLevel);
+	int FindFreeBlock(uint64_t size, uint64_t alignment);
+
+	int CreateBlock(uint64_t offset, uint64_t size);
+	void ReleaseBlock(int block);
+	void InsertFreeBlock(int block);
+	void RemoveFreeBlock(int block);
+
+	// Splits off everything past 'size' as a new free block //
+	void SplitBlock(int block, uint64_t size);
+
+private:
+	uint64_t capacity;
+	uint64_t granularity;
+	unsigned int firstLevelCount;
+
+	std::vector<Block> blocks;
+	std::vector<int> unusedBlocks; // Entries within 'blocks' that can be reused
+	std::unordered_map<uint64_t, int> allocatedBlocks;
+
+	uint64_t firstLevelBitmap = 0;
+	std::vector<unsigned int> secondLevelBitmaps;
+	std::vector<int> freeLists; // First free block of every bucket
+
+	uint64_t allocatedSize = 0;
+};
+
+struct HeapAllocation
+{
+	unsigned int Heap = 0;
+	uint64_t Offset = 0;
+	uint64_t Size = 0;
+	int SizeClass = -1; // -1 when it's a block of its own
+
+	bool IsValid() const { return Size > 0; }
+};
+
+struct HeapAllocatorStatistics
+{
+	unsigned int HeapCount = 0;
+	unsigned int AllocationCount = 0;
+
+	uint64_t ReservedSize = 0; // Size of all heaps
+	uint64_t RequestedSize = 0; // Sum of the requested sizes
+	uint64_t AllocatedSize = 0; // Blocks & slabs taken from the heaps
+
+	float InternalFragmentation = 0.0f; // Part of the allocated memory that wasn't requested
+	float ExternalFragmentation = 0.0f; // 1 - largest free block of every heap / free memory, 0 when every heap has a single free block
+};
+
+/// <summary>
+/// Bookkeeping of sub-allocations within a growing set of equally sized heaps, without touching any device.
+/// Allocations go to the heap with the smallest free block that fits ( best fit ), a new heap is added when none has room.
+/// Small allocations are served from size classes ( powers of two from 256 bytes up to 'maxSizeClass' ),
+/// each class carves slots out of 64 KB slabs that are a single block,
+/// which avoids rounding every tiny buffer up to a full block. Empty slabs go back to their heap.
+/// Allocations larger than a heap fail, those should get a dedicated resource.
+/// </summary>
+class HeapAllocator
+{
+public:
+	// 'maxSizeClass' of 0 disables size classes //
+	HeapAllocator(uint64_t heapSize, uint64_t granularity, uint64_t maxSizeClass = 0);
+
+	HeapAllocation Allocate(uint64_t size, uint64_t alignment);
+	void Free(const HeapAllocation& allocation);
+
+	unsigned int GetHeapCount();
+	uint64_t GetHeapSize();
+	HeapAllocatorStatistics GetStatistics();
+
+	// Headless benchmark, logs throughput & fragmentation of a few synthetic allocation patterns //
+	static void RunBenchmark();
+
+	static constexpr uint64_t MinSizeClass = 256;
+	static constexpr uint64_t SlabSize = 64 << 10;
+
+private:
+	int GetSizeClass(uint64_t size, uint64_t alignment);
+	HeapAllocation AllocateBlock(uint64_t size, uint64_t alignment);
+	HeapAllocation AllocateSlot(int sizeClass, uint64_t size);
+	void FreeSlot(const HeapAllocation& allocation);
+
+private:
+	struct Slab
+	{
+		HeapAllocation Block;
+		std::vector<unsigned int> FreeSlots;
+		unsigned int SlotCount;
+	};
+
+	// Heap index & offset of a slab //
+	typedef std::pair<unsigned int, uint64_t> SlabKey;
+
+	uint64_t heapSize;
+	uint64_t granularity;
+	uint64_t maxSizeClass;
+
+	std::vector<TLSFAllocator> heaps;
+	std::map<SlabKey, Slab> slabs;
+	std::vector<std::set<SlabKey>> partialSlabs; // Slabs with free slots, for every size class
+
+	unsigned int allocationCount = 0;
+	uint64_t requestedSize = 0;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+/// <summary>
+/// Bakes the split-sum image based lighting inputs on the CPU, spread over the ThreadPool.
+/// - A specular chain, where every level is the environment convolved with GGX for a higher roughness,
+///   so shading only needs a single trilinear fetch instead of sampling the full resolution HDRI.
+/// - The BRDF lookup table, scale & bias applied to F0, indexed by NoV and roughness.
+/// Both use importance sampled GGX, the specular chain also reads from lower environment mips
+/// based on the pdf of each sample ( filtered importance sampling ), which keeps the sample count low.
+/// </summary>
+class IBLBaker
+{
+public:
+	// 'environment' is a RGBA32F equirectangular mip chain ( see MipGenerator ).
+	// Output is a tightly packed RGBA32F chain, level 0 is a copy of the first environment level that fits
+	// within 'maxWidth', level i is filtered for roughness i / ( levelCount - 1 ). Returns the level count.
+	static int PrefilterSpecular(const std::vector<float>& environment, int width, int height, int mipCount,
+		int maxWidth, int maxLevelCount, std::vector<float>& output, int& outputWidth, int& outputHeight);
+
+	// Output is RGBA32F, R = scale & G = bias. Columns go over NoV, rows over roughness //
+	static void IntegrateBRDF(int size, std::vector<float>& output);
+
+	static const int SpecularSampleCount = 128;
+	static const int BRDFSampleCount = 512;
+};
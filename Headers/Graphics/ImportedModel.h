@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Framework/Mathematics.h"
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/Bounds.h"
+
+// Plain CPU-side model data, filled in by the ModelImporter //
+// Nothing in here depends on DirectX, so it can be used by tools as well
+
+struct Vertex
+{
+	glm::vec3 Position;
+	glm::vec3 Normal;
+	glm::vec3 Tangent;
+	glm::vec3 Color;
+	glm::vec2 TexCoord;
+};
+
+struct Material
+{
+	int hasAlbedo;
+	int hasNormal;
+	int hasMetallicRoughness;
+	int hasOcclusion;
+	int hasEmissive;
+
+	int oChannel = 0;
+	int rChannel = 1;
+	int mChannel = 2;
+
+	int alphaBlend = 0; // glTF 'BLEND', drawn with the blended pipeline
+	int alphaMask = 0; // glTF 'MASK', drawn with the opaque pipeline, pixels below the cutoff are discarded
+	float AlphaCutoff = 0.5f;
+
+	// Customize //
+	int useTextures = 1;
+	glm::vec3 Color = glm::vec3(1.0f, 1.0f, 1.0f);
+	float Metallic = 0.0f;
+	float Roughness = 0.0f;
+	float Opacity = 1.0f;
+};
+
+// Decoded image, Pixels contains the full mip chain tightly packed in the given format ( see BlockCompressor ) //
+struct ImportedTexture
+{
+	int Width = 0;
+	int Height = 0;
+	int MipCount = 1;
+	TextureFormat Format = TextureFormat::RGBA8;
+	std::vector<unsigned char> Pixels;
+};
+
+struct ImportedMesh
+{
+	std::string Name;
+
+	std::vector<Vertex> Vertices;
+	std::vector<unsigned int> Indices;
+
+	// Of the vertices, after the node transform got applied //
+	BoundingBox Bounds;
+	BoundingSphere Sphere;
+
+	::Material Material;
+
+	// Indices into ImportedModel::Textures, -1 if the material doesn't use the slot //
+	int AlbedoTexture = -1;
+	int NormalTexture = -1;
+	int MetallicRoughnessTexture = -1;
+	int OcclusionTexture = -1;
+	int EmissiveTexture = -1;
+};
+
+struct ImportedModel
+{
+	std::string Name;
+	std::string FilePath;
+
+	std::vector<ImportedMesh> Meshes;
+	std::vector<ImportedTexture> Textures;
+
+	// Every file the model was read from ( glTF, buffers, images ), used to validate cached copies //
+	std::vector<std::string> SourceFiles;
+
+	// Preset the textures were compressed with, a cached copy is only valid for the same preset //
+	CompressionQuality TextureQuality = CompressionQuality::None;
+};
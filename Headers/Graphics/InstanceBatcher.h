@@ -0,0 +1,60 @@
+#pragma once
+
+#include <d3d12.h>
+#include <unordered_map>
+#include <vector>
+
+#include "Framework/Mathematics.h"
+
+class DXConstantRing;
+class Mesh;
+class Model;
+struct ModelVisibility;
+
+// Every visible placement of a single mesh, drawn with one instanced draw //
+struct InstanceBatch
+{
+	Mesh* Geometry;
+	unsigned int FirstInstance; // Into the instance indices, the shader gets it as a root constant
+	unsigned int InstanceCount;
+
+	unsigned int MeshID; // Same for every batch of a mesh, small enough to sort on
+	float Depth; // Distance from the view to the closest instance
+};
+
+// Addresses to bind the instance data with, both are read as structured buffers //
+struct InstanceBuffers
+{
+	D3D12_GPU_VIRTUAL_ADDRESS Indices; // Transform of every instance, batch after batch
+	D3D12_GPU_VIRTUAL_ADDRESS Transforms; // Model matrix of every visible model
+};
+
+/// <summary>
+/// Groups the visible meshes of a stage by the mesh they draw. Models placed from the same file share their meshes,
+/// so every unique mesh turns into a single instanced draw, no matter how often it's placed. Model matrices get copied
+/// once per visible model, batches reach them through a list of instance indices, so the copy into the constant ring
+/// is a matrix per model & an index per instance, done in one go after the whole list has been built.
+/// Transparent meshes aren't merged, every placement gets a batch of its own so they can be drawn back to front.
+/// </summary>
+class InstanceBatcher
+{
+public:
+	void Build(const std::vector<Model*>& models, const ModelVisibility& visibility, const glm::vec3& viewPosition);
+
+	// Copies the instance indices & transforms into the current frame //
+	InstanceBuffers Upload(DXConstantRing* constantRing);
+
+	const std::vector<InstanceBatch>& GetBatches();
+	const std::vector<unsigned int>& GetDrawCounts(); // A draw per batch, to split them over lists with
+	unsigned int GetInstanceCount();
+
+private:
+	std::vector<InstanceBatch> batches;
+	std::vector<unsigned int> drawCounts;
+	std::vector<unsigned int> instanceIndices;
+	std::vector<glm::mat4> transforms;
+
+	std::vector<unsigned int> meshBatches; // Batch of every visible mesh, in the order of ModelVisibility::Meshes
+	std::unordered_map<Mesh*, unsigned int> batchLookup; // Opaque meshes only
+	std::unordered_map<Mesh*, unsigned int> meshIDs;
+};
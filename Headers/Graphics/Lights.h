@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 #include <glm.hpp>
 
 const int MAX_AMOUNT_OF_LIGHTS = 15;
@@ -17,4 +18,10 @@ struct LightData
 	int activePointLights;		// 480 - 484 //
 	glm::vec3 stub;				// 484 - 496 //
 	glm::vec4 stub2;			// 496 - 512 // 
-};
\ No newline at end of file
+};
+
+// Distance where inverse square falloff drops below 1/256, past it a light can't change an 8-bit color //
+inline float GetPointLightRange(const PointLight& light)
+{
+	return sqrtf(light.Intensity * 256.0f);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef MATERIAL_LAYOUT_H
+#define MATERIAL_LAYOUT_H
+
+// Included by both C++ & HLSL ( default.pixel.hlsl ), so there's a single definition of the GPU material.
+// Uses an include guard & macros only, since this has to be valid in both languages.
+
+#ifdef __cplusplus
+#include "Framework/Mathematics.h"
+#include <cstddef>
+#define MATERIAL_FLOAT3 glm::vec3
+#define MATERIAL_UINT unsigned int
+#else
+#define MATERIAL_FLOAT3 float3
+#define MATERIAL_UINT uint
+#endif
+
+// Bits of MaterialData::Flags //
+#define MATERIAL_HAS_ALBEDO (1u << 0)
+#define MATERIAL_HAS_NORMAL (1u << 1)
+#define MATERIAL_HAS_METALLIC_ROUGHNESS (1u << 2)
+#define MATERIAL_HAS_OCCLUSION (1u << 3)
+#define MATERIAL_HAS_EMISSIVE (1u << 4)
+#define MATERIAL_USE_TEXTURES (1u << 5)
+#define MATERIAL_ALPHA_TEST (1u << 6)
+
+// Texture channels ( 0 - 2 ) are stored in 2 bits each, after the flags //
+#define MATERIAL_OCCLUSION_CHANNEL_SHIFT 8
+#define MATERIAL_ROUGHNESS_CHANNEL_SHIFT 10
+#define MATERIAL_METALLIC_CHANNEL_SHIFT 12
+
+#define MATERIAL_TEXTURE_COUNT 5
+
+// Structured buffers are tightly packed, so this is 52 bytes on both sides //
+struct MaterialData
+{
+	MATERIAL_FLOAT3 Color;
+	float Metallic;
+	float Roughness;
+	float Opacity;
+	float AlphaCutoff; // Only read with MATERIAL_ALPHA_TEST
+	MATERIAL_UINT Flags;
+
+	// Indices into the descriptor heap: Albedo, Normal, Metallic Roughness, Occlusion, Emissive //
+	MATERIAL_UINT TextureIndices[MATERIAL_TEXTURE_COUNT];
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(MaterialData) == 52, "MaterialData has to be tightly packed to match the HLSL layout");
+static_assert(offsetof(MaterialData, Metallic) == 12 && offsetof(MaterialData, Flags) == 28 &&
+	offsetof(MaterialData, TextureIndices) == 32, "MaterialData members have to be at the same offsets as in HLSL");
+#endif
+
+#undef MATERIAL_FLOAT3
+#undef MATERIAL_UINT
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <d3d12.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Graphics/ImportedModel.h"
+#include "Graphics/MaterialLayout.h"
+
+class DXConstantRing;
+
+/// <summary>
+/// Every unique material in the scene, drawn meshes only pass their index into it.
+/// Identical materials share an entry, entries are reference counted & reused once released,
+/// so both the memory & the per frame copy into the constant ring scale with the unique materials.
+/// The table is read as a structured buffer of MaterialData ( see MaterialLayout.h ), textures are
+/// referenced by their index in the CBV/SRV/UAV heap, which the shader reads as an unbounded table.
+/// </summary>
+class MaterialTable
+{
+public:
+	// Returns the index of an identical material when there is one, otherwise it gets added //
+	unsigned int Acquire(const MaterialData& material);
+	void Release(unsigned int index);
+
+	// Copies every material into the current frame, returns the address to bind the buffer with //
+	D3D12_GPU_VIRTUAL_ADDRESS Upload(DXConstantRing* constantRing);
+
+	unsigned int GetMaterialCount();
+	unsigned int GetReferenceCount();
+
+	// Packs the flags & channels of 'material' together with the heap indices of its textures //
+	static MaterialData Pack(const Material& material, const unsigned int textureIndices[MATERIAL_TEXTURE_COUNT]);
+
+	static const unsigned int InvalidIndex = ~0u;
+
+private:
+	uint64_t Hash(const MaterialData& material);
+
+private:
+	std::vector<MaterialData> materials;
+	std::vector<unsigned int> referenceCounts;
+	std::vector<unsigned int> freeSlots;
+	std::unordered_multimap<uint64_t, unsigned int> lookup; // Hash of the material to its index
+
+	unsigned int referenceCount = 0;
+};
@@ -8,71 +8,45 @@
 using namespace Microsoft::WRL;
 
 #include "Framework/Mathematics.h"
-#include "tiny_gltf.h"
-
-struct Vertex
-{
-	glm::vec3 Position;
-	glm::vec3 Normal;
-	glm::vec3 Tangent;
-	glm::vec3 Color;
-	glm::vec2 TexCoord;
-};
-
-struct Material
-{
-	int hasAlbedo;
-	int hasNormal;
-	int hasMetallicRoughness;
-	int hasOcclusion;
-	int hasEmissive;
-
-	int oChannel = 0;
-	int rChannel = 1;
-	int mChannel = 2;
-
-	// Customize //
-	int useTextures = 1;
-	glm::vec3 Color = glm::vec3(1.0f, 1.0f, 1.0f);
-	float Metallic = 0.0f;
-	float Roughness = 0.0f;
-
-	// GPU Memory alignment //
-	double stub[25];
-};
+#include "Graphics/ImportedModel.h"
+#include "Graphics/UploadQueue.h"
+#include "Graphics/DXMemoryAllocator.h"
 
 class Texture;
 
 class Mesh
 {
 public:
-	Mesh(tinygltf::Model& model, tinygltf::Primitive& primitive, glm::mat4& transform);
+	Mesh(ImportedMesh& importedMesh, const std::string& modelPath, const std::vector<ImportedTexture>& textures);
 	Mesh(Vertex* vertices, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount);
-
-	void UpdateMaterialData();
+	~Mesh();
 
 	const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView();
 	const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView();
-	const CD3DX12_GPU_DESCRIPTOR_HANDLE GetMaterialView();
 	const unsigned int GetIndicesCount();
 
 	bool HasTextures();
-	unsigned int GetTextureID();
+	bool IsTransparent(); // Blended, by the 'BLEND' alpha mode or an opacity below 1. Masked meshes stay opaque
+	unsigned int GetMaterialIndex();
 
-private:
-	void LoadAttribute(tinygltf::Model& model, tinygltf::Primitive& primitive, const std::string& attributeType);
-	void LoadIndices(tinygltf::Model& model, tinygltf::Primitive& primitive);
-	void LoadMaterial(tinygltf::Model& model, tinygltf::Primitive& primitive);
-	void LoadTexture(tinygltf::Model& model, Texture** texture, int textureID, int& materialCheck);
+	// In the space of the model, kept after the vertices are released //
+	const BoundingBox& GetBounds();
+	const BoundingSphere& GetBoundingSphere();
+
+	// Has to be called after editing 'Material', identical materials share an entry in the MaterialTable //
+	void UpdateMaterial();
 
-	void GenerateTangents();
+	// Vertex & index buffers are usable once the upload queue has completed this ticket //
+	const UploadTicket& GetUploadTicket();
 
-	void ApplyNodeTransform(const glm::mat4& transform);
+private:
+	void LoadTexture(Texture** texture, const std::string& modelPath, const std::vector<ImportedTexture>& textures,
+		int textureIndex, int& materialCheck);
 	void UploadBuffers();
 
 public:
 	std::string Name;
-	Material Material;
+	Material Material; // CPU side copy, packed into the MaterialTable by UpdateMaterial
 
 	// Texture & Material Data //
 	Texture* albedoTexture = nullptr;
@@ -83,19 +57,20 @@ public:
 
 private:
 	// Vertex & Index Data //
-	ComPtr<ID3D12Resource> vertexBuffer;
+	BufferAllocation vertexBuffer;
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
 
-	ComPtr<ID3D12Resource> indexBuffer;
+	BufferAllocation indexBuffer;
 	D3D12_INDEX_BUFFER_VIEW indexBufferView;
 
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 	unsigned int indicesCount = 0;
+	UploadTicket uploadTicket;
 
+	BoundingBox bounds;
+	BoundingSphere boundingSphere;
 
 	bool hasTextures = false;
-
-	int materialCBVIndex = -1;
-	ComPtr<ID3D12Resource> materialBuffer;
+	unsigned int materialIndex = ~0u;
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+enum class MipFilter
+{
+	Box, // 2x2 average, fast
+	Kaiser // Separable 6-tap Kaiser-windowed sinc, sharper & less aliasing
+};
+
+/// <summary>
+/// Generates full mip chains on the CPU, so it can run as part of importing.
+/// Filtering always happens on linear values, sRGB images get decoded first and encoded again afterwards.
+/// Levels are appended to the passed pixels, tightly packed starting from level 0.
+/// Each level is half the size of the previous one ( rounded down, minimum of 1 ) down to 1x1.
+/// </summary>
+class MipGenerator
+{
+public:
+	// Returns the amount of levels within the chain //
+	static int GenerateRGBA8(std::vector<unsigned char>& pixels, int width, int height,
+		bool isSRGB, MipFilter filter = MipFilter::Box);
+	static int GenerateRGBA32F(std::vector<float>& pixels, int width, int height, MipFilter filter = MipFilter::Box);
+
+	static int GetMipCount(int width, int height);
+	static void GetMipSize(int width, int height, int level, int& mipWidth, int& mipHeight);
+
+	// Offset in pixels of a level within a tightly packed chain //
+	static size_t GetMipOffset(int width, int height, int level);
+
+private:
+	static void Downsample(const float* source, int sourceWidth, int sourceHeight,
+		float* destination, int destinationWidth, int destinationHeight, MipFilter filter);
+	static void DownsampleBox(const float* source, int sourceWidth, int sourceHeight,
+		float* destination, int destinationWidth, int destinationHeight);
+	static void DownsampleKaiser(const float* source, int sourceWidth, int sourceHeight,
+		float* destination, int destinationWidth, int destinationHeight);
+};
@@ -1,32 +1,55 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
-#include <tiny_gltf.h>
 
 #include "Graphics/Transform.h"
+#include "Graphics/Bounds.h"
 #include "Graphics/DXUtilities.h"
 
 class Mesh;
 
+// Everything loaded from a glTF, shared by every model placed from the same file //
+// Owns its meshes, they get deleted once the last model & the scene let go of it
+struct ModelAsset
+{
+	ModelAsset() = default;
+	ModelAsset(const ModelAsset&) = delete;
+	ModelAsset& operator=(const ModelAsset&) = delete;
+	~ModelAsset();
+
+	std::string FilePath;
+	std::string Name;
+	std::vector<Mesh*> Meshes;
+
+	BoundingBox Bounds;
+	BoundingSphere Sphere;
+};
+
 class Model
 {
 public:
 	Model(const std::string& filePath);
 
-	void Draw(const glm::mat4& viewProjection, const glm::mat4& lightMatrix);
+	// Another placement of an already loaded asset, only the transform is its own //
+	Model(const std::shared_ptr<ModelAsset>& asset);
+
+	// False when the file couldn't be imported, the model has no meshes then //
+	bool IsLoaded();
 
 	Mesh* GetMesh(int index);
 	const std::vector<Mesh*>& GetMeshes();
+	const std::shared_ptr<ModelAsset>& GetAsset();
+
+	// Around every mesh, without the transform //
+	const BoundingBox& GetBounds();
+	const BoundingSphere& GetBoundingSphere();
 
 public:
 	Transform Transform;
 	std::string Name;
 
 private:
-	void TraverseRootNodes(tinygltf::Model& model);
-	void TraverseChildNodes(tinygltf::Model& model, tinygltf::Node& node, const glm::mat4& parentMatrix);
-
-	glm::mat4 GetTransformFromNode(tinygltf::Node& node);
-
-	std::vector<Mesh*> meshes;
+	std::shared_ptr<ModelAsset> asset;
+	bool loaded = false;
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include "Graphics/ImportedModel.h"
+
+/// <summary>
+/// Stores imported models as 'cooked' binary files, so loading them again skips
+/// parsing, decoding & processing entirely. Entries are keyed by the source path, and only
+/// used while every source file still has the same size & modification time ( or content ).
+/// When an entry is missing or stale, the model is expected to be imported and stored again.
+/// </summary>
+class ModelCache
+{
+public:
+	ModelCache(const std::string& cacheDirectory = "Cache/Models/");
+
+	// Entries compressed with a different preset are treated as stale //
+	bool Load(const std::string& filePath, ImportedModel& importedModel, CompressionQuality textureQuality);
+	bool Store(const ImportedModel& importedModel);
+
+private:
+	std::string GetCachePath(const std::string& filePath);
+
+private:
+	std::string cacheDirectory;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <tiny_gltf.h>
+#include <json.hpp>
+
+#include "Graphics/ImportedModel.h"
+#include "Graphics/AccessorDecoder.h"
+#include "Utilities/MappedFile.h"
+
+/// <summary>
+/// Turns a glTF (.gltf/.glb) file into an ImportedModel. Parsing happens on the calling thread,
+/// afterwards all primitives and images get decoded in parallel on the ThreadPool.
+/// Binary data is read straight out of memory mapped files, TinyglTF only ever sees the JSON.
+/// Images get a mip chain and are block compressed based on the material slots they're used for.
+/// The importer never touches the GPU, uploading is done by Model/Mesh.
+/// </summary>
+class ModelImporter
+{
+public:
+	ModelImporter(CompressionQuality textureQuality = CompressionQuality::Balanced);
+
+	// False when the file can't be read or holds no drawable geometry, the reason gets logged //
+	bool Import(const std::string& filePath, ImportedModel& importedModel);
+
+	CompressionQuality GetTextureQuality();
+
+	// Geometry decode throughput per attribute in vertices/s, best of several imports per model.
+	// Without paths DamagedHelmet & the Skydome are used, images aren't decoded during the benchmark //
+	static void RunBenchmark(const std::vector<std::string>& modelPaths);
+
+private:
+	// Material slots an image is used for, combined as flags //
+	enum ImageUsage
+	{
+		AlbedoUsage = 1 << 0,
+		NormalUsage = 1 << 1,
+		MetallicRoughnessUsage = 1 << 2,
+		OcclusionUsage = 1 << 3,
+		EmissiveUsage = 1 << 4
+	};
+
+	// Work item for a single primitive, collected while traversing the node tree //
+	struct PrimitiveJob
+	{
+		const tinygltf::Primitive* Primitive;
+		std::string Name;
+		glm::mat4 Transform;
+	};
+
+	// Destination of a glTF attribute within the interleaved Vertex //
+	struct VertexAttribute
+	{
+		const char* Name;
+		size_t Offset;
+		unsigned int Components;
+	};
+
+	// Time spent decoding, summed over all threads, to report throughput per attribute //
+	struct DecodeStatistics
+	{
+		std::atomic<unsigned long long> Nanoseconds{ 0 };
+		std::atomic<unsigned long long> Elements{ 0 };
+	};
+
+	// View into binary data that lives in a mapped file ( or TinyglTF for data URIs ) //
+	struct BufferSpan
+	{
+		const unsigned char* Data = nullptr;
+		size_t Size = 0;
+	};
+
+	// Where the encoded image can be found, it gets read once the image is decoded //
+	struct ImageSource
+	{
+		std::string Uri;
+		int BufferView = -1;
+	};
+
+	bool ParseGLB(const unsigned char* data, size_t size, BufferSpan& jsonChunk, BufferSpan& binaryChunk);
+	bool PrepareBuffers(nlohmann::json& document, const BufferSpan& binaryChunk,
+		std::vector<bool>& mappedBuffers, std::vector<std::string>& sourceFiles);
+	void PrepareImages(nlohmann::json& document);
+
+	void TraverseRootNodes(tinygltf::Model& model);
+	void TraverseChildNodes(tinygltf::Model& model, tinygltf::Node& node, const glm::mat4& parentTransform);
+	void AddPrimitiveJobs(tinygltf::Model& model, int meshID, const glm::mat4& transform);
+
+	glm::mat4 GetTransformFromNode(tinygltf::Node& node);
+
+	// False when the primitive can't be drawn, it's left out of the model then //
+	bool ImportPrimitive(tinygltf::Model& model, const PrimitiveJob& job, ImportedMesh& mesh);
+	bool GetAccessorView(tinygltf::Model& model, int bufferViewID, size_t byteOffset, size_t count,
+		int componentType, int type, bool normalized, AccessorView& accessorView);
+
+	bool LoadAttribute(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh, const VertexAttribute& attribute);
+	bool LoadIndices(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh);
+	void LoadMaterial(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh);
+	int GetImageIndex(tinygltf::Model& model, int textureID, int& materialCheck);
+	TextureFormat GetTextureFormat(unsigned int usage, const ImportedTexture& texture);
+
+	void GenerateTangents(ImportedMesh& mesh);
+	void ApplyNodeTransform(ImportedMesh& mesh, const glm::mat4& transform);
+
+	void DecodeImage(tinygltf::Model& model, unsigned int imageIndex, ImportedTexture& texture);
+
+private:
+	static const unsigned int VertexAttributeCount = 4;
+	static const VertexAttribute vertexAttributes[VertexAttributeCount];
+
+	// One entry per vertex attribute, the last one being the indices //
+	DecodeStatistics attributeStatistics[VertexAttributeCount + 1];
+
+	CompressionQuality textureQuality;
+	std::string baseDirectory;
+	bool decodeImages = true;
+
+	std::vector<PrimitiveJob> primitiveJobs;
+	std::vector<BufferSpan> buffers;
+	std::vector<ImageSource> images;
+
+	// Keeps the external buffers mapped for as long as the import takes //
+	std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+};
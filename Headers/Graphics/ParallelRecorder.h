@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+struct RecordRange
+{
+	unsigned int Begin;
+	unsigned int End; // Exclusive
+};
+
+/// <summary>
+/// Splits a list of items ( models ) into contiguous ranges with about the same amount of draws each,
+/// so every range can be recorded into its own command list on a worker of the ThreadPool. Ranges stay
+/// in order, executing their lists in order draws everything in the same order as a single list would.
+/// Doesn't know about the backend, the benchmark records into a mock command list.
+/// </summary>
+class ParallelRecorder
+{
+public:
+	// At most 'maxRanges' ranges, but none with less than 'minimumDraws' unless there's only one //
+	static std::vector<RecordRange> Partition(const std::vector<unsigned int>& drawCounts, unsigned int maxRanges,
+		unsigned int minimumDraws);
+
+	// Runs 'record' for every range on the thread pool, returns once all of them are done //
+	static void Record(ThreadPool& threadPool, const std::vector<RecordRange>& ranges,
+		const std::function<void(unsigned int, const RecordRange&)>& record);
+
+	// Draws per millisecond against thread count, recording into mock command lists //
+	static void RunBenchmark();
+
+	static const unsigned int MinimumDrawsPerList = 256;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+// Binds the recording loop made, against the ones it skipped because the same state was already bound on that list //
+struct RenderQueueStatistics
+{
+	unsigned int Draws = 0;
+
+	unsigned int PipelineBinds = 0;
+	unsigned int MaterialBinds = 0;
+	unsigned int GeometryBinds = 0;
+
+	unsigned int PipelinesSkipped = 0;
+	unsigned int MaterialsSkipped = 0;
+	unsigned int GeometrySkipped = 0;
+};
+
+/// <summary>
+/// Orders the draws of a stage by a 64-bit key, so draws that share state end up next to each other and the recording
+/// loop only has to bind what changed. Opaque keys hold the pipeline, material, depth & mesh, most significant first,
+/// so draws of a material go front to back, only draws at the same quantized depth get grouped by mesh. Blended
+/// pipelines put depth ( back to front ) right after the pipeline, their draws have to be in order to blend correctly.
+/// Keys are radix sorted 8 bits at a time, passes are split over the ThreadPool. Doesn't know about the backend, the
+/// benchmark sorts synthetic draws headless.
+/// </summary>
+class RenderQueue
+{
+public:
+	// Also resets the statistics //
+	void Clear();
+
+	// 'item' is what the caller records the draw with, like the index of a batch //
+	void Add(unsigned int pipeline, unsigned int material, unsigned int mesh, float depth, unsigned int item);
+	void Sort(ThreadPool* threadPool = nullptr);
+
+	// Pipelines are opaque unless marked, draws of a blended pipeline sort back to front //
+	void SetBlended(unsigned int pipeline, bool blended);
+
+	unsigned int GetDrawCount();
+	unsigned int GetItem(unsigned int draw); // In sorted order once 'Sort' has been called
+	unsigned int GetPipeline(unsigned int draw);
+	uint64_t GetKey(unsigned int draw);
+
+	// Recording threads add what they bound, stays readable until the next 'Clear' //
+	void AddStatistics(const RenderQueueStatistics& listStatistics);
+	RenderQueueStatistics GetStatistics();
+
+	static uint64_t MakeKey(unsigned int pipeline, bool blended, unsigned int material, unsigned int mesh, float depth);
+
+	// Sort timings on 100k synthetic draws against std::sort, and the binds sorting saves //
+	static void RunBenchmark();
+
+	static const unsigned int PipelineBits = 2;
+	static const unsigned int MaterialBits = 20;
+	static const unsigned int MeshBits = 20;
+	static const unsigned int DepthBits = 22;
+
+private:
+	struct SortItem
+	{
+		uint64_t Key;
+		unsigned int Item;
+	};
+
+	std::vector<SortItem> draws;
+	std::vector<SortItem> scratch;
+	std::vector<unsigned int> histograms; // 256 buckets for every chunk of a pass
+
+	unsigned int blendedPipelines = 0; // Bit for every pipeline
+
+	std::mutex statisticsMutex;
+	RenderQueueStatistics statistics;
+};
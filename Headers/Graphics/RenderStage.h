@@ -1,29 +1,61 @@
 #pragma once
 
 #include <d3d12.h>
+#include <functional>
+#include <vector>
 #include <wrl.h>
 using namespace Microsoft::WRL;
 
+#include "Graphics/ParallelRecorder.h"
+#include "Graphics/FrustumCuller.h"
+
 class Window;
 class DXPipeline;
 class DXRootSignature;
+class DXFrameGraph;
+class Scene;
+
+// Visible meshes of every model, in the order the models were culled in //
+struct ModelVisibility
+{
+	std::vector<unsigned int> DrawCounts; // Visible meshes of every model
+	std::vector<unsigned int> MeshOffsets; // First entry of every model in 'Meshes'
+	std::vector<unsigned char> Meshes; // 1 for every mesh that's visible
+};
 
 /// <summary>
 /// The purpose of the RenderStage is to be able to encapsulate
 /// render pass functionality. Whenever you need to do something
 /// relating to screen-spaced pass, we go to ScreenStage.cpp
-/// This also allows us to easily order our render passes in the Renderer.cpp
+/// Stages declare the resources they read & write, the frame graph orders them
+/// & transitions those resources, so stages don't assume what ran before them
 /// </summary>
 class RenderStage
 {
 public:
 	RenderStage(Window* window);
 
+	virtual void DeclareResources(DXFrameGraph& frameGraph, unsigned int pass) = 0;
 	virtual void RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList) = 0;
 
+protected:
+	// Splits the items ( usually models ) over lists recorded on the ThreadPool, by their amount of draws. 'record' binds
+	// everything the stage needs on the list it gets, lists don't inherit state. Returns the list recording continues in //
+	ComPtr<ID3D12GraphicsCommandList2> RecordParallel(ComPtr<ID3D12GraphicsCommandList2> commandList, const std::vector<unsigned int>& drawCounts,
+		const std::function<void(ID3D12GraphicsCommandList2*, const RecordRange&)>& record);
+
+	// Finds the visible models through the scene's hierarchy, then culls the meshes of those by their boxes //
+	void CullModels(Scene* scene, const glm::mat4& viewProjection, ModelVisibility& visibility);
+
 protected:
 	DXPipeline* pipeline;
 	DXRootSignature* rootSignature;
 
 	Window* window;
+
+private:
+	FrustumCuller frustumCuller;
+	std::vector<unsigned int> visibleModels;
+	std::vector<unsigned char> modelVisibility;
+	std::vector<unsigned char> meshVisibility;
 };
\ No newline at end of file
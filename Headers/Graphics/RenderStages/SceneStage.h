@@ -1,5 +1,6 @@
 #pragma once
 #include "Graphics/RenderStage.h"
+#include "Graphics/InstanceBatcher.h"
 
 #include <vector>
 #include <glm.hpp>
@@ -7,16 +8,18 @@
 
 class Scene;
 class ShadowStage;
+class HDRI;
 
 class SceneStage : public RenderStage
 {
 public:
 	SceneStage(Window* window, Scene* scene, ShadowStage* shadowStage);
 
+	void DeclareResources(DXFrameGraph& frameGraph, unsigned int pass) override;
 	void RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList) override;
 	void SetScene(Scene* newScene);
 
-	void SetSkydome(CD3DX12_GPU_DESCRIPTOR_HANDLE skydomeHandle);
+	void SetEnvironment(HDRI* environment);
 
 private:
 	void CreatePipeline();
@@ -25,5 +28,8 @@ private:
 	ShadowStage* shadowStage;
 
 	Scene* scene;
-	CD3DX12_GPU_DESCRIPTOR_HANDLE skydomeHandle;
+	HDRI* environment = nullptr;
+	DXPipeline* blendedPipeline = nullptr; // 'pipeline' draws everything opaque
+	ModelVisibility visibility;
+	InstanceBatcher instances;
 };
\ No newline at end of file
@@ -14,6 +14,7 @@ class ScreenStage : public RenderStage
 public:
 	ScreenStage(Window* window);
 
+	void DeclareResources(DXFrameGraph& frameGraph, unsigned int pass) override;
 	void RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList) override;
 
 private:
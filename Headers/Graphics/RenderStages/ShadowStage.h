@@ -1,5 +1,6 @@
 #pragma once
 #include "Graphics/RenderStage.h"
+#include "Graphics/InstanceBatcher.h"
 #include <glm.hpp>
 
 class DepthBuffer;
@@ -13,6 +14,7 @@ public:
 
 	void Update(float deltaTime);
 
+	void DeclareResources(DXFrameGraph& frameGraph, unsigned int pass) override;
 	void RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList) override;
 
 	DepthBuffer* GetDepthBuffer();
@@ -34,6 +36,8 @@ private:
 	D3D12_VIEWPORT viewport;
 
 	Scene* scene;
+	ModelVisibility visibility;
+	InstanceBatcher instances;
 
 	glm::vec3 lightPosition;
 	glm::vec3 lightDirection;
@@ -6,7 +6,6 @@
 
 class Scene;
 class Mesh;
-class Texture;
 class HDRI;
 
 class SkydomeStage : public RenderStage
@@ -14,6 +13,7 @@ class SkydomeStage : public RenderStage
 public:
 	SkydomeStage(Window* window, Scene* scene);
 
+	void DeclareResources(DXFrameGraph& frameGraph, unsigned int pass) override;
 	void RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList) override;
 	void SetScene(Scene* newScene);
 
@@ -25,7 +25,6 @@ private:
 
 private:
 	Scene* scene;
-	Texture* skydomeTexture;
 	Mesh* skydomeMesh;
 
 	glm::mat4 skydomeMatrix;
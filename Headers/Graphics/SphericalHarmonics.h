@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm.hpp>
+
+// Memory aligned, matches 'IrradianceData' in default.pixel.hlsl //
+// Coefficients are already convolved with the cosine lobe and divided by PI,
+// so evaluating them gives the diffuse lighting for an albedo of 1.
+struct SHIrradiance
+{
+	glm::vec4 Coefficients[9];	// 000 - 144 //
+	glm::vec4 stub[7];			// 144 - 256 //
+};
+
+/// <summary>
+/// L2 spherical harmonics ( 9 coefficients ) of an equirectangular HDRI, used for diffuse
+/// image based lighting instead of convoluting an irradiance map on the GPU.
+/// The projection runs on the ThreadPool, a row at a time, with 4 pixels per SSE iteration.
+/// Directions follow the mapping the shaders use: v = 0 looks down, u = 0.5 looks along +x.
+/// </summary>
+class SphericalHarmonics
+{
+public:
+	// 'pixels' are RGBA32F, tightly packed //
+	static SHIrradiance ProjectIrradiance(const float* pixels, int width, int height);
+	static glm::vec3 EvaluateIrradiance(const SHIrradiance& irradiance, const glm::vec3& normal);
+
+	// Brute force hemisphere integral, the same one the old convolution pass did per pixel //
+	static glm::vec3 IntegrateIrradiance(const float* pixels, int width, int height,
+		const glm::vec3& normal, float sampleDelta = 0.01f);
+
+	// Headless benchmark, logs projection time for every mip level & the error against the brute force integral //
+	static void RunBenchmark(const std::vector<std::string>& hdriPaths);
+
+private:
+	static void ProjectRow(const float* pixels, int width, int height, int y,
+		const float* cosPhi, const float* sinPhi, double* sums);
+};
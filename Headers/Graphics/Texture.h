@@ -1,29 +1,52 @@
 #pragma once
 
-#include <tiny_gltf.h>
+#include <string>
+#include <vector>
 #include <d3d12.h>
 #include <d3dx12.h>
 #include <wrl.h>
 using namespace Microsoft::WRL;
 
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/UploadQueue.h"
+#include "Graphics/HeapAllocator.h"
+
 class Texture
 {
 public:
-	Texture(tinygltf::Model& model, tinygltf::Texture& texture);
 	Texture(const std::string& filePath);
-	Texture(unsigned char* data, int width, int height);
+	Texture(unsigned char* data, int width, int height, int mipCount = 1, TextureFormat format = TextureFormat::RGBA8);
 
 	~Texture();
 
+	// Creates an additional view of the texture, e.g. within a mesh's descriptor table //
+	void CreateSRV(D3D12_CPU_DESCRIPTOR_HANDLE handle);
+
 	int GetSRVIndex();
 	CD3DX12_GPU_DESCRIPTOR_HANDLE GetSRV();
 	D3D12_GPU_VIRTUAL_ADDRESS GetGPULocation();
 	ComPtr<ID3D12Resource> GetResource();
 
+	int GetWidth();
+	int GetHeight();
+	int GetMipCount();
+	TextureFormat GetFormat();
+	unsigned long long GetByteSize();
+
+	// The texture is usable once the upload queue has completed this ticket //
+	const UploadTicket& GetUploadTicket();
+
 private:
-	void UploadData(unsigned char* data, int width, int height);
+	void UploadData(unsigned char* data, int width, int height, int mipCount, TextureFormat format);
 
 private:
 	ComPtr<ID3D12Resource> textureResource;
+	HeapAllocation textureAllocation; // Invalid when the texture is a committed resource
 	int srvIndex = 0;
+	UploadTicket uploadTicket;
+
+	int width = 0;
+	int height = 0;
+	int mipCount = 1;
+	TextureFormat format = TextureFormat::RGBA8;
 };
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "Graphics/ImportedModel.h"
+
+class Texture;
+
+struct TextureRegistryStatistics
+{
+	unsigned int Hits = 0;
+	unsigned int Misses = 0;
+
+	unsigned long long UploadedBytes = 0; // Bytes uploaded to the GPU
+	unsigned long long SavedBytes = 0; // Bytes that would have been uploaded again without the registry
+};
+
+/// <summary>
+/// Owns every texture loaded for models, so each image gets decoded, uploaded & given an SRV once.
+/// Textures are identified by either their file path, or the model they belong to together with
+/// their image index. Every Acquire needs a matching Release, once the last reference is gone
+/// the texture gets deleted. The caller is responsible for the GPU not using it anymore.
+/// </summary>
+class TextureRegistry
+{
+public:
+	~TextureRegistry();
+
+	Texture* Acquire(const std::string& modelPath, int imageIndex, const ImportedTexture& image);
+	Texture* Acquire(const std::string& filePath);
+	void Release(Texture* texture);
+
+	const TextureRegistryStatistics& GetStatistics();
+	unsigned int GetTextureCount();
+
+private:
+	Texture* Find(const std::string& key);
+	void Add(const std::string& key, Texture* texture);
+
+private:
+	struct Entry
+	{
+		Texture* Texture;
+		unsigned int ReferenceCount;
+	};
+
+	std::unordered_map<std::string, Entry> entries;
+	std::unordered_map<Texture*, std::string> keys;
+
+	TextureRegistryStatistics statistics;
+};
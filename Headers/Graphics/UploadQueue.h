@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Identifies the batch an upload was recorded in, the upload has
+// finished on the GPU once the queue's fence reached 'FenceValue'
+struct UploadTicket
+{
+	uint64_t FenceValue = 0;
+};
+
+// CPU writable staging memory, 'Handle' is whatever the backend needs to find it back //
+struct StagingBuffer
+{
+	void* Handle = nullptr;
+	unsigned char* Data = nullptr;
+	uint64_t Size = 0;
+};
+
+struct UploadQueueStatistics
+{
+	unsigned long long SubmittedBatches = 0;
+	unsigned long long SubmittedBytes = 0;
+	unsigned long long RetiredBatches = 0;
+	unsigned long long Stalls = 0; // Times the CPU had to wait for the GPU to free up staging memory
+};
+
+/// <summary>
+/// The part of the upload queue that talks to the GPU. Copies themselves get recorded
+/// by the backend, the queue only decides when batches get submitted & when staging memory is released.
+/// </summary>
+class UploadBackend
+{
+public:
+	virtual ~UploadBackend() {}
+
+	virtual StagingBuffer CreateStaging(uint64_t size) = 0;
+	virtual void ReleaseStaging(StagingBuffer& staging) = 0;
+
+	// Executes everything recorded since the previous submission, followed by a signal of 'fenceValue' //
+	virtual void Submit(uint64_t fenceValue) = 0;
+	virtual uint64_t GetCompletedValue() = 0;
+	virtual void WaitForValue(uint64_t fenceValue) = 0;
+};
+
+/// <summary>
+/// Batches uploads into a single submission instead of flushing & waiting for every resource.
+/// Staging memory is allocated into the open batch, once a batch gets submitted it's tagged with
+/// the fence value it signals, and its staging memory is released after that value has been reached.
+/// Batches are submitted when they grow past 'batchSize', when a ticket of the open batch
+/// gets waited on, or explicitly through Submit ( the renderer does so every frame ).
+/// Not thread safe, uploads are expected to be recorded from the main thread.
+/// </summary>
+class UploadQueue
+{
+public:
+	UploadQueue(UploadBackend* backend, uint64_t batchSize = 64ull << 20, uint64_t maxInFlightSize = 256ull << 20);
+	~UploadQueue();
+
+	// Staging memory for a single upload, 'ticket' is set to the batch the copy has to be recorded in //
+	StagingBuffer Allocate(uint64_t size, UploadTicket& ticket);
+
+	// Submits the open batch if it contains anything, returns the ticket of the last submitted batch //
+	UploadTicket Submit();
+
+	bool IsComplete(const UploadTicket& ticket);
+	void Wait(const UploadTicket& ticket);
+	void Flush();
+
+	// Releases staging memory of every batch the GPU has finished //
+	void Retire();
+
+	UploadTicket GetOpenTicket();
+	UploadTicket GetSubmittedTicket();
+	uint64_t GetPendingSize();
+	uint64_t GetInFlightSize();
+	unsigned int GetInFlightBatchCount();
+	const UploadQueueStatistics& GetStatistics();
+
+private:
+	struct Batch
+	{
+		uint64_t FenceValue = 0;
+		uint64_t Size = 0;
+		std::vector<StagingBuffer> Staging;
+	};
+
+	void ReleaseBatch(Batch& batch);
+
+private:
+	UploadBackend* backend;
+	uint64_t batchSize;
+	uint64_t maxInFlightSize;
+
+	Batch openBatch;
+	std::deque<Batch> inFlightBatches;
+	uint64_t inFlightSize = 0;
+
+	uint64_t submittedValue = 0;
+	UploadQueueStatistics statistics;
+};
+
+/// <summary>
+/// Backend without a device, staging memory is plain system memory & submissions complete
+/// whenever 'CompleteUpTo' is called ( or immediately when waited on ).
+/// Used to exercise the batching & retirement logic without D3D12.
+/// </summary>
+class NullUploadBackend : public UploadBackend
+{
+public:
+	StagingBuffer CreateStaging(uint64_t size) override;
+	void ReleaseStaging(StagingBuffer& staging) override;
+
+	void Submit(uint64_t fenceValue) override;
+	uint64_t GetCompletedValue() override;
+	void WaitForValue(uint64_t fenceValue) override;
+
+	void CompleteUpTo(uint64_t fenceValue);
+
+	uint64_t GetSubmittedValue();
+	uint64_t GetLiveStagingSize();
+	unsigned int GetLiveStagingCount();
+
+private:
+	uint64_t submittedValue = 0;
+	uint64_t completedValue = 0;
+
+	uint64_t liveStagingSize = 0;
+	unsigned int liveStagingCount = 0;
+};
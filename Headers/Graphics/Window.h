@@ -21,6 +21,10 @@ public:
 	void Present();
 	void Resize();
 
+	// Presents that can be queued before WaitForFrameLatency blocks //
+	void SetFrameLatency(unsigned int frameLatency);
+	void WaitForFrameLatency();
+
 	unsigned int GetCurrentBackBufferIndex();
 
 	// Render Targets are back buffers used to draw the scene into //
@@ -32,6 +36,7 @@ public:
 	ComPtr<ID3D12Resource> GetCurrentScreenBuffer();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE GetCurrentScreenRTV();
 
+	ComPtr<ID3D12Resource> GetDepthBuffer();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE GetDepthDSV();
 
 	HWND GetHWND();
@@ -51,6 +56,9 @@ private:
 public:
 	static const unsigned int BackBufferCount = 3;
 
+	// Only a hung or removed device takes this long, the frame goes on instead of freezing the window //
+	static const unsigned int FrameLatencyTimeout = 1000; // Milliseconds
+
 	// PLACEHOLDER //
 	// Attempt at using backbuffers as textures //
 
@@ -73,6 +81,7 @@ private:
 
 	// Screen Buffers //
 	ComPtr<IDXGISwapChain4> swapChain;
+	HANDLE frameLatencyWaitable;
 	ComPtr<ID3D12Resource> screenBuffers[BackBufferCount];
 	int screenBufferRTVs[BackBufferCount];
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Helpers shared by the on-disk caches ( models, environments ) //
+
+// Sequential reader over the mapped cache file, every read is bounds checked //
+class CacheReader
+{
+public:
+	CacheReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+	bool Read(void* destination, size_t byteCount)
+	{
+		if(byteCount > size - offset)
+		{
+			return false;
+		}
+
+		memcpy(destination, data + offset, byteCount);
+		offset += byteCount;
+		return true;
+	}
+
+	template<typename T>
+	bool Read(T& value)
+	{
+		return Read(&value, sizeof(T));
+	}
+
+	template<typename T>
+	bool ReadVector(std::vector<T>& values, unsigned long long count)
+	{
+		if(count > (size - offset) / sizeof(T))
+		{
+			return false;
+		}
+
+		values.resize(static_cast<size_t>(count));
+		return Read(values.data(), values.size() * sizeof(T));
+	}
+
+	bool ReadString(std::string& text)
+	{
+		unsigned int length;
+		if(!Read(length) || length > size - offset)
+		{
+			return false;
+		}
+
+		text.assign(reinterpret_cast<const char*>(data + offset), length);
+		offset += length;
+		return true;
+	}
+
+private:
+	const unsigned char* data;
+	size_t size;
+	size_t offset = 0;
+};
+
+template<typename T>
+inline void Write(std::ofstream& file, const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void WriteString(std::ofstream& file, const std::string& text)
+{
+	Write(file, static_cast<unsigned int>(text.size()));
+	file.write(text.data(), text.size());
+}
+
+// Size & modification time, used to quickly check if a source file changed //
+bool GetFileInfo(const std::string& filePath, unsigned long long& size, long long& time);
+
+// Content hash of a file, only needed when the modification time changed //
+bool HashFile(const std::string& filePath, unsigned long long& hash);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+
+// 64-bit FNV-1a, consuming 8 bytes at a time so hashing large files stays cheap.
+// Only meant to detect changes in data, not for anything security related.
+inline unsigned long long HashData(const void* data, size_t size, unsigned long long hash = 14695981039346656037ull)
+{
+	const unsigned long long prime = 1099511628211ull;
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	size_t i = 0;
+	for(; i + 8 <= size; i += 8)
+	{
+		unsigned long long word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ word) * prime;
+	}
+
+	for(; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * prime;
+	}
+
+	return hash;
+}
+
+inline unsigned long long HashString(const std::string& text)
+{
+	return HashData(text.data(), text.size());
+}
@@ -3,11 +3,15 @@
 // Github: https://github.com/WhatevvsDev
 
 #include <string>
+#include <cstdio>
+
+#ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #define VC_EXTRALEAN
 #endif
 #include <Windows.h>
+#endif
 
 #define LOG_IN_RELEASE true
 
@@ -20,10 +24,11 @@ namespace Log
 		Error
 	};
 
+#ifdef _WIN32
 	namespace
 	{
 		// Get Windows Console specific attribute for different text color
-		WORD type_to_color(MessageType aType)
+		unsigned short type_to_color(MessageType aType)
 		{
 			switch(aType)
 			{
@@ -37,15 +42,18 @@ namespace Log
 			}
 		}
 	}
+#endif
 
 	inline void print(MessageType aType, const char* aFile, int aLineNumber, const std::string& aMessage)
 	{
 #if _DEBUG || LOG_IN_RELEASE
+#ifdef _WIN32
 		HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
 
 		// Modify color of text
 		WORD attribute = type_to_color(aType);
 		SetConsoleTextAttribute(handle, attribute);
+#endif
 
 		// Get only file name
 		std::string fileName{ aFile };
@@ -53,7 +61,9 @@ namespace Log
 
 		// Print and reset color
 		printf("[%s: %i] - %s\n", fileName.c_str(), aLineNumber, aMessage.c_str());
+#ifdef _WIN32
 		SetConsoleTextAttribute(handle, 15);
+#endif
 #endif
 	}
 }
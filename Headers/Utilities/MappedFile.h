@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+/// <summary>
+/// Read-only memory mapping of a file. The contents can be read directly through
+/// GetData() without first copying the file into a buffer, the OS pages data in
+/// as it gets accessed. The mapping stays valid for the lifetime of the object.
+/// </summary>
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const std::string& filePath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& filePath);
+	void Close();
+
+	bool IsOpen();
+	const unsigned char* GetData();
+	size_t GetSize();
+
+private:
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
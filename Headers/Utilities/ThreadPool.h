@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+
+/// <summary>
+/// Small worker pool used for CPU heavy work such as model importing.
+/// Work gets submitted as a 'ParallelFor', the calling thread helps out
+/// with the work and only returns once every index has been processed.
+/// This also makes it safe to call ParallelFor from within a job.
+/// </summary>
+class ThreadPool
+{
+public:
+	ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	void ParallelFor(unsigned int count, const std::function<void(unsigned int)>& job);
+
+	unsigned int GetThreadCount();
+
+	// Shared pool, lazily created with a worker for every hardware thread //
+	static ThreadPool& Get();
+
+private:
+	struct Batch
+	{
+		const std::function<void(unsigned int)>* job;
+		unsigned int count;
+
+		std::atomic<unsigned int> nextIndex{ 0 };
+		std::atomic<unsigned int> completed{ 0 };
+	};
+
+	void WorkerLoop();
+	void ProcessBatch(Batch* batch);
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::condition_variable batchFinished;
+	std::deque<std::shared_ptr<Batch>> batches;
+
+	bool shutdown = false;
+};
@@ -0,0 +1,75 @@
+#include "Graphics/ModelImporter.h"
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/SphericalHarmonics.h"
+#include "Graphics/HeapAllocator.h"
+#include "Graphics/FrameGraph.h"
+#include "Graphics/ParallelRecorder.h"
+#include "Graphics/FrustumCuller.h"
+#include "Graphics/BVH.h"
+#include "Graphics/RenderQueue.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Headless benchmarks, built by the portable build so they run without a window or device: //
+// NovaBenchmarks --<name>-benchmark [paths...], run from the repository root so the default assets can be found
+struct Benchmark
+{
+	const char* Flag;
+	void(*Run)(const std::vector<std::string>& paths);
+};
+
+static const Benchmark benchmarks[] =
+{
+	// Geometry decode, vertices/s per attribute, defaults to DamagedHelmet & the Skydome: model0.gltf model1.glb ...
+	{ "--decode-benchmark", ModelImporter::RunBenchmark },
+
+	// Texture compression, PSNR & throughput per format and quality: image0.png image1.jpg ...
+	{ "--compression-benchmark", BlockCompressor::RunBenchmark },
+
+	// Irradiance, SH projection time & error against brute force convolution: environment0.hdr environment1.hdr ...
+	{ "--irradiance-benchmark", SphericalHarmonics::RunBenchmark },
+
+	// Heap allocator, throughput & fragmentation of synthetic buffer & texture workloads
+	{ "--allocator-benchmark", [](const std::vector<std::string>&) { HeapAllocator::RunBenchmark(); } },
+
+	// Frame graph, compile time, culling, barrier batches & aliasing of synthetic graphs
+	{ "--framegraph-benchmark", [](const std::vector<std::string>&) { FrameGraph::RunBenchmark(); } },
+
+	// Command recording, draws/ms against thread count, recorded into mock command lists
+	{ "--recording-benchmark", [](const std::vector<std::string>&) { ParallelRecorder::RunBenchmark(); } },
+
+	// Frustum culling, ns per box & sphere for the scalar, SSE & AVX paths
+	{ "--culling-benchmark", [](const std::vector<std::string>&) { FrustumCuller::RunBenchmark(); } },
+
+	// Scene hierarchy, build, refit & query timings on synthetic scenes of 10k to 1M instances
+	{ "--bvh-benchmark", [](const std::vector<std::string>&) { BVH::RunBenchmark(); } },
+
+	// Draw sorting, radix sort of 100k draw keys against std::sort & the binds it saves
+	{ "--renderqueue-benchmark", [](const std::vector<std::string>&) { RenderQueue::RunBenchmark(); } }
+};
+
+int main(int argc, char* argv[])
+{
+	if(argc > 1)
+	{
+		for(const Benchmark& benchmark : benchmarks)
+		{
+			if(std::string(argv[1]) == benchmark.Flag)
+			{
+				std::vector<std::string> paths(argv + 2, argv + argc);
+				benchmark.Run(paths);
+				return 0;
+			}
+		}
+	}
+
+	printf("Usage: NovaBenchmarks <benchmark> [paths...]\n");
+	for(const Benchmark& benchmark : benchmarks)
+	{
+		printf("  %s\n", benchmark.Flag);
+	}
+
+	return 1;
+}
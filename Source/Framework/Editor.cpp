@@ -5,6 +5,14 @@
 #include "Graphics/Model.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureRegistry.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXMemoryAllocator.h"
+#include "Graphics/DXDescriptorHeap.h"
+#include "Graphics/DXBarrierBatcher.h"
+#include "Graphics/DXFrameScheduler.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/RenderQueue.h"
 
 #include <d3d12.h>
 #include <imgui.h>
@@ -29,6 +37,8 @@ void Editor::Update(float deltaTime)
 
 	HierachyWindow();
 	DetailsWindow();
+
+	ViewportPicking();
 }
 
 void Editor::SetScene(Scene* newScene)
@@ -74,6 +84,70 @@ void Editor::StatisticsWindow()
 	ImGui::SeparatorText("Stats");
 
 	ImGui::Text("FPS: %i", int(1.0f / deltaTime));
+
+	DXFrameScheduler* frameScheduler = DXAccess::GetFrameScheduler();
+	const FrameStatistics& frameStatistics = frameScheduler->GetStatistics();
+	int framesInFlight = frameScheduler->GetFramesInFlight();
+
+	ImGui::SeparatorText("Frames");
+	if(ImGui::SliderInt("Frames in flight", &framesInFlight, 1, DXFrameScheduler::MaxFramesInFlight))
+	{
+		frameScheduler->SetFramesInFlight(framesInFlight);
+	}
+
+	ImGui::Text("Waited: %.2f ms on the GPU - %.2f ms on the swap chain", frameStatistics.FenceWait, frameStatistics.LatencyWait);
+	ImGui::Text("Queued on the GPU: %u frames", frameStatistics.QueuedFrames);
+
+	TextureRegistry* textureRegistry = DXAccess::GetTextureRegistry();
+	const TextureRegistryStatistics& textureStatistics = textureRegistry->GetStatistics();
+
+	ImGui::SeparatorText("Textures");
+	ImGui::Text("Loaded: %u", textureRegistry->GetTextureCount());
+	ImGui::Text("Hits: %u - Misses: %u", textureStatistics.Hits, textureStatistics.Misses);
+	ImGui::Text("Uploaded: %.2f MB", textureStatistics.UploadedBytes / (1024.0 * 1024.0));
+	ImGui::Text("Saved: %.2f MB", textureStatistics.SavedBytes / (1024.0 * 1024.0));
+
+	DXMemoryAllocator* memoryAllocator = DXAccess::GetMemoryAllocator();
+	const char* poolNames[3] = { "Buffers", "Upload", "Textures" };
+	MemoryPool pools[3] = { MemoryPool::Buffers, MemoryPool::Upload, MemoryPool::Textures };
+
+	ImGui::SeparatorText("GPU Memory");
+	for(int i = 0; i < 3; i++)
+	{
+		HeapAllocatorStatistics poolStatistics = memoryAllocator->GetStatistics(pools[i]);
+		ImGui::Text("%s: %u heaps - %.2f / %.2f MB", poolNames[i], poolStatistics.HeapCount,
+			poolStatistics.AllocatedSize / (1024.0 * 1024.0), poolStatistics.ReservedSize / (1024.0 * 1024.0));
+		ImGui::Text("  Allocations: %u - Fragmentation: %.1f%% internal, %.1f%% external", poolStatistics.AllocationCount,
+			poolStatistics.InternalFragmentation * 100.0f, poolStatistics.ExternalFragmentation * 100.0f);
+	}
+
+	ImGui::Text("Committed fallbacks: %u - %.2f MB", memoryAllocator->GetDedicatedCount(),
+		memoryAllocator->GetDedicatedSize() / (1024.0 * 1024.0));
+
+	DescriptorAllocatorStatistics descriptorStatistics =
+		DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)->GetStatistics();
+
+	MaterialTable* materialTable = DXAccess::GetMaterialTable();
+	ImGui::SeparatorText("Materials");
+	ImGui::Text("Unique: %u - Used by %u meshes", materialTable->GetMaterialCount(), materialTable->GetReferenceCount());
+
+	RenderQueueStatistics queueStatistics = DXAccess::GetRenderQueue()->GetStatistics();
+	ImGui::SeparatorText("Draws");
+	ImGui::Text("Scene: %u draws", queueStatistics.Draws);
+	ImGui::Text("Pipelines: %u bound - %u skipped", queueStatistics.PipelineBinds, queueStatistics.PipelinesSkipped);
+	ImGui::Text("Materials: %u bound - %u skipped", queueStatistics.MaterialBinds, queueStatistics.MaterialsSkipped);
+	ImGui::Text("Geometry: %u bound - %u skipped", queueStatistics.GeometryBinds, queueStatistics.GeometrySkipped);
+
+	ImGui::SeparatorText("Descriptors");
+	ImGui::Text("Persistent: %u / %u - %u pending", descriptorStatistics.PersistentAllocated,
+		descriptorStatistics.PersistentCapacity, descriptorStatistics.PendingFrees);
+	ImGui::Text("Free ranges: %u - Largest: %u", descriptorStatistics.FreeRangeCount, descriptorStatistics.LargestFreeRange);
+	ImGui::Text("Transient: %u / %u", descriptorStatistics.TransientAllocated, descriptorStatistics.TransientCapacity);
+
+	BarrierStatistics barrierStatistics = DXAccess::GetBarrierBatcher()->GetStatistics();
+	ImGui::SeparatorText("Barriers");
+	ImGui::Text("Per frame: %u requested - %u recorded in %u calls", barrierStatistics.Requested,
+		barrierStatistics.Recorded, barrierStatistics.Calls);
 	ImGui::End();
 }
 
@@ -86,7 +160,6 @@ void Editor::LightsWindow()
 		if(scene->lights.activePointLights < MAX_AMOUNT_OF_LIGHTS)
 		{
 			scene->lights.activePointLights++;
-			scene->lightsEdited = true;
 		}
 		else
 		{
@@ -103,9 +176,15 @@ void Editor::LightsWindow()
 		std::string name = "Light - " + std::to_string(i);
 		ImGui::SeparatorText(name.c_str());
 
-		if(ImGui::DragFloat3("Position", &pointLight.Position[0], 0.01f)) { scene->lightsEdited = true; }
-		if(ImGui::ColorEdit3("Color", &pointLight.Color[0])) { scene->lightsEdited = true; }
-		if(ImGui::DragFloat("Intensity", &pointLight.Intensity, 0.05f, 0.0f, 1000.0f)) { scene->lightsEdited = true; }
+		// Lights are copied to the GPU every frame, so edits show up right away //
+		ImGui::DragFloat3("Position", &pointLight.Position[0], 0.01f);
+		ImGui::ColorEdit3("Color", &pointLight.Color[0]);
+		ImGui::DragFloat("Intensity", &pointLight.Intensity, 0.05f, 0.0f, 1000.0f);
+
+		// Models within the light's range, found through the scene's hierarchy //
+		litModels.clear();
+		scene->QueryModels({ pointLight.Position, GetPointLightRange(pointLight) }, litModels);
+		ImGui::Text("Range: %.1f, reaches %i model(s)", GetPointLightRange(pointLight), int(litModels.size()));
 
 		ImGui::PopID();
 	}
@@ -198,8 +277,7 @@ void Editor::DetailsWindow()
 			mesh->Material.oChannel = material.oChannel;
 			mesh->Material.rChannel = material.rChannel;
 			mesh->Material.mChannel = material.mChannel;
-
-			mesh->UpdateMaterialData();
+			mesh->UpdateMaterial();
 		}
 	}
 
@@ -217,6 +295,29 @@ void Editor::DetailsWindow()
 	ImGui::End();
 }
 
+void Editor::ViewportPicking()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	if(io.WantCaptureMouse || !ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+	{
+		return;
+	}
+
+	// 1. Cursor to a point on the far plane, the ray goes from the camera through it //
+	Camera& camera = scene->GetCamera();
+	glm::vec2 cursor = glm::vec2(io.MousePos.x / io.DisplaySize.x, io.MousePos.y / io.DisplaySize.y);
+	glm::vec4 farPoint = glm::inverse(camera.GetViewProjectionMatrix()) *
+		glm::vec4(cursor.x * 2.0f - 1.0f, 1.0f - cursor.y * 2.0f, 1.0f, 1.0f);
+
+	glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - camera.Position);
+
+	// 2. Clicking nothing keeps the current selection //
+	if(Model* model = scene->PickModel(camera.Position, direction))
+	{
+		hierachySelectedModel = model;
+	}
+}
+
 void Editor::TextureColumnHighlight(Texture* texture, std::string name)
 {
 	ImGui::Separator();
@@ -243,7 +344,7 @@ void Editor::LoadModelFilePaths(std::string path, std::string originalPath)
 		std::string filePath = file.path().string();
 		std::string fileType = filePath.substr(filePath.find_last_of('.') + 1, filePath.size());
 
-		if(fileType == "gltf")
+		if(fileType == "gltf" || fileType == "glb")
 		{
 			displayNames.push_back(filePath.substr(filePath.find_last_of('\\') + 1));
 			modelFilePaths.push_back(filePath.c_str());
@@ -7,10 +7,18 @@
 #include "Graphics/DXAccess.h"
 #include "Graphics/DXDevice.h"
 #include "Graphics/DXCommands.h"
+#include "Graphics/DXFrameScheduler.h"
+#include "Graphics/DXUploadQueue.h"
+#include "Graphics/DXMemoryAllocator.h"
+#include "Graphics/DXConstantRing.h"
+#include "Graphics/DXBarrierBatcher.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/RenderQueue.h"
 #include "Graphics/DXUtilities.h"
 #include "Graphics/DXDescriptorHeap.h"
 #include "Graphics/DXRootSignature.h"
 #include "Graphics/DXPipeline.h"
+#include "Graphics/DXFrameGraph.h"
 
 // Renderer Components //
 #include "Graphics/Window.h"
@@ -18,6 +26,7 @@
 #include "Graphics/Mesh.h"
 #include "Graphics/Camera.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureRegistry.h"
 #include "Graphics/DepthBuffer.h"
 
 // Render Stages //
@@ -25,7 +34,6 @@
 #include "Graphics/RenderStages/SceneStage.h"
 #include "Graphics/RenderStages/ScreenStage.h"
 #include "Graphics/RenderStages/SkydomeStage.h"
-#include "Graphics/RenderStages/HDRIConvolutionStage.h"
 
 #include <cassert>
 #include <imgui.h>
@@ -39,12 +47,20 @@ namespace RendererInternal
 
 	DXCommands* directCommands = nullptr;
 	DXCommands* copyCommands = nullptr;
+	DXFrameScheduler* frameScheduler = nullptr;
+	DXMemoryAllocator* memoryAllocator = nullptr;
+	DXUploadQueue* uploadQueue = nullptr;
+	DXConstantRing* constantRing = nullptr;
+	DXBarrierBatcher* barrierBatcher = nullptr;
+	MaterialTable* materialTable = nullptr;
+	RenderQueue* renderQueue = nullptr;
 
 	DXDescriptorHeap* CBVHeap = nullptr;
 	DXDescriptorHeap* DSVHeap = nullptr;
 	DXDescriptorHeap* RTVHeap = nullptr;
 
 	Texture* defaultTexture = nullptr;
+	TextureRegistry* textureRegistry = nullptr;
 }
 using namespace RendererInternal;
 
@@ -55,26 +71,54 @@ Renderer::Renderer(const std::wstring& applicationName, Scene* scene, unsigned i
 	SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
 
 	device = new DXDevice();
-	CBVHeap = new DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 5000, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
+	CBVHeap = new DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 5000, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
+		256, DXFrameScheduler::MaxFramesInFlight);
 	DSVHeap = new DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 10);
 	RTVHeap = new DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 15);
 
-	directCommands = new DXCommands(D3D12_COMMAND_LIST_TYPE_DIRECT, Window::BackBufferCount);
-	copyCommands = new DXCommands(D3D12_COMMAND_LIST_TYPE_DIRECT, 1);
+	directCommands = new DXCommands(D3D12_COMMAND_LIST_TYPE_DIRECT, DXFrameScheduler::MaxFramesInFlight);
+	copyCommands = new DXCommands(D3D12_COMMAND_LIST_TYPE_COPY, 1);
+	memoryAllocator = new DXMemoryAllocator();
+	uploadQueue = new DXUploadQueue(copyCommands);
+	constantRing = new DXConstantRing(DXFrameScheduler::MaxFramesInFlight, 1 << 22); // Room for the instance data of both model stages
+	barrierBatcher = new DXBarrierBatcher();
+	materialTable = new MaterialTable();
+	renderQueue = new RenderQueue();
 
 	window = new Window(applicationName, windowWidth, windowHeight);
-	defaultTexture = new Texture("Assets/Textures/error.jpg");
+	frameScheduler = new DXFrameScheduler(directCommands, window, 2);
+	textureRegistry = new TextureRegistry();
+	defaultTexture = textureRegistry->Acquire("Assets/Textures/error.jpg");
 
 	InitializeImGui();
 
+	// Bind general resources & Set pipeline parameters, on every list, since stages can record into several //
+	directCommands->SetListInitializer([](ID3D12GraphicsCommandList2* commandList)
+	{
+		ID3D12DescriptorHeap* heaps[] = { CBVHeap->GetAddress() };
+		commandList->SetDescriptorHeaps(1, heaps);
+		commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	});
+
 	shadowStage = new ShadowStage(window, scene);
 	sceneStage = new SceneStage(window, scene, shadowStage);
 	screenStage = new ScreenStage(window);
 	skydomeStage = new SkydomeStage(window, scene);
-	convolutionStage = new HDRIConvolutionStage(window);
 
-	sceneStage->SetSkydome(skydomeStage->GetSkydomeHandle());
-	convolutionStage->BindHDRI(skydomeStage->GetHDRI());
+	sceneStage->SetEnvironment(skydomeStage->GetHDRI());
+
+	// Window buffers get bound every frame, stages are added in the order they write their resources //
+	frameGraph = new DXFrameGraph();
+	renderBufferResource = frameGraph->ImportResource("RenderBuffer", nullptr, ResourceUsage::ShaderResource);
+	screenBufferResource = frameGraph->ImportResource("ScreenBuffer", nullptr, ResourceUsage::Present);
+	depthBufferResource = frameGraph->ImportResource("DepthBuffer", nullptr, ResourceUsage::DepthWrite);
+	frameGraph->ExportResource(screenBufferResource);
+
+	frameGraph->AddStage("Shadow", shadowStage);
+	frameGraph->AddStage("Scene", sceneStage);
+	frameGraph->AddStage("Skydome", skydomeStage);
+	frameGraph->AddStage("Screen", screenStage);
+	frameGraph->Compile();
 
 	// TODO: Move to scene
 	//this->scene->AddModel("Assets/Models/GroundPlane\\plane.gltf");
@@ -90,29 +134,30 @@ void Renderer::Update(float deltaTime)
 
 void Renderer::Render()
 {
-	// 0. Grab all relevant objects to perform all stages //
-	unsigned int backBufferIndex = window->GetCurrentBackBufferIndex();
-	ComPtr<ID3D12GraphicsCommandList2> commandList = directCommands->GetGraphicsCommandList();
-	ID3D12DescriptorHeap* heaps[] = { CBVHeap->GetAddress() };
-
-	// 1. Reset & prepare command allocator //
-	directCommands->ResetCommandList(backBufferIndex);
-
-	// 2. Bind general resources & Set pipeline parameters //
-	commandList->SetDescriptorHeaps(1, heaps);
-	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-	// 3. Record Render Stages //
-	convolutionStage->RecordStage(commandList);
-	shadowStage->RecordStage(commandList);
-	sceneStage->RecordStage(commandList);
-	skydomeStage->RecordStage(commandList);
-	screenStage->RecordStage(commandList);
-
-	// 4. Execute List, Present and wait for the next frame to be ready //
-	directCommands->ExecuteCommandList(backBufferIndex);
+	// 0. Wait until this frame fits in the latency budget, the GPU can still be working on the previous ones //
+	unsigned int frameIndex = frameScheduler->BeginFrame();
+
+	// 1. Reset & prepare command allocators, the GPU is done with this frame's constants & descriptors as well //
+	directCommands->ResetCommandList(frameIndex);
+	constantRing->BeginFrame(frameIndex);
+	CBVHeap->BeginFrame(frameIndex);
+	barrierBatcher->ResetStatistics();
+
+	// 2. Submit uploads queued since the last frame, the direct queue waits for them on the GPU.
+	// Their transitions get flushed together with the ones before the first stage //
+	uploadQueue->Synchronize(directCommands->GetCommandQueue().Get(), *barrierBatcher);
+
+	// 3. Record Render Stages, in the order of the frame graph, with this frame's window buffers.
+	// Stages can record in parallel, every list of the frame executes in order with a single call //
+	frameGraph->SetResource(renderBufferResource, window->GetCurrentRenderBuffer().Get());
+	frameGraph->SetResource(screenBufferResource, window->GetCurrentScreenBuffer().Get());
+	frameGraph->SetResource(depthBufferResource, window->GetDepthBuffer().Get());
+	frameGraph->Execute(directCommands);
+
+	// 4. Execute List & Present, the next frame only waits for the GPU once it needs this frame's slot //
+	directCommands->ExecuteCommandList(frameIndex);
 	window->Present();
-	directCommands->WaitForFenceValue(window->GetCurrentBackBufferIndex());
+	frameScheduler->EndFrame();
 }
 
 void Renderer::SetScene(Scene* newScene)
@@ -138,7 +183,7 @@ void Renderer::InitializeImGui()
 	ImGui_ImplWin32_Init(window->GetHWND());
 
 	const unsigned int cbvIndex = CBVHeap->GetNextAvailableIndex();
-	ImGui_ImplDX12_Init(device->GetAddress(), Window::BackBufferCount, DXGI_FORMAT_R8G8B8A8_UNORM,
+	ImGui_ImplDX12_Init(device->GetAddress(), DXFrameScheduler::MaxFramesInFlight, DXGI_FORMAT_R8G8B8A8_UNORM,
 		CBVHeap->GetAddress(), CBVHeap->GetCPUHandleAt(cbvIndex), CBVHeap->GetGPUHandleAt(cbvIndex));
 }
 
@@ -175,6 +220,76 @@ DXCommands* DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE type)
 	return nullptr;
 }
 
+DXUploadQueue* DXAccess::GetUploadQueue()
+{
+	if(!uploadQueue)
+	{
+		assert(false && "Upload queue hasn't been initialized yet, call will return nullptr");
+	}
+
+	return uploadQueue;
+}
+
+DXMemoryAllocator* DXAccess::GetMemoryAllocator()
+{
+	if(!memoryAllocator)
+	{
+		assert(false && "Memory allocator hasn't been initialized yet, call will return nullptr");
+	}
+
+	return memoryAllocator;
+}
+
+DXConstantRing* DXAccess::GetConstantRing()
+{
+	if(!constantRing)
+	{
+		assert(false && "Constant ring hasn't been initialized yet, call will return nullptr");
+	}
+
+	return constantRing;
+}
+
+DXBarrierBatcher* DXAccess::GetBarrierBatcher()
+{
+	if(!barrierBatcher)
+	{
+		assert(false && "Barrier batcher hasn't been initialized yet, call will return nullptr");
+	}
+
+	return barrierBatcher;
+}
+
+DXFrameScheduler* DXAccess::GetFrameScheduler()
+{
+	if(!frameScheduler)
+	{
+		assert(false && "Frame scheduler hasn't been initialized yet, call will return nullptr");
+	}
+
+	return frameScheduler;
+}
+
+MaterialTable* DXAccess::GetMaterialTable()
+{
+	if(!materialTable)
+	{
+		assert(false && "Material table hasn't been initialized yet, call will return nullptr");
+	}
+
+	return materialTable;
+}
+
+RenderQueue* DXAccess::GetRenderQueue()
+{
+	if(!renderQueue)
+	{
+		assert(false && "Render queue hasn't been initialized yet, call will return nullptr");
+	}
+
+	return renderQueue;
+}
+
 unsigned int DXAccess::GetCurrentBackBufferIndex()
 {
 	if(!window)
@@ -185,6 +300,16 @@ unsigned int DXAccess::GetCurrentBackBufferIndex()
 	return window->GetCurrentBackBufferIndex();
 }
 
+unsigned int DXAccess::GetCurrentFrameIndex()
+{
+	if(!frameScheduler)
+	{
+		assert(false && "Frame scheduler hasn't been initialized yet, can't retrieve frame index");
+	}
+
+	return frameScheduler->GetFrameIndex();
+}
+
 Texture* DXAccess::GetDefaultTexture()
 {
 	// Incase an texture isn't present, the 'default' texture gets loaded in
@@ -218,4 +343,14 @@ Window* DXAccess::GetWindow()
 {
 	return window;
 }
+
+TextureRegistry* DXAccess::GetTextureRegistry()
+{
+	if(!textureRegistry)
+	{
+		assert(false && "TextureRegistry hasn't been initialized yet, call will return nullptr");
+	}
+
+	return textureRegistry;
+}
 #pragma endregion
\ No newline at end of file
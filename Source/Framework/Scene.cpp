@@ -2,16 +2,25 @@
 
 #include "Graphics/Camera.h"
 #include "Graphics/Model.h"
-#include "Graphics/DXDescriptorHeap.h"
-#include "Graphics/DXUtilities.h"
+#include "Graphics/Mesh.h"
+
+#include "Utilities/ThreadPool.h"
 
 Scene::Scene(unsigned int windowWidth, unsigned int windowHeight)
 {
 	camera = new Camera(windowWidth, windowHeight);
+}
+
+Scene::~Scene()
+{
+	for(Model* model : models)
+	{
+		delete model;
+	}
 
-	// Makes sure that lights get updated 
-	// AFTER the renderer has fully initialized
-	lightsEdited = true;
+	// The assets go last, with the meshes every model was drawing //
+	assets.clear();
+	delete camera;
 }
 
 void Scene::Update(float deltaTime)
@@ -19,18 +28,125 @@ void Scene::Update(float deltaTime)
 	sceneRuntime += deltaTime;
 
 	camera->Update(deltaTime);
+	UpdateHierarchy();
+}
 
-	// In case the lights have been edited, update lightBuffer
-	if(lightsEdited)
+bool Scene::AddModel(const std::string& filePath)
+{
+	// Files that are already loaded get placed again, sharing meshes, textures & materials so they're drawn instanced //
+	Model* model = nullptr;
+	for(const std::shared_ptr<ModelAsset>& asset : assets)
 	{
-		UpdateLightBuffer();
-		lightsEdited = false;
+		if(asset->FilePath == filePath)
+		{
+			model = new Model(asset);
+			break;
+		}
 	}
+
+	if(!model)
+	{
+		model = new Model(filePath);
+
+		// The importer already reported why, the scene stays as it was //
+		if(!model->IsLoaded())
+		{
+			delete model;
+			return false;
+		}
+
+		assets.push_back(model->GetAsset());
+	}
+
+	models.push_back(model);
+	rebuildHierarchy = true;
+	return true;
 }
 
-void Scene::AddModel(const std::string& filePath)
+void Scene::UpdateHierarchy()
 {
-	models.push_back(new Model(filePath));
+	// Refits loosen the tree, past this much of its original cost a rebuild pays for itself //
+	const float rebuildCostRatio = 1.5f;
+
+	if(rebuildHierarchy)
+	{
+		std::vector<BoundingBox> bounds(models.size());
+		fittedTransforms.resize(models.size() * 3);
+
+		for(unsigned int i = 0; i < models.size(); i++)
+		{
+			const Transform& transform = models[i]->Transform;
+			fittedTransforms[i * 3] = transform.Position;
+			fittedTransforms[i * 3 + 1] = transform.Rotation;
+			fittedTransforms[i * 3 + 2] = transform.Scale;
+			bounds[i] = GetWorldBounds(i);
+		}
+
+		hierarchy.Build(bounds, &ThreadPool::Get());
+		rebuildHierarchy = false;
+		return;
+	}
+
+	// Only models whose transform changed get refit, along with the nodes above them //
+	bool moved = false;
+
+	for(unsigned int i = 0; i < models.size(); i++)
+	{
+		const Transform& transform = models[i]->Transform;
+		glm::vec3* fitted = &fittedTransforms[i * 3];
+
+		if(fitted[0] != transform.Position || fitted[1] != transform.Rotation || fitted[2] != transform.Scale)
+		{
+			fitted[0] = transform.Position;
+			fitted[1] = transform.Rotation;
+			fitted[2] = transform.Scale;
+
+			hierarchy.UpdateItem(i, GetWorldBounds(i));
+			moved = true;
+		}
+	}
+
+	if(moved)
+	{
+		hierarchy.Refit();
+
+		if(hierarchy.GetCost() > hierarchy.GetBuildCost() * rebuildCostRatio)
+		{
+			hierarchy.Rebuild(&ThreadPool::Get());
+		}
+	}
+}
+
+Model* Scene::PickModel(const glm::vec3& origin, const glm::vec3& direction)
+{
+	glm::vec3 inverseDirection = 1.0f / direction;
+
+	// The model's box only tells the ray gets close, the first mesh box it enters is the actual hit //
+	RayHit hit = hierarchy.Raycast(origin, direction, FLT_MAX, [&](unsigned int modelIndex, float& distance)
+	{
+		Model* model = models[modelIndex];
+		const glm::mat4& modelMatrix = model->Transform.GetModelMatrix();
+		float closest = FLT_MAX;
+
+		for(Mesh* mesh : model->GetMeshes())
+		{
+			float meshDistance;
+			if(IntersectRay(TransformBoundingBox(mesh->GetBounds(), modelMatrix), origin, inverseDirection, closest, meshDistance))
+			{
+				closest = meshDistance;
+			}
+		}
+
+		distance = closest;
+		return closest < FLT_MAX;
+	});
+
+	return hit.Item < models.size() ? models[hit.Item] : nullptr;
+}
+
+void Scene::QueryModels(const BoundingSphere& sphere, std::vector<unsigned int>& modelIndices)
+{
+	hierarchy.QuerySphere(sphere, modelIndices);
 }
 
 Camera& Scene::GetCamera()
@@ -43,19 +159,18 @@ const std::vector<Model*>& Scene::GetModels()
 	return models;
 }
 
-CD3DX12_GPU_DESCRIPTOR_HANDLE Scene::GetLightBufferHandle()
+const LightData& Scene::GetLightData()
 {
-	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	return CBVHeap->GetGPUHandleAt(lightCBVIndex);
+	return lights;
 }
 
-void Scene::UpdateLightBuffer()
+BVH& Scene::GetHierarchy()
 {
-	if(lightCBVIndex < 0)
-	{
-		DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		lightCBVIndex = CBVHeap->GetNextAvailableIndex();
-	}
-
-	UpdateInFlightCBV(lightBuffer, lightCBVIndex, 1, sizeof(LightData), &lights);
+	return hierarchy;
 }
+
+BoundingBox Scene::GetWorldBounds(unsigned int modelIndex)
+{
+	Model* model = models[modelIndex];
+	return TransformBoundingBox(model->GetBounds(), model->Transform.GetModelMatrix());
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Graphics/AccessorDecoder.h"
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <tiny_gltf.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVA_SSE_DEQUANTIZE
+#include <emmintrin.h>
+#endif
+
+// Scalar conversion, following the glTF spec for normalized integers //
+template<typename Component, bool Normalized>
+static inline float Dequantize(Component value)
+{
+	if constexpr(std::is_same<Component, float>::value || !Normalized)
+	{
+		return static_cast<float>(value);
+	}
+	else if constexpr(std::is_signed<Component>::value)
+	{
+		float result = static_cast<float>(value) / static_cast<float>(std::numeric_limits<Component>::max());
+		return result < -1.0f ? -1.0f : result;
+	}
+	else
+	{
+		return static_cast<float>(value) / static_cast<float>(std::numeric_limits<Component>::max());
+	}
+}
+
+template<typename Component, bool Normalized, unsigned int Components>
+static void GatherFloats(const AccessorView& accessor, unsigned char* destination, size_t destinationStride)
+{
+	const unsigned char* source = accessor.Data;
+	const size_t sourceStride = accessor.Stride;
+
+	if constexpr(std::is_same<Component, float>::value)
+	{
+		// Already in the right format, only the layout differs //
+		for(size_t i = 0; i < accessor.Count; i++)
+		{
+			memcpy(destination + i * destinationStride, source + i * sourceStride, sizeof(float) * Components);
+		}
+	}
+#ifdef NOVA_SSE_DEQUANTIZE
+	else if constexpr(sizeof(Component) <= 2)
+	{
+		// 8 & 16 bit components all fit in an int32 lane, so the whole
+		// element gets converted, scaled & clamped in one go
+		const float scale = Normalized ? 1.0f / static_cast<float>(std::numeric_limits<Component>::max()) : 1.0f;
+		const __m128 scaleVector = _mm_set1_ps(scale);
+		const __m128 minimumVector = _mm_set1_ps(-1.0f);
+
+		for(size_t i = 0; i < accessor.Count; i++)
+		{
+			const unsigned char* element = source + i * sourceStride;
+
+			alignas(16) int values[4] = { 0, 0, 0, 0 };
+			for(unsigned int c = 0; c < Components; c++)
+			{
+				Component value;
+				memcpy(&value, element + c * sizeof(Component), sizeof(Component));
+				values[c] = value;
+			}
+
+			__m128 result = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(values)));
+			result = _mm_mul_ps(result, scaleVector);
+
+			if constexpr(Normalized && std::is_signed<Component>::value)
+			{
+				result = _mm_max_ps(result, minimumVector);
+			}
+
+			alignas(16) float output[4];
+			_mm_store_ps(output, result);
+			memcpy(destination + i * destinationStride, output, sizeof(float) * Components);
+		}
+	}
+#endif
+	else
+	{
+		for(size_t i = 0; i < accessor.Count; i++)
+		{
+			const unsigned char* element = source + i * sourceStride;
+			float output[Components];
+
+			for(unsigned int c = 0; c < Components; c++)
+			{
+				Component value;
+				memcpy(&value, element + c * sizeof(Component), sizeof(Component));
+				output[c] = Dequantize<Component, Normalized>(value);
+			}
+
+			memcpy(destination + i * destinationStride, output, sizeof(float) * Components);
+		}
+	}
+}
+
+template<typename Component, bool Normalized>
+static bool DispatchComponents(const AccessorView& accessor, unsigned char* destination,
+	size_t destinationStride, unsigned int components)
+{
+	switch(components)
+	{
+	case 1: GatherFloats<Component, Normalized, 1>(accessor, destination, destinationStride); return true;
+	case 2: GatherFloats<Component, Normalized, 2>(accessor, destination, destinationStride); return true;
+	case 3: GatherFloats<Component, Normalized, 3>(accessor, destination, destinationStride); return true;
+	case 4: GatherFloats<Component, Normalized, 4>(accessor, destination, destinationStride); return true;
+	}
+
+	return false;
+}
+
+template<typename Component>
+static bool DispatchNormalized(const AccessorView& accessor, unsigned char* destination,
+	size_t destinationStride, unsigned int components)
+{
+	if(accessor.Normalized)
+	{
+		return DispatchComponents<Component, true>(accessor, destination, destinationStride, components);
+	}
+
+	return DispatchComponents<Component, false>(accessor, destination, destinationStride, components);
+}
+
+template<typename Component>
+static void GatherIndices(const AccessorView& accessor, unsigned int* destination)
+{
+	for(size_t i = 0; i < accessor.Count; i++)
+	{
+		Component index;
+		memcpy(&index, accessor.Data + i * accessor.Stride, sizeof(Component));
+		destination[i] = static_cast<unsigned int>(index);
+	}
+}
+
+bool AccessorDecoder::DecodeFloats(const AccessorView& accessor, unsigned char* destination,
+	size_t destinationStride, unsigned int destinationComponents)
+{
+	// Only copy what fits, for example a VEC4 tangent into a vec3 //
+	unsigned int components = accessor.ComponentCount < destinationComponents ? accessor.ComponentCount : destinationComponents;
+
+	switch(accessor.ComponentType)
+	{
+	case TINYGLTF_COMPONENT_TYPE_FLOAT:
+		return DispatchNormalized<float>(accessor, destination, destinationStride, components);
+	case TINYGLTF_COMPONENT_TYPE_BYTE:
+		return DispatchNormalized<signed char>(accessor, destination, destinationStride, components);
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		return DispatchNormalized<unsigned char>(accessor, destination, destinationStride, components);
+	case TINYGLTF_COMPONENT_TYPE_SHORT:
+		return DispatchNormalized<short>(accessor, destination, destinationStride, components);
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		return DispatchNormalized<unsigned short>(accessor, destination, destinationStride, components);
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+		return DispatchNormalized<unsigned int>(accessor, destination, destinationStride, components);
+	}
+
+	return false;
+}
+
+bool AccessorDecoder::DecodeIndices(const AccessorView& accessor, unsigned int* destination)
+{
+	switch(accessor.ComponentType)
+	{
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		GatherIndices<unsigned char>(accessor, destination);
+		return true;
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		GatherIndices<unsigned short>(accessor, destination);
+		return true;
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+		GatherIndices<unsigned int>(accessor, destination);
+		return true;
+	}
+
+	return false;
+}
+
+bool AccessorDecoder::ApplySparseFloats(const AccessorView& indices, const AccessorView& values, unsigned char* destination,
+	size_t destinationStride, unsigned int destinationComponents, size_t elementCount)
+{
+	if(indices.Count != values.Count)
+	{
+		return false;
+	}
+
+	std::vector<unsigned int> sparseIndices(indices.Count);
+	if(!DecodeIndices(indices, sparseIndices.data()))
+	{
+		return false;
+	}
+
+	// Decode the values tightly packed first, afterwards scatter them to their elements //
+	const size_t elementSize = sizeof(float) * destinationComponents;
+	std::vector<unsigned char> sparseValues(values.Count * elementSize);
+	if(!DecodeFloats(values, sparseValues.data(), elementSize, destinationComponents))
+	{
+		return false;
+	}
+
+	unsigned int components = values.ComponentCount < destinationComponents ? values.ComponentCount : destinationComponents;
+	for(size_t i = 0; i < sparseIndices.size(); i++)
+	{
+		if(sparseIndices[i] >= elementCount)
+		{
+			return false;
+		}
+
+		memcpy(destination + sparseIndices[i] * destinationStride, sparseValues.data() + i * elementSize, sizeof(float) * components);
+	}
+
+	return true;
+}
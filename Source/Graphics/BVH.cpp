@@ -0,0 +1,901 @@
+#include "Graphics/BVH.h"
+
+#include "Utilities/Logger.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace
+{
+	const unsigned int BinCount = 12;
+	const unsigned int MaxSAHDepth = 48; // Deeper than this, splits go through the median so the depth stays bounded
+	const unsigned int ParallelBuildSize = 8192; // Smaller subtrees get built by the thread that split them off
+	const unsigned int StackSize = 128;
+	const unsigned int InvalidNode = ~0u;
+
+	const float TraversalCost = 1.0f;
+	const float IntersectionCost = 1.0f;
+
+	// Going through every node once is cheaper than walking up from this many dirty leaves, 1 in 'x' nodes //
+	const unsigned int RefitSweepRatio = 16;
+
+	unsigned int GetBin(float value, float minimum, float scale)
+	{
+		return std::min(static_cast<unsigned int>((value - minimum) * scale), BinCount - 1);
+	}
+
+	glm::vec3 GetCentroid(const BVH::BuildItem& item)
+	{
+		return (item.Min + item.Max) * 0.5f;
+	}
+
+	BoundingBox GetNodeBounds(const BVHNode& node)
+	{
+		return BoundingBox{ node.Min, node.Max };
+	}
+
+	// Same test as the FrustumCuller, planes the box is completely in front of get cleared from 'planes' //
+	bool ClassifyBox(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max, unsigned int& planes)
+	{
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extents = (max - min) * 0.5f;
+
+		for(unsigned int i = 0; i < 6; i++)
+		{
+			if(!(planes & (1u << i)))
+			{
+				continue;
+			}
+
+			const glm::vec4& plane = frustum.Planes[i];
+			float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+			float radius = fabsf(plane.x) * extents.x + fabsf(plane.y) * extents.y + fabsf(plane.z) * extents.z;
+
+			if(distance + radius < 0.0f)
+			{
+				return false;
+			}
+
+			if(distance - radius >= 0.0f)
+			{
+				planes &= ~(1u << i);
+			}
+		}
+
+		return true;
+	}
+}
+
+#pragma region Build
+void BVH::Build(const std::vector<BoundingBox>& boxes, ThreadPool* threadPool)
+{
+	itemBounds = boxes;
+	Rebuild(threadPool);
+}
+
+void BVH::Rebuild(ThreadPool* threadPool)
+{
+	unsigned int itemCount = static_cast<unsigned int>(itemBounds.size());
+
+	buildItems.resize(itemCount);
+	itemIndices.resize(itemCount);
+	itemLeaves.assign(itemCount, 0);
+
+	for(unsigned int i = 0; i < itemCount; i++)
+	{
+		buildItems[i] = { itemBounds[i].Min, i, itemBounds[i].Max, 0.0f };
+	}
+
+	nodePairs.clear();
+	nodeCount = 0;
+	parents.clear();
+	dirtyLeaves.clear();
+	dirtyFlags.clear();
+	buildCost = 0.0f;
+
+	if(itemCount == 0)
+	{
+		return;
+	}
+
+	// A subtree over 'n' items never needs more than 2( n - 1 ) nodes below its root, so every subtree
+	// reserves that much of the scratch space up front and both halves can be built at the same time //
+	buildNodes.resize(2 * itemCount - 1);
+	BuildNode(0, 0, itemCount, 1, 0, threadPool);
+
+	for(unsigned int i = 0; i < itemCount; i++)
+	{
+		itemIndices[i] = buildItems[i].Item;
+	}
+
+	Compact();
+	buildCost = GetCost();
+}
+
+void BVH::BuildNode(unsigned int nodeIndex, unsigned int first, unsigned int count, unsigned int rangeStart,
+	unsigned int depth, ThreadPool* threadPool)
+{
+	BVHNode& node = buildNodes[nodeIndex];
+	BoundingBox centroidBounds;
+
+	node.Min = glm::vec3(FLT_MAX);
+	node.Max = glm::vec3(-FLT_MAX);
+
+	for(unsigned int i = first; i < first + count; i++)
+	{
+		const BuildItem& item = buildItems[i];
+		glm::vec3 centroid = GetCentroid(item);
+
+		node.Min = glm::min(node.Min, item.Min);
+		node.Max = glm::max(node.Max, item.Max);
+		centroidBounds.Min = glm::min(centroidBounds.Min, centroid);
+		centroidBounds.Max = glm::max(centroidBounds.Max, centroid);
+	}
+
+	if(count <= MaxLeafSize)
+	{
+		node.LeftFirst = first;
+		node.Count = count;
+		return;
+	}
+
+	// 1. Split where the surface area heuristic is lowest, through the median of the widest axis if that doesn't separate anything //
+	BuildItem* items = buildItems.data() + first;
+	unsigned int leftCount = 0;
+	int axis = 0;
+	unsigned int bin = 0;
+
+	if(depth < MaxSAHDepth && FindSplit(centroidBounds, first, count, axis, bin))
+	{
+		float minimum = centroidBounds.Min[axis];
+		float scale = BinCount / (centroidBounds.Max[axis] - minimum);
+
+		BuildItem* middle = std::partition(items, items + count, [&](const BuildItem& item)
+		{
+			return GetBin(GetCentroid(item)[axis], minimum, scale) < bin;
+		});
+
+		leftCount = static_cast<unsigned int>(middle - items);
+	}
+
+	if(leftCount == 0 || leftCount == count)
+	{
+		glm::vec3 extents = centroidBounds.Max - centroidBounds.Min;
+		axis = extents.x > extents.y ? (extents.x > extents.z ? 0 : 2) : (extents.y > extents.z ? 1 : 2);
+		leftCount = count / 2;
+
+		std::nth_element(items, items + leftCount, items + count, [&](const BuildItem& a, const BuildItem& b)
+		{
+			return GetCentroid(a)[axis] < GetCentroid(b)[axis];
+		});
+	}
+
+	// 2. Children take the first two nodes of the range, the rest is split between their subtrees //
+	unsigned int rightCount = count - leftCount;
+	unsigned int leftRange = rangeStart + 2;
+	unsigned int rightRange = leftRange + 2 * (leftCount - 1);
+
+	node.LeftFirst = rangeStart;
+	node.Count = 0;
+
+	auto buildChild = [&](unsigned int child)
+	{
+		if(child == 0)
+		{
+			BuildNode(rangeStart, first, leftCount, leftRange, depth + 1, threadPool);
+		}
+		else
+		{
+			BuildNode(rangeStart + 1, first + leftCount, rightCount, rightRange, depth + 1, threadPool);
+		}
+	};
+
+	if(threadPool && count >= ParallelBuildSize)
+	{
+		threadPool->ParallelFor(2, buildChild);
+	}
+	else
+	{
+		buildChild(0);
+		buildChild(1);
+	}
+}
+
+bool BVH::FindSplit(const BoundingBox& centroidBounds, unsigned int first, unsigned int count, int& axis, unsigned int& bin)
+{
+	// 1. Sort the items into bins along every axis in a single pass over them //
+	BoundingBox bins[3][BinCount];
+	unsigned int binCounts[3][BinCount] = {};
+
+	glm::vec3 minimum = centroidBounds.Min;
+	glm::vec3 extents = centroidBounds.Max - centroidBounds.Min;
+	glm::vec3 scale = glm::vec3(BinCount) / glm::max(extents, glm::vec3(FLT_MIN));
+
+	for(unsigned int i = first; i < first + count; i++)
+	{
+		const BuildItem& item = buildItems[i];
+		glm::vec3 centroid = GetCentroid(item);
+
+		for(int a = 0; a < 3; a++)
+		{
+			unsigned int b = GetBin(centroid[a], minimum[a], scale[a]);
+			bins[a][b].Min = glm::min(bins[a][b].Min, item.Min);
+			bins[a][b].Max = glm::max(bins[a][b].Max, item.Max);
+			binCounts[a][b]++;
+		}
+	}
+
+	// 2. Sweep from the right for the area past every plane, then from the left to evaluate them //
+	float bestCost = FLT_MAX;
+
+	for(int a = 0; a < 3; a++)
+	{
+		if(extents[a] <= 0.0f)
+		{
+			continue;
+		}
+
+		float rightAreas[BinCount];
+		unsigned int rightCounts[BinCount];
+		BoundingBox right;
+		unsigned int rightCount = 0;
+
+		for(unsigned int b = BinCount - 1; b > 0; b--)
+		{
+			right.Min = glm::min(right.Min, bins[a][b].Min);
+			right.Max = glm::max(right.Max, bins[a][b].Max);
+			rightCount += binCounts[a][b];
+			rightAreas[b] = GetSurfaceArea(right);
+			rightCounts[b] = rightCount;
+		}
+
+		BoundingBox left;
+		unsigned int leftCount = 0;
+
+		for(unsigned int b = 1; b < BinCount; b++)
+		{
+			left.Min = glm::min(left.Min, bins[a][b - 1].Min);
+			left.Max = glm::max(left.Max, bins[a][b - 1].Max);
+			leftCount += binCounts[a][b - 1];
+
+			if(leftCount == 0 || rightCounts[b] == 0)
+			{
+				continue;
+			}
+
+			float cost = GetSurfaceArea(left) * leftCount + rightAreas[b] * rightCounts[b];
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				axis = a;
+				bin = b;
+			}
+		}
+	}
+
+	return bestCost < FLT_MAX;
+}
+
+void BVH::Compact()
+{
+	// Depth first, so a subtree mostly lives in one stretch of memory. Node 1 is padding, siblings start at even indices //
+	unsigned int itemCount = static_cast<unsigned int>(itemBounds.size());
+	nodePairs.resize(itemCount);
+	parents.assign(itemCount * 2, InvalidNode);
+
+	BVHNode* nodes = GetNodes();
+	nodes[1] = BVHNode{ glm::vec3(FLT_MAX), 0, glm::vec3(-FLT_MAX), 0 };
+	nodeCount = 2;
+
+	std::vector<std::pair<unsigned int, unsigned int>> stack;
+	stack.push_back({ 0, 0 });
+
+	while(!stack.empty())
+	{
+		unsigned int buildIndex = stack.back().first;
+		unsigned int nodeIndex = stack.back().second;
+		stack.pop_back();
+
+		BVHNode& node = nodes[nodeIndex];
+		node = buildNodes[buildIndex];
+
+		if(node.Count > 0)
+		{
+			for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				itemLeaves[itemIndices[i]] = nodeIndex;
+			}
+
+			continue;
+		}
+
+		unsigned int pair = nodeCount;
+		nodeCount += 2;
+
+		parents[pair] = nodeIndex;
+		parents[pair + 1] = nodeIndex;
+
+		stack.push_back({ node.LeftFirst + 1, pair + 1 });
+		stack.push_back({ node.LeftFirst, pair });
+		node.LeftFirst = pair;
+	}
+
+	nodePairs.resize(nodeCount / 2);
+	parents.resize(nodeCount);
+	dirtyFlags.assign(nodeCount, 0);
+}
+#pragma endregion
+
+#pragma region Refit
+void BVH::UpdateItem(unsigned int item, const BoundingBox& box)
+{
+	itemBounds[item] = box;
+
+	unsigned int leaf = itemLeaves[item];
+	if(!dirtyFlags[leaf])
+	{
+		dirtyFlags[leaf] = 1;
+		dirtyLeaves.push_back(leaf);
+	}
+}
+
+void BVH::Refit()
+{
+	if(dirtyLeaves.empty())
+	{
+		return;
+	}
+
+	BVHNode* nodes = GetNodes();
+
+	if(dirtyLeaves.size() * RefitSweepRatio > nodeCount)
+	{
+		// Children always come after their parent, so going backwards has them done first //
+		for(unsigned int i = nodeCount; i-- > 0;)
+		{
+			if(i != 1)
+			{
+				RefitNode(i);
+			}
+		}
+	}
+	else
+	{
+		// Stops once a node doesn't change, its parents then already contain it //
+		for(unsigned int leaf : dirtyLeaves)
+		{
+			unsigned int nodeIndex = leaf;
+
+			while(nodeIndex != InvalidNode)
+			{
+				glm::vec3 min = nodes[nodeIndex].Min;
+				glm::vec3 max = nodes[nodeIndex].Max;
+				RefitNode(nodeIndex);
+
+				if(nodeIndex != leaf && min == nodes[nodeIndex].Min && max == nodes[nodeIndex].Max)
+				{
+					break;
+				}
+
+				nodeIndex = parents[nodeIndex];
+			}
+		}
+	}
+
+	for(unsigned int leaf : dirtyLeaves)
+	{
+		dirtyFlags[leaf] = 0;
+	}
+
+	dirtyLeaves.clear();
+}
+
+void BVH::RefitNode(unsigned int nodeIndex)
+{
+	BVHNode* nodes = GetNodes();
+	BVHNode& node = nodes[nodeIndex];
+
+	if(node.Count > 0)
+	{
+		node.Min = glm::vec3(FLT_MAX);
+		node.Max = glm::vec3(-FLT_MAX);
+
+		for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+		{
+			node.Min = glm::min(node.Min, itemBounds[itemIndices[i]].Min);
+			node.Max = glm::max(node.Max, itemBounds[itemIndices[i]].Max);
+		}
+	}
+	else
+	{
+		const BVHNode& left = nodes[node.LeftFirst];
+		const BVHNode& right = nodes[node.LeftFirst + 1];
+
+		node.Min = glm::min(left.Min, right.Min);
+		node.Max = glm::max(left.Max, right.Max);
+	}
+}
+#pragma endregion
+
+#pragma region Queries
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& items)
+{
+	if(nodeCount == 0)
+	{
+		return;
+	}
+
+	BVHNode* nodes = GetNodes();
+
+	// Planes a node is completely in front of don't need testing for anything below it, once none are left the whole subtree is in //
+	struct Entry
+	{
+		unsigned int Node;
+		unsigned int Planes;
+	};
+
+	Entry stack[StackSize];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = { 0, 0x3F };
+
+	while(stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		const BVHNode& node = nodes[entry.Node];
+
+		if(!ClassifyBox(frustum, node.Min, node.Max, entry.Planes))
+		{
+			continue;
+		}
+
+		if(entry.Planes == 0)
+		{
+			AddSubtree(entry.Node, items);
+			continue;
+		}
+
+		if(node.Count > 0)
+		{
+			for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				unsigned int planes = entry.Planes;
+				const BoundingBox& box = itemBounds[itemIndices[i]];
+
+				if(ClassifyBox(frustum, box.Min, box.Max, planes))
+				{
+					items.push_back(itemIndices[i]);
+				}
+			}
+
+			continue;
+		}
+
+		stack[stackSize++] = { node.LeftFirst + 1, entry.Planes };
+		stack[stackSize++] = { node.LeftFirst, entry.Planes };
+	}
+}
+
+void BVH::QueryBox(const BoundingBox& box, std::vector<unsigned int>& items)
+{
+	if(nodeCount == 0)
+	{
+		return;
+	}
+
+	BVHNode* nodes = GetNodes();
+	unsigned int stack[StackSize];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize > 0)
+	{
+		const BVHNode& node = nodes[stack[--stackSize]];
+		if(!Overlaps(GetNodeBounds(node), box))
+		{
+			continue;
+		}
+
+		if(node.Count > 0)
+		{
+			for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				if(Overlaps(itemBounds[itemIndices[i]], box))
+				{
+					items.push_back(itemIndices[i]);
+				}
+			}
+
+			continue;
+		}
+
+		stack[stackSize++] = node.LeftFirst + 1;
+		stack[stackSize++] = node.LeftFirst;
+	}
+}
+
+void BVH::QuerySphere(const BoundingSphere& sphere, std::vector<unsigned int>& items)
+{
+	if(nodeCount == 0)
+	{
+		return;
+	}
+
+	BVHNode* nodes = GetNodes();
+	unsigned int stack[StackSize];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize > 0)
+	{
+		const BVHNode& node = nodes[stack[--stackSize]];
+		if(!Overlaps(GetNodeBounds(node), sphere))
+		{
+			continue;
+		}
+
+		if(node.Count > 0)
+		{
+			for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				if(Overlaps(itemBounds[itemIndices[i]], sphere))
+				{
+					items.push_back(itemIndices[i]);
+				}
+			}
+
+			continue;
+		}
+
+		stack[stackSize++] = node.LeftFirst + 1;
+		stack[stackSize++] = node.LeftFirst;
+	}
+}
+
+RayHit BVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+	const std::function<bool(unsigned int, float&)>& test)
+{
+	RayHit hit;
+	if(nodeCount == 0)
+	{
+		return hit;
+	}
+
+	BVHNode* nodes = GetNodes();
+	glm::vec3 inverseDirection = 1.0f / direction;
+	float closest = maxDistance;
+
+	// Nodes keep the distance they were entered at, once something closer got hit they can be skipped //
+	struct Entry
+	{
+		unsigned int Node;
+		float Distance;
+	};
+
+	Entry stack[StackSize];
+	unsigned int stackSize = 0;
+	float distance;
+
+	if(!IntersectRay(GetNodeBounds(nodes[0]), origin, inverseDirection, closest, distance))
+	{
+		return hit;
+	}
+
+	stack[stackSize++] = { 0, distance };
+
+	while(stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		if(entry.Distance > closest)
+		{
+			continue;
+		}
+
+		const BVHNode& node = nodes[entry.Node];
+
+		if(node.Count > 0)
+		{
+			for(unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++)
+			{
+				unsigned int item = itemIndices[i];
+				if(!IntersectRay(itemBounds[item], origin, inverseDirection, closest, distance))
+				{
+					continue;
+				}
+
+				if((!test || test(item, distance)) && distance <= closest)
+				{
+					closest = distance;
+					hit.Item = item;
+					hit.Distance = distance;
+				}
+			}
+
+			continue;
+		}
+
+		// The nearest child goes on top, so it's visited first and can rule out the other one //
+		float leftDistance, rightDistance;
+		bool leftHit = IntersectRay(GetNodeBounds(nodes[node.LeftFirst]), origin, inverseDirection, closest, leftDistance);
+		bool rightHit = IntersectRay(GetNodeBounds(nodes[node.LeftFirst + 1]), origin, inverseDirection, closest, rightDistance);
+
+		if(leftHit && rightHit)
+		{
+			bool leftFirst = leftDistance <= rightDistance;
+			stack[stackSize++] = leftFirst ? Entry{ node.LeftFirst + 1, rightDistance } : Entry{ node.LeftFirst, leftDistance };
+			stack[stackSize++] = leftFirst ? Entry{ node.LeftFirst, leftDistance } : Entry{ node.LeftFirst + 1, rightDistance };
+		}
+		else if(leftHit)
+		{
+			stack[stackSize++] = { node.LeftFirst, leftDistance };
+		}
+		else if(rightHit)
+		{
+			stack[stackSize++] = { node.LeftFirst + 1, rightDistance };
+		}
+	}
+
+	return hit;
+}
+
+void BVH::AddSubtree(unsigned int nodeIndex, std::vector<unsigned int>& items)
+{
+	BVHNode* nodes = GetNodes();
+	unsigned int stack[StackSize];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = nodeIndex;
+
+	while(stackSize > 0)
+	{
+		const BVHNode& node = nodes[stack[--stackSize]];
+
+		if(node.Count > 0)
+		{
+			items.insert(items.end(), itemIndices.begin() + node.LeftFirst, itemIndices.begin() + node.LeftFirst + node.Count);
+			continue;
+		}
+
+		stack[stackSize++] = node.LeftFirst + 1;
+		stack[stackSize++] = node.LeftFirst;
+	}
+}
+#pragma endregion
+
+const BoundingBox& BVH::GetItemBounds(unsigned int item)
+{
+	return itemBounds[item];
+}
+
+BoundingBox BVH::GetBounds()
+{
+	return nodeCount > 0 ? GetNodeBounds(GetNodes()[0]) : BoundingBox();
+}
+
+float BVH::GetCost()
+{
+	if(nodeCount == 0)
+	{
+		return 0.0f;
+	}
+
+	BVHNode* nodes = GetNodes();
+	float rootArea = GetSurfaceArea(GetNodeBounds(nodes[0]));
+	if(rootArea <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	float cost = 0.0f;
+	for(unsigned int i = 0; i < nodeCount; i++)
+	{
+		if(i != 1)
+		{
+			float area = GetSurfaceArea(GetNodeBounds(nodes[i]));
+			cost += area * (nodes[i].Count > 0 ? IntersectionCost * nodes[i].Count : TraversalCost);
+		}
+	}
+
+	return cost / rootArea;
+}
+
+float BVH::GetBuildCost()
+{
+	return buildCost;
+}
+
+unsigned int BVH::GetItemCount()
+{
+	return static_cast<unsigned int>(itemBounds.size());
+}
+
+unsigned int BVH::GetNodeCount()
+{
+	return nodeCount;
+}
+
+BVHNode* BVH::GetNodes()
+{
+	return reinterpret_cast<BVHNode*>(nodePairs.data());
+}
+
+#pragma region Benchmark
+namespace
+{
+	template<typename Function>
+	double MeasureMilliseconds(const Function& function)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		function();
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+	}
+}
+
+void BVH::RunBenchmark()
+{
+	const unsigned int itemCounts[] = { 10000, 100000, 1000000 };
+	const unsigned int queryCount = 10000;
+	const unsigned int verifyCount = 100;
+
+	ThreadPool& threadPool = ThreadPool::Get();
+
+	for(unsigned int itemCount : itemCounts)
+	{
+		// 1. Boxes spread through a cube that grows with the item count, so every scene is about as dense //
+		std::mt19937 random(1337);
+		float sceneSize = 8.0f * std::cbrt(static_cast<float>(itemCount));
+		std::uniform_real_distribution<float> position(-sceneSize * 0.5f, sceneSize * 0.5f);
+		std::uniform_real_distribution<float> size(0.25f, 1.25f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		std::vector<BoundingBox> boxes(itemCount);
+		for(BoundingBox& box : boxes)
+		{
+			glm::vec3 center = glm::vec3(position(random), position(random), position(random));
+			glm::vec3 extents = glm::vec3(size(random), size(random), size(random));
+			box.Min = center - extents;
+			box.Max = center + extents;
+		}
+
+		std::string scene = "BVH benchmark: " + std::to_string(itemCount) + " items";
+
+		// 2. Build on the calling thread, then on the pool //
+		BVH bvh;
+		double serialBuild = MeasureMilliseconds([&]() { bvh.Build(boxes); });
+		double parallelBuild = MeasureMilliseconds([&]() { bvh.Build(boxes, &threadPool); });
+
+		LOG(scene + " - build " + std::to_string(serialBuild) + " ms, " + std::to_string(parallelBuild) + " ms on " +
+			std::to_string(threadPool.GetThreadCount()) + " threads, " + std::to_string(bvh.GetNodeCount()) + " nodes, cost " +
+			std::to_string(bvh.GetBuildCost()));
+
+		// 3. Refit after moving 1% of the items a bit, then after moving all of them //
+		auto moveItems = [&](unsigned int count)
+		{
+			for(unsigned int i = 0; i < count; i++)
+			{
+				unsigned int item = count == itemCount ? i : random() % itemCount;
+				glm::vec3 offset = glm::vec3(unit(random), unit(random), unit(random));
+
+				boxes[item].Min += offset;
+				boxes[item].Max += offset;
+				bvh.UpdateItem(item, boxes[item]);
+			}
+
+			bvh.Refit();
+		};
+
+		double partialRefit = MeasureMilliseconds([&]() { moveItems(itemCount / 100); });
+		double fullRefit = MeasureMilliseconds([&]() { moveItems(itemCount); });
+
+		LOG(scene + " - refit 1% " + std::to_string(partialRefit) + " ms, refit all " + std::to_string(fullRefit) +
+			" ms, cost after " + std::to_string(bvh.GetCost()));
+
+		// 4. Frustum queries from inside the scene, against culling every box //
+		FrustumCuller culler;
+		for(const BoundingBox& box : boxes)
+		{
+			culler.AddBox(box);
+		}
+
+		std::vector<unsigned int> items;
+		std::vector<unsigned char> visibility;
+		double frustumMilliseconds = 0.0;
+		double cullerMilliseconds = 0.0;
+		size_t visibleCount = 0;
+		bool frustumMatches = true;
+		const unsigned int frustumCount = 16;
+
+		for(unsigned int i = 0; i < frustumCount; i++)
+		{
+			glm::vec3 eye = glm::vec3(position(random), position(random), position(random));
+			glm::vec3 target = eye + glm::vec3(unit(random), unit(random) * 0.25f, unit(random));
+			glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 projection = glm::perspective(glm::radians(55.0f), 16.0f / 9.0f, 0.1f, sceneSize * 0.25f);
+			Frustum frustum = FrustumCuller::ExtractFrustum(projection * view);
+
+			items.clear();
+			frustumMilliseconds += MeasureMilliseconds([&]() { bvh.QueryFrustum(frustum, items); });
+
+			unsigned int cullerCount = 0;
+			cullerMilliseconds += MeasureMilliseconds([&]() { cullerCount = culler.CullBoxes(frustum, visibility); });
+
+			visibleCount += items.size();
+			frustumMatches &= items.size() == cullerCount;
+		}
+
+		LOG(scene + " - frustum query " + std::to_string(frustumMilliseconds * 1000.0 / frustumCount) + " us, culling every box " +
+			std::to_string(cullerMilliseconds * 1000.0 / frustumCount) + " us, " + std::to_string(visibleCount / frustumCount) +
+			" visible");
+
+		if(!frustumMatches)
+		{
+			LOG(Log::MessageType::Error, "BVH frustum query doesn't match the FrustumCuller!");
+		}
+
+		// 5. Rays & spheres through the scene, the first few get checked against every item //
+		std::vector<glm::vec3> origins(queryCount);
+		std::vector<glm::vec3> directions(queryCount);
+		for(unsigned int i = 0; i < queryCount; i++)
+		{
+			origins[i] = glm::vec3(position(random), position(random), position(random));
+			directions[i] = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.0f, 0.001f));
+		}
+
+		std::vector<RayHit> hits(queryCount);
+		double rayMilliseconds = MeasureMilliseconds([&]()
+		{
+			for(unsigned int i = 0; i < queryCount; i++)
+			{
+				hits[i] = bvh.Raycast(origins[i], directions[i]);
+			}
+		});
+
+		size_t overlapCount = 0;
+		double sphereMilliseconds = MeasureMilliseconds([&]()
+		{
+			for(unsigned int i = 0; i < queryCount; i++)
+			{
+				items.clear();
+				bvh.QuerySphere({ origins[i], 4.0f }, items);
+				overlapCount += items.size();
+			}
+		});
+
+		LOG(scene + " - ray " + std::to_string(rayMilliseconds * 1000000.0 / queryCount) + " ns, sphere overlap " +
+			std::to_string(sphereMilliseconds * 1000000.0 / queryCount) + " ns, " + std::to_string(overlapCount / queryCount) +
+			" items per sphere");
+
+		bool queriesMatch = true;
+		for(unsigned int i = 0; i < verifyCount; i++)
+		{
+			glm::vec3 inverseDirection = 1.0f / directions[i];
+			float closest = FLT_MAX;
+			unsigned int overlaps = 0;
+			BoundingSphere sphere = { origins[i], 4.0f };
+
+			for(const BoundingBox& box : boxes)
+			{
+				float distance;
+				if(IntersectRay(box, origins[i], inverseDirection, closest, distance))
+				{
+					closest = std::min(closest, distance);
+				}
+
+				overlaps += Overlaps(box, sphere) ? 1 : 0;
+			}
+
+			items.clear();
+			bvh.QuerySphere(sphere, items);
+			queriesMatch &= closest == hits[i].Distance && overlaps == items.size();
+		}
+
+		if(!queriesMatch)
+		{
+			LOG(Log::MessageType::Error, "BVH ray or sphere query doesn't match checking every item!");
+		}
+	}
+}
+#pragma endregion
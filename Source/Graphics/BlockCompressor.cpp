@@ -0,0 +1,1616 @@
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/MipGenerator.h"
+
+#include "Utilities/Logger.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stb_image.h>
+#include <gtc/packing.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVA_SSE_BLOCKS
+#include <xmmintrin.h>
+#endif
+
+// 4x4 pixels, stored per channel so 4 pixels can be processed at once.
+// Values go from 0 to 255, or to the largest half float bit pattern for BC6H.
+struct BlockPixels
+{
+	alignas(16) float Channels[4][16];
+	float Maximum;
+};
+
+struct EncodeSettings
+{
+	bool UsePrincipalAxis;
+	int RefineIterations;
+	bool ExhaustiveSearch; // All p-bit combinations for BC7, endpoint neighbourhood for BC4
+};
+
+static EncodeSettings GetEncodeSettings(CompressionQuality quality)
+{
+	switch(quality)
+	{
+	case CompressionQuality::Fast:
+		return { false, 0, false };
+	case CompressionQuality::High:
+		return { true, 4, true };
+	default:
+		return { true, 1, false };
+	}
+}
+
+static void LoadBlock(const unsigned char* pixels, int width, int height, int blockX, int blockY, BlockPixels& block)
+{
+	// Levels smaller than a block repeat their edge pixels //
+	for(int y = 0; y < 4; y++)
+	{
+		int sourceY = std::min(blockY * 4 + y, height - 1);
+
+		for(int x = 0; x < 4; x++)
+		{
+			int sourceX = std::min(blockX * 4 + x, width - 1);
+			const unsigned char* pixel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+
+			for(int c = 0; c < 4; c++)
+			{
+				block.Channels[c][y * 4 + x] = pixel[c];
+			}
+		}
+	}
+
+	block.Maximum = 255.0f;
+}
+
+static float Clamp(float value, float minimum, float maximum)
+{
+	return std::min(std::max(value, minimum), maximum);
+}
+
+// Endpoints //
+
+// Picks the line through the block's colors that endpoints get placed on.
+// Fast uses the bounding box diagonal, otherwise the principal axis of the colors is used.
+static void FindEndpoints(const BlockPixels& block, int firstChannel, int channelCount,
+	bool usePrincipalAxis, float* low, float* high)
+{
+	float minimum[4];
+	float maximum[4];
+	float mean[4];
+
+	for(int c = 0; c < channelCount; c++)
+	{
+		const float* values = block.Channels[firstChannel + c];
+		minimum[c] = maximum[c] = values[0];
+		mean[c] = 0.0f;
+
+		for(int i = 0; i < 16; i++)
+		{
+			minimum[c] = std::min(minimum[c], values[i]);
+			maximum[c] = std::max(maximum[c], values[i]);
+			mean[c] += values[i];
+		}
+
+		mean[c] /= 16.0f;
+	}
+
+	if(!usePrincipalAxis || channelCount == 1)
+	{
+		// The extremes of each channel rarely lie on the same line, so inset them slightly //
+		float inset = channelCount == 1 ? 0.0f : 1.0f / 32.0f;
+		for(int c = 0; c < channelCount; c++)
+		{
+			float range = (maximum[c] - minimum[c]) * inset;
+			low[c] = minimum[c] + range;
+			high[c] = maximum[c] - range;
+		}
+
+		// Pick the diagonal that matches the correlation with the widest channel //
+		int widest = 0;
+		for(int c = 1; c < channelCount; c++)
+		{
+			if(maximum[c] - minimum[c] > maximum[widest] - minimum[widest])
+			{
+				widest = c;
+			}
+		}
+
+		for(int c = 0; c < channelCount; c++)
+		{
+			float correlation = 0.0f;
+			for(int i = 0; i < 16; i++)
+			{
+				correlation += (block.Channels[firstChannel + c][i] - mean[c]) *
+					(block.Channels[firstChannel + widest][i] - mean[widest]);
+			}
+
+			if(correlation < 0.0f)
+			{
+				std::swap(low[c], high[c]);
+			}
+		}
+
+		return;
+	}
+
+	float covariance[4][4] = {};
+	for(int i = 0; i < 16; i++)
+	{
+		float delta[4];
+		for(int c = 0; c < channelCount; c++)
+		{
+			delta[c] = block.Channels[firstChannel + c][i] - mean[c];
+		}
+
+		for(int a = 0; a < channelCount; a++)
+		{
+			for(int b = 0; b < channelCount; b++)
+			{
+				covariance[a][b] += delta[a] * delta[b];
+			}
+		}
+	}
+
+	// Power iteration, starting from the bounding box diagonal //
+	float axis[4];
+	for(int c = 0; c < channelCount; c++)
+	{
+		axis[c] = maximum[c] - minimum[c];
+	}
+
+	for(int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[4] = {};
+		float largest = 0.0f;
+
+		for(int a = 0; a < channelCount; a++)
+		{
+			for(int b = 0; b < channelCount; b++)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+
+			largest = std::max(largest, std::abs(next[a]));
+		}
+
+		if(largest < 1e-6f)
+		{
+			break;
+		}
+
+		for(int c = 0; c < channelCount; c++)
+		{
+			axis[c] = next[c] / largest;
+		}
+	}
+
+	float axisLength = 0.0f;
+	for(int c = 0; c < channelCount; c++)
+	{
+		axisLength += axis[c] * axis[c];
+	}
+
+	// Flat block, a single color represents it perfectly //
+	if(axisLength < 1e-6f)
+	{
+		for(int c = 0; c < channelCount; c++)
+		{
+			low[c] = high[c] = mean[c];
+		}
+
+		return;
+	}
+
+	float minimumProjection = 0.0f;
+	float maximumProjection = 0.0f;
+	for(int i = 0; i < 16; i++)
+	{
+		float projection = 0.0f;
+		for(int c = 0; c < channelCount; c++)
+		{
+			projection += (block.Channels[firstChannel + c][i] - mean[c]) * axis[c];
+		}
+
+		minimumProjection = std::min(minimumProjection, projection);
+		maximumProjection = std::max(maximumProjection, projection);
+	}
+
+	for(int c = 0; c < channelCount; c++)
+	{
+		low[c] = Clamp(mean[c] + axis[c] * minimumProjection / axisLength, 0.0f, block.Maximum);
+		high[c] = Clamp(mean[c] + axis[c] * maximumProjection / axisLength, 0.0f, block.Maximum);
+	}
+}
+
+// Solves the least squares fit of both endpoints for the currently chosen weights //
+static bool RefineEndpoints(const BlockPixels& block, int firstChannel, int channelCount,
+	const unsigned char* ordinals, const float* weights, float* low, float* high)
+{
+	float lowLow = 0.0f;
+	float lowHigh = 0.0f;
+	float highHigh = 0.0f;
+	float lowValue[4] = {};
+	float highValue[4] = {};
+
+	for(int i = 0; i < 16; i++)
+	{
+		float weight = weights[ordinals[i]];
+		float inverse = 1.0f - weight;
+
+		lowLow += inverse * inverse;
+		lowHigh += inverse * weight;
+		highHigh += weight * weight;
+
+		for(int c = 0; c < channelCount; c++)
+		{
+			float value = block.Channels[firstChannel + c][i];
+			lowValue[c] += inverse * value;
+			highValue[c] += weight * value;
+		}
+	}
+
+	float determinant = lowLow * highHigh - lowHigh * lowHigh;
+	if(std::abs(determinant) < 1e-6f)
+	{
+		return false;
+	}
+
+	for(int c = 0; c < channelCount; c++)
+	{
+		low[c] = Clamp((lowValue[c] * highHigh - highValue[c] * lowHigh) / determinant, 0.0f, block.Maximum);
+		high[c] = Clamp((highValue[c] * lowLow - lowValue[c] * lowHigh) / determinant, 0.0f, block.Maximum);
+	}
+
+	return true;
+}
+
+// Palette search //
+
+// Finds the closest palette entry for every pixel, returns the summed squared error //
+static float AssignOrdinals(const BlockPixels& block, int firstChannel, int channelCount,
+	const float palette[][4], int paletteSize, unsigned char* ordinals)
+{
+	float totalError = 0.0f;
+
+#ifdef NOVA_SSE_BLOCKS
+	for(int group = 0; group < 16; group += 4)
+	{
+		__m128 bestError = _mm_set1_ps(1e30f);
+		__m128 bestOrdinal = _mm_setzero_ps();
+
+		for(int k = 0; k < paletteSize; k++)
+		{
+			__m128 error = _mm_setzero_ps();
+			for(int c = 0; c < channelCount; c++)
+			{
+				__m128 delta = _mm_sub_ps(_mm_load_ps(&block.Channels[firstChannel + c][group]), _mm_set1_ps(palette[k][c]));
+				error = _mm_add_ps(error, _mm_mul_ps(delta, delta));
+			}
+
+			__m128 closer = _mm_cmplt_ps(error, bestError);
+			bestError = _mm_min_ps(error, bestError);
+			bestOrdinal = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(k))), _mm_andnot_ps(closer, bestOrdinal));
+		}
+
+		alignas(16) float errors[4];
+		alignas(16) float closest[4];
+		_mm_store_ps(errors, bestError);
+		_mm_store_ps(closest, bestOrdinal);
+
+		for(int i = 0; i < 4; i++)
+		{
+			ordinals[group + i] = static_cast<unsigned char>(closest[i]);
+			totalError += errors[i];
+		}
+	}
+#else
+	for(int i = 0; i < 16; i++)
+	{
+		float bestError = 1e30f;
+		int bestOrdinal = 0;
+
+		for(int k = 0; k < paletteSize; k++)
+		{
+			float error = 0.0f;
+			for(int c = 0; c < channelCount; c++)
+			{
+				float delta = block.Channels[firstChannel + c][i] - palette[k][c];
+				error += delta * delta;
+			}
+
+			if(error < bestError)
+			{
+				bestError = error;
+				bestOrdinal = k;
+			}
+		}
+
+		ordinals[i] = static_cast<unsigned char>(bestOrdinal);
+		totalError += bestError;
+	}
+#endif
+
+	return totalError;
+}
+
+// BC1 //
+
+static const float bc1Weights[4] = { 0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f };
+
+static unsigned short QuantizeRGB565(const float* color)
+{
+	unsigned int r = static_cast<unsigned int>(color[0] * (31.0f / 255.0f) + 0.5f);
+	unsigned int g = static_cast<unsigned int>(color[1] * (63.0f / 255.0f) + 0.5f);
+	unsigned int b = static_cast<unsigned int>(color[2] * (31.0f / 255.0f) + 0.5f);
+	return static_cast<unsigned short>((r << 11) | (g << 5) | b);
+}
+
+static void ExpandRGB565(unsigned short value, float* color)
+{
+	unsigned int r = (value >> 11) & 31;
+	unsigned int g = (value >> 5) & 63;
+	unsigned int b = value & 31;
+
+	color[0] = static_cast<float>((r << 3) | (r >> 2));
+	color[1] = static_cast<float>((g << 2) | (g >> 4));
+	color[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+static float EvaluateBC1(const BlockPixels& block, const float* low, const float* high,
+	unsigned short& lowColor, unsigned short& highColor, unsigned char* ordinals)
+{
+	lowColor = QuantizeRGB565(low);
+	highColor = QuantizeRGB565(high);
+
+	float lowExpanded[3];
+	float highExpanded[3];
+	ExpandRGB565(lowColor, lowExpanded);
+	ExpandRGB565(highColor, highExpanded);
+
+	float palette[4][4];
+	for(int k = 0; k < 4; k++)
+	{
+		for(int c = 0; c < 3; c++)
+		{
+			palette[k][c] = lowExpanded[c] + (highExpanded[c] - lowExpanded[c]) * bc1Weights[k];
+		}
+	}
+
+	return AssignOrdinals(block, 0, 3, palette, 4, ordinals);
+}
+
+static void EncodeBC1(const BlockPixels& block, const EncodeSettings& settings, unsigned char* output)
+{
+	float low[4];
+	float high[4];
+	FindEndpoints(block, 0, 3, settings.UsePrincipalAxis, low, high);
+
+	unsigned short bestLow;
+	unsigned short bestHigh;
+	unsigned char bestOrdinals[16];
+	float bestError = EvaluateBC1(block, low, high, bestLow, bestHigh, bestOrdinals);
+
+	for(int iteration = 0; iteration < settings.RefineIterations; iteration++)
+	{
+		if(!RefineEndpoints(block, 0, 3, bestOrdinals, bc1Weights, low, high))
+		{
+			break;
+		}
+
+		unsigned short lowColor;
+		unsigned short highColor;
+		unsigned char ordinals[16];
+		float error = EvaluateBC1(block, low, high, lowColor, highColor, ordinals);
+
+		if(error >= bestError)
+		{
+			break;
+		}
+
+		bestError = error;
+		bestLow = lowColor;
+		bestHigh = highColor;
+		memcpy(bestOrdinals, ordinals, sizeof(ordinals));
+	}
+
+	// Four color mode needs color0 > color1, the codes then go c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1 //
+	static const unsigned int codes[4] = { 0, 2, 3, 1 };
+	unsigned int indices = 0;
+
+	if(bestLow == bestHigh)
+	{
+		// Every pixel uses color0 //
+	}
+	else if(bestLow > bestHigh)
+	{
+		for(int i = 0; i < 16; i++)
+		{
+			indices |= codes[bestOrdinals[i]] << (i * 2);
+		}
+	}
+	else
+	{
+		std::swap(bestLow, bestHigh);
+		for(int i = 0; i < 16; i++)
+		{
+			indices |= codes[3 - bestOrdinals[i]] << (i * 2);
+		}
+	}
+
+	memcpy(output, &bestLow, 2);
+	memcpy(output + 2, &bestHigh, 2);
+	memcpy(output + 4, &indices, 4);
+}
+
+static void DecodeBC1(const unsigned char* input, bool forceFourColors, unsigned char pixels[16][4])
+{
+	unsigned short color0;
+	unsigned short color1;
+	unsigned int indices;
+	memcpy(&color0, input, 2);
+	memcpy(&color1, input + 2, 2);
+	memcpy(&indices, input + 4, 4);
+
+	float colors[4][3];
+	ExpandRGB565(color0, colors[0]);
+	ExpandRGB565(color1, colors[1]);
+
+	bool fourColors = forceFourColors || color0 > color1;
+	for(int c = 0; c < 3; c++)
+	{
+		if(fourColors)
+		{
+			colors[2][c] = (2.0f * colors[0][c] + colors[1][c]) / 3.0f;
+			colors[3][c] = (colors[0][c] + 2.0f * colors[1][c]) / 3.0f;
+		}
+		else
+		{
+			colors[2][c] = (colors[0][c] + colors[1][c]) * 0.5f;
+			colors[3][c] = 0.0f;
+		}
+	}
+
+	for(int i = 0; i < 16; i++)
+	{
+		unsigned int code = (indices >> (i * 2)) & 3;
+		for(int c = 0; c < 3; c++)
+		{
+			pixels[i][c] = static_cast<unsigned char>(colors[code][c] + 0.5f);
+		}
+
+		pixels[i][3] = (!fourColors && code == 3) ? 0 : 255;
+	}
+}
+
+// BC4 //
+
+static const float bc4Weights[8] = { 0.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f, 1.0f };
+
+static float EvaluateBC4(const BlockPixels& block, int channel, int low, int high, unsigned char* ordinals)
+{
+	float palette[8][4];
+	for(int k = 0; k < 8; k++)
+	{
+		palette[k][0] = low + (high - low) * bc4Weights[k];
+	}
+
+	return AssignOrdinals(block, channel, 1, palette, 8, ordinals);
+}
+
+static void EncodeBC4(const BlockPixels& block, int channel, const EncodeSettings& settings, unsigned char* output)
+{
+	float lowValue;
+	float highValue;
+	FindEndpoints(block, channel, 1, false, &lowValue, &highValue);
+
+	int bestLow = static_cast<int>(lowValue + 0.5f);
+	int bestHigh = static_cast<int>(highValue + 0.5f);
+	unsigned char bestOrdinals[16];
+	float bestError = EvaluateBC4(block, channel, bestLow, bestHigh, bestOrdinals);
+
+	for(int iteration = 0; iteration < settings.RefineIterations; iteration++)
+	{
+		if(!RefineEndpoints(block, channel, 1, bestOrdinals, bc4Weights, &lowValue, &highValue))
+		{
+			break;
+		}
+
+		int low = static_cast<int>(std::min(lowValue, highValue) + 0.5f);
+		int high = static_cast<int>(std::max(lowValue, highValue) + 0.5f);
+
+		unsigned char ordinals[16];
+		float error = EvaluateBC4(block, channel, low, high, ordinals);
+
+		if(error >= bestError)
+		{
+			break;
+		}
+
+		bestError = error;
+		bestLow = low;
+		bestHigh = high;
+		memcpy(bestOrdinals, ordinals, sizeof(ordinals));
+	}
+
+	if(settings.ExhaustiveSearch)
+	{
+		int centerLow = bestLow;
+		int centerHigh = bestHigh;
+
+		for(int lowOffset = -2; lowOffset <= 2; lowOffset++)
+		{
+			for(int highOffset = -2; highOffset <= 2; highOffset++)
+			{
+				int low = std::max(centerLow + lowOffset, 0);
+				int high = std::min(centerHigh + highOffset, 255);
+
+				if(low > high)
+				{
+					continue;
+				}
+
+				unsigned char ordinals[16];
+				float error = EvaluateBC4(block, channel, low, high, ordinals);
+
+				if(error < bestError)
+				{
+					bestError = error;
+					bestLow = low;
+					bestHigh = high;
+					memcpy(bestOrdinals, ordinals, sizeof(ordinals));
+				}
+			}
+		}
+	}
+
+	// Eight value mode needs red0 > red1, the codes then go r0, r1, 6/7 r0 + 1/7 r1 ... 1/7 r0 + 6/7 r1 //
+	static const unsigned long long codes[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+	unsigned long long indices = 0;
+
+	if(bestLow != bestHigh)
+	{
+		for(int i = 0; i < 16; i++)
+		{
+			indices |= codes[bestOrdinals[i]] << (i * 3);
+		}
+	}
+
+	output[0] = static_cast<unsigned char>(bestHigh);
+	output[1] = static_cast<unsigned char>(bestLow);
+	for(int i = 0; i < 6; i++)
+	{
+		output[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+	}
+}
+
+static void DecodeBC4(const unsigned char* input, unsigned char values[16])
+{
+	float palette[8];
+	palette[0] = input[0];
+	palette[1] = input[1];
+
+	if(input[0] > input[1])
+	{
+		for(int k = 1; k < 7; k++)
+		{
+			palette[k + 1] = ((7 - k) * palette[0] + k * palette[1]) / 7.0f;
+		}
+	}
+	else
+	{
+		for(int k = 1; k < 5; k++)
+		{
+			palette[k + 1] = ((5 - k) * palette[0] + k * palette[1]) / 5.0f;
+		}
+
+		palette[6] = 0.0f;
+		palette[7] = 255.0f;
+	}
+
+	unsigned long long indices = 0;
+	for(int i = 0; i < 6; i++)
+	{
+		indices |= static_cast<unsigned long long>(input[2 + i]) << (i * 8);
+	}
+
+	for(int i = 0; i < 16; i++)
+	{
+		values[i] = static_cast<unsigned char>(palette[(indices >> (i * 3)) & 7] + 0.5f);
+	}
+}
+
+// BC7 ( mode 6 ) //
+
+static const int bc7WeightsInteger[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+static const float bc7Weights[16] = { 0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f,
+	21.0f / 64.0f, 26.0f / 64.0f, 30.0f / 64.0f, 34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f,
+	51.0f / 64.0f, 55.0f / 64.0f, 60.0f / 64.0f, 64.0f / 64.0f };
+
+struct BC7Endpoints
+{
+	unsigned char Low[4]; // 7 bits per channel
+	unsigned char High[4];
+	int LowPBit;
+	int HighPBit;
+};
+
+// Every channel is stored with 7 bits, the shared p-bit becomes the lowest bit //
+static float QuantizeBC7Endpoint(const float* color, int pBit, unsigned char* quantized)
+{
+	float error = 0.0f;
+	for(int c = 0; c < 4; c++)
+	{
+		int value = static_cast<int>((color[c] - pBit) * 0.5f + 0.5f);
+		quantized[c] = static_cast<unsigned char>(std::min(std::max(value, 0), 127));
+
+		float delta = static_cast<float>(quantized[c] * 2 + pBit) - color[c];
+		error += delta * delta;
+	}
+
+	return error;
+}
+
+static float EvaluateBC7(const BlockPixels& block, const BC7Endpoints& endpoints, unsigned char* ordinals)
+{
+	int low[4];
+	int high[4];
+	for(int c = 0; c < 4; c++)
+	{
+		low[c] = endpoints.Low[c] * 2 + endpoints.LowPBit;
+		high[c] = endpoints.High[c] * 2 + endpoints.HighPBit;
+	}
+
+	float palette[16][4];
+	for(int k = 0; k < 16; k++)
+	{
+		for(int c = 0; c < 4; c++)
+		{
+			palette[k][c] = static_cast<float>(((64 - bc7WeightsInteger[k]) * low[c] + bc7WeightsInteger[k] * high[c] + 32) >> 6);
+		}
+	}
+
+	return AssignOrdinals(block, 0, 4, palette, 16, ordinals);
+}
+
+static float QuantizeAndEvaluateBC7(const BlockPixels& block, const float* low, const float* high,
+	bool exhaustiveSearch, BC7Endpoints& endpoints, unsigned char* ordinals)
+{
+	if(!exhaustiveSearch)
+	{
+		// Each endpoint picks the p-bit that represents it best //
+		BC7Endpoints zero;
+		BC7Endpoints one;
+		float lowError[2] = { QuantizeBC7Endpoint(low, 0, zero.Low), QuantizeBC7Endpoint(low, 1, one.Low) };
+		float highError[2] = { QuantizeBC7Endpoint(high, 0, zero.High), QuantizeBC7Endpoint(high, 1, one.High) };
+
+		endpoints.LowPBit = lowError[1] < lowError[0] ? 1 : 0;
+		endpoints.HighPBit = highError[1] < highError[0] ? 1 : 0;
+		memcpy(endpoints.Low, endpoints.LowPBit ? one.Low : zero.Low, 4);
+		memcpy(endpoints.High, endpoints.HighPBit ? one.High : zero.High, 4);
+
+		return EvaluateBC7(block, endpoints, ordinals);
+	}
+
+	float bestError = 1e30f;
+	for(int pBits = 0; pBits < 4; pBits++)
+	{
+		BC7Endpoints candidate;
+		candidate.LowPBit = pBits & 1;
+		candidate.HighPBit = pBits >> 1;
+		QuantizeBC7Endpoint(low, candidate.LowPBit, candidate.Low);
+		QuantizeBC7Endpoint(high, candidate.HighPBit, candidate.High);
+
+		unsigned char candidateOrdinals[16];
+		float error = EvaluateBC7(block, candidate, candidateOrdinals);
+
+		if(error < bestError)
+		{
+			bestError = error;
+			endpoints = candidate;
+			memcpy(ordinals, candidateOrdinals, sizeof(candidateOrdinals));
+		}
+	}
+
+	return bestError;
+}
+
+// Writes fields least significant bit first, as the BC7 layout is defined //
+struct BitWriter
+{
+	unsigned char* Data;
+	int Position;
+
+	void Write(unsigned int value, int bitCount)
+	{
+		for(int bit = 0; bit < bitCount; bit++, Position++)
+		{
+			if((value >> bit) & 1)
+			{
+				Data[Position >> 3] |= static_cast<unsigned char>(1 << (Position & 7));
+			}
+		}
+	}
+};
+
+static unsigned int ReadBits(const unsigned char* data, int& position, int bitCount)
+{
+	unsigned int value = 0;
+	for(int bit = 0; bit < bitCount; bit++, position++)
+	{
+		value |= ((data[position >> 3] >> (position & 7)) & 1u) << bit;
+	}
+
+	return value;
+}
+
+static void EncodeBC7(const BlockPixels& block, const EncodeSettings& settings, unsigned char* output)
+{
+	float low[4];
+	float high[4];
+	FindEndpoints(block, 0, 4, settings.UsePrincipalAxis, low, high);
+
+	BC7Endpoints bestEndpoints;
+	unsigned char bestOrdinals[16];
+	float bestError = QuantizeAndEvaluateBC7(block, low, high, settings.ExhaustiveSearch, bestEndpoints, bestOrdinals);
+
+	for(int iteration = 0; iteration < settings.RefineIterations; iteration++)
+	{
+		if(!RefineEndpoints(block, 0, 4, bestOrdinals, bc7Weights, low, high))
+		{
+			break;
+		}
+
+		BC7Endpoints endpoints;
+		unsigned char ordinals[16];
+		float error = QuantizeAndEvaluateBC7(block, low, high, settings.ExhaustiveSearch, endpoints, ordinals);
+
+		if(error >= bestError)
+		{
+			break;
+		}
+
+		bestError = error;
+		bestEndpoints = endpoints;
+		memcpy(bestOrdinals, ordinals, sizeof(ordinals));
+	}
+
+	// The first pixel's index is stored without its highest bit, so it has to be below 8 //
+	if(bestOrdinals[0] >= 8)
+	{
+		std::swap(bestEndpoints.Low, bestEndpoints.High);
+		std::swap(bestEndpoints.LowPBit, bestEndpoints.HighPBit);
+
+		for(int i = 0; i < 16; i++)
+		{
+			bestOrdinals[i] = 15 - bestOrdinals[i];
+		}
+	}
+
+	memset(output, 0, 16);
+	BitWriter writer = { output, 0 };
+	writer.Write(1 << 6, 7);
+
+	for(int c = 0; c < 4; c++)
+	{
+		writer.Write(bestEndpoints.Low[c], 7);
+		writer.Write(bestEndpoints.High[c], 7);
+	}
+
+	writer.Write(bestEndpoints.LowPBit, 1);
+	writer.Write(bestEndpoints.HighPBit, 1);
+
+	for(int i = 0; i < 16; i++)
+	{
+		writer.Write(bestOrdinals[i], i == 0 ? 3 : 4);
+	}
+}
+
+static void DecodeBC7(const unsigned char* input, unsigned char pixels[16][4])
+{
+	if((input[0] & 0x7F) != (1 << 6))
+	{
+		assert(false && "Only BC7 mode 6 blocks can be decoded.");
+		memset(pixels, 0, 16 * 4);
+		return;
+	}
+
+	int position = 7;
+	unsigned int low[4];
+	unsigned int high[4];
+
+	for(int c = 0; c < 4; c++)
+	{
+		low[c] = ReadBits(input, position, 7) << 1;
+		high[c] = ReadBits(input, position, 7) << 1;
+	}
+
+	unsigned int lowPBit = ReadBits(input, position, 1);
+	unsigned int highPBit = ReadBits(input, position, 1);
+
+	for(int i = 0; i < 16; i++)
+	{
+		unsigned int index = ReadBits(input, position, i == 0 ? 3 : 4);
+		int weight = bc7WeightsInteger[index];
+
+		for(int c = 0; c < 4; c++)
+		{
+			int lowValue = low[c] | lowPBit;
+			int highValue = high[c] | highPBit;
+			pixels[i][c] = static_cast<unsigned char>(((64 - weight) * lowValue + weight * highValue + 32) >> 6);
+		}
+	}
+}
+
+// BC6H ( mode 11, unsigned ) //
+// Endpoints get fitted on the bit patterns of half floats, which are close to logarithmic.
+// That's also the space the hardware interpolates in.
+
+static const float halfMaximum = 31743.0f; // 0x7BFF, the largest finite half
+
+static unsigned short FloatToHalfBits(float value)
+{
+	// Unsigned format, negative values & NaNs become 0 //
+	if(!(value > 0.0f))
+	{
+		return 0;
+	}
+
+	return std::min(glm::packHalf1x16(value), static_cast<glm::uint16>(0x7BFF));
+}
+
+static float HalfBitsToFloat(unsigned short bits)
+{
+	return glm::unpackHalf1x16(bits);
+}
+
+static void LoadHDRBlock(const float* pixels, int width, int height, int blockX, int blockY, BlockPixels& block)
+{
+	for(int y = 0; y < 4; y++)
+	{
+		int sourceY = std::min(blockY * 4 + y, height - 1);
+
+		for(int x = 0; x < 4; x++)
+		{
+			int sourceX = std::min(blockX * 4 + x, width - 1);
+			const float* pixel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+
+			for(int c = 0; c < 3; c++)
+			{
+				block.Channels[c][y * 4 + x] = FloatToHalfBits(pixel[c]);
+			}
+
+			block.Channels[3][y * 4 + x] = 0.0f;
+		}
+	}
+
+	block.Maximum = halfMaximum;
+}
+
+// Follows the unquantization of the spec, so the encoder sees exactly what the GPU decodes //
+static int UnquantizeBC6H(int value)
+{
+	if(value == 0)
+	{
+		return 0;
+	}
+
+	if(value == 1023)
+	{
+		return 0xFFFF;
+	}
+
+	return ((value << 16) + 0x8000) >> 10;
+}
+
+static int FinishBC6H(int value)
+{
+	return (value * 31) >> 6;
+}
+
+static void QuantizeBC6HEndpoint(const float* color, int* quantized)
+{
+	for(int c = 0; c < 3; c++)
+	{
+		// Everything but the extremes decodes to 31 * value + 15, so only neighbours need checking //
+		int estimate = static_cast<int>((color[c] - 15.0f) / 31.0f + 0.5f);
+		float bestError = 1e30f;
+
+		for(int candidate = std::max(estimate - 1, 0); candidate <= std::min(estimate + 1, 1023); candidate++)
+		{
+			float error = std::abs(static_cast<float>(FinishBC6H(UnquantizeBC6H(candidate))) - color[c]);
+			if(error < bestError)
+			{
+				bestError = error;
+				quantized[c] = candidate;
+			}
+		}
+	}
+}
+
+static float EvaluateBC6H(const BlockPixels& block, const float* low, const float* high,
+	int* lowQuantized, int* highQuantized, unsigned char* ordinals)
+{
+	QuantizeBC6HEndpoint(low, lowQuantized);
+	QuantizeBC6HEndpoint(high, highQuantized);
+
+	float palette[16][4];
+	for(int c = 0; c < 3; c++)
+	{
+		int lowValue = UnquantizeBC6H(lowQuantized[c]);
+		int highValue = UnquantizeBC6H(highQuantized[c]);
+
+		for(int k = 0; k < 16; k++)
+		{
+			int weight = bc7WeightsInteger[k];
+			palette[k][c] = static_cast<float>(FinishBC6H(((64 - weight) * lowValue + weight * highValue + 32) >> 6));
+		}
+	}
+
+	return AssignOrdinals(block, 0, 3, palette, 16, ordinals);
+}
+
+static void EncodeBC6H(const BlockPixels& block, const EncodeSettings& settings, unsigned char* output)
+{
+	float low[4];
+	float high[4];
+	FindEndpoints(block, 0, 3, settings.UsePrincipalAxis, low, high);
+
+	int bestLow[3];
+	int bestHigh[3];
+	unsigned char bestOrdinals[16];
+	float bestError = EvaluateBC6H(block, low, high, bestLow, bestHigh, bestOrdinals);
+
+	for(int iteration = 0; iteration < settings.RefineIterations; iteration++)
+	{
+		if(!RefineEndpoints(block, 0, 3, bestOrdinals, bc7Weights, low, high))
+		{
+			break;
+		}
+
+		int lowQuantized[3];
+		int highQuantized[3];
+		unsigned char ordinals[16];
+		float error = EvaluateBC6H(block, low, high, lowQuantized, highQuantized, ordinals);
+
+		if(error >= bestError)
+		{
+			break;
+		}
+
+		bestError = error;
+		memcpy(bestLow, lowQuantized, sizeof(lowQuantized));
+		memcpy(bestHigh, highQuantized, sizeof(highQuantized));
+		memcpy(bestOrdinals, ordinals, sizeof(ordinals));
+	}
+
+	// Same as BC7, the first index is stored without its highest bit //
+	if(bestOrdinals[0] >= 8)
+	{
+		std::swap(bestLow, bestHigh);
+
+		for(int i = 0; i < 16; i++)
+		{
+			bestOrdinals[i] = 15 - bestOrdinals[i];
+		}
+	}
+
+	memset(output, 0, 16);
+	BitWriter writer = { output, 0 };
+	writer.Write(0x03, 5);
+
+	for(int c = 0; c < 3; c++)
+	{
+		writer.Write(bestLow[c], 10);
+	}
+
+	for(int c = 0; c < 3; c++)
+	{
+		writer.Write(bestHigh[c], 10);
+	}
+
+	for(int i = 0; i < 16; i++)
+	{
+		writer.Write(bestOrdinals[i], i == 0 ? 3 : 4);
+	}
+}
+
+static void DecodeBC6H(const unsigned char* input, float pixels[16][4])
+{
+	int position = 0;
+	if(ReadBits(input, position, 5) != 0x03)
+	{
+		assert(false && "Only BC6H mode 11 blocks can be decoded.");
+		memset(pixels, 0, 16 * 4 * sizeof(float));
+		return;
+	}
+
+	int low[3];
+	int high[3];
+	for(int c = 0; c < 3; c++)
+	{
+		low[c] = UnquantizeBC6H(ReadBits(input, position, 10));
+	}
+
+	for(int c = 0; c < 3; c++)
+	{
+		high[c] = UnquantizeBC6H(ReadBits(input, position, 10));
+	}
+
+	for(int i = 0; i < 16; i++)
+	{
+		int weight = bc7WeightsInteger[ReadBits(input, position, i == 0 ? 3 : 4)];
+
+		for(int c = 0; c < 3; c++)
+		{
+			int bits = FinishBC6H(((64 - weight) * low[c] + weight * high[c] + 32) >> 6);
+			pixels[i][c] = HalfBitsToFloat(static_cast<unsigned short>(bits));
+		}
+
+		pixels[i][3] = 1.0f;
+	}
+}
+
+// Formats //
+
+static int GetBlockBytes(TextureFormat format)
+{
+	switch(format)
+	{
+	case TextureFormat::BC1:
+	case TextureFormat::BC4:
+		return 8;
+	case TextureFormat::BC3:
+	case TextureFormat::BC5:
+	case TextureFormat::BC7:
+	case TextureFormat::BC6H:
+	case TextureFormat::RGBA32F:
+		return 16;
+	case TextureFormat::RGBA16F:
+		return 8;
+	default:
+		return 4;
+	}
+}
+
+// Uncompressed formats are treated as 1x1 blocks //
+static int GetBlockDimension(TextureFormat format)
+{
+	switch(format)
+	{
+	case TextureFormat::RGBA8:
+	case TextureFormat::RGBA16F:
+	case TextureFormat::RGBA32F:
+		return 1;
+	default:
+		return 4;
+	}
+}
+
+static void EncodeBlock(const BlockPixels& block, TextureFormat format, const EncodeSettings& settings, unsigned char* output)
+{
+	switch(format)
+	{
+	case TextureFormat::BC1:
+		EncodeBC1(block, settings, output);
+		break;
+	case TextureFormat::BC3:
+		EncodeBC4(block, 3, settings, output);
+		EncodeBC1(block, settings, output + 8);
+		break;
+	case TextureFormat::BC4:
+		EncodeBC4(block, 0, settings, output);
+		break;
+	case TextureFormat::BC5:
+		EncodeBC4(block, 0, settings, output);
+		EncodeBC4(block, 1, settings, output + 8);
+		break;
+	case TextureFormat::BC7:
+		EncodeBC7(block, settings, output);
+		break;
+	case TextureFormat::BC6H:
+		EncodeBC6H(block, settings, output);
+		break;
+	default:
+		assert(false && "Format isn't block compressed.");
+		break;
+	}
+}
+
+static void DecodeBlock(const unsigned char* input, TextureFormat format, unsigned char pixels[16][4])
+{
+	unsigned char values[16];
+
+	switch(format)
+	{
+	case TextureFormat::BC1:
+		DecodeBC1(input, false, pixels);
+		break;
+	case TextureFormat::BC3:
+		DecodeBC1(input + 8, true, pixels);
+		DecodeBC4(input, values);
+		for(int i = 0; i < 16; i++) { pixels[i][3] = values[i]; }
+		break;
+	case TextureFormat::BC4:
+		DecodeBC4(input, values);
+		for(int i = 0; i < 16; i++) { pixels[i][0] = values[i]; pixels[i][1] = 0; pixels[i][2] = 0; pixels[i][3] = 255; }
+		break;
+	case TextureFormat::BC5:
+		DecodeBC4(input, values);
+		for(int i = 0; i < 16; i++) { pixels[i][0] = values[i]; pixels[i][2] = 0; pixels[i][3] = 255; }
+		DecodeBC4(input + 8, values);
+		for(int i = 0; i < 16; i++) { pixels[i][1] = values[i]; }
+		break;
+	case TextureFormat::BC7:
+		DecodeBC7(input, pixels);
+		break;
+	default:
+		assert(false && "Format isn't block compressed.");
+		break;
+	}
+}
+
+// BlockCompressor //
+
+bool BlockCompressor::Compress(std::vector<unsigned char>& pixels, int width, int height, int mipCount,
+	TextureFormat format, CompressionQuality quality)
+{
+	if(format == TextureFormat::RGBA8)
+	{
+		return true;
+	}
+
+	if(IsHDRFormat(format))
+	{
+		assert(false && "HDR formats need to be created with CompressHDR.");
+		return false;
+	}
+
+	if(quality == CompressionQuality::None || !CanCompress(width, height))
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> blocks(GetLevelOffset(format, width, height, mipCount));
+
+	for(int level = 0; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+
+		const unsigned char* source = pixels.data() + MipGenerator::GetMipOffset(width, height, level) * 4;
+		CompressLevel(source, mipWidth, mipHeight, format, quality, blocks.data() + GetLevelOffset(format, width, height, level));
+	}
+
+	pixels.swap(blocks);
+	return true;
+}
+
+bool BlockCompressor::CompressHDR(const std::vector<float>& pixels, int width, int height, int mipCount,
+	TextureFormat format, CompressionQuality quality, std::vector<unsigned char>& output)
+{
+	if(!IsHDRFormat(format))
+	{
+		assert(false && "CompressHDR only creates HDR formats.");
+		return false;
+	}
+
+	if(format == TextureFormat::BC6H && (quality == CompressionQuality::None || !CanCompress(width, height)))
+	{
+		return false;
+	}
+
+	output.resize(GetLevelOffset(format, width, height, mipCount));
+
+	if(format == TextureFormat::RGBA32F)
+	{
+		memcpy(output.data(), pixels.data(), output.size());
+		return true;
+	}
+
+	for(int level = 0; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+
+		const float* source = pixels.data() + MipGenerator::GetMipOffset(width, height, level) * 4;
+		unsigned char* destination = output.data() + GetLevelOffset(format, width, height, level);
+
+		if(format == TextureFormat::BC6H)
+		{
+			CompressLevel(source, mipWidth, mipHeight, format, quality, destination);
+			continue;
+		}
+
+		// Half floats, converted per row on the pool since environments can have tens of millions of values //
+		ThreadPool::Get().ParallelFor(static_cast<unsigned int>(mipHeight), [&](unsigned int y)
+		{
+			size_t rowStart = static_cast<size_t>(y) * mipWidth * 4;
+			unsigned short* row = reinterpret_cast<unsigned short*>(destination) + rowStart;
+
+			for(size_t i = 0; i < static_cast<size_t>(mipWidth) * 4; i++)
+			{
+				row[i] = glm::packHalf1x16(source[rowStart + i]);
+			}
+		});
+	}
+
+	return true;
+}
+
+void BlockCompressor::Decompress(const unsigned char* blocks, int width, int height, TextureFormat format, unsigned char* pixels)
+{
+	if(format == TextureFormat::RGBA8)
+	{
+		memcpy(pixels, blocks, static_cast<size_t>(width) * height * 4);
+		return;
+	}
+
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	int blockBytes = GetBlockBytes(format);
+
+	for(int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for(int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			unsigned char decoded[16][4];
+			DecodeBlock(blocks + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockBytes, format, decoded);
+
+			for(int y = 0; y < 4 && blockY * 4 + y < height; y++)
+			{
+				for(int x = 0; x < 4 && blockX * 4 + x < width; x++)
+				{
+					size_t pixel = static_cast<size_t>(blockY * 4 + y) * width + (blockX * 4 + x);
+					memcpy(pixels + pixel * 4, decoded[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+}
+
+void BlockCompressor::DecompressHDR(const unsigned char* blocks, int width, int height, TextureFormat format, float* pixels)
+{
+	size_t pixelCount = static_cast<size_t>(width) * height;
+
+	if(format == TextureFormat::RGBA32F)
+	{
+		memcpy(pixels, blocks, pixelCount * 4 * sizeof(float));
+		return;
+	}
+
+	if(format == TextureFormat::RGBA16F)
+	{
+		const unsigned short* halves = reinterpret_cast<const unsigned short*>(blocks);
+		for(size_t i = 0; i < pixelCount * 4; i++)
+		{
+			pixels[i] = HalfBitsToFloat(halves[i]);
+		}
+
+		return;
+	}
+
+	assert(format == TextureFormat::BC6H && "DecompressHDR only decodes HDR formats.");
+
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+
+	for(int blockY = 0; blockY < blocksHigh; blockY++)
+	{
+		for(int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			float decoded[16][4];
+			DecodeBC6H(blocks + (static_cast<size_t>(blockY) * blocksWide + blockX) * 16, decoded);
+
+			for(int y = 0; y < 4 && blockY * 4 + y < height; y++)
+			{
+				for(int x = 0; x < 4 && blockX * 4 + x < width; x++)
+				{
+					size_t pixel = static_cast<size_t>(blockY * 4 + y) * width + (blockX * 4 + x);
+					memcpy(pixels + pixel * 4, decoded[y * 4 + x], 4 * sizeof(float));
+				}
+			}
+		}
+	}
+}
+
+bool BlockCompressor::CanCompress(int width, int height)
+{
+	return width > 0 && height > 0 && width % 4 == 0 && height % 4 == 0;
+}
+
+bool BlockCompressor::IsHDRFormat(TextureFormat format)
+{
+	return format == TextureFormat::RGBA16F || format == TextureFormat::RGBA32F || format == TextureFormat::BC6H;
+}
+
+int BlockCompressor::GetChannelCount(TextureFormat format)
+{
+	switch(format)
+	{
+	case TextureFormat::BC1:
+	case TextureFormat::BC6H:
+		return 3;
+	case TextureFormat::BC4:
+		return 1;
+	case TextureFormat::BC5:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+size_t BlockCompressor::GetRowPitch(TextureFormat format, int width)
+{
+	int dimension = GetBlockDimension(format);
+	return static_cast<size_t>((width + dimension - 1) / dimension) * GetBlockBytes(format);
+}
+
+size_t BlockCompressor::GetLevelSize(TextureFormat format, int width, int height)
+{
+	int dimension = GetBlockDimension(format);
+	return GetRowPitch(format, width) * ((height + dimension - 1) / dimension);
+}
+
+size_t BlockCompressor::GetLevelOffset(TextureFormat format, int width, int height, int level)
+{
+	size_t offset = 0;
+	for(int i = 0; i < level; i++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, i, mipWidth, mipHeight);
+		offset += GetLevelSize(format, mipWidth, mipHeight);
+	}
+
+	return offset;
+}
+
+float BlockCompressor::ComputePSNR(const unsigned char* reference, const unsigned char* pixels, size_t pixelCount, int channelCount)
+{
+	double squaredError = 0.0;
+	for(size_t i = 0; i < pixelCount; i++)
+	{
+		for(int c = 0; c < channelCount; c++)
+		{
+			double delta = static_cast<double>(reference[i * 4 + c]) - pixels[i * 4 + c];
+			squaredError += delta * delta;
+		}
+	}
+
+	double meanSquaredError = squaredError / (static_cast<double>(pixelCount) * channelCount);
+	if(meanSquaredError <= 0.0)
+	{
+		return 99.0f;
+	}
+
+	return static_cast<float>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+}
+
+void BlockCompressor::RunBenchmark(const std::vector<std::string>& imagePaths)
+{
+	const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3,
+		TextureFormat::BC4, TextureFormat::BC5, TextureFormat::BC7 };
+	const CompressionQuality qualities[] = { CompressionQuality::Fast,
+		CompressionQuality::Balanced, CompressionQuality::High };
+
+	if(imagePaths.empty())
+	{
+		LOG(Log::MessageType::Error, "No images passed to the compression benchmark.");
+		return;
+	}
+
+	for(const std::string& imagePath : imagePaths)
+	{
+		if(stbi_is_hdr(imagePath.c_str()))
+		{
+			RunHDRBenchmark(imagePath);
+			continue;
+		}
+
+		int width;
+		int height;
+		int channels;
+		unsigned char* buffer = stbi_load(imagePath.c_str(), &width, &height, &channels, 4);
+
+		if(!buffer)
+		{
+			LOG(Log::MessageType::Error, "Couldn't load '" + imagePath + "' for the compression benchmark.");
+			continue;
+		}
+
+		// Crop to whole blocks, so every format can be measured on the same pixels //
+		int croppedWidth = width & ~3;
+		int croppedHeight = height & ~3;
+		std::vector<unsigned char> source(static_cast<size_t>(croppedWidth) * croppedHeight * 4);
+
+		for(int y = 0; y < croppedHeight; y++)
+		{
+			memcpy(source.data() + static_cast<size_t>(y) * croppedWidth * 4,
+				buffer + static_cast<size_t>(y) * width * 4, static_cast<size_t>(croppedWidth) * 4);
+		}
+
+		stbi_image_free(buffer);
+
+		if(source.empty())
+		{
+			LOG(Log::MessageType::Error, "'" + imagePath + "' is smaller than a single block.");
+			continue;
+		}
+
+		LOG("Compression benchmark: '" + imagePath + "' ( " + std::to_string(croppedWidth) + "x" +
+			std::to_string(croppedHeight) + ", " + std::to_string(ThreadPool::Get().GetThreadCount()) + " threads )");
+
+		size_t pixelCount = static_cast<size_t>(croppedWidth) * croppedHeight;
+		std::vector<unsigned char> decoded(pixelCount * 4);
+
+		for(TextureFormat format : formats)
+		{
+			for(CompressionQuality quality : qualities)
+			{
+				std::vector<unsigned char> blocks = source;
+
+				auto startTime = std::chrono::high_resolution_clock::now();
+				Compress(blocks, croppedWidth, croppedHeight, 1, format, quality);
+				auto endTime = std::chrono::high_resolution_clock::now();
+
+				Decompress(blocks.data(), croppedWidth, croppedHeight, format, decoded.data());
+
+				float seconds = std::chrono::duration<float>(endTime - startTime).count();
+				float megapixelsPerSecond = static_cast<float>(pixelCount) / std::max(seconds, 1e-6f) / 1e6f;
+				float psnr = ComputePSNR(source.data(), decoded.data(), pixelCount, GetChannelCount(format));
+
+				char line[128];
+				snprintf(line, sizeof(line), "  %s %-8s - %6.2f dB, %8.2f MPixel/s",
+					GetFormatName(format), GetQualityName(quality), psnr, megapixelsPerSecond);
+				LOG(line);
+			}
+		}
+	}
+}
+
+void BlockCompressor::RunHDRBenchmark(const std::string& imagePath)
+{
+	int width;
+	int height;
+	int channels;
+	float* buffer = stbi_loadf(imagePath.c_str(), &width, &height, &channels, 4);
+
+	if(!buffer)
+	{
+		LOG(Log::MessageType::Error, "Couldn't load '" + imagePath + "' for the compression benchmark.");
+		return;
+	}
+
+	int croppedWidth = width & ~3;
+	int croppedHeight = height & ~3;
+	size_t pixelCount = static_cast<size_t>(croppedWidth) * croppedHeight;
+	std::vector<float> source(pixelCount * 4);
+
+	for(int y = 0; y < croppedHeight; y++)
+	{
+		memcpy(source.data() + static_cast<size_t>(y) * croppedWidth * 4,
+			buffer + static_cast<size_t>(y) * width * 4, static_cast<size_t>(croppedWidth) * 4 * sizeof(float));
+	}
+
+	stbi_image_free(buffer);
+
+	if(source.empty())
+	{
+		LOG(Log::MessageType::Error, "'" + imagePath + "' is smaller than a single block.");
+		return;
+	}
+
+	LOG("Compression benchmark: '" + imagePath + "' ( " + std::to_string(croppedWidth) + "x" +
+		std::to_string(croppedHeight) + ", HDR, PSNR measured on half float bits )");
+
+	struct Run
+	{
+		TextureFormat Format;
+		CompressionQuality Quality;
+	};
+
+	const Run runs[] = { { TextureFormat::RGBA16F, CompressionQuality::None },
+		{ TextureFormat::BC6H, CompressionQuality::Fast }, { TextureFormat::BC6H, CompressionQuality::Balanced },
+		{ TextureFormat::BC6H, CompressionQuality::High } };
+
+	std::vector<float> decoded(pixelCount * 4);
+
+	for(const Run& run : runs)
+	{
+		std::vector<unsigned char> blocks;
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		CompressHDR(source, croppedWidth, croppedHeight, 1, run.Format, run.Quality, blocks);
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		DecompressHDR(blocks.data(), croppedWidth, croppedHeight, run.Format, decoded.data());
+
+		// Errors in half float bits are roughly relative errors, which is what matters for HDR //
+		double squaredError = 0.0;
+		for(size_t i = 0; i < pixelCount; i++)
+		{
+			for(int c = 0; c < 3; c++)
+			{
+				double delta = static_cast<double>(FloatToHalfBits(source[i * 4 + c])) - FloatToHalfBits(decoded[i * 4 + c]);
+				squaredError += delta * delta;
+			}
+		}
+
+		double meanSquaredError = squaredError / (static_cast<double>(pixelCount) * 3.0);
+		float psnr = meanSquaredError <= 0.0 ? 99.0f :
+			static_cast<float>(10.0 * std::log10(halfMaximum * halfMaximum / meanSquaredError));
+
+		float seconds = std::chrono::duration<float>(endTime - startTime).count();
+		float megapixelsPerSecond = static_cast<float>(pixelCount) / std::max(seconds, 1e-6f) / 1e6f;
+
+		char line[128];
+		snprintf(line, sizeof(line), "  %-7s %-8s - %6.2f dB, %8.2f MPixel/s, %6.2f MB",
+			GetFormatName(run.Format), GetQualityName(run.Quality), psnr, megapixelsPerSecond, blocks.size() / (1024.0f * 1024.0f));
+		LOG(line);
+	}
+}
+
+const char* BlockCompressor::GetFormatName(TextureFormat format)
+{
+	switch(format)
+	{
+	case TextureFormat::BC1: return "BC1";
+	case TextureFormat::BC3: return "BC3";
+	case TextureFormat::BC4: return "BC4";
+	case TextureFormat::BC5: return "BC5";
+	case TextureFormat::BC7: return "BC7";
+	case TextureFormat::RGBA16F: return "RGBA16F";
+	case TextureFormat::RGBA32F: return "RGBA32F";
+	case TextureFormat::BC6H: return "BC6H";
+	default: return "RGBA8";
+	}
+}
+
+const char* BlockCompressor::GetQualityName(CompressionQuality quality)
+{
+	switch(quality)
+	{
+	case CompressionQuality::Fast: return "Fast";
+	case CompressionQuality::Balanced: return "Balanced";
+	case CompressionQuality::High: return "High";
+	default: return "None";
+	}
+}
+
+void BlockCompressor::CompressLevel(const void* pixels, int width, int height,
+	TextureFormat format, CompressionQuality quality, unsigned char* blocks)
+{
+	EncodeSettings settings = GetEncodeSettings(quality);
+
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	int blockBytes = GetBlockBytes(format);
+
+	// Every row of blocks is independent, so rows get spread over the pool //
+	ThreadPool::Get().ParallelFor(static_cast<unsigned int>(blocksHigh), [&](unsigned int blockY)
+	{
+		BlockPixels block;
+		unsigned char* output = blocks + static_cast<size_t>(blockY) * blocksWide * blockBytes;
+
+		for(int blockX = 0; blockX < blocksWide; blockX++)
+		{
+			if(format == TextureFormat::BC6H)
+			{
+				LoadHDRBlock(static_cast<const float*>(pixels), width, height, blockX, blockY, block);
+			}
+			else
+			{
+				LoadBlock(static_cast<const unsigned char*>(pixels), width, height, blockX, blockY, block);
+			}
+
+			EncodeBlock(block, format, settings, output + blockX * blockBytes);
+		}
+	});
+}
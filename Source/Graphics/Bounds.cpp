@@ -0,0 +1,157 @@
+#include "Graphics/Bounds.h"
+
+#include <algorithm>
+
+namespace
+{
+	const glm::vec3& GetPosition(const glm::vec3* positions, size_t index, size_t stride)
+	{
+		return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const unsigned char*>(positions) + index * stride);
+	}
+}
+
+BoundingBox ComputeBoundingBox(const glm::vec3* positions, size_t count, size_t stride)
+{
+	BoundingBox box;
+
+	for(size_t i = 0; i < count; i++)
+	{
+		const glm::vec3& position = GetPosition(positions, i, stride);
+		box.Min = glm::min(box.Min, position);
+		box.Max = glm::max(box.Max, position);
+	}
+
+	return box;
+}
+
+BoundingSphere ComputeBoundingSphere(const glm::vec3* positions, size_t count, const BoundingBox& box, size_t stride)
+{
+	BoundingSphere sphere;
+	if(!IsBoundingBoxValid(box))
+	{
+		return sphere;
+	}
+
+	sphere.Center = (box.Min + box.Max) * 0.5f;
+
+	float radiusSquared = 0.0f;
+	for(size_t i = 0; i < count; i++)
+	{
+		glm::vec3 offset = GetPosition(positions, i, stride) - sphere.Center;
+		radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+	}
+
+	sphere.Radius = sqrtf(radiusSquared);
+	return sphere;
+}
+
+BoundingBox MergeBoundingBoxes(const BoundingBox& a, const BoundingBox& b)
+{
+	BoundingBox box;
+	box.Min = glm::min(a.Min, b.Min);
+	box.Max = glm::max(a.Max, b.Max);
+
+	return box;
+}
+
+BoundingSphere MergeBoundingSpheres(const BoundingSphere& a, const BoundingSphere& b)
+{
+	glm::vec3 offset = b.Center - a.Center;
+	float distance = glm::length(offset);
+
+	// One already contains the other //
+	if(distance + b.Radius <= a.Radius)
+	{
+		return a;
+	}
+
+	if(distance + a.Radius <= b.Radius)
+	{
+		return b;
+	}
+
+	BoundingSphere sphere;
+	sphere.Radius = (distance + a.Radius + b.Radius) * 0.5f;
+	sphere.Center = a.Center + offset * ((sphere.Radius - a.Radius) / distance);
+
+	return sphere;
+}
+
+BoundingBox TransformBoundingBox(const BoundingBox& box, const glm::mat4& transform)
+{
+	if(!IsBoundingBoxValid(box))
+	{
+		return box;
+	}
+
+	// Transform the center, every axis of the matrix adds the absolute extents it contributes ( Arvo ) //
+	glm::vec3 center = (box.Min + box.Max) * 0.5f;
+	glm::vec3 extents = (box.Max - box.Min) * 0.5f;
+
+	glm::vec3 transformedCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+	glm::vec3 transformedExtents = glm::abs(glm::vec3(transform[0])) * extents.x +
+		glm::abs(glm::vec3(transform[1])) * extents.y + glm::abs(glm::vec3(transform[2])) * extents.z;
+
+	BoundingBox transformed;
+	transformed.Min = transformedCenter - transformedExtents;
+	transformed.Max = transformedCenter + transformedExtents;
+
+	return transformed;
+}
+
+BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const glm::mat4& transform)
+{
+	float scale = std::max(glm::length(glm::vec3(transform[0])),
+		std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+
+	BoundingSphere transformed;
+	transformed.Center = glm::vec3(transform * glm::vec4(sphere.Center, 1.0f));
+	transformed.Radius = sphere.Radius * scale;
+
+	return transformed;
+}
+
+bool IsBoundingBoxValid(const BoundingBox& box)
+{
+	return box.Min.x <= box.Max.x && box.Min.y <= box.Max.y && box.Min.z <= box.Max.z;
+}
+
+float GetSurfaceArea(const BoundingBox& box)
+{
+	if(!IsBoundingBoxValid(box))
+	{
+		return 0.0f;
+	}
+
+	glm::vec3 size = box.Max - box.Min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool Overlaps(const BoundingBox& a, const BoundingBox& b)
+{
+	return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x && a.Min.y <= b.Max.y && a.Max.y >= b.Min.y &&
+		a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+}
+
+bool Overlaps(const BoundingBox& box, const BoundingSphere& sphere)
+{
+	glm::vec3 closest = glm::clamp(sphere.Center, box.Min, box.Max);
+	glm::vec3 offset = closest - sphere.Center;
+
+	return IsBoundingBoxValid(box) && glm::dot(offset, offset) <= sphere.Radius * sphere.Radius;
+}
+
+bool IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+	float& distance)
+{
+	glm::vec3 t0 = (box.Min - origin) * inverseDirection;
+	glm::vec3 t1 = (box.Max - origin) * inverseDirection;
+	glm::vec3 entries = glm::min(t0, t1);
+	glm::vec3 exits = glm::max(t0, t1);
+
+	float enter = std::max(std::max(entries.x, entries.y), std::max(entries.z, 0.0f));
+	float exit = std::min(std::min(exits.x, exits.y), std::min(exits.z, maxDistance));
+
+	distance = enter;
+	return enter <= exit;
+}
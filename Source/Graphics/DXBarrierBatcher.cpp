@@ -0,0 +1,243 @@
+#include "Graphics/DXBarrierBatcher.h"
+
+#include "Utilities/Logger.h"
+
+#include <cassert>
+#include <d3dx12.h>
+
+void DXBarrierBatcher::Track(ID3D12Resource* resource, D3D12_RESOURCE_STATES state)
+{
+	TrackedResource trackedResource;
+	trackedResource.State = state;
+	trackedResource.SplitState = state;
+
+	resources[resource] = trackedResource;
+}
+
+void DXBarrierBatcher::Untrack(ID3D12Resource* resource)
+{
+	auto trackedResource = resources.find(resource);
+	if(trackedResource == resources.end())
+	{
+		return;
+	}
+
+	if(trackedResource->second.Splitting)
+	{
+		assert(false && "Resource stopped being tracked in the middle of a split transition");
+	}
+
+	resources.erase(trackedResource);
+	pendingTransitions.erase(resource);
+}
+
+bool DXBarrierBatcher::IsTracked(ID3D12Resource* resource)
+{
+	return resources.find(resource) != resources.end();
+}
+
+D3D12_RESOURCE_STATES DXBarrierBatcher::GetState(ID3D12Resource* resource)
+{
+	TrackedResource* trackedResource = GetTrackedResource(resource);
+	if(!trackedResource)
+	{
+		return D3D12_RESOURCE_STATE_COMMON;
+	}
+
+	return trackedResource->Splitting ? trackedResource->SplitState : trackedResource->State;
+}
+
+void DXBarrierBatcher::Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state)
+{
+	TrackedResource* trackedResource = GetTrackedResource(resource);
+	if(!trackedResource)
+	{
+		return;
+	}
+
+	if(trackedResource->Splitting)
+	{
+		assert(false && "Resource is in the middle of a split transition, end it before transitioning again");
+		return;
+	}
+
+	statistics.Requested++;
+	if(trackedResource->State == state)
+	{
+		return;
+	}
+
+	// Merge with the transition queued for this resource earlier in the batch //
+	auto queued = pendingTransitions.find(resource);
+	if(queued != pendingTransitions.end() && pending[queued->second].Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE)
+	{
+		D3D12_RESOURCE_TRANSITION_BARRIER& transition = pending[queued->second].Transition;
+		transition.StateAfter = state;
+
+		if(transition.StateBefore == state)
+		{
+			Erase(queued->second);
+		}
+
+		trackedResource->State = state;
+		return;
+	}
+
+	pendingTransitions[resource] = pending.size();
+	pending.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, trackedResource->State, state));
+	trackedResource->State = state;
+}
+
+void DXBarrierBatcher::BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state)
+{
+	TrackedResource* trackedResource = GetTrackedResource(resource);
+	if(!trackedResource)
+	{
+		return;
+	}
+
+	if(trackedResource->Splitting)
+	{
+		assert(false && "Resource is already in the middle of a split transition");
+		return;
+	}
+
+	statistics.Requested++;
+	trackedResource->Splitting = true;
+	trackedResource->SplitState = state;
+
+	// Nothing to do, EndTransition won't record anything either //
+	if(trackedResource->State == state)
+	{
+		return;
+	}
+
+	pendingTransitions[resource] = pending.size();
+	pending.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, trackedResource->State, state,
+		D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY));
+}
+
+void DXBarrierBatcher::EndTransition(ID3D12Resource* resource)
+{
+	TrackedResource* trackedResource = GetTrackedResource(resource);
+	if(!trackedResource)
+	{
+		return;
+	}
+
+	if(!trackedResource->Splitting)
+	{
+		assert(false && "Ending a split transition that never began");
+		return;
+	}
+
+	trackedResource->Splitting = false;
+	if(trackedResource->State == trackedResource->SplitState)
+	{
+		return;
+	}
+
+	// Beginning & ending in the same batch is just a regular transition //
+	auto queued = pendingTransitions.find(resource);
+	if(queued != pendingTransitions.end() && pending[queued->second].Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+	{
+		pending[queued->second].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	}
+	else
+	{
+		pendingTransitions[resource] = pending.size();
+		pending.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, trackedResource->State, trackedResource->SplitState,
+			D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY));
+	}
+
+	trackedResource->State = trackedResource->SplitState;
+}
+
+void DXBarrierBatcher::Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after)
+{
+	statistics.Requested++;
+	if(before == after)
+	{
+		return;
+	}
+
+	pending.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, before, after));
+}
+
+void DXBarrierBatcher::Aliasing(ID3D12Resource* before, ID3D12Resource* after)
+{
+	// Transitions queued before this barrier can't be merged with ones after it //
+	pendingTransitions.erase(before);
+	pendingTransitions.erase(after);
+
+	statistics.Requested++;
+	pending.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(before, after));
+}
+
+void DXBarrierBatcher::UAV(ID3D12Resource* resource)
+{
+	pendingTransitions.erase(resource);
+
+	statistics.Requested++;
+	pending.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+}
+
+void DXBarrierBatcher::Flush(ID3D12GraphicsCommandList* commandList)
+{
+	if(pending.empty())
+	{
+		return;
+	}
+
+	commandList->ResourceBarrier(static_cast<UINT>(pending.size()), pending.data());
+
+	statistics.Recorded += static_cast<unsigned int>(pending.size());
+	statistics.Calls++;
+
+	pending.clear();
+	pendingTransitions.clear();
+}
+
+BarrierStatistics DXBarrierBatcher::GetStatistics()
+{
+	return statistics;
+}
+
+void DXBarrierBatcher::ResetStatistics()
+{
+	statistics = BarrierStatistics();
+}
+
+DXBarrierBatcher::TrackedResource* DXBarrierBatcher::GetTrackedResource(ID3D12Resource* resource)
+{
+	auto trackedResource = resources.find(resource);
+	if(trackedResource == resources.end())
+	{
+		LOG(Log::MessageType::Error, "Resource isn't tracked by the barrier batcher, its current state is unknown!");
+		assert(false);
+		return nullptr;
+	}
+
+	return &trackedResource->second;
+}
+
+void DXBarrierBatcher::Erase(size_t index)
+{
+	pending.erase(pending.begin() + index);
+
+	for(auto queued = pendingTransitions.begin(); queued != pendingTransitions.end();)
+	{
+		if(queued->second == index)
+		{
+			queued = pendingTransitions.erase(queued);
+			continue;
+		}
+
+		if(queued->second > index)
+		{
+			queued->second--;
+		}
+
+		queued++;
+	}
+}
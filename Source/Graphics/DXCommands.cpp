@@ -6,7 +6,8 @@
 #include <cassert>
 #include <chrono>
 
-DXCommands::DXCommands(D3D12_COMMAND_LIST_TYPE type, unsigned int commandAllocatorCount) : commandAllocatorCount(commandAllocatorCount)
+DXCommands::DXCommands(D3D12_COMMAND_LIST_TYPE type, unsigned int commandAllocatorCount) :
+	type(type), commandAllocatorCount(commandAllocatorCount)
 {
 	if(commandAllocatorCount == 0)
 	{
@@ -21,10 +22,9 @@ DXCommands::DXCommands(D3D12_COMMAND_LIST_TYPE type, unsigned int commandAllocat
 	}
 
 	device = DXAccess::GetDevice();
+	commandAllocators.resize(commandAllocatorCount);
 
-	CreateCommandQueue(type);
-	CreateCommandAllocators();
-	CreateCommandList();
+	CreateCommandQueue();
 	CreateSynchronizationObjects();
 }
 
@@ -38,8 +38,8 @@ void DXCommands::ExecuteCommandList(int allocatorIndex)
 {
 	ThrowIfFailed(commandList->Close());
 
-	ID3D12CommandList* const commandLists[] = { commandList.Get() };
-	commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+	commandQueue->ExecuteCommandLists(static_cast<UINT>(submission.size()), submission.data());
+	submission.clear();
 
 	Signal();
 	frameFenceValues[allocatorIndex] = fenceValue;
@@ -47,8 +47,51 @@ void DXCommands::ExecuteCommandList(int allocatorIndex)
 
 void DXCommands::ResetCommandList(int allocatorIndex)
 {
-	commandAllocators[allocatorIndex]->Reset();
-	commandList->Reset(commandAllocators[allocatorIndex].Get(), nullptr);
+	// The GPU is done with everything recorded with this frame's allocators //
+	currentAllocator = allocatorIndex;
+	openedListCount = 0;
+	submission.clear();
+
+	for(ComPtr<ID3D12CommandAllocator>& commandAllocator : commandAllocators[allocatorIndex])
+	{
+		commandAllocator->Reset();
+	}
+
+	commandList = OpenCommandList();
+}
+
+const std::vector<ID3D12GraphicsCommandList2*>& DXCommands::BeginParallelLists(unsigned int count)
+{
+	if(!parallelLists.empty())
+	{
+		assert(false && "Parallel lists have to end before new ones can begin");
+	}
+
+	// Everything recorded so far has to execute before the parallel lists //
+	ThrowIfFailed(commandList->Close());
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		parallelLists.push_back(OpenCommandList());
+	}
+
+	return parallelLists;
+}
+
+void DXCommands::EndParallelLists()
+{
+	for(ID3D12GraphicsCommandList2* parallelList : parallelLists)
+	{
+		ThrowIfFailed(parallelList->Close());
+	}
+
+	parallelLists.clear();
+	commandList = OpenCommandList();
+}
+
+void DXCommands::SetListInitializer(const std::function<void(ID3D12GraphicsCommandList2*)>& initializer)
+{
+	listInitializer = initializer;
 }
 
 void DXCommands::Signal()
@@ -77,6 +120,11 @@ void DXCommands::WaitForFenceValue(unsigned int allocatorIndex)
 	}
 }
 
+bool DXCommands::IsFenceValueComplete(unsigned int allocatorIndex)
+{
+	return fence->GetCompletedValue() >= frameFenceValues[allocatorIndex];
+}
+
 ComPtr<ID3D12CommandQueue> DXCommands::GetCommandQueue()
 {
 	return commandQueue;
@@ -95,7 +143,7 @@ ComPtr<ID3D12GraphicsCommandList2> DXCommands::GetGraphicsCommandList()
 	return commandList;
 }
 
-void DXCommands::CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type)
+void DXCommands::CreateCommandQueue()
 {
 	D3D12_COMMAND_QUEUE_DESC description = {};
 	description.Type = type;
@@ -106,25 +154,39 @@ void DXCommands::CreateCommandQueue(D3D12_COMMAND_LIST_TYPE type)
 	ThrowIfFailed(device->CreateCommandQueue(&description, IID_PPV_ARGS(&commandQueue)));
 }
 
-void DXCommands::CreateCommandList()
+ID3D12GraphicsCommandList2* DXCommands::OpenCommandList()
 {
-	ComPtr<ID3D12CommandAllocator> commandAllocator = commandAllocators[0];
-	ThrowIfFailed(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList)));
+	unsigned int index = openedListCount++;
 
-	// Command List open in a recording state, since in our render loop we start with `Reset`
-	// we want to close the command list first so it can be properly reset.
-	ThrowIfFailed(commandList->Close());
-}
-
-void DXCommands::CreateCommandAllocators()
-{
-	for(int i = 0; i < commandAllocatorCount; i++)
+	if(index < commandLists.size())
+	{
+		ThrowIfFailed(commandLists[index]->Reset(commandAllocators[currentAllocator][index].Get(), nullptr));
+	}
+	else
 	{
-		ComPtr<ID3D12CommandAllocator> commandAllocator;
-		ThrowIfFailed(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator)));
+		// Every frame needs an allocator for the new list, lists are created open //
+		for(std::vector<ComPtr<ID3D12CommandAllocator>>& frameAllocators : commandAllocators)
+		{
+			ComPtr<ID3D12CommandAllocator> commandAllocator;
+			ThrowIfFailed(device->CreateCommandAllocator(type, IID_PPV_ARGS(&commandAllocator)));
+			frameAllocators.push_back(commandAllocator);
+		}
+
+		ComPtr<ID3D12GraphicsCommandList2> newList;
+		ThrowIfFailed(device->CreateCommandList(0, type, commandAllocators[currentAllocator][index].Get(),
+			nullptr, IID_PPV_ARGS(&newList)));
+		commandLists.push_back(newList);
+	}
+
+	ID3D12GraphicsCommandList2* list = commandLists[index].Get();
+	submission.push_back(list);
 
-		commandAllocators[i] = commandAllocator;
+	if(listInitializer)
+	{
+		listInitializer(list);
 	}
+
+	return list;
 }
 
 void DXCommands::CreateSynchronizationObjects()
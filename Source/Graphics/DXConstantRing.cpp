@@ -0,0 +1,134 @@
+#include "Graphics/DXConstantRing.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXUtilities.h"
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+DXConstantRing::DXConstantRing(unsigned int frameCount, unsigned int frameSize) : frameCount(frameCount)
+{
+	// Every region starts aligned, so aligning offsets within a region is enough //
+	this->frameSize = (frameSize + Alignment - 1) & ~(Alignment - 1);
+
+	ComPtr<ID3D12Device2> device = DXAccess::GetDevice();
+	CD3DX12_HEAP_PROPERTIES uploadHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC bufferDescription = CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(this->frameSize) * frameCount);
+
+	ThrowIfFailed(device->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE,
+		&bufferDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&buffer)));
+
+	// Stays mapped for its whole lifetime, the CPU only ever writes to it //
+	CD3DX12_RANGE readRange(0, 0);
+	ThrowIfFailed(buffer->Map(0, &readRange, reinterpret_cast<void**>(&mappedData)));
+	gpuAddress = buffer->GetGPUVirtualAddress();
+
+	overflowPages.resize(frameCount);
+}
+
+DXConstantRing::~DXConstantRing()
+{
+	buffer->Unmap(0, nullptr);
+
+	for(std::vector<OverflowPage>& pages : overflowPages)
+	{
+		for(OverflowPage& page : pages)
+		{
+			page.Buffer->Unmap(0, nullptr);
+		}
+	}
+}
+
+void DXConstantRing::BeginFrame(unsigned int frameIndex)
+{
+	if(frameIndex >= frameCount)
+	{
+		LOG(Log::MessageType::Error, "Frame index exceeds the amount of frames in the constant ring: " + std::to_string(frameIndex));
+		assert(false && "Frame index exceeds the amount of frames in the constant ring");
+		return;
+	}
+
+	this->frameIndex = frameIndex;
+	frameStart = frameIndex * frameSize;
+	frameOffset = 0;
+
+	// The GPU is done with the last frame that used this region, so also with its overflow //
+	for(OverflowPage& page : overflowPages[frameIndex])
+	{
+		page.Buffer->Unmap(0, nullptr);
+	}
+	overflowPages[frameIndex].clear();
+}
+
+ConstantAllocation DXConstantRing::Allocate(unsigned int size)
+{
+	unsigned int alignedSize = (size + Alignment - 1) & ~(Alignment - 1);
+
+	if(frameOffset + alignedSize > frameSize)
+	{
+		return AllocateOverflow(alignedSize);
+	}
+
+	ConstantAllocation allocation;
+	allocation.CPU = mappedData + frameStart + frameOffset;
+	allocation.GPU = gpuAddress + frameStart + frameOffset;
+
+	frameOffset += alignedSize;
+	return allocation;
+}
+
+ConstantAllocation DXConstantRing::AllocateOverflow(unsigned int alignedSize)
+{
+	std::vector<OverflowPage>& pages = overflowPages[frameIndex];
+
+	if(pages.empty() || pages.back().Offset + alignedSize > pages.back().Size)
+	{
+		// Reported once per frame, the region should be made large enough for a regular frame //
+		if(pages.empty())
+		{
+			LOG(Log::MessageType::Debug, "Constant ring ran out of memory for this frame, using an overflow buffer. Frame size: " +
+				std::to_string(frameSize) + " bytes");
+		}
+
+		OverflowPage page;
+		page.Size = std::max(alignedSize, frameSize);
+
+		CD3DX12_HEAP_PROPERTIES uploadHeapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		CD3DX12_RESOURCE_DESC bufferDescription = CD3DX12_RESOURCE_DESC::Buffer(page.Size);
+
+		ThrowIfFailed(DXAccess::GetDevice()->CreateCommittedResource(&uploadHeapProperties, D3D12_HEAP_FLAG_NONE,
+			&bufferDescription, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&page.Buffer)));
+
+		CD3DX12_RANGE readRange(0, 0);
+		ThrowIfFailed(page.Buffer->Map(0, &readRange, reinterpret_cast<void**>(&page.CPU)));
+		page.GPU = page.Buffer->GetGPUVirtualAddress();
+
+		pages.push_back(page);
+	}
+
+	OverflowPage& page = pages.back();
+
+	ConstantAllocation allocation;
+	allocation.CPU = page.CPU + page.Offset;
+	allocation.GPU = page.GPU + page.Offset;
+
+	page.Offset += alignedSize;
+	return allocation;
+}
+
+unsigned int DXConstantRing::GetUsedSize()
+{
+	unsigned int usedSize = frameOffset;
+	for(const OverflowPage& page : overflowPages[frameIndex])
+	{
+		usedSize += page.Offset;
+	}
+
+	return usedSize;
+}
+
+unsigned int DXConstantRing::GetFrameSize()
+{
+	return frameSize;
+}
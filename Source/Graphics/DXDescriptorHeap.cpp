@@ -4,12 +4,14 @@
 
 #include <cassert>
 
-DXDescriptorHeap::DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, unsigned int numberOfDescriptors, D3D12_DESCRIPTOR_HEAP_FLAGS flags) 
-	: descriptorCount(numberOfDescriptors)
+DXDescriptorHeap::DXDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE type, unsigned int numberOfDescriptors, D3D12_DESCRIPTOR_HEAP_FLAGS flags,
+	unsigned int transientDescriptors, unsigned int frameCount) : allocator(numberOfDescriptors, transientDescriptors, frameCount)
 {
+	isShaderVisible = (flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) != 0;
+
 	ComPtr<ID3D12Device2> device = DXAccess::GetDevice();
 	D3D12_DESCRIPTOR_HEAP_DESC description = {};
-	description.NumDescriptors = numberOfDescriptors;
+	description.NumDescriptors = allocator.GetDescriptorCount();
 	description.Type = type;
 	description.Flags = flags;
 
@@ -39,13 +41,45 @@ CD3DX12_GPU_DESCRIPTOR_HANDLE DXDescriptorHeap::GetGPUHandleAt(unsigned int inde
 
 unsigned int DXDescriptorHeap::GetNextAvailableIndex()
 {
-	if(currentDescriptorIndex >= descriptorCount)
+	return AllocateRange(1);
+}
+
+unsigned int DXDescriptorHeap::AllocateRange(unsigned int count)
+{
+	unsigned int index = allocator.Allocate(count);
+	if(index == DescriptorAllocator::InvalidIndex)
 	{
 		assert(false && "Descriptor count within heap has been exceeded!");
 		return 0;
 	}
 
-	unsigned int index = currentDescriptorIndex;
-	currentDescriptorIndex++;
 	return index;
 }
+
+void DXDescriptorHeap::Free(unsigned int index)
+{
+	// CPU only heaps are read when the command gets recorded, so those can be reused right away //
+	if(isShaderVisible)
+	{
+		allocator.Free(index);
+	}
+	else
+	{
+		allocator.FreeImmediate(index);
+	}
+}
+
+void DXDescriptorHeap::BeginFrame(unsigned int frameIndex)
+{
+	allocator.BeginFrame(frameIndex);
+}
+
+unsigned int DXDescriptorHeap::AllocateTransient(unsigned int count)
+{
+	return allocator.AllocateTransient(count);
+}
+
+DescriptorAllocatorStatistics DXDescriptorHeap::GetStatistics()
+{
+	return allocator.GetStatistics();
+}
@@ -0,0 +1,277 @@
+#include "Graphics/DXFrameGraph.h"
+#include "Graphics/DXCommands.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXBarrierBatcher.h"
+#include "Graphics/DXUtilities.h"
+#include "Graphics/RenderStage.h"
+
+#include <cassert>
+
+namespace
+{
+	D3D12_RESOURCE_STATES GetResourceState(ResourceUsage usage)
+	{
+		switch(usage)
+		{
+		case ResourceUsage::RenderTarget:
+			return D3D12_RESOURCE_STATE_RENDER_TARGET;
+		case ResourceUsage::DepthWrite:
+			return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+		case ResourceUsage::DepthRead:
+			return D3D12_RESOURCE_STATE_DEPTH_READ;
+		case ResourceUsage::ShaderResource:
+			return D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		case ResourceUsage::UnorderedAccess:
+			return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+		case ResourceUsage::CopySource:
+			return D3D12_RESOURCE_STATE_COPY_SOURCE;
+		case ResourceUsage::CopyDestination:
+			return D3D12_RESOURCE_STATE_COPY_DEST;
+		case ResourceUsage::Present:
+			return D3D12_RESOURCE_STATE_PRESENT;
+		default:
+			return D3D12_RESOURCE_STATE_COMMON;
+		}
+	}
+}
+
+unsigned int DXFrameGraph::ImportResource(const std::string& name, ID3D12Resource* resource, ResourceUsage usage)
+{
+	unsigned int index = graph.ImportResource(name, usage);
+
+	physicalResources.push_back(resource);
+	descriptions.push_back(D3D12_RESOURCE_DESC());
+	return index;
+}
+
+void DXFrameGraph::ExportResource(unsigned int resource)
+{
+	graph.ExportResource(resource);
+}
+
+unsigned int DXFrameGraph::CreateTexture(const std::string& name, const D3D12_RESOURCE_DESC& description)
+{
+	const D3D12_RESOURCE_FLAGS targetFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+	if((description.Flags & targetFlags) == 0)
+	{
+		assert(false && "Transient textures have to be render targets or depth buffers");
+	}
+
+	D3D12_RESOURCE_ALLOCATION_INFO info = DXAccess::GetDevice()->GetResourceAllocationInfo(0, 1, &description);
+	unsigned int index = graph.CreateTransient(name, info.SizeInBytes, info.Alignment);
+
+	physicalResources.push_back(nullptr);
+	descriptions.push_back(description);
+	return index;
+}
+
+void DXFrameGraph::AddStage(const std::string& name, RenderStage* stage, bool hasSideEffects)
+{
+	unsigned int pass = graph.AddPass(name, hasSideEffects);
+	stages.push_back(stage);
+
+	stage->DeclareResources(*this, pass);
+}
+
+void DXFrameGraph::Read(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	graph.Read(pass, resource, usage);
+}
+
+void DXFrameGraph::Write(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	graph.Write(pass, resource, usage);
+}
+
+void DXFrameGraph::ReadWrite(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	graph.ReadWrite(pass, resource, usage);
+}
+
+unsigned int DXFrameGraph::LookupResource(const std::string& name)
+{
+	unsigned int resource = graph.LookupResource(name);
+	if(resource == FrameGraph::InvalidIndex)
+	{
+		LOG(Log::MessageType::Error, "Frame graph resource '" + name + "' doesn't exist, is the stage that creates it added before?");
+		assert(false);
+	}
+
+	return resource;
+}
+
+void DXFrameGraph::Compile()
+{
+	graph.Compile();
+	CreateTransientTextures();
+
+	for(unsigned int i = 0; i < graph.GetPassCount(); i++)
+	{
+		if(graph.IsPassCulled(i))
+		{
+			LOG("Frame graph culled stage: " + graph.GetPassName(i));
+		}
+	}
+
+	compiled = true;
+}
+
+void DXFrameGraph::Execute(DXCommands* commands)
+{
+	if(!compiled)
+	{
+		assert(false && "Frame graph has to be compiled before it can be executed");
+		return;
+	}
+
+	DXBarrierBatcher* barriers = DXAccess::GetBarrierBatcher();
+
+	// 1. Imported resources are in the usage the graph expects at the start of every frame //
+	for(unsigned int i = 0; i < graph.GetResourceCount(); i++)
+	{
+		if(!graph.IsTransient(i) && physicalResources[i])
+		{
+			barriers->Track(physicalResources[i], GetResourceState(graph.GetInitialUsage(i)));
+		}
+	}
+
+	for(const CompiledPass& pass : graph.GetCompiledPasses())
+	{
+		// 2. Transitions for the whole level go in one call //
+		for(const FrameGraphBarrier& barrier : pass.Barriers)
+		{
+			QueueBarrier(barrier, barriers);
+		}
+
+		// 3. Record the stage itself, stages that record in parallel continue in another list afterwards //
+		ComPtr<ID3D12GraphicsCommandList2> commandList = commands->GetGraphicsCommandList();
+		barriers->Flush(commandList.Get());
+
+		stages[pass.Pass]->RecordStage(commandList);
+	}
+
+	// 4. Return everything to the state it's in outside of the frame, like presenting the screen buffer //
+	for(const FrameGraphBarrier& barrier : graph.GetFinalBarriers())
+	{
+		QueueBarrier(barrier, barriers);
+	}
+
+	barriers->Flush(commands->GetGraphicsCommandList().Get());
+
+	// 5. Window buffers rotate, so imported resources are only tracked while the graph executes //
+	for(unsigned int i = 0; i < graph.GetResourceCount(); i++)
+	{
+		if(!graph.IsTransient(i) && physicalResources[i])
+		{
+			barriers->Untrack(physicalResources[i]);
+		}
+	}
+}
+
+void DXFrameGraph::SetResource(unsigned int resource, ID3D12Resource* physicalResource)
+{
+	if(graph.IsTransient(resource))
+	{
+		assert(false && "Transient textures are owned by the frame graph");
+		return;
+	}
+
+	physicalResources[resource] = physicalResource;
+}
+
+ID3D12Resource* DXFrameGraph::GetResource(unsigned int resource)
+{
+	return physicalResources[resource];
+}
+
+FrameGraph& DXFrameGraph::GetGraph()
+{
+	return graph;
+}
+
+void DXFrameGraph::CreateTransientTextures()
+{
+	ComPtr<ID3D12Device2> device = DXAccess::GetDevice();
+	DXBarrierBatcher* barriers = DXAccess::GetBarrierBatcher();
+	uint64_t requiredSize = graph.GetTransientMemorySize();
+
+	for(ComPtr<ID3D12Resource>& texture : transientTextures)
+	{
+		barriers->Untrack(texture.Get());
+	}
+
+	transientTextures.clear();
+	if(requiredSize == 0)
+	{
+		return;
+	}
+
+	// 1. The heap only grows, recompiling with fewer transients keeps using the old one //
+	if(requiredSize > transientHeapSize)
+	{
+		D3D12_HEAP_DESC heapDescription = {};
+		heapDescription.SizeInBytes = requiredSize;
+		heapDescription.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDescription.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+		heapDescription.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+		transientHeap.Reset();
+		ThrowIfFailed(device->CreateHeap(&heapDescription, IID_PPV_ARGS(&transientHeap)));
+		transientHeapSize = requiredSize;
+	}
+
+	// 2. Textures are created in the usage of their first access, the graph returns them to it every frame //
+	for(unsigned int i = 0; i < graph.GetResourceCount(); i++)
+	{
+		if(!graph.IsTransient(i))
+		{
+			continue;
+		}
+
+		ComPtr<ID3D12Resource> texture;
+		ThrowIfFailed(device->CreatePlacedResource(transientHeap.Get(), graph.GetTransientOffset(i), &descriptions[i],
+			GetResourceState(graph.GetInitialUsage(i)), nullptr, IID_PPV_ARGS(&texture)));
+
+		physicalResources[i] = texture.Get();
+		transientTextures.push_back(texture);
+		barriers->Track(texture.Get(), GetResourceState(graph.GetInitialUsage(i)));
+	}
+}
+
+void DXFrameGraph::QueueBarrier(const FrameGraphBarrier& barrier, DXBarrierBatcher* barriers)
+{
+	ID3D12Resource* resource = physicalResources[barrier.Resource];
+	if(!resource)
+	{
+		LOG(Log::MessageType::Error, "Frame graph resource '" + graph.GetResourceName(barrier.Resource) + "' has no resource bound");
+		assert(false);
+		return;
+	}
+
+	if(barrier.Aliasing)
+	{
+		barriers->Aliasing(nullptr, resource);
+	}
+
+	// The batcher knows the actual state, the graph's expectation should always match it //
+	if(barrier.Split != BarrierSplit::End && barriers->GetState(resource) != GetResourceState(barrier.Before))
+	{
+		LOG(Log::MessageType::Error, "Frame graph resource '" + graph.GetResourceName(barrier.Resource) + "' isn't in the expected state");
+		assert(false);
+	}
+
+	switch(barrier.Split)
+	{
+	case BarrierSplit::Begin:
+		barriers->BeginTransition(resource, GetResourceState(barrier.After));
+		break;
+
+	case BarrierSplit::End:
+		barriers->EndTransition(resource);
+		break;
+
+	default:
+		barriers->Transition(resource, GetResourceState(barrier.After));
+		break;
+	}
+}
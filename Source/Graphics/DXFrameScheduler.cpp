@@ -0,0 +1,80 @@
+#include "Graphics/DXFrameScheduler.h"
+#include "Graphics/DXCommands.h"
+
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+DXFrameScheduler::DXFrameScheduler(DXCommands* commands, Window* window, unsigned int framesInFlight) :
+	commands(commands), window(window)
+{
+	SetFramesInFlight(framesInFlight);
+}
+
+unsigned int DXFrameScheduler::BeginFrame()
+{
+	statistics = FrameStatistics();
+	unsigned int frameIndex = GetFrameIndex();
+
+	for(unsigned int i = 1; i < MaxFramesInFlight && i <= frameNumber; i++)
+	{
+		if(!commands->IsFenceValueComplete((frameIndex + MaxFramesInFlight - i) % MaxFramesInFlight))
+		{
+			statistics.QueuedFrames++;
+		}
+	}
+
+	// 1. Don't queue presents beyond the latency budget, waiting here instead of after Present
+	// means input is read as late as possible //
+	auto latencyStart = std::chrono::high_resolution_clock::now();
+	window->WaitForFrameLatency();
+	auto latencyEnd = std::chrono::high_resolution_clock::now();
+
+	// 2. The frame 'framesInFlight' frames ago has to be done, since slots are reused in order this
+	// also covers the previous use of this frame's slot //
+	if(frameNumber >= framesInFlight)
+	{
+		commands->WaitForFenceValue(static_cast<unsigned int>((frameNumber - framesInFlight) % MaxFramesInFlight));
+	}
+
+	auto fenceEnd = std::chrono::high_resolution_clock::now();
+
+	statistics.LatencyWait = std::chrono::duration<float, std::milli>(latencyEnd - latencyStart).count();
+	statistics.FenceWait = std::chrono::duration<float, std::milli>(fenceEnd - latencyEnd).count();
+	return frameIndex;
+}
+
+void DXFrameScheduler::EndFrame()
+{
+	frameNumber++;
+}
+
+void DXFrameScheduler::SetFramesInFlight(unsigned int framesInFlight)
+{
+	if(framesInFlight == 0 || framesInFlight > MaxFramesInFlight)
+	{
+		LOG(Log::MessageType::Error, "Frames in flight has to be between 1 & " + std::to_string(MaxFramesInFlight));
+		assert(false);
+		framesInFlight = std::min(std::max(framesInFlight, 1u), MaxFramesInFlight);
+	}
+
+	this->framesInFlight = framesInFlight;
+	window->SetFrameLatency(framesInFlight);
+}
+
+unsigned int DXFrameScheduler::GetFramesInFlight()
+{
+	return framesInFlight;
+}
+
+unsigned int DXFrameScheduler::GetFrameIndex()
+{
+	return static_cast<unsigned int>(frameNumber % MaxFramesInFlight);
+}
+
+const FrameStatistics& DXFrameScheduler::GetStatistics()
+{
+	return statistics;
+}
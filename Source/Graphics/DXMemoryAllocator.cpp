@@ -0,0 +1,220 @@
+#include "Graphics/DXMemoryAllocator.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXUtilities.h"
+
+#include <cassert>
+
+DXMemoryAllocator::Pool::Pool(D3D12_HEAP_TYPE type, D3D12_HEAP_FLAGS flags, uint64_t granularity, uint64_t maxSizeClass) :
+	Allocator(HeapSize, granularity, maxSizeClass), Type(type), Flags(flags) { }
+
+DXMemoryAllocator::DXMemoryAllocator() :
+	bufferPool(D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, 256, 32 << 10),
+	uploadPool(D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, 0),
+	texturePool(D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT, 0)
+{
+	device = DXAccess::GetDevice();
+}
+
+BufferAllocation DXMemoryAllocator::AllocateBuffer(uint64_t size)
+{
+	// Vertex & index buffers only need 4 bytes, 256 also allows constant buffer views //
+	return AllocateBuffer(bufferPool, MemoryPool::Buffers, size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+}
+
+BufferAllocation DXMemoryAllocator::AllocateUpload(uint64_t size)
+{
+	// Copies into textures need their source data to be 512-byte aligned //
+	return AllocateBuffer(uploadPool, MemoryPool::Upload, size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+}
+
+void DXMemoryAllocator::FreeBuffer(BufferAllocation& allocation)
+{
+	if(!allocation.IsValid())
+	{
+		return;
+	}
+
+	if(allocation.Dedicated)
+	{
+		if(allocation.CPU)
+		{
+			allocation.Dedicated->Unmap(0, nullptr);
+		}
+	}
+	else
+	{
+		GetPool(allocation.Pool).Allocator.Free(allocation.Allocation);
+	}
+
+	allocation = BufferAllocation();
+}
+
+HeapAllocation DXMemoryAllocator::CreateTexture(const D3D12_RESOURCE_DESC& description, D3D12_RESOURCE_STATES state,
+	ComPtr<ID3D12Resource>& resource)
+{
+	HeapAllocation allocation;
+	D3D12_RESOURCE_DESC placedDescription = description;
+
+	// Render targets & depth buffers can't share a heap with other textures on every device //
+	const D3D12_RESOURCE_FLAGS committedFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+	if((description.Flags & committedFlags) == 0)
+	{
+		// 1. Small textures can use 4 KB alignment, the device tells whether this one qualifies //
+		placedDescription.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+		D3D12_RESOURCE_ALLOCATION_INFO info = device->GetResourceAllocationInfo(0, 1, &placedDescription);
+
+		if(info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+		{
+			placedDescription.Alignment = 0;
+			info = device->GetResourceAllocationInfo(0, 1, &placedDescription);
+		}
+
+		// 2. Place it, unless it's larger than a heap //
+		allocation = texturePool.Allocator.Allocate(info.SizeInBytes, info.Alignment);
+		if(allocation.IsValid())
+		{
+			CreateHeaps(texturePool);
+
+			ThrowIfFailed(device->CreatePlacedResource(texturePool.Heaps[allocation.Heap].Get(), allocation.Offset,
+				&placedDescription, state, nullptr, IID_PPV_ARGS(&resource)));
+
+			return allocation;
+		}
+	}
+
+	CD3DX12_HEAP_PROPERTIES heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	ThrowIfFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
+		&description, state, nullptr, IID_PPV_ARGS(&resource)));
+
+	dedicatedCount++;
+	dedicatedSize += device->GetResourceAllocationInfo(0, 1, &description).SizeInBytes;
+	return HeapAllocation();
+}
+
+void DXMemoryAllocator::FreeTexture(HeapAllocation& allocation)
+{
+	texturePool.Allocator.Free(allocation);
+	allocation = HeapAllocation();
+}
+
+HeapAllocatorStatistics DXMemoryAllocator::GetStatistics(MemoryPool pool)
+{
+	return GetPool(pool).Allocator.GetStatistics();
+}
+
+unsigned int DXMemoryAllocator::GetDedicatedCount()
+{
+	return dedicatedCount;
+}
+
+uint64_t DXMemoryAllocator::GetDedicatedSize()
+{
+	return dedicatedSize;
+}
+
+BufferAllocation DXMemoryAllocator::AllocateBuffer(Pool& pool, MemoryPool poolType, uint64_t size, uint64_t alignment)
+{
+	BufferAllocation allocation;
+	allocation.Pool = poolType;
+	allocation.Allocation = pool.Allocator.Allocate(size, alignment);
+
+	// Larger than a heap, so it gets a buffer of its own //
+	if(!allocation.Allocation.IsValid())
+	{
+		allocation.Dedicated = CreateDedicatedBuffer(pool.Type, size);
+		allocation.Resource = allocation.Dedicated.Get();
+		allocation.GPU = allocation.Resource->GetGPUVirtualAddress();
+
+		if(pool.Type == D3D12_HEAP_TYPE_UPLOAD)
+		{
+			CD3DX12_RANGE readRange(0, 0);
+			ThrowIfFailed(allocation.Resource->Map(0, &readRange, reinterpret_cast<void**>(&allocation.CPU)));
+		}
+
+		return allocation;
+	}
+
+	CreateHeaps(pool);
+
+	unsigned int heap = allocation.Allocation.Heap;
+	allocation.Resource = pool.Buffers[heap].Get();
+	allocation.Offset = allocation.Allocation.Offset;
+	allocation.GPU = allocation.Resource->GetGPUVirtualAddress() + allocation.Offset;
+
+	if(pool.MappedData[heap])
+	{
+		allocation.CPU = pool.MappedData[heap] + allocation.Offset;
+	}
+
+	return allocation;
+}
+
+ComPtr<ID3D12Resource> DXMemoryAllocator::CreateDedicatedBuffer(D3D12_HEAP_TYPE type, uint64_t size)
+{
+	ComPtr<ID3D12Resource> buffer;
+
+	// Any resource within the upload heap MUST be GENERIC_READ //
+	D3D12_RESOURCE_STATES state = type == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON;
+	CD3DX12_HEAP_PROPERTIES heapProperties = CD3DX12_HEAP_PROPERTIES(type);
+	CD3DX12_RESOURCE_DESC bufferDescription = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+	ThrowIfFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE,
+		&bufferDescription, state, nullptr, IID_PPV_ARGS(&buffer)));
+
+	dedicatedCount++;
+	dedicatedSize += size;
+	return buffer;
+}
+
+void DXMemoryAllocator::CreateHeaps(Pool& pool)
+{
+	while(pool.Heaps.size() < pool.Allocator.GetHeapCount())
+	{
+		D3D12_HEAP_DESC heapDescription = {};
+		heapDescription.SizeInBytes = HeapSize;
+		heapDescription.Properties = CD3DX12_HEAP_PROPERTIES(pool.Type);
+		heapDescription.Flags = pool.Flags;
+
+		ComPtr<ID3D12Heap> heap;
+		ThrowIfFailed(device->CreateHeap(&heapDescription, IID_PPV_ARGS(&heap)));
+		pool.Heaps.push_back(heap);
+
+		if(pool.Flags != D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS)
+		{
+			continue;
+		}
+
+		// Buffers behave as if they allow simultaneous access, so separate ranges of this single
+		// buffer can be written by the copy queue while the direct queue reads from others
+		ComPtr<ID3D12Resource> buffer;
+		D3D12_RESOURCE_STATES state = pool.Type == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON;
+		CD3DX12_RESOURCE_DESC bufferDescription = CD3DX12_RESOURCE_DESC::Buffer(HeapSize);
+
+		ThrowIfFailed(device->CreatePlacedResource(heap.Get(), 0, &bufferDescription, state, nullptr, IID_PPV_ARGS(&buffer)));
+		pool.Buffers.push_back(buffer);
+
+		// Upload heaps stay mapped, the CPU never reads from them //
+		unsigned char* mappedData = nullptr;
+		if(pool.Type == D3D12_HEAP_TYPE_UPLOAD)
+		{
+			CD3DX12_RANGE readRange(0, 0);
+			ThrowIfFailed(buffer->Map(0, &readRange, reinterpret_cast<void**>(&mappedData)));
+		}
+
+		pool.MappedData.push_back(mappedData);
+	}
+}
+
+DXMemoryAllocator::Pool& DXMemoryAllocator::GetPool(MemoryPool pool)
+{
+	switch(pool)
+	{
+	case MemoryPool::Upload:
+		return uploadPool;
+
+	case MemoryPool::Textures:
+		return texturePool;
+	}
+
+	return bufferPool;
+}
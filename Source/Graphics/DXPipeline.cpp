@@ -30,7 +30,7 @@ void DXPipeline::CompileShaders()
 	ComPtr<ID3DBlob> vertexError;
 	std::wstring vertexShaderPath(description.VertexPath.begin(), description.VertexPath.end());
 
-	D3DCompileFromFile(vertexShaderPath.c_str(), NULL, NULL, "main", "vs_5_1", 0, 0, &vertexShaderBlob, &vertexError);
+	D3DCompileFromFile(vertexShaderPath.c_str(), NULL, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "vs_5_1", 0, 0, &vertexShaderBlob, &vertexError);
 
 	if(!vertexError == NULL)
 	{
@@ -43,7 +43,7 @@ void DXPipeline::CompileShaders()
 	ComPtr<ID3DBlob> pixelError;
 	std::wstring pixelShaderPath(description.PixelPath.begin(), description.PixelPath.end());
 
-	D3DCompileFromFile(pixelShaderPath.c_str(), NULL, NULL, "main", "ps_5_1", 0, 0, &pixelShaderBlob, &pixelError);
+	D3DCompileFromFile(pixelShaderPath.c_str(), NULL, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", "ps_5_1", 0, 0, &pixelShaderBlob, &pixelError);
 
 	if(!pixelError == NULL)
 	{
@@ -74,6 +74,7 @@ void DXPipeline::CreatePipelineState()
 		CD3DX12_PIPELINE_STATE_STREAM_INPUT_LAYOUT InputLayout;
 		CD3DX12_PIPELINE_STATE_STREAM_RASTERIZER Rasterizer;
 		CD3DX12_PIPELINE_STATE_STREAM_BLEND_DESC Blending;
+		CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL DepthStencil;
 		CD3DX12_PIPELINE_STATE_STREAM_PRIMITIVE_TOPOLOGY PrimitiveTopologyType;
 		CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL_FORMAT DSVFormat;
 		CD3DX12_PIPELINE_STATE_STREAM_RENDER_TARGET_FORMATS RTVFormats;
@@ -92,7 +93,7 @@ void DXPipeline::CreatePipelineState()
 	D3D12_RENDER_TARGET_BLEND_DESC rtBlendDesc = {};
 	rtBlendDesc.BlendEnable = description.DoAlphaBlending;
 	rtBlendDesc.LogicOpEnable = false;
-	rtBlendDesc.SrcBlend = D3D12_BLEND_ONE;
+	rtBlendDesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
 	rtBlendDesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
 	rtBlendDesc.BlendOp = D3D12_BLEND_OP_ADD;
 	rtBlendDesc.SrcBlendAlpha = D3D12_BLEND_ONE;
@@ -106,10 +107,14 @@ void DXPipeline::CreatePipelineState()
 	blendDesc.IndependentBlendEnable = false;
 	blendDesc.RenderTarget[0] = rtBlendDesc;
 
+	CD3DX12_DEPTH_STENCIL_DESC depthStencilDesc(D3D12_DEFAULT);
+	depthStencilDesc.DepthWriteMask = description.DoDepthWrite ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+
 	PSS.RootSignature = description.RootSignature->GetAddress();
 	PSS.InputLayout = { inputLayout, _countof(inputLayout) };
 	PSS.Rasterizer = rasterizerDesc;
 	PSS.Blending = blendDesc;
+	PSS.DepthStencil = depthStencilDesc;
 	PSS.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 	PSS.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	PSS.RTVFormats = rtvFormats;
@@ -0,0 +1,209 @@
+#include "Graphics/DXUploadQueue.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXCommands.h"
+#include "Graphics/DXBarrierBatcher.h"
+#include "Graphics/DXUtilities.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+DXUploadQueue::DXUploadQueue(DXCommands* commands) : uploadQueue(this)
+{
+	device = DXAccess::GetDevice();
+	memoryAllocator = DXAccess::GetMemoryAllocator();
+	commandQueue = commands->GetCommandQueue();
+	type = commandQueue->GetDesc().Type;
+
+	// The list is created in a recording state, it gets closed right away so the first upload can reset it //
+	CreateCommandAllocator(recordingAllocator);
+	ThrowIfFailed(device->CreateCommandList(0, type, recordingAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList)));
+	ThrowIfFailed(commandList->Close());
+
+	ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+	fenceEvent = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+	assert(fenceEvent && "Failed to create Fence Event");
+}
+
+DXUploadQueue::~DXUploadQueue()
+{
+	uploadQueue.Flush();
+	CloseHandle(fenceEvent);
+}
+
+UploadTicket DXUploadQueue::UploadBuffer(const BufferAllocation& destination, const void* data, unsigned int size)
+{
+	if(!data)
+	{
+		LOG(Log::MessageType::Error, "Buffer data is NOT valid!");
+		assert(false);
+	}
+
+	// Allocating can submit the open batch, so the list is only grabbed afterwards //
+	UploadTicket ticket;
+	StagingBuffer staging = uploadQueue.Allocate(size, ticket);
+	memcpy(staging.Data, data, size);
+
+	DXStagingBuffer* stagingBuffer = static_cast<DXStagingBuffer*>(staging.Handle);
+	stagingBuffer->Destination = destination.Resource;
+
+	GetCommandList()->CopyBufferRegion(destination.Resource, destination.Offset,
+		stagingBuffer->Upload.Resource, stagingBuffer->Upload.Offset, size);
+	return ticket;
+}
+
+UploadTicket DXUploadQueue::UploadTexture(const ComPtr<ID3D12Resource>& destination, const D3D12_SUBRESOURCE_DATA* subresources,
+	unsigned int subresourceCount)
+{
+	UploadTicket ticket;
+	uint64_t size = GetRequiredIntermediateSize(destination.Get(), 0, subresourceCount);
+	StagingBuffer staging = uploadQueue.Allocate(size, ticket);
+
+	DXStagingBuffer* stagingBuffer = static_cast<DXStagingBuffer*>(staging.Handle);
+	stagingBuffer->Destination = destination;
+
+	// On a copy queue COMMON gets promoted to COPY_DEST & decays back once the batch has executed,
+	// other queue types need to do this explicitly so every texture leaves the upload in COMMON
+	ID3D12GraphicsCommandList2* list = GetCommandList();
+	CD3DX12_RESOURCE_BARRIER copyBarrier = CD3DX12_RESOURCE_BARRIER::Transition(destination.Get(),
+		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+	CD3DX12_RESOURCE_BARRIER commonBarrier = CD3DX12_RESOURCE_BARRIER::Transition(destination.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+
+	if(type != D3D12_COMMAND_LIST_TYPE_COPY)
+	{
+		list->ResourceBarrier(1, &copyBarrier);
+	}
+
+	// UpdateSubresources lays out every subresource with the footprints the device wants //
+	UpdateSubresources(list, destination.Get(), stagingBuffer->Upload.Resource, stagingBuffer->Upload.Offset,
+		0, subresourceCount, subresources);
+
+	if(type != D3D12_COMMAND_LIST_TYPE_COPY)
+	{
+		list->ResourceBarrier(1, &commonBarrier);
+	}
+
+	pendingTextures.push_back(destination);
+	return ticket;
+}
+
+void DXUploadQueue::Synchronize(ID3D12CommandQueue* waitingQueue, DXBarrierBatcher& barriers)
+{
+	// 1. Every pending upload is part of this submission, so the wait covers all of them //
+	UploadTicket ticket = uploadQueue.Submit();
+
+	if(!uploadQueue.IsComplete(ticket))
+	{
+		ThrowIfFailed(waitingQueue->Wait(fence.Get(), ticket.FenceValue));
+	}
+
+	// 2. Hand the textures over to the waiting queue, they decayed to COMMON after the copy queue //
+	for(ComPtr<ID3D12Resource>& texture : pendingTextures)
+	{
+		barriers.Transition(texture.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	}
+
+	handedOverTextures.swap(pendingTextures);
+	pendingTextures.clear();
+
+	uploadQueue.Retire();
+}
+
+void DXUploadQueue::RemovePendingTexture(ID3D12Resource* texture)
+{
+	pendingTextures.erase(std::remove_if(pendingTextures.begin(), pendingTextures.end(),
+		[texture](const ComPtr<ID3D12Resource>& pending) { return pending.Get() == texture; }), pendingTextures.end());
+}
+
+UploadQueue& DXUploadQueue::GetQueue()
+{
+	return uploadQueue;
+}
+
+StagingBuffer DXUploadQueue::CreateStaging(uint64_t size)
+{
+	DXStagingBuffer* stagingBuffer = new DXStagingBuffer();
+	stagingBuffer->Upload = memoryAllocator->AllocateUpload(size);
+
+	StagingBuffer staging;
+	staging.Handle = stagingBuffer;
+	staging.Data = stagingBuffer->Upload.CPU;
+	staging.Size = size;
+	return staging;
+}
+
+void DXUploadQueue::ReleaseStaging(StagingBuffer& staging)
+{
+	// Only called once the batch retired, so the copies out of it have finished //
+	DXStagingBuffer* stagingBuffer = static_cast<DXStagingBuffer*>(staging.Handle);
+	memoryAllocator->FreeBuffer(stagingBuffer->Upload);
+
+	delete stagingBuffer;
+	staging = StagingBuffer();
+}
+
+void DXUploadQueue::Submit(uint64_t fenceValue)
+{
+	if(isRecording)
+	{
+		ThrowIfFailed(commandList->Close());
+
+		ID3D12CommandList* const commandLists[] = { commandList.Get() };
+		commandQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+		submittedAllocators.push_back({ recordingAllocator, fenceValue });
+		recordingAllocator = nullptr;
+		isRecording = false;
+	}
+
+	ThrowIfFailed(commandQueue->Signal(fence.Get(), fenceValue));
+}
+
+uint64_t DXUploadQueue::GetCompletedValue()
+{
+	return fence->GetCompletedValue();
+}
+
+void DXUploadQueue::WaitForValue(uint64_t fenceValue)
+{
+	if(fence->GetCompletedValue() < fenceValue)
+	{
+		ThrowIfFailed(fence->SetEventOnCompletion(fenceValue, fenceEvent));
+		WaitForSingleObject(fenceEvent, static_cast<DWORD>(std::chrono::milliseconds::max().count()));
+	}
+}
+
+ID3D12GraphicsCommandList2* DXUploadQueue::GetCommandList()
+{
+	if(isRecording)
+	{
+		return commandList.Get();
+	}
+
+	// Allocators can only be reset once the GPU is done with the batch they recorded //
+	if(!recordingAllocator)
+	{
+		if(!submittedAllocators.empty() && submittedAllocators.front().FenceValue <= fence->GetCompletedValue())
+		{
+			recordingAllocator = submittedAllocators.front().Allocator;
+			submittedAllocators.pop_front();
+		}
+		else
+		{
+			CreateCommandAllocator(recordingAllocator);
+		}
+	}
+
+	ThrowIfFailed(recordingAllocator->Reset());
+	ThrowIfFailed(commandList->Reset(recordingAllocator.Get(), nullptr));
+	isRecording = true;
+
+	return commandList.Get();
+}
+
+void DXUploadQueue::CreateCommandAllocator(ComPtr<ID3D12CommandAllocator>& allocator)
+{
+	ThrowIfFailed(device->CreateCommandAllocator(type, IID_PPV_ARGS(&allocator)));
+}
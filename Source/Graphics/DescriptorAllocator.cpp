@@ -0,0 +1,156 @@
+#include "Graphics/DescriptorAllocator.h"
+
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+
+DescriptorAllocator::DescriptorAllocator(unsigned int persistentCount, unsigned int transientCount, unsigned int frameCount) :
+	persistentCount(persistentCount), transientCount(transientCount), frameCount(std::max(frameCount, 1u))
+{
+	if(persistentCount > 0)
+	{
+		freeRanges[0] = persistentCount;
+	}
+
+	pendingFrees.resize(this->frameCount);
+}
+
+unsigned int DescriptorAllocator::Allocate(unsigned int count)
+{
+	if(count == 0)
+	{
+		return InvalidIndex;
+	}
+
+	// First fit, ranges at the front get reused first, which keeps the back of the heap free for large tables //
+	for(auto range = freeRanges.begin(); range != freeRanges.end(); range++)
+	{
+		if(range->second < count)
+		{
+			continue;
+		}
+
+		unsigned int index = range->first;
+		unsigned int remaining = range->second - count;
+		freeRanges.erase(range);
+
+		if(remaining > 0)
+		{
+			freeRanges[index + count] = remaining;
+		}
+
+		allocatedRanges[index] = count;
+		allocatedCount += count;
+		return index;
+	}
+
+	return InvalidIndex;
+}
+
+void DescriptorAllocator::Free(unsigned int index)
+{
+	if(allocatedRanges.find(index) == allocatedRanges.end())
+	{
+		assert(false && "Freeing a descriptor range that isn't allocated");
+		return;
+	}
+
+	pendingFrees[currentFrame].push_back(index);
+}
+
+void DescriptorAllocator::FreeImmediate(unsigned int index)
+{
+	auto allocation = allocatedRanges.find(index);
+	if(allocation == allocatedRanges.end())
+	{
+		assert(false && "Freeing a descriptor range that isn't allocated");
+		return;
+	}
+
+	unsigned int count = allocation->second;
+	allocatedRanges.erase(allocation);
+	allocatedCount -= count;
+
+	// Merge with the free ranges on either side //
+	auto next = freeRanges.lower_bound(index);
+	if(next != freeRanges.end() && next->first == index + count)
+	{
+		count += next->second;
+		next = freeRanges.erase(next);
+	}
+
+	if(next != freeRanges.begin())
+	{
+		auto previous = std::prev(next);
+		if(previous->first + previous->second == index)
+		{
+			previous->second += count;
+			return;
+		}
+	}
+
+	freeRanges[index] = count;
+}
+
+void DescriptorAllocator::BeginFrame(unsigned int frameIndex)
+{
+	if(frameIndex >= frameCount)
+	{
+		assert(false && "Frame index exceeds the amount of frames in the descriptor allocator");
+	}
+
+	// Everything freed during the previous use of this frame is no longer referenced by the GPU //
+	for(unsigned int index : pendingFrees[frameIndex])
+	{
+		FreeImmediate(index);
+	}
+
+	pendingFrees[frameIndex].clear();
+	currentFrame = frameIndex;
+	transientOffset = 0;
+}
+
+unsigned int DescriptorAllocator::AllocateTransient(unsigned int count)
+{
+	if(transientOffset + count > transientCount)
+	{
+		LOG(Log::MessageType::Error, "Descriptor allocator ran out of transient descriptors for this frame!");
+		assert(false);
+		return InvalidIndex;
+	}
+
+	unsigned int index = persistentCount + currentFrame * transientCount + transientOffset;
+	transientOffset += count;
+	return index;
+}
+
+unsigned int DescriptorAllocator::GetDescriptorCount()
+{
+	return persistentCount + transientCount * frameCount;
+}
+
+DescriptorAllocatorStatistics DescriptorAllocator::GetStatistics()
+{
+	DescriptorAllocatorStatistics statistics;
+	statistics.PersistentCapacity = persistentCount;
+	statistics.PersistentAllocated = allocatedCount;
+	statistics.FreeRangeCount = static_cast<unsigned int>(freeRanges.size());
+	statistics.TransientCapacity = transientCount;
+	statistics.TransientAllocated = transientOffset;
+
+	for(const std::vector<unsigned int>& frees : pendingFrees)
+	{
+		for(unsigned int index : frees)
+		{
+			statistics.PendingFrees += allocatedRanges[index];
+		}
+	}
+
+	for(const auto& range : freeRanges)
+	{
+		statistics.LargestFreeRange = std::max(statistics.LargestFreeRange, range.second);
+	}
+
+	return statistics;
+}
@@ -0,0 +1,322 @@
+#include "Graphics/EnvironmentCache.h"
+#include "Graphics/MipGenerator.h"
+
+#include "Utilities/CacheFile.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Logger.h"
+#include "Utilities/MappedFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+// Layout of a cache file:
+// - EnvironmentHeader
+// - Source file: path, size, modification time, content hash
+// - Spherical harmonics irradiance coefficients
+// - Data size followed by the encoded mip chain
+// - SpecularHeader, data size followed by the encoded specular chain
+static const unsigned int environmentMagic = 0x4345564E; // 'NVEC'
+static const unsigned int environmentVersion = 3;
+
+static const unsigned int brdfMagic = 0x4C42564E; // 'NVBL'
+static const unsigned int brdfVersion = 1;
+
+struct EnvironmentHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	int Width;
+	int Height;
+
+	int MipCount;
+	TextureFormat Format;
+	CompressionQuality Quality;
+	unsigned int Padding;
+};
+
+struct SpecularHeader
+{
+	int Width;
+	int Height;
+	int MipCount;
+	TextureFormat Format;
+};
+
+struct BRDFHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	int Size;
+	int SampleCount;
+};
+
+EnvironmentCache::EnvironmentCache(const std::string& cacheDirectory) : cacheDirectory(cacheDirectory) {}
+
+bool EnvironmentCache::Load(const std::string& filePath, TextureFormat format, CompressionQuality quality, EnvironmentData& environment)
+{
+	std::string cachePath = GetCachePath(filePath);
+
+	std::error_code error;
+	if(!std::filesystem::exists(cachePath, error))
+	{
+		return false;
+	}
+
+	MappedFile cacheFile;
+	if(!cacheFile.Open(cachePath))
+	{
+		return false;
+	}
+
+	CacheReader reader(cacheFile.GetData(), cacheFile.GetSize());
+
+	// 1. Check if the entry matches the requested encoding //
+	EnvironmentHeader header;
+	if(!reader.Read(header) || header.Magic != environmentMagic || header.Version != environmentVersion)
+	{
+		LOG(Log::MessageType::Debug, "Cache entry has an outdated format: " + cachePath);
+		return false;
+	}
+
+	// Environments that can't be block compressed are stored as half floats instead //
+	bool isFallback = format == TextureFormat::BC6H && header.Format == TextureFormat::RGBA16F &&
+		!BlockCompressor::CanCompress(header.Width, header.Height);
+
+	if(header.Quality != quality || (header.Format != format && !isFallback))
+	{
+		LOG(Log::MessageType::Debug, "Cache entry uses a different encoding: " + cachePath);
+		return false;
+	}
+
+	// 2. Check if the source file is unchanged //
+	std::string sourcePath;
+	unsigned long long cachedSize;
+	long long cachedTime;
+	unsigned long long cachedHash;
+
+	if(!reader.ReadString(sourcePath) || !reader.Read(cachedSize) || !reader.Read(cachedTime) || !reader.Read(cachedHash) ||
+		sourcePath != filePath)
+	{
+		return false;
+	}
+
+	unsigned long long size;
+	long long time;
+	unsigned long long hash;
+	if(!GetFileInfo(sourcePath, size, time) || size != cachedSize ||
+		(time != cachedTime && (!HashFile(sourcePath, hash) || hash != cachedHash)))
+	{
+		LOG(Log::MessageType::Debug, "Cache entry is stale, source changed: " + sourcePath);
+		return false;
+	}
+
+	// 3. Read the encoded data, which has to match what the upload will read //
+	unsigned long long dataSize;
+	SpecularHeader specular;
+	unsigned long long specularSize;
+	EnvironmentData data;
+
+	bool result = reader.Read(data.Irradiance.Coefficients, sizeof(data.Irradiance.Coefficients)) &&
+		reader.Read(dataSize) && reader.ReadVector(data.Data, dataSize) &&
+		BlockCompressor::IsHDRFormat(header.Format) && header.Width > 0 && header.Height > 0 && header.MipCount >= 1 &&
+		header.MipCount <= MipGenerator::GetMipCount(header.Width, header.Height) &&
+		dataSize == BlockCompressor::GetLevelOffset(header.Format, header.Width, header.Height, header.MipCount);
+
+	result = result && reader.Read(specular) && reader.Read(specularSize) && reader.ReadVector(data.Specular, specularSize) &&
+		BlockCompressor::IsHDRFormat(specular.Format) && specular.Width > 0 && specular.Height > 0 && specular.MipCount >= 1 &&
+		specular.MipCount <= MipGenerator::GetMipCount(specular.Width, specular.Height) &&
+		specularSize == BlockCompressor::GetLevelOffset(specular.Format, specular.Width, specular.Height, specular.MipCount);
+
+	if(!result)
+	{
+		LOG(Log::MessageType::Error, "Cache entry is corrupt: " + cachePath);
+		return false;
+	}
+
+	data.Width = header.Width;
+	data.Height = header.Height;
+	data.MipCount = header.MipCount;
+	data.Format = header.Format;
+	data.Quality = header.Quality;
+	data.SpecularWidth = specular.Width;
+	data.SpecularHeight = specular.Height;
+	data.SpecularMipCount = specular.MipCount;
+	data.SpecularFormat = specular.Format;
+	environment = std::move(data);
+
+	return true;
+}
+
+bool EnvironmentCache::Store(const std::string& filePath, const EnvironmentData& environment)
+{
+	std::string cachePath = GetCachePath(filePath);
+	std::string temporaryPath = cachePath + ".tmp";
+
+	unsigned long long size;
+	long long time;
+	unsigned long long hash;
+	if(!GetFileInfo(filePath, size, time) || !HashFile(filePath, hash))
+	{
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(cacheDirectory, error);
+
+	// Write to a temporary file first, so an interrupted write never leaves a broken entry behind //
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to create cache entry: " + cachePath);
+			return false;
+		}
+
+		EnvironmentHeader header;
+		header.Magic = environmentMagic;
+		header.Version = environmentVersion;
+		header.Width = environment.Width;
+		header.Height = environment.Height;
+		header.MipCount = environment.MipCount;
+		header.Format = environment.Format;
+		header.Quality = environment.Quality;
+		header.Padding = 0;
+		Write(file, header);
+
+		WriteString(file, filePath);
+		Write(file, size);
+		Write(file, time);
+		Write(file, hash);
+
+		Write(file, environment.Irradiance.Coefficients);
+
+		Write(file, static_cast<unsigned long long>(environment.Data.size()));
+		file.write(reinterpret_cast<const char*>(environment.Data.data()), environment.Data.size());
+
+		SpecularHeader specular;
+		specular.Width = environment.SpecularWidth;
+		specular.Height = environment.SpecularHeight;
+		specular.MipCount = environment.SpecularMipCount;
+		specular.Format = environment.SpecularFormat;
+		Write(file, specular);
+
+		Write(file, static_cast<unsigned long long>(environment.Specular.size()));
+		file.write(reinterpret_cast<const char*>(environment.Specular.data()), environment.Specular.size());
+
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to write cache entry: " + cachePath);
+			file.close();
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if(error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+bool EnvironmentCache::LoadBRDF(int size, int sampleCount, std::vector<unsigned char>& data)
+{
+	std::string cachePath = GetBRDFCachePath(size);
+
+	std::error_code error;
+	if(!std::filesystem::exists(cachePath, error))
+	{
+		return false;
+	}
+
+	MappedFile cacheFile;
+	if(!cacheFile.Open(cachePath))
+	{
+		return false;
+	}
+
+	CacheReader reader(cacheFile.GetData(), cacheFile.GetSize());
+
+	BRDFHeader header;
+	unsigned long long dataSize;
+
+	if(!reader.Read(header) || header.Magic != brdfMagic || header.Version != brdfVersion ||
+		header.Size != size || header.SampleCount != sampleCount)
+	{
+		LOG(Log::MessageType::Debug, "Cache entry has an outdated format: " + cachePath);
+		return false;
+	}
+
+	if(!reader.Read(dataSize) || dataSize != BlockCompressor::GetLevelSize(TextureFormat::RGBA16F, size, size) ||
+		!reader.ReadVector(data, dataSize))
+	{
+		LOG(Log::MessageType::Error, "Cache entry is corrupt: " + cachePath);
+		return false;
+	}
+
+	return true;
+}
+
+bool EnvironmentCache::StoreBRDF(int size, int sampleCount, const std::vector<unsigned char>& data)
+{
+	std::string cachePath = GetBRDFCachePath(size);
+	std::string temporaryPath = cachePath + ".tmp";
+
+	std::error_code error;
+	std::filesystem::create_directories(cacheDirectory, error);
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to create cache entry: " + cachePath);
+			return false;
+		}
+
+		BRDFHeader header;
+		header.Magic = brdfMagic;
+		header.Version = brdfVersion;
+		header.Size = size;
+		header.SampleCount = sampleCount;
+		Write(file, header);
+
+		Write(file, static_cast<unsigned long long>(data.size()));
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to write cache entry: " + cachePath);
+			file.close();
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if(error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+std::string EnvironmentCache::GetCachePath(const std::string& filePath)
+{
+	std::string name = filePath.substr(filePath.find_last_of("/\\") + 1);
+
+	char pathHash[17];
+	snprintf(pathHash, sizeof(pathHash), "%016llx", HashString(filePath));
+
+	return cacheDirectory + name + "_" + pathHash + ".environment";
+}
+
+std::string EnvironmentCache::GetBRDFCachePath(int size)
+{
+	return cacheDirectory + "brdf_" + std::to_string(size) + ".lut";
+}
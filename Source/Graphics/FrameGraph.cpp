@@ -0,0 +1,585 @@
+#include "Graphics/FrameGraph.h"
+
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <random>
+
+unsigned int FrameGraph::ImportResource(const std::string& name, ResourceUsage usage)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Transient = false;
+	resource.Usage = usage;
+
+	resourceLookup[name] = static_cast<unsigned int>(resources.size());
+	resources.push_back(resource);
+	return static_cast<unsigned int>(resources.size() - 1);
+}
+
+unsigned int FrameGraph::CreateTransient(const std::string& name, uint64_t size, uint64_t alignment)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Transient = true;
+	resource.Usage = ResourceUsage::Common;
+	resource.Size = size;
+	resource.Alignment = std::max<uint64_t>(alignment, 1);
+
+	resourceLookup[name] = static_cast<unsigned int>(resources.size());
+	resources.push_back(resource);
+	return static_cast<unsigned int>(resources.size() - 1);
+}
+
+void FrameGraph::ExportResource(unsigned int resource)
+{
+	if(resources[resource].Transient)
+	{
+		assert(false && "Transient resources don't outlive the frame, so they can't be exported");
+		return;
+	}
+
+	resources[resource].Exported = true;
+}
+
+unsigned int FrameGraph::AddPass(const std::string& name, bool hasSideEffects)
+{
+	Pass pass;
+	pass.Name = name;
+	pass.HasSideEffects = hasSideEffects;
+
+	passes.push_back(pass);
+	return static_cast<unsigned int>(passes.size() - 1);
+}
+
+void FrameGraph::Read(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	AddAccess(pass, resource, usage, Access::Read);
+}
+
+void FrameGraph::Write(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	AddAccess(pass, resource, usage, Access::Write);
+}
+
+void FrameGraph::ReadWrite(unsigned int pass, unsigned int resource, ResourceUsage usage)
+{
+	AddAccess(pass, resource, usage, Access::ReadWrite);
+}
+
+void FrameGraph::Compile()
+{
+	compiledPasses.clear();
+	finalBarriers.clear();
+
+	CullPasses();
+	AssignLevels();
+	PlaceTransients();
+	RecordBarriers();
+}
+
+#pragma region Getters
+const std::vector<CompiledPass>& FrameGraph::GetCompiledPasses()
+{
+	return compiledPasses;
+}
+
+const std::vector<FrameGraphBarrier>& FrameGraph::GetFinalBarriers()
+{
+	return finalBarriers;
+}
+
+bool FrameGraph::IsPassCulled(unsigned int pass)
+{
+	return culled[pass];
+}
+
+unsigned int FrameGraph::LookupResource(const std::string& name)
+{
+	auto resource = resourceLookup.find(name);
+	if(resource == resourceLookup.end())
+	{
+		return InvalidIndex;
+	}
+
+	return resource->second;
+}
+
+const std::string& FrameGraph::GetResourceName(unsigned int resource)
+{
+	return resources[resource].Name;
+}
+
+const std::string& FrameGraph::GetPassName(unsigned int pass)
+{
+	return passes[pass].Name;
+}
+
+bool FrameGraph::IsTransient(unsigned int resource)
+{
+	return resources[resource].Transient;
+}
+
+ResourceUsage FrameGraph::GetInitialUsage(unsigned int resource)
+{
+	return resources[resource].Usage;
+}
+
+uint64_t FrameGraph::GetTransientOffset(unsigned int resource)
+{
+	return resources[resource].Offset;
+}
+
+uint64_t FrameGraph::GetTransientMemorySize()
+{
+	return transientMemorySize;
+}
+
+uint64_t FrameGraph::GetUnaliasedMemorySize()
+{
+	return unaliasedMemorySize;
+}
+
+unsigned int FrameGraph::GetPassCount()
+{
+	return static_cast<unsigned int>(passes.size());
+}
+
+unsigned int FrameGraph::GetResourceCount()
+{
+	return static_cast<unsigned int>(resources.size());
+}
+
+unsigned int FrameGraph::GetLevelCount()
+{
+	return levelCount;
+}
+#pragma endregion
+
+void FrameGraph::AddAccess(unsigned int pass, unsigned int resource, ResourceUsage usage, Access type)
+{
+	if(pass >= passes.size() || resource >= resources.size())
+	{
+		assert(false && "Pass or resource doesn't exist in this frame graph");
+		return;
+	}
+
+	for(const ResourceAccess& access : passes[pass].Accesses)
+	{
+		if(access.Resource == resource)
+		{
+			LOG(Log::MessageType::Error, "Pass '" + passes[pass].Name + "' declared '" + resources[resource].Name + "' twice");
+			assert(false && "A pass can only use a resource in a single way");
+			return;
+		}
+	}
+
+	passes[pass].Accesses.push_back({ resource, usage, type });
+}
+
+void FrameGraph::CullPasses()
+{
+	// Walk back from the exported resources, a pass stays if a later pass ( or the outside ) needs what it wrote //
+	std::vector<bool> needed(resources.size(), false);
+	for(unsigned int i = 0; i < resources.size(); i++)
+	{
+		needed[i] = resources[i].Exported;
+	}
+
+	culled.assign(passes.size(), true);
+	for(int i = static_cast<int>(passes.size()) - 1; i >= 0; i--)
+	{
+		const Pass& pass = passes[i];
+		bool alive = pass.HasSideEffects;
+
+		for(const ResourceAccess& access : pass.Accesses)
+		{
+			if(access.Type != Access::Read && needed[access.Resource])
+			{
+				alive = true;
+			}
+		}
+
+		if(!alive)
+		{
+			continue;
+		}
+
+		culled[i] = false;
+
+		// A plain write replaces the contents, so whatever came before it isn't needed anymore //
+		for(const ResourceAccess& access : pass.Accesses)
+		{
+			if(access.Type == Access::Write)
+			{
+				needed[access.Resource] = false;
+			}
+		}
+
+		for(const ResourceAccess& access : pass.Accesses)
+		{
+			if(access.Type != Access::Write)
+			{
+				needed[access.Resource] = true;
+			}
+		}
+	}
+}
+
+void FrameGraph::AssignLevels()
+{
+	struct ResourceState
+	{
+		unsigned int LastWriter = InvalidIndex;
+		std::vector<std::pair<unsigned int, ResourceUsage>> Readers; // Since the last write
+	};
+
+	std::vector<ResourceState> states(resources.size());
+	std::vector<unsigned int> levels(passes.size(), 0);
+	levelCount = 0;
+
+	// 1. Declaration order decides who writes first, every pass depends on the last writer of what it reads.
+	// Writers also wait on the readers before them, & reads in a different usage wait on each other //
+	for(unsigned int i = 0; i < passes.size(); i++)
+	{
+		if(culled[i])
+		{
+			continue;
+		}
+
+		unsigned int level = 0;
+		auto dependOn = [&](unsigned int pass)
+		{
+			if(pass != InvalidIndex)
+			{
+				level = std::max(level, levels[pass] + 1);
+			}
+		};
+
+		for(const ResourceAccess& access : passes[i].Accesses)
+		{
+			ResourceState& state = states[access.Resource];
+			dependOn(state.LastWriter);
+
+			for(const std::pair<unsigned int, ResourceUsage>& reader : state.Readers)
+			{
+				if(access.Type != Access::Read || reader.second != access.Usage)
+				{
+					dependOn(reader.first);
+				}
+			}
+		}
+
+		for(const ResourceAccess& access : passes[i].Accesses)
+		{
+			ResourceState& state = states[access.Resource];
+			if(access.Type == Access::Read)
+			{
+				state.Readers.push_back({ i, access.Usage });
+			}
+			else
+			{
+				state.LastWriter = i;
+				state.Readers.clear();
+			}
+		}
+
+		levels[i] = level;
+		levelCount = std::max(levelCount, level + 1);
+	}
+
+	// 2. Execute level by level, keeping declaration order within one //
+	for(unsigned int i = 0; i < passes.size(); i++)
+	{
+		if(!culled[i])
+		{
+			compiledPasses.push_back({ i, levels[i], {} });
+		}
+	}
+
+	std::stable_sort(compiledPasses.begin(), compiledPasses.end(), [](const CompiledPass& a, const CompiledPass& b)
+	{
+		return a.Level < b.Level;
+	});
+}
+
+void FrameGraph::PlaceTransients()
+{
+	// 1. Lifetime of every transient, in compiled pass indices //
+	std::vector<unsigned int> firstUse(resources.size(), InvalidIndex);
+	std::vector<unsigned int> lastUse(resources.size(), 0);
+
+	for(unsigned int i = 0; i < compiledPasses.size(); i++)
+	{
+		for(const ResourceAccess& access : passes[compiledPasses[i].Pass].Accesses)
+		{
+			Resource& resource = resources[access.Resource];
+			if(!resource.Transient)
+			{
+				continue;
+			}
+
+			if(firstUse[access.Resource] == InvalidIndex)
+			{
+				if(access.Type != Access::Write)
+				{
+					LOG(Log::MessageType::Error, "Transient '" + resource.Name + "' is read by '" +
+						passes[compiledPasses[i].Pass].Name + "' before anything wrote to it");
+					assert(false && "Transient resources have no contents until written");
+				}
+
+				firstUse[access.Resource] = i;
+				resource.Usage = access.Usage;
+			}
+
+			lastUse[access.Resource] = i;
+		}
+	}
+
+	std::vector<unsigned int> transients;
+	for(unsigned int i = 0; i < resources.size(); i++)
+	{
+		resources[i].Offset = 0;
+		if(resources[i].Transient && firstUse[i] != InvalidIndex)
+		{
+			transients.push_back(i);
+		}
+	}
+
+	// 2. Largest first, each at the lowest offset that doesn't overlap with a placed transient alive at the same time //
+	std::stable_sort(transients.begin(), transients.end(), [this](unsigned int a, unsigned int b)
+	{
+		return resources[a].Size > resources[b].Size;
+	});
+
+	std::vector<unsigned int> placed;
+	std::vector<std::pair<uint64_t, uint64_t>> occupied;
+	transientMemorySize = 0;
+	unaliasedMemorySize = 0;
+
+	for(unsigned int index : transients)
+	{
+		Resource& resource = resources[index];
+
+		occupied.clear();
+		for(unsigned int other : placed)
+		{
+			if(firstUse[other] <= lastUse[index] && firstUse[index] <= lastUse[other])
+			{
+				occupied.push_back({ resources[other].Offset, resources[other].Offset + resources[other].Size });
+			}
+		}
+
+		std::sort(occupied.begin(), occupied.end());
+
+		uint64_t offset = 0;
+		for(const std::pair<uint64_t, uint64_t>& range : occupied)
+		{
+			offset = (offset + resource.Alignment - 1) / resource.Alignment * resource.Alignment;
+			if(offset + resource.Size <= range.first)
+			{
+				break;
+			}
+
+			offset = std::max(offset, range.second);
+		}
+
+		resource.Offset = (offset + resource.Alignment - 1) / resource.Alignment * resource.Alignment;
+		placed.push_back(index);
+
+		transientMemorySize = std::max(transientMemorySize, resource.Offset + resource.Size);
+		unaliasedMemorySize = (unaliasedMemorySize + resource.Alignment - 1) / resource.Alignment * resource.Alignment + resource.Size;
+	}
+
+	// 3. Sharing memory with any other transient means the contents are gone by the first use, every frame.
+	// Sweeping by offset, a range overlaps a previous one when it starts before the furthest end so far //
+	aliased.assign(resources.size(), false);
+	std::sort(placed.begin(), placed.end(), [this](unsigned int a, unsigned int b)
+	{
+		return resources[a].Offset < resources[b].Offset;
+	});
+
+	unsigned int furthest = InvalidIndex;
+	for(unsigned int index : placed)
+	{
+		const Resource& resource = resources[index];
+		if(furthest != InvalidIndex && resource.Offset < resources[furthest].Offset + resources[furthest].Size)
+		{
+			aliased[index] = true;
+			aliased[furthest] = true;
+		}
+
+		if(furthest == InvalidIndex || resource.Offset + resource.Size > resources[furthest].Offset + resources[furthest].Size)
+		{
+			furthest = index;
+		}
+	}
+}
+
+void FrameGraph::RecordBarriers()
+{
+	std::vector<ResourceUsage> current(resources.size());
+	std::vector<unsigned int> lastLevel(resources.size(), InvalidIndex);
+
+	for(unsigned int i = 0; i < resources.size(); i++)
+	{
+		current[i] = resources[i].Usage;
+	}
+
+	// 1. Passes on a level don't depend on each other, so all their transitions go into the batch of the first one //
+	std::vector<unsigned int> batches(levelCount, InvalidIndex);
+	for(unsigned int i = 0; i < compiledPasses.size(); i++)
+	{
+		if(batches[compiledPasses[i].Level] == InvalidIndex)
+		{
+			batches[compiledPasses[i].Level] = i;
+		}
+	}
+
+	// 2. A transition begins in the batch after the last use of the resource, & ends right before the next use //
+	auto addTransition = [&](unsigned int resource, ResourceUsage usage, unsigned int level, std::vector<FrameGraphBarrier>& barriers)
+	{
+		unsigned int beginLevel = lastLevel[resource] == InvalidIndex ? 0 : lastLevel[resource] + 1;
+
+		if(beginLevel < level)
+		{
+			compiledPasses[batches[beginLevel]].Barriers.push_back({ resource, current[resource], usage, false, BarrierSplit::Begin });
+			barriers.push_back({ resource, current[resource], usage, false, BarrierSplit::End });
+		}
+		else
+		{
+			barriers.push_back({ resource, current[resource], usage, false, BarrierSplit::None });
+		}
+	};
+
+	for(const CompiledPass& compiledPass : compiledPasses)
+	{
+		unsigned int level = compiledPass.Level;
+		std::vector<FrameGraphBarrier>& barriers = compiledPasses[batches[level]].Barriers;
+
+		for(const ResourceAccess& access : passes[compiledPass.Pass].Accesses)
+		{
+			if(lastLevel[access.Resource] == InvalidIndex && aliased[access.Resource])
+			{
+				barriers.push_back({ access.Resource, current[access.Resource], access.Usage, true, BarrierSplit::None });
+			}
+			else if(current[access.Resource] != access.Usage)
+			{
+				addTransition(access.Resource, access.Usage, level, barriers);
+			}
+
+			current[access.Resource] = access.Usage;
+			lastLevel[access.Resource] = level;
+		}
+	}
+
+	// 3. Transients return to the usage of their first access as well, which is the state they're created in //
+	for(unsigned int i = 0; i < resources.size(); i++)
+	{
+		if(lastLevel[i] != InvalidIndex && current[i] != resources[i].Usage)
+		{
+			addTransition(i, resources[i].Usage, levelCount, finalBarriers);
+		}
+	}
+}
+
+#pragma region Benchmark
+void FrameGraph::RunBenchmark()
+{
+	const unsigned int passCounts[] = { 100, 250, 500, 1000 };
+	const int compileCount = 200;
+
+	std::mt19937 random(1337);
+
+	for(unsigned int passCount : passCounts)
+	{
+		// 1. Synthetic frame, every pass reads a few recent outputs & writes new render targets of 1 to 32 MB.
+		// Some outputs are never read, so their passes get culled, the final pass composites into the back buffer //
+		FrameGraph graph;
+		unsigned int backBuffer = graph.ImportResource("BackBuffer", ResourceUsage::Present);
+		unsigned int history = graph.ImportResource("History", ResourceUsage::ShaderResource);
+		graph.ExportResource(backBuffer);
+
+		std::vector<unsigned int> outputs;
+		for(unsigned int i = 0; i < passCount - 1; i++)
+		{
+			unsigned int pass = graph.AddPass("Pass " + std::to_string(i));
+
+			unsigned int readCount = outputs.empty() ? 0 : 1 + random() % 3;
+			for(unsigned int r = 0; r < readCount; r++)
+			{
+				size_t window = std::min<size_t>(outputs.size(), 16);
+				unsigned int input = outputs[outputs.size() - 1 - random() % window];
+
+				bool declared = false;
+				for(const ResourceAccess& access : graph.passes[pass].Accesses)
+				{
+					declared |= access.Resource == input;
+				}
+
+				if(!declared)
+				{
+					graph.Read(pass, input, random() % 4 ? ResourceUsage::ShaderResource : ResourceUsage::CopySource);
+				}
+			}
+
+			if(random() % 8 == 0)
+			{
+				graph.Read(pass, history, ResourceUsage::ShaderResource);
+			}
+
+			unsigned int writeCount = 1 + random() % 2;
+			for(unsigned int w = 0; w < writeCount; w++)
+			{
+				uint64_t size = (1ull + random() % 32) << 20;
+				unsigned int output = graph.CreateTransient("Target " + std::to_string(i) + "." + std::to_string(w), size, 64 << 10);
+
+				graph.Write(pass, output, ResourceUsage::RenderTarget);
+				outputs.push_back(output);
+			}
+		}
+
+		unsigned int composite = graph.AddPass("Composite");
+		graph.Read(composite, outputs.back(), ResourceUsage::ShaderResource);
+		graph.Write(composite, backBuffer, ResourceUsage::RenderTarget);
+
+		// 2. Compile repeatedly, the graph only gets rebuilt when passes change //
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for(int i = 0; i < compileCount; i++)
+		{
+			graph.Compile();
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		double microseconds = std::chrono::duration<double, std::micro>(endTime - startTime).count() / compileCount;
+
+		unsigned int barrierCount = static_cast<unsigned int>(graph.GetFinalBarriers().size());
+		unsigned int batchCount = graph.GetFinalBarriers().empty() ? 0 : 1;
+		unsigned int splitCount = 0;
+		for(const CompiledPass& pass : graph.GetCompiledPasses())
+		{
+			for(const FrameGraphBarrier& barrier : pass.Barriers)
+			{
+				barrierCount += barrier.Split == BarrierSplit::Begin ? 0 : 1;
+				splitCount += barrier.Split == BarrierSplit::Begin ? 1 : 0;
+			}
+
+			batchCount += pass.Barriers.empty() ? 0 : 1;
+		}
+
+		auto toMB = [](uint64_t size) { return std::to_string(size / (1024.0 * 1024.0)); };
+
+		LOG("Frame graph benchmark: " + std::to_string(passCount) + " passes, " + std::to_string(graph.GetResourceCount()) + " resources");
+		LOG("  Compile: " + std::to_string(microseconds) + " us");
+		LOG("  Executed passes: " + std::to_string(graph.GetCompiledPasses().size()) + ", culled " +
+			std::to_string(passCount - graph.GetCompiledPasses().size()) + ", levels " + std::to_string(graph.GetLevelCount()));
+		LOG("  Barriers: " + std::to_string(barrierCount) + " in " + std::to_string(batchCount) + " batches, " +
+			std::to_string(splitCount) + " of them split");
+		LOG("  Transient memory: " + toMB(graph.GetTransientMemorySize()) + " MB aliased, " +
+			toMB(graph.GetUnaliasedMemorySize()) + " MB without aliasing");
+	}
+}
+#pragma endregion
@@ -0,0 +1,372 @@
+#include "Graphics/FrustumCuller.h"
+
+#include "Utilities/Logger.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <xmmintrin.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	// Boxes use all six arrays ( center & extents ), spheres the first four ( center & radius ) //
+	struct VolumeArrays
+	{
+		const float* Data[6];
+		unsigned int Count;
+	};
+
+	template<bool IsSphere>
+	unsigned int CullScalar(const Frustum& frustum, const VolumeArrays& volumes, unsigned char* visibility)
+	{
+		unsigned int visibleCount = 0;
+
+		for(unsigned int i = 0; i < volumes.Count; i++)
+		{
+			bool visible = true;
+
+			for(const glm::vec4& plane : frustum.Planes)
+			{
+				float distance = plane.x * volumes.Data[0][i] + plane.y * volumes.Data[1][i] + plane.z * volumes.Data[2][i] + plane.w;
+				float radius = IsSphere ? volumes.Data[3][i] : fabsf(plane.x) * volumes.Data[3][i] +
+					fabsf(plane.y) * volumes.Data[4][i] + fabsf(plane.z) * volumes.Data[5][i];
+
+				visible &= distance + radius >= 0.0f;
+			}
+
+			visibility[i] = visible;
+			visibleCount += visible;
+		}
+
+		return visibleCount;
+	}
+
+	// Writes the lanes of 'mask' that belong to actual volumes //
+	unsigned int StoreVisibility(int mask, unsigned int first, unsigned int width, unsigned int count, unsigned char* visibility)
+	{
+		unsigned int visibleCount = 0;
+		unsigned int lanes = count - first < width ? count - first : width;
+
+		for(unsigned int lane = 0; lane < lanes; lane++)
+		{
+			unsigned char visible = (mask >> lane) & 1;
+			visibility[first + lane] = visible;
+			visibleCount += visible;
+		}
+
+		return visibleCount;
+	}
+
+	template<bool IsSphere>
+	unsigned int CullSSE(const Frustum& frustum, const VolumeArrays& volumes, unsigned char* visibility)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+		__m128 absoluteX[6], absoluteY[6], absoluteZ[6];
+
+		for(int p = 0; p < 6; p++)
+		{
+			const glm::vec4& plane = frustum.Planes[p];
+			planeX[p] = _mm_set1_ps(plane.x);
+			planeY[p] = _mm_set1_ps(plane.y);
+			planeZ[p] = _mm_set1_ps(plane.z);
+			planeW[p] = _mm_set1_ps(plane.w);
+			absoluteX[p] = _mm_set1_ps(fabsf(plane.x));
+			absoluteY[p] = _mm_set1_ps(fabsf(plane.y));
+			absoluteZ[p] = _mm_set1_ps(fabsf(plane.z));
+		}
+
+		unsigned int visibleCount = 0;
+		for(unsigned int i = 0; i < volumes.Count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(volumes.Data[0] + i);
+			__m128 y = _mm_loadu_ps(volumes.Data[1] + i);
+			__m128 z = _mm_loadu_ps(volumes.Data[2] + i);
+			__m128 a = _mm_loadu_ps(volumes.Data[3] + i);
+			__m128 b = IsSphere ? zero : _mm_loadu_ps(volumes.Data[4] + i);
+			__m128 c = IsSphere ? zero : _mm_loadu_ps(volumes.Data[5] + i);
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for(int p = 0; p < 6; p++)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+					_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+
+				__m128 radius = IsSphere ? a : _mm_add_ps(_mm_add_ps(_mm_mul_ps(absoluteX[p], a),
+					_mm_mul_ps(absoluteY[p], b)), _mm_mul_ps(absoluteZ[p], c));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			visibleCount += StoreVisibility(_mm_movemask_ps(inside), i, 4, volumes.Count, visibility);
+		}
+
+		return visibleCount;
+	}
+
+#if defined(__AVX__)
+	template<bool IsSphere>
+	unsigned int CullAVX(const Frustum& frustum, const VolumeArrays& volumes, unsigned char* visibility)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+		__m256 absoluteX[6], absoluteY[6], absoluteZ[6];
+
+		for(int p = 0; p < 6; p++)
+		{
+			const glm::vec4& plane = frustum.Planes[p];
+			planeX[p] = _mm256_set1_ps(plane.x);
+			planeY[p] = _mm256_set1_ps(plane.y);
+			planeZ[p] = _mm256_set1_ps(plane.z);
+			planeW[p] = _mm256_set1_ps(plane.w);
+			absoluteX[p] = _mm256_set1_ps(fabsf(plane.x));
+			absoluteY[p] = _mm256_set1_ps(fabsf(plane.y));
+			absoluteZ[p] = _mm256_set1_ps(fabsf(plane.z));
+		}
+
+		unsigned int visibleCount = 0;
+		for(unsigned int i = 0; i < volumes.Count; i += 8)
+		{
+			__m256 x = _mm256_loadu_ps(volumes.Data[0] + i);
+			__m256 y = _mm256_loadu_ps(volumes.Data[1] + i);
+			__m256 z = _mm256_loadu_ps(volumes.Data[2] + i);
+			__m256 a = _mm256_loadu_ps(volumes.Data[3] + i);
+			__m256 b = IsSphere ? zero : _mm256_loadu_ps(volumes.Data[4] + i);
+			__m256 c = IsSphere ? zero : _mm256_loadu_ps(volumes.Data[5] + i);
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for(int p = 0; p < 6; p++)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)),
+					_mm256_add_ps(_mm256_mul_ps(planeZ[p], z), planeW[p]));
+
+				__m256 radius = IsSphere ? a : _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absoluteX[p], a),
+					_mm256_mul_ps(absoluteY[p], b)), _mm256_mul_ps(absoluteZ[p], c));
+
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+			}
+
+			visibleCount += StoreVisibility(_mm256_movemask_ps(inside), i, 8, volumes.Count, visibility);
+		}
+
+		return visibleCount;
+	}
+#endif
+
+	template<bool IsSphere>
+	unsigned int Cull(const Frustum& frustum, const VolumeArrays& volumes, unsigned char* visibility)
+	{
+#if defined(__AVX__)
+		return CullAVX<IsSphere>(frustum, volumes, visibility);
+#else
+		return CullSSE<IsSphere>(frustum, volumes, visibility);
+#endif
+	}
+
+	void PushPadded(std::vector<float>& values, unsigned int index, float value)
+	{
+		if(index >= values.size())
+		{
+			values.resize(values.size() + FrustumCuller::GroupSize, 0.0f);
+		}
+
+		values[index] = value;
+	}
+}
+
+Frustum FrustumCuller::ExtractFrustum(const glm::mat4& viewProjection)
+{
+	// Rows of the matrix, glm stores columns //
+	glm::vec4 rows[4];
+	for(int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	Frustum frustum;
+	frustum.Planes[0] = rows[3] + rows[0]; // Left
+	frustum.Planes[1] = rows[3] - rows[0]; // Right
+	frustum.Planes[2] = rows[3] + rows[1]; // Bottom
+	frustum.Planes[3] = rows[3] - rows[1]; // Top
+	frustum.Planes[4] = rows[3] + rows[2]; // Near
+	frustum.Planes[5] = rows[3] - rows[2]; // Far
+
+	// Normalized, so distances are in world units & spheres can compare against their radius //
+	for(glm::vec4& plane : frustum.Planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return frustum;
+}
+
+void FrustumCuller::Clear()
+{
+	boxCount = 0;
+	sphereCount = 0;
+}
+
+void FrustumCuller::AddBox(const BoundingBox& box)
+{
+	glm::vec3 center = glm::vec3(0.0f);
+	glm::vec3 extents = glm::vec3(-FLT_MAX);
+
+	// Empty boxes keep negative extents, so they're always culled //
+	if(IsBoundingBoxValid(box))
+	{
+		center = (box.Min + box.Max) * 0.5f;
+		extents = (box.Max - box.Min) * 0.5f;
+	}
+
+	PushPadded(boxCenterX, boxCount, center.x);
+	PushPadded(boxCenterY, boxCount, center.y);
+	PushPadded(boxCenterZ, boxCount, center.z);
+	PushPadded(boxExtentX, boxCount, extents.x);
+	PushPadded(boxExtentY, boxCount, extents.y);
+	PushPadded(boxExtentZ, boxCount, extents.z);
+	boxCount++;
+}
+
+void FrustumCuller::AddSphere(const BoundingSphere& sphere)
+{
+	PushPadded(sphereX, sphereCount, sphere.Center.x);
+	PushPadded(sphereY, sphereCount, sphere.Center.y);
+	PushPadded(sphereZ, sphereCount, sphere.Center.z);
+	PushPadded(sphereRadius, sphereCount, sphere.Radius);
+	sphereCount++;
+}
+
+unsigned int FrustumCuller::CullBoxes(const Frustum& frustum, std::vector<unsigned char>& visibility)
+{
+	visibility.resize(boxCount);
+	if(boxCount == 0)
+	{
+		return 0;
+	}
+
+	VolumeArrays boxes = { { boxCenterX.data(), boxCenterY.data(), boxCenterZ.data(),
+		boxExtentX.data(), boxExtentY.data(), boxExtentZ.data() }, boxCount };
+
+	return Cull<false>(frustum, boxes, visibility.data());
+}
+
+unsigned int FrustumCuller::CullSpheres(const Frustum& frustum, std::vector<unsigned char>& visibility)
+{
+	visibility.resize(sphereCount);
+	if(sphereCount == 0)
+	{
+		return 0;
+	}
+
+	VolumeArrays spheres = { { sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data() }, sphereCount };
+	return Cull<true>(frustum, spheres, visibility.data());
+}
+
+unsigned int FrustumCuller::GetBoxCount()
+{
+	return boxCount;
+}
+
+unsigned int FrustumCuller::GetSphereCount()
+{
+	return sphereCount;
+}
+
+#pragma region Benchmark
+void FrustumCuller::RunBenchmark()
+{
+	const unsigned int volumeCount = 1 << 18;
+	const int iterations = 50;
+
+	// 1. Volumes spread through a large scene, the camera sees a part of it //
+	std::mt19937 random(1337);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.25f, 5.0f);
+
+	FrustumCuller culler;
+	for(unsigned int i = 0; i < volumeCount; i++)
+	{
+		glm::vec3 center = glm::vec3(position(random), position(random), position(random));
+		glm::vec3 extents = glm::vec3(size(random), size(random), size(random));
+
+		BoundingBox box;
+		box.Min = center - extents;
+		box.Max = center + extents;
+		culler.AddBox(box);
+
+		BoundingSphere sphere;
+		sphere.Center = center;
+		sphere.Radius = glm::length(extents);
+		culler.AddSphere(sphere);
+	}
+
+	glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, 0.0f), glm::vec3(100.0f, 0.0f, -100.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+	Frustum frustum = ExtractFrustum(projection * view);
+
+	VolumeArrays boxes = { { culler.boxCenterX.data(), culler.boxCenterY.data(), culler.boxCenterZ.data(),
+		culler.boxExtentX.data(), culler.boxExtentY.data(), culler.boxExtentZ.data() }, volumeCount };
+	VolumeArrays spheres = { { culler.sphereX.data(), culler.sphereY.data(), culler.sphereZ.data(),
+		culler.sphereRadius.data() }, volumeCount };
+
+	// 2. Every path has to agree with the scalar reference //
+	struct CullPath
+	{
+		const char* Name;
+		unsigned int(*Boxes)(const Frustum&, const VolumeArrays&, unsigned char*);
+		unsigned int(*Spheres)(const Frustum&, const VolumeArrays&, unsigned char*);
+	};
+
+	std::vector<CullPath> paths;
+	paths.push_back({ "Scalar", CullScalar<false>, CullScalar<true> });
+	paths.push_back({ "SSE ( 4 wide )", CullSSE<false>, CullSSE<true> });
+#if defined(__AVX__)
+	paths.push_back({ "AVX ( 8 wide )", CullAVX<false>, CullAVX<true> });
+#else
+	LOG("Frustum culling benchmark: built without AVX, only scalar & SSE are measured");
+#endif
+
+	std::vector<unsigned char> referenceBoxes(volumeCount);
+	std::vector<unsigned char> referenceSpheres(volumeCount);
+	CullScalar<false>(frustum, boxes, referenceBoxes.data());
+	CullScalar<true>(frustum, spheres, referenceSpheres.data());
+
+	std::vector<unsigned char> visibility(volumeCount);
+
+	for(const CullPath& path : paths)
+	{
+		const char* shapes[2] = { "boxes", "spheres" };
+
+		for(int shape = 0; shape < 2; shape++)
+		{
+			auto cull = shape == 0 ? path.Boxes : path.Spheres;
+			const VolumeArrays& volumes = shape == 0 ? boxes : spheres;
+			const std::vector<unsigned char>& reference = shape == 0 ? referenceBoxes : referenceSpheres;
+
+			unsigned int visibleCount = 0;
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			for(int i = 0; i < iterations; i++)
+			{
+				visibleCount = cull(frustum, volumes, visibility.data());
+			}
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			double nanoseconds = std::chrono::duration<double, std::nano>(endTime - startTime).count();
+			double perVolume = nanoseconds / (static_cast<double>(volumeCount) * iterations);
+
+			LOG("Frustum culling benchmark: " + std::string(path.Name) + ", " + std::to_string(volumeCount) + " " + shapes[shape] +
+				" - " + std::to_string(perVolume) + " ns per object, " + std::to_string(visibleCount) + " visible");
+
+			if(visibility != reference)
+			{
+				LOG(Log::MessageType::Error, std::string(path.Name) + " culling doesn't match the scalar reference!");
+			}
+		}
+	}
+}
+#pragma endregion
@@ -1,47 +1,64 @@
 #include "Graphics/HDRI.h"
 #include "Graphics/DXUtilities.h"
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXUploadQueue.h"
+#include "Graphics/DXMemoryAllocator.h"
+#include "Graphics/MipGenerator.h"
+#include "Graphics/EnvironmentCache.h"
+#include "Graphics/IBLBaker.h"
 
 #include <stb_image.h>
+#include <vector>
 
 #include <imgui.h>
 #include <glm.hpp>
 
-HDRI::HDRI(const std::string& filePath)
-{
-	int width;
-	int height;
-	int channels;
+// Quality used for BC6H, the result is cached so this only affects the first load //
+static const CompressionQuality environmentQuality = CompressionQuality::Balanced;
 
-	stbi_set_flip_vertically_on_load(true);
+// Reflections of rough surfaces are blurry, so the specular chain can be a lot smaller than the HDRI //
+static const int specularMaxWidth = 256;
+static const int specularLevelCount = 6;
+static const int brdfSize = 128;
 
-	// Instead of 8 bits, we store 32 bits per channel with HDRIs
-	float* buffer = stbi_loadf(filePath.c_str(), &width, &height, &channels, 4);
-	stbi_set_flip_vertically_on_load(false);
+HDRI::HDRI(const std::string& filePath, TextureFormat format)
+{
+	// 1. Load the encoded environment, only decode & encode it when the cache is out of date //
+	EnvironmentCache cache;
+	EnvironmentData environment;
 
-	if(buffer == NULL)
+	if(!cache.Load(filePath, format, environmentQuality, environment))
 	{
-		LOG(Log::MessageType::Error, "Unsuccesful with loading: " + filePath);
-		assert(false);
+		if(!LoadEnvironment(filePath, format, environment))
+		{
+			LOG(Log::MessageType::Error, "Unsuccesful with loading: " + filePath);
+			assert(false);
+			return;
+		}
+
+		cache.Store(filePath, environment);
 	}
 
-	this->width = width;
-	this->height = height;
+	width = environment.Width;
+	height = environment.Height;
+	this->format = environment.Format;
+	irradiance = environment.Irradiance;
 
-	// 1. Upload Environment map
-	UploadBuffer(buffer, width, height, hdriResource, hdriIndex);
-	stbi_image_free(buffer);
+	// 2. Upload Environment map, including its full mip chain //
+	UploadBuffer(environment.Data.data(), width, height, environment.MipCount, environment.Format, hdriResource, hdriIndex);
 
-	// 2. Allocate resource with matching dimensions to read/write to
-	float* buff = new float[width * height * sizeof(float)];
-	UploadBuffer(buff, width, height, irradianceResource, irradianceIndex);
-	delete[] buff;
+	// 3. Upload the image based lighting inputs, prefiltered reflections & the BRDF lookup table //
+	UploadBuffer(environment.Specular.data(), environment.SpecularWidth, environment.SpecularHeight,
+		environment.SpecularMipCount, environment.SpecularFormat, specularResource, specularIndex);
 
-	DXDescriptorHeap* rtvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-	irradianceRTVIndex = rtvHeap->GetNextAvailableIndex();
+	std::vector<unsigned char> brdf;
+	LoadBRDF(brdf);
+	UploadBuffer(brdf.data(), brdfSize, brdfSize, 1, TextureFormat::RGBA16F, brdfResource, brdfIndex);
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap->GetCPUHandleAt(irradianceRTVIndex);
-	DXAccess::GetDevice()->CreateRenderTargetView(irradianceResource.Get(), nullptr, rtvHandle);
+	// 4. Upload the irradiance coefficients, used for diffuse lighting //
+	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	irradianceCBVIndex = CBVHeap->GetNextAvailableIndex();
+	UpdateInFlightCBV(irradianceBuffer, irradianceCBVIndex, 1, sizeof(SHIrradiance), &irradiance);
 }
 
 int HDRI::GetHDRiSRVIndex()
@@ -49,34 +66,41 @@ int HDRI::GetHDRiSRVIndex()
 	return hdriIndex;
 }
 
-int HDRI::GetIrradianceSRVIndex()
+CD3DX12_GPU_DESCRIPTOR_HANDLE HDRI::GetHDRISRVHandle()
 {
-	return irradianceIndex;
+	DXDescriptorHeap* srvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return srvHeap->GetGPUHandleAt(hdriIndex);
 }
 
-CD3DX12_GPU_DESCRIPTOR_HANDLE HDRI::GetHDRISRVHandle()
+CD3DX12_GPU_DESCRIPTOR_HANDLE HDRI::GetSpecularSRVHandle()
 {
 	DXDescriptorHeap* srvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	return srvHeap->GetGPUHandleAt(hdriIndex);
+	return srvHeap->GetGPUHandleAt(specularIndex);
 }
 
-CD3DX12_CPU_DESCRIPTOR_HANDLE HDRI::GetIraddianceRTVHandle()
+CD3DX12_GPU_DESCRIPTOR_HANDLE HDRI::GetBRDFSRVHandle()
 {
-	DXDescriptorHeap* rtvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-	return rtvHeap->GetCPUHandleAt(irradianceRTVIndex);
+	DXDescriptorHeap* srvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return srvHeap->GetGPUHandleAt(brdfIndex);
 }
 
-ComPtr<ID3D12Resource> HDRI::GetHDRiResource()
+CD3DX12_GPU_DESCRIPTOR_HANDLE HDRI::GetIrradianceCBVHandle()
 {
-	return hdriResource;
+	DXDescriptorHeap* cbvHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return cbvHeap->GetGPUHandleAt(irradianceCBVIndex);
 }
 
-ComPtr<ID3D12Resource> HDRI::GetIrradianceResource()
+const SHIrradiance& HDRI::GetIrradiance()
 {
-	return irradianceResource;
+	return irradiance;
 }
 
-static glm::vec3 testing = glm::vec3(0.0f, 0.0f, 0.0f);
+ComPtr<ID3D12Resource> HDRI::GetHDRiResource()
+{
+	return hdriResource;
+}
+
+static glm::vec3 testing = glm::vec3(0.0f, 1.0f, 0.0f);
 
 void HDRI::HDRIDebugWindow()
 {
@@ -90,13 +114,19 @@ void HDRI::HDRIDebugWindow()
 
 	ImGui::Separator();
 
-	ImGui::Text("HDRI - Irradiance Capture");
-	CD3DX12_GPU_DESCRIPTOR_HANDLE irradianceHandle = SRVHeap->GetGPUHandleAt(irradianceIndex);
-	ImGui::Image((ImTextureID)irradianceHandle.ptr, ImVec2(512, 256));
-
+	ImGui::Text("HDRI - Irradiance ( Spherical Harmonics )");
 	ImGui::DragFloat3("Tester", &testing.x, 0.001f); 
 	testing = glm::normalize(testing);
 
+	glm::vec3 testIrradiance = SphericalHarmonics::EvaluateIrradiance(irradiance, testing);
+	ImGui::ColorEdit3("Irradiance", &testIrradiance.x, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_HDR);
+
+	ImGui::Separator();
+
+	ImGui::Text("BRDF Lookup ( NoV, Roughness )");
+	CD3DX12_GPU_DESCRIPTOR_HANDLE brdfHandle = SRVHeap->GetGPUHandleAt(brdfIndex);
+	ImGui::Image((ImTextureID)brdfHandle.ptr, ImVec2(256, 256));
+
 	ImGui::End();
 }
 
@@ -110,24 +140,109 @@ int HDRI::GetHeight()
 	return height;
 }
 
-void HDRI::UploadBuffer(float* data, int width, int height, ComPtr<ID3D12Resource>& resource, int& index)
+bool HDRI::LoadEnvironment(const std::string& filePath, TextureFormat format, EnvironmentData& environment)
 {
-	D3D12_RESOURCE_DESC description = CD3DX12_RESOURCE_DESC::Tex2D(
-		DXGI_FORMAT_R32G32B32A32_FLOAT, width, height);
-	description.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+	int width;
+	int height;
+	int channels;
+
+	stbi_set_flip_vertically_on_load(true);
 
-	D3D12_SUBRESOURCE_DATA subresource;
-	subresource.pData = data;
-	subresource.RowPitch = width * (sizeof(float) * 4);
+	// Instead of 8 bits, we load 32 bits per channel with HDRIs
+	float* buffer = stbi_loadf(filePath.c_str(), &width, &height, &channels, 4);
+	stbi_set_flip_vertically_on_load(false);
+
+	if(buffer == NULL)
+	{
+		return false;
+	}
+
+	std::vector<float> pixels(buffer, buffer + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(buffer);
+
+	// Irradiance only needs the top level, projected before any compression //
+	environment.Irradiance = SphericalHarmonics::ProjectIrradiance(pixels.data(), width, height);
+
+	int mipCount = MipGenerator::GenerateRGBA32F(pixels, width, height);
+
+	// Specular reflections get filtered from the whole chain, also before compression //
+	std::vector<float> specular;
+	int specularWidth;
+	int specularHeight;
+	int specularMipCount = IBLBaker::PrefilterSpecular(pixels, width, height, mipCount,
+		specularMaxWidth, specularLevelCount, specular, specularWidth, specularHeight);
+
+	// BC6H needs the top level to be a multiple of 4, other environments are stored as half floats //
+	TextureFormat specularFormat = format;
+	if(format == TextureFormat::BC6H && !BlockCompressor::CanCompress(width, height))
+	{
+		LOG(Log::MessageType::Debug, "HDRI can't be block compressed, using RGBA16F instead: " + filePath);
+		format = TextureFormat::RGBA16F;
+	}
+
+	if(specularFormat == TextureFormat::BC6H && !BlockCompressor::CanCompress(specularWidth, specularHeight))
+	{
+		specularFormat = TextureFormat::RGBA16F;
+	}
+
+	environment.Width = width;
+	environment.Height = height;
+	environment.MipCount = mipCount;
+	environment.Format = format;
+	environment.Quality = environmentQuality;
+
+	environment.SpecularWidth = specularWidth;
+	environment.SpecularHeight = specularHeight;
+	environment.SpecularMipCount = specularMipCount;
+	environment.SpecularFormat = specularFormat;
+
+	return BlockCompressor::CompressHDR(pixels, width, height, mipCount, format, environmentQuality, environment.Data) &&
+		BlockCompressor::CompressHDR(specular, specularWidth, specularHeight, specularMipCount, specularFormat,
+			environmentQuality, environment.Specular);
+}
+
+void HDRI::LoadBRDF(std::vector<unsigned char>& data)
+{
+	EnvironmentCache cache;
+	if(cache.LoadBRDF(brdfSize, IBLBaker::BRDFSampleCount, data))
+	{
+		return;
+	}
+
+	std::vector<float> lookup;
+	IBLBaker::IntegrateBRDF(brdfSize, lookup);
+
+	BlockCompressor::CompressHDR(lookup, brdfSize, brdfSize, 1, TextureFormat::RGBA16F, CompressionQuality::None, data);
+	cache.StoreBRDF(brdfSize, IBLBaker::BRDFSampleCount, data);
+}
+
+void HDRI::UploadBuffer(const unsigned char* data, int width, int height, int mipCount, TextureFormat format,
+	ComPtr<ID3D12Resource>& resource, int& index)
+{
+	DXGI_FORMAT dxgiFormat = GetDXGIFormat(format);
+	D3D12_RESOURCE_DESC description = CD3DX12_RESOURCE_DESC::Tex2D(dxgiFormat, width, height, 1, mipCount);
+
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources(mipCount);
+	for(int level = 0; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+
+		subresources[level].pData = data + BlockCompressor::GetLevelOffset(format, width, height, level);
+		subresources[level].RowPitch = BlockCompressor::GetRowPitch(format, mipWidth);
+		subresources[level].SlicePitch = BlockCompressor::GetLevelSize(format, mipWidth, mipHeight);
+	}
 
-	ComPtr<ID3D12Resource> intermediate;
-	UploadPixelShaderResource(resource, intermediate, description, subresource);
+	// The environment is kept for the lifetime of the renderer, so its placement is never freed //
+	DXAccess::GetMemoryAllocator()->CreateTexture(description, D3D12_RESOURCE_STATE_COMMON, resource);
+	DXAccess::GetUploadQueue()->UploadTexture(resource, subresources.data(), mipCount);
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-	srvDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	srvDesc.Format = dxgiFormat;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.Texture2D.MipLevels = mipCount;
 
 	DXDescriptorHeap* SRVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	index = SRVHeap->GetNextAvailableIndex();
@@ -0,0 +1,672 @@
+#include "Graphics/HeapAllocator.h"
+
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace
+{
+	// Index of the lowest set bit, 'bits' can't be 0 //
+	unsigned int FindLowestBit(uint64_t bits)
+	{
+		unsigned int index = 0;
+		while((bits & 1) == 0)
+		{
+			bits >>= 1;
+			index++;
+		}
+
+		return index;
+	}
+
+	unsigned int FindHighestBit(uint64_t bits)
+	{
+		unsigned int index = 0;
+		while(bits >>= 1)
+		{
+			index++;
+		}
+
+		return index;
+	}
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+#pragma region TLSFAllocator
+TLSFAllocator::TLSFAllocator(uint64_t capacity, uint64_t granularity) : granularity(granularity)
+{
+	if(granularity == 0 || (granularity & (granularity - 1)) != 0 || capacity < granularity)
+	{
+		assert(false && "TLSF granularity has to be a power of two within the capacity");
+	}
+
+	this->capacity = capacity & ~(granularity - 1);
+
+	// The first level covers everything below 16 granules linearly, every level after that doubles //
+	uint64_t units = this->capacity / granularity;
+	firstLevelCount = units < SecondLevelCount ? 1 : FindHighestBit(units) - 3 + 1;
+
+	secondLevelBitmaps.resize(firstLevelCount, 0);
+	freeLists.resize(firstLevelCount * SecondLevelCount, -1);
+
+	// Starts out as a single free block spanning everything //
+	InsertFreeBlock(CreateBlock(0, this->capacity));
+}
+
+bool TLSFAllocator::Allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+	size = AlignUp(std::max<uint64_t>(size, 1), granularity);
+	alignment = std::max(alignment, granularity);
+
+	int block = FindFreeBlock(size, alignment);
+	if(block < 0)
+	{
+		return false;
+	}
+
+	RemoveFreeBlock(block);
+
+	// 1. Anything in front of the aligned offset stays behind as a free block //
+	uint64_t padding = AlignUp(blocks[block].Offset, alignment) - blocks[block].Offset;
+	if(padding > 0)
+	{
+		SplitBlock(block, padding);
+
+		int front = block;
+		block = blocks[front].NextPhysical;
+
+		RemoveFreeBlock(block);
+		InsertFreeBlock(front);
+	}
+
+	// 2. Trim the tail, so the block is exactly as large as it needs to be //
+	if(blocks[block].Size > size)
+	{
+		SplitBlock(block, size);
+	}
+
+	blocks[block].IsFree = false;
+	allocatedBlocks[blocks[block].Offset] = block;
+	allocatedSize += size;
+
+	offset = blocks[block].Offset;
+	return true;
+}
+
+void TLSFAllocator::Free(uint64_t offset)
+{
+	auto entry = allocatedBlocks.find(offset);
+	if(entry == allocatedBlocks.end())
+	{
+		assert(false && "Freeing an offset that isn't allocated");
+		return;
+	}
+
+	int block = entry->second;
+	allocatedBlocks.erase(entry);
+
+	allocatedSize -= blocks[block].Size;
+	blocks[block].IsFree = true;
+
+	// Merge with free neighbours, so there are never two free blocks next to each other //
+	int previous = blocks[block].PreviousPhysical;
+	if(previous >= 0 && blocks[previous].IsFree)
+	{
+		RemoveFreeBlock(previous);
+		blocks[previous].Size += blocks[block].Size;
+		blocks[previous].NextPhysical = blocks[block].NextPhysical;
+
+		if(blocks[block].NextPhysical >= 0)
+		{
+			blocks[blocks[block].NextPhysical].PreviousPhysical = previous;
+		}
+
+		ReleaseBlock(block);
+		block = previous;
+	}
+
+	int next = blocks[block].NextPhysical;
+	if(next >= 0 && blocks[next].IsFree)
+	{
+		RemoveFreeBlock(next);
+		blocks[block].Size += blocks[next].Size;
+		blocks[block].NextPhysical = blocks[next].NextPhysical;
+
+		if(blocks[next].NextPhysical >= 0)
+		{
+			blocks[blocks[next].NextPhysical].PreviousPhysical = block;
+		}
+
+		ReleaseBlock(next);
+	}
+
+	InsertFreeBlock(block);
+}
+
+uint64_t TLSFAllocator::GetFittingBlockSize(uint64_t size, uint64_t alignment)
+{
+	size = AlignUp(std::max<uint64_t>(size, 1), granularity);
+	alignment = std::max(alignment, granularity);
+
+	int block = FindFreeBlock(size, alignment);
+	return block >= 0 ? blocks[block].Size : 0;
+}
+
+uint64_t TLSFAllocator::GetCapacity()
+{
+	return capacity;
+}
+
+uint64_t TLSFAllocator::GetAllocatedSize()
+{
+	return allocatedSize;
+}
+
+uint64_t TLSFAllocator::GetLargestFreeBlock()
+{
+	if(firstLevelBitmap == 0)
+	{
+		return 0;
+	}
+
+	// Only the highest non-empty bucket can hold the largest block //
+	unsigned int firstLevel = FindHighestBit(firstLevelBitmap);
+	unsigned int secondLevel = FindHighestBit(secondLevelBitmaps[firstLevel]);
+
+	uint64_t largestBlock = 0;
+	for(int block = freeLists[firstLevel * SecondLevelCount + secondLevel]; block >= 0; block = blocks[block].NextFree)
+	{
+		largestBlock = std::max(largestBlock, blocks[block].Size);
+	}
+
+	return largestBlock;
+}
+
+unsigned int TLSFAllocator::GetAllocationCount()
+{
+	return static_cast<unsigned int>(allocatedBlocks.size());
+}
+
+void TLSFAllocator::GetBucket(uint64_t size, unsigned int& firstLevel, unsigned int& secondLevel)
+{
+	uint64_t units = size / granularity;
+
+	if(units < SecondLevelCount)
+	{
+		firstLevel = 0;
+		secondLevel = static_cast<unsigned int>(units);
+		return;
+	}
+
+	unsigned int highestBit = FindHighestBit(units);
+	firstLevel = highestBit - 3;
+	secondLevel = static_cast<unsigned int>(units >> (highestBit - 4)) - SecondLevelCount;
+}
+
+int TLSFAllocator::FindFreeBlock(uint64_t size, uint64_t alignment)
+{
+	// Room for the worst case padding, so any block that gets found can be aligned //
+	uint64_t searchSize = size + alignment - granularity;
+	if(searchSize > capacity)
+	{
+		return -1;
+	}
+
+	// 1. Round up to the next bucket, every block within it is guaranteed to fit //
+	uint64_t units = searchSize / granularity;
+	if(units >= SecondLevelCount)
+	{
+		units += (1ull << (FindHighestBit(units) - 4)) - 1;
+	}
+
+	unsigned int firstLevel;
+	unsigned int secondLevel;
+	GetBucket(units * granularity, firstLevel, secondLevel);
+
+	if(firstLevel < firstLevelCount)
+	{
+		unsigned int secondLevelBits = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if(secondLevelBits != 0)
+		{
+			return freeLists[firstLevel * SecondLevelCount + FindLowestBit(secondLevelBits)];
+		}
+
+		uint64_t firstLevelBits = firstLevel + 1 < 64 ? firstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+		if(firstLevelBits != 0)
+		{
+			firstLevel = FindLowestBit(firstLevelBits);
+			return freeLists[firstLevel * SecondLevelCount + FindLowestBit(secondLevelBitmaps[firstLevel])];
+		}
+	}
+
+	// 2. Blocks in the bucket of the size itself might still fit, which matters when a heap is nearly full //
+	GetBucket(size, firstLevel, secondLevel);
+	for(int block = freeLists[firstLevel * SecondLevelCount + secondLevel]; block >= 0; block = blocks[block].NextFree)
+	{
+		uint64_t end = blocks[block].Offset + blocks[block].Size;
+		if(AlignUp(blocks[block].Offset, alignment) + size <= end)
+		{
+			return block;
+		}
+	}
+
+	return -1;
+}
+
+int TLSFAllocator::CreateBlock(uint64_t offset, uint64_t size)
+{
+	int block;
+	if(!unusedBlocks.empty())
+	{
+		block = unusedBlocks.back();
+		unusedBlocks.pop_back();
+	}
+	else
+	{
+		block = static_cast<int>(blocks.size());
+		blocks.emplace_back();
+	}
+
+	blocks[block] = { offset, size, true, -1, -1, -1, -1 };
+	return block;
+}
+
+void TLSFAllocator::ReleaseBlock(int block)
+{
+	unusedBlocks.push_back(block);
+}
+
+void TLSFAllocator::InsertFreeBlock(int block)
+{
+	unsigned int firstLevel;
+	unsigned int secondLevel;
+	GetBucket(blocks[block].Size, firstLevel, secondLevel);
+
+	int& head = freeLists[firstLevel * SecondLevelCount + secondLevel];
+	blocks[block].IsFree = true;
+	blocks[block].PreviousFree = -1;
+	blocks[block].NextFree = head;
+
+	if(head >= 0)
+	{
+		blocks[head].PreviousFree = block;
+	}
+
+	head = block;
+	firstLevelBitmap |= 1ull << firstLevel;
+	secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+void TLSFAllocator::RemoveFreeBlock(int block)
+{
+	unsigned int firstLevel;
+	unsigned int secondLevel;
+	GetBucket(blocks[block].Size, firstLevel, secondLevel);
+
+	int previous = blocks[block].PreviousFree;
+	int next = blocks[block].NextFree;
+
+	if(previous >= 0)
+	{
+		blocks[previous].NextFree = next;
+	}
+	else
+	{
+		freeLists[firstLevel * SecondLevelCount + secondLevel] = next;
+	}
+
+	if(next >= 0)
+	{
+		blocks[next].PreviousFree = previous;
+	}
+
+	blocks[block].PreviousFree = -1;
+	blocks[block].NextFree = -1;
+
+	// Clear the bits once the bucket runs empty //
+	if(freeLists[firstLevel * SecondLevelCount + secondLevel] < 0)
+	{
+		secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+		if(secondLevelBitmaps[firstLevel] == 0)
+		{
+			firstLevelBitmap &= ~(1ull << firstLevel);
+		}
+	}
+}
+
+void TLSFAllocator::SplitBlock(int block, uint64_t size)
+{
+	// Creating a block can grow 'blocks', so no references are held across it //
+	int remainder = CreateBlock(blocks[block].Offset + size, blocks[block].Size - size);
+	int next = blocks[block].NextPhysical;
+
+	blocks[remainder].PreviousPhysical = block;
+	blocks[remainder].NextPhysical = next;
+	if(next >= 0)
+	{
+		blocks[next].PreviousPhysical = remainder;
+	}
+
+	blocks[block].NextPhysical = remainder;
+	blocks[block].Size = size;
+
+	InsertFreeBlock(remainder);
+}
+#pragma endregion
+
+#pragma region HeapAllocator
+HeapAllocator::HeapAllocator(uint64_t heapSize, uint64_t granularity, uint64_t maxSizeClass) :
+	heapSize(heapSize), granularity(granularity), maxSizeClass(std::min(maxSizeClass, SlabSize / 2))
+{
+	int sizeClassCount = 0;
+	while(this->maxSizeClass >= MinSizeClass && (MinSizeClass << sizeClassCount) <= this->maxSizeClass)
+	{
+		sizeClassCount++;
+	}
+
+	partialSlabs.resize(sizeClassCount);
+}
+
+HeapAllocation HeapAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	if(size == 0)
+	{
+		return HeapAllocation();
+	}
+
+	int sizeClass = GetSizeClass(size, alignment);
+	HeapAllocation allocation = sizeClass >= 0 ? AllocateSlot(sizeClass, size) : AllocateBlock(size, alignment);
+
+	if(allocation.IsValid())
+	{
+		allocation.Size = size;
+		allocationCount++;
+		requestedSize += size;
+	}
+
+	return allocation;
+}
+
+void HeapAllocator::Free(const HeapAllocation& allocation)
+{
+	if(!allocation.IsValid())
+	{
+		return;
+	}
+
+	if(allocation.SizeClass >= 0)
+	{
+		FreeSlot(allocation);
+	}
+	else
+	{
+		heaps[allocation.Heap].Free(allocation.Offset);
+	}
+
+	allocationCount--;
+	requestedSize -= allocation.Size;
+}
+
+unsigned int HeapAllocator::GetHeapCount()
+{
+	return static_cast<unsigned int>(heaps.size());
+}
+
+uint64_t HeapAllocator::GetHeapSize()
+{
+	return heapSize;
+}
+
+HeapAllocatorStatistics HeapAllocator::GetStatistics()
+{
+	HeapAllocatorStatistics statistics;
+	statistics.HeapCount = GetHeapCount();
+	statistics.AllocationCount = allocationCount;
+	statistics.ReservedSize = heapSize * heaps.size();
+	statistics.RequestedSize = requestedSize;
+
+	// External fragmentation is measured within every heap, free memory spread over separate heaps is expected //
+	uint64_t freeSize = 0;
+	uint64_t largestFreeBlocks = 0;
+
+	for(TLSFAllocator& heap : heaps)
+	{
+		statistics.AllocatedSize += heap.GetAllocatedSize();
+		freeSize += heap.GetCapacity() - heap.GetAllocatedSize();
+		largestFreeBlocks += heap.GetLargestFreeBlock();
+	}
+
+	if(statistics.AllocatedSize > 0)
+	{
+		statistics.InternalFragmentation = 1.0f - static_cast<float>(static_cast<double>(requestedSize) / statistics.AllocatedSize);
+	}
+
+	if(freeSize > 0)
+	{
+		statistics.ExternalFragmentation = 1.0f - static_cast<float>(static_cast<double>(largestFreeBlocks) / freeSize);
+	}
+
+	return statistics;
+}
+
+int HeapAllocator::GetSizeClass(uint64_t size, uint64_t alignment)
+{
+	uint64_t slotSize = std::max(std::max(size, alignment), MinSizeClass);
+	if(partialSlabs.empty() || slotSize > maxSizeClass)
+	{
+		return -1;
+	}
+
+	int sizeClass = 0;
+	while((MinSizeClass << sizeClass) < slotSize)
+	{
+		sizeClass++;
+	}
+
+	return sizeClass;
+}
+
+HeapAllocation HeapAllocator::AllocateBlock(uint64_t size, uint64_t alignment)
+{
+	if(std::max(size, alignment) > heapSize)
+	{
+		return HeapAllocation();
+	}
+
+	HeapAllocation allocation;
+	allocation.Size = size;
+
+	// Best fit, splitting the smallest block leaves the large ones for large allocations //
+	uint64_t bestBlockSize = 0;
+	for(unsigned int i = 0; i < heaps.size(); i++)
+	{
+		uint64_t blockSize = heaps[i].GetFittingBlockSize(size, alignment);
+		if(blockSize > 0 && (bestBlockSize == 0 || blockSize < bestBlockSize))
+		{
+			bestBlockSize = blockSize;
+			allocation.Heap = i;
+		}
+	}
+
+	// None of the heaps has room, so a new one gets added //
+	if(bestBlockSize == 0)
+	{
+		heaps.emplace_back(heapSize, granularity);
+		allocation.Heap = static_cast<unsigned int>(heaps.size() - 1);
+	}
+
+	heaps[allocation.Heap].Allocate(size, alignment, allocation.Offset);
+	return allocation;
+}
+
+HeapAllocation HeapAllocator::AllocateSlot(int sizeClass, uint64_t size)
+{
+	uint64_t slotSize = MinSizeClass << sizeClass;
+
+	// 1. Every size class fills up partially used slabs before it takes a new one //
+	if(partialSlabs[sizeClass].empty())
+	{
+		Slab slab;
+		slab.Block = AllocateBlock(SlabSize, SlabSize);
+		slab.SlotCount = static_cast<unsigned int>(SlabSize / slotSize);
+
+		// Reversed, so slots get handed out from the start of the slab //
+		slab.FreeSlots.resize(slab.SlotCount);
+		for(unsigned int i = 0; i < slab.SlotCount; i++)
+		{
+			slab.FreeSlots[i] = slab.SlotCount - 1 - i;
+		}
+
+		SlabKey key(slab.Block.Heap, slab.Block.Offset);
+		slabs[key] = std::move(slab);
+		partialSlabs[sizeClass].insert(key);
+	}
+
+	// 2. Take a slot out of the slab //
+	SlabKey key = *partialSlabs[sizeClass].begin();
+	Slab& slab = slabs[key];
+
+	unsigned int slot = slab.FreeSlots.back();
+	slab.FreeSlots.pop_back();
+
+	if(slab.FreeSlots.empty())
+	{
+		partialSlabs[sizeClass].erase(key);
+	}
+
+	HeapAllocation allocation;
+	allocation.Heap = key.first;
+	allocation.Offset = key.second + slot * slotSize;
+	allocation.Size = size;
+	allocation.SizeClass = sizeClass;
+
+	return allocation;
+}
+
+void HeapAllocator::FreeSlot(const HeapAllocation& allocation)
+{
+	uint64_t slotSize = MinSizeClass << allocation.SizeClass;
+
+	// Slabs are allocated aligned to their size, so the slab of a slot is found by masking its offset //
+	SlabKey key(allocation.Heap, allocation.Offset & ~(SlabSize - 1));
+	auto entry = slabs.find(key);
+
+	if(entry == slabs.end())
+	{
+		assert(false && "Freeing a slot of a slab that doesn't exist");
+		return;
+	}
+
+	Slab& slab = entry->second;
+	slab.FreeSlots.push_back(static_cast<unsigned int>((allocation.Offset - key.second) / slotSize));
+	partialSlabs[allocation.SizeClass].insert(key);
+
+	// Empty slabs go back to the heap, so other size classes & blocks can use the memory //
+	if(slab.FreeSlots.size() == slab.SlotCount)
+	{
+		heaps[key.first].Free(key.second);
+		partialSlabs[allocation.SizeClass].erase(key);
+		slabs.erase(entry);
+	}
+}
+
+void HeapAllocator::RunBenchmark()
+{
+	const uint64_t heapSize = 64ull << 20;
+	const int churnCount = 100000;
+
+	std::mt19937 random(1337);
+
+	// Mesh buffers, sizes are spread evenly on a log scale from 64 bytes to 1 MB //
+	std::uniform_real_distribution<double> logSize(6.0, 20.0);
+	auto bufferSize = [&]()
+	{
+		return static_cast<uint64_t>(std::exp2(logSize(random)));
+	};
+
+	// Block compressed textures with a full mip chain, 128 to 2048 texels wide, square or 2:1 //
+	auto textureSize = [&]()
+	{
+		uint64_t width = 128ull << (random() % 5);
+		uint64_t height = random() % 2 ? width : width / 2;
+		uint64_t bytesPerTexel = random() % 2 ? 1 : 0;
+
+		uint64_t size = bytesPerTexel ? width * height : width * height / 2;
+		return size * 4 / 3;
+	};
+
+	struct Workload
+	{
+		std::string Name;
+		uint64_t Granularity;
+		uint64_t MaxSizeClass;
+		uint64_t Alignment;
+		int LiveCount;
+		std::function<uint64_t()> Size;
+	};
+
+	const Workload workloads[] =
+	{
+		{ "Buffers, with size classes", 256, 32 << 10, 256, 8000, bufferSize },
+		{ "Buffers, blocks only", 256, 0, 256, 8000, bufferSize },
+		{ "Textures", 4 << 10, 0, 4 << 10, 1000, textureSize },
+	};
+
+	for(const Workload& workload : workloads)
+	{
+		HeapAllocator allocator(heapSize, workload.Granularity, workload.MaxSizeClass);
+
+		std::vector<HeapAllocation> allocations;
+		allocations.reserve(workload.LiveCount);
+
+		// 1. Fill up, followed by churn: every step frees a random allocation & makes a new one //
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for(int i = 0; i < workload.LiveCount; i++)
+		{
+			allocations.push_back(allocator.Allocate(workload.Size(), workload.Alignment));
+		}
+
+		for(int i = 0; i < churnCount; i++)
+		{
+			size_t index = random() % allocations.size();
+			allocator.Free(allocations[index]);
+			allocations[index] = allocator.Allocate(workload.Size(), workload.Alignment);
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		double seconds = std::chrono::duration<double>(endTime - startTime).count();
+		double operationCount = workload.LiveCount + churnCount * 2.0;
+
+		// 2. Compare against a committed resource per allocation, which gets rounded up to 64 KB //
+		const uint64_t committedAlignment = 64 << 10;
+		uint64_t committedSize = 0;
+
+		for(const HeapAllocation& allocation : allocations)
+		{
+			committedSize += (allocation.Size + committedAlignment - 1) / committedAlignment * committedAlignment;
+		}
+
+		HeapAllocatorStatistics statistics = allocator.GetStatistics();
+		auto toMB = [](uint64_t size) { return std::to_string(size / (1024.0 * 1024.0)); };
+
+		LOG("Heap allocator benchmark: " + workload.Name + " ( " + std::to_string(workload.LiveCount) + " live allocations )");
+		LOG("  " + std::to_string(operationCount / seconds / 1000000.0) + " million operations per second");
+		LOG("  Heaps: " + std::to_string(statistics.HeapCount) + ", reserved " + toMB(statistics.ReservedSize) + " MB" +
+			", allocated " + toMB(statistics.AllocatedSize) + " MB, requested " + toMB(statistics.RequestedSize) + " MB");
+		LOG("  As committed resources: " + toMB(committedSize) + " MB");
+		LOG("  Internal fragmentation: " + std::to_string(statistics.InternalFragmentation * 100.0f) + "%" +
+			", external fragmentation: " + std::to_string(statistics.ExternalFragmentation * 100.0f) + "%");
+	}
+}
+#pragma endregion
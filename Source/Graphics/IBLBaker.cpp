@@ -0,0 +1,248 @@
+#include "Graphics/IBLBaker.h"
+#include "Graphics/MipGenerator.h"
+
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm.hpp>
+
+static const float PI = 3.14159265359f;
+
+// Low discrepancy sample set, the same one the GPU bakers from the split-sum paper use //
+static glm::vec2 Hammersley(unsigned int index, unsigned int count)
+{
+	unsigned int bits = index;
+	bits = (bits << 16u) | (bits >> 16u);
+	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+	return glm::vec2(static_cast<float>(index) / count, bits * 2.3283064365386963e-10f);
+}
+
+// Half vector around +z, roughness gets squared like D_GGX does in the shaders //
+static glm::vec3 ImportanceSampleGGX(const glm::vec2& xi, float roughness)
+{
+	float a = roughness * roughness;
+	float phi = 2.0f * PI * xi.x;
+	float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+	float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+	return glm::vec3(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+}
+
+// Equirectangular mapping used by the shaders, v = 0 looks down //
+static glm::vec3 GetDirection(int x, int y, int width, int height)
+{
+	float theta = (1.0f - (y + 0.5f) / height) * PI;
+	float phi = ((x + 0.5f) / width) * 2.0f * PI - PI;
+
+	return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+}
+
+static glm::vec3 SampleLevel(const float* pixels, int width, int height, float u, float v)
+{
+	float x = u * width - 0.5f;
+	float y = v * height - 0.5f;
+
+	int x0 = static_cast<int>(std::floor(x));
+	int y0 = static_cast<int>(std::floor(y));
+	float fx = x - x0;
+	float fy = y - y0;
+
+	// Wraps horizontally, clamps at the poles //
+	auto fetch = [&](int px, int py)
+	{
+		px = ((px % width) + width) % width;
+		py = std::min(std::max(py, 0), height - 1);
+
+		const float* pixel = pixels + (static_cast<size_t>(py) * width + px) * 4;
+		return glm::vec3(pixel[0], pixel[1], pixel[2]);
+	};
+
+	glm::vec3 top = glm::mix(fetch(x0, y0), fetch(x0 + 1, y0), fx);
+	glm::vec3 bottom = glm::mix(fetch(x0, y0 + 1), fetch(x0 + 1, y0 + 1), fx);
+	return glm::mix(top, bottom, fy);
+}
+
+static glm::vec3 SampleTrilinear(const std::vector<float>& environment, int width, int height, int mipCount,
+	const glm::vec3& direction, float lod)
+{
+	float u = (std::atan2(direction.z, direction.x) + PI) / (2.0f * PI);
+	float v = 1.0f - std::acos(glm::clamp(direction.y, -1.0f, 1.0f)) / PI;
+
+	lod = glm::clamp(lod, 0.0f, static_cast<float>(mipCount - 1));
+	int level = static_cast<int>(lod);
+	int nextLevel = std::min(level + 1, mipCount - 1);
+
+	auto sample = [&](int mip)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, mip, mipWidth, mipHeight);
+
+		const float* pixels = environment.data() + MipGenerator::GetMipOffset(width, height, mip) * 4;
+		return SampleLevel(pixels, mipWidth, mipHeight, u, v);
+	};
+
+	glm::vec3 color = sample(level);
+	if(nextLevel != level)
+	{
+		color = glm::mix(color, sample(nextLevel), lod - level);
+	}
+
+	return color;
+}
+
+int IBLBaker::PrefilterSpecular(const std::vector<float>& environment, int width, int height, int mipCount,
+	int maxWidth, int maxLevelCount, std::vector<float>& output, int& outputWidth, int& outputHeight)
+{
+	// 1. Level 0 is a mirror, so it's the first environment level that is small enough //
+	int baseLevel = 0;
+	MipGenerator::GetMipSize(width, height, baseLevel, outputWidth, outputHeight);
+
+	while(outputWidth > maxWidth && baseLevel + 1 < mipCount)
+	{
+		baseLevel++;
+		MipGenerator::GetMipSize(width, height, baseLevel, outputWidth, outputHeight);
+	}
+
+	int levelCount = std::min(maxLevelCount, MipGenerator::GetMipCount(outputWidth, outputHeight));
+	output.resize(MipGenerator::GetMipOffset(outputWidth, outputHeight, levelCount) * 4);
+
+	const float* basePixels = environment.data() + MipGenerator::GetMipOffset(width, height, baseLevel) * 4;
+	memcpy(output.data(), basePixels, static_cast<size_t>(outputWidth) * outputHeight * 4 * sizeof(float));
+
+	// Solid angle of a single texel of the full resolution environment, used to pick the mip per sample //
+	float texelSolidAngle = 4.0f * PI / (static_cast<float>(width) * height);
+
+	struct SpecularSample
+	{
+		glm::vec3 Light; // Tangent space, with N = V = +z
+		float NoL;
+		float Lod;
+	};
+
+	// 2. Every other level is a GGX convolution, assuming N = V = R //
+	for(int level = 1; level < levelCount; level++)
+	{
+		float roughness = static_cast<float>(level) / (levelCount - 1);
+		float a = roughness * roughness;
+
+		// Samples only depend on the roughness, so they are shared by every texel of the level //
+		std::vector<SpecularSample> samples;
+		samples.reserve(SpecularSampleCount);
+
+		for(int i = 0; i < SpecularSampleCount; i++)
+		{
+			glm::vec3 halfVector = ImportanceSampleGGX(Hammersley(i, SpecularSampleCount), roughness);
+			float NoH = halfVector.z;
+			glm::vec3 light = 2.0f * NoH * halfVector - glm::vec3(0.0f, 0.0f, 1.0f);
+
+			if(light.z <= 0.0f)
+			{
+				continue;
+			}
+
+			// With V = N the pdf of L simplifies to D / 4 //
+			float denominator = NoH * NoH * (a * a - 1.0f) + 1.0f;
+			float D = (a * a) / (PI * denominator * denominator);
+			float pdf = D * 0.25f + 0.0001f;
+
+			float sampleSolidAngle = 1.0f / (SpecularSampleCount * pdf);
+			float lod = 0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f;
+
+			samples.push_back({ light, light.z, lod });
+		}
+
+		int levelWidth;
+		int levelHeight;
+		MipGenerator::GetMipSize(outputWidth, outputHeight, level, levelWidth, levelHeight);
+		float* levelPixels = output.data() + MipGenerator::GetMipOffset(outputWidth, outputHeight, level) * 4;
+
+		ThreadPool::Get().ParallelFor(static_cast<unsigned int>(levelHeight), [&](unsigned int y)
+		{
+			for(int x = 0; x < levelWidth; x++)
+			{
+				glm::vec3 normal = GetDirection(x, y, levelWidth, levelHeight);
+				glm::vec3 up = std::abs(normal.y) < 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+				glm::vec3 tangent = glm::normalize(glm::cross(up, normal));
+				glm::vec3 bitangent = glm::cross(normal, tangent);
+
+				glm::vec3 color = glm::vec3(0.0f);
+				float totalWeight = 0.0f;
+
+				for(const SpecularSample& sample : samples)
+				{
+					glm::vec3 light = tangent * sample.Light.x + bitangent * sample.Light.y + normal * sample.Light.z;
+					color += SampleTrilinear(environment, width, height, mipCount, light, sample.Lod) * sample.NoL;
+					totalWeight += sample.NoL;
+				}
+
+				color /= std::max(totalWeight, 0.0001f);
+
+				float* pixel = levelPixels + (static_cast<size_t>(y) * levelWidth + x) * 4;
+				pixel[0] = color.r;
+				pixel[1] = color.g;
+				pixel[2] = color.b;
+				pixel[3] = 1.0f;
+			}
+		});
+	}
+
+	return levelCount;
+}
+
+void IBLBaker::IntegrateBRDF(int size, std::vector<float>& output)
+{
+	output.resize(static_cast<size_t>(size) * size * 4);
+
+	ThreadPool::Get().ParallelFor(static_cast<unsigned int>(size), [&](unsigned int y)
+	{
+		float roughness = (y + 0.5f) / size;
+		float a = roughness * roughness;
+
+		// Schlick-GGX geometry term, k is remapped for image based lighting //
+		float k = a * 0.5f;
+
+		for(int x = 0; x < size; x++)
+		{
+			float NoV = (x + 0.5f) / size;
+			glm::vec3 view = glm::vec3(std::sqrt(1.0f - NoV * NoV), 0.0f, NoV);
+
+			float scale = 0.0f;
+			float bias = 0.0f;
+
+			for(int i = 0; i < BRDFSampleCount; i++)
+			{
+				glm::vec3 halfVector = ImportanceSampleGGX(Hammersley(i, BRDFSampleCount), roughness);
+				float VoH = glm::dot(view, halfVector);
+				glm::vec3 light = 2.0f * VoH * halfVector - view;
+
+				float NoL = light.z;
+				float NoH = halfVector.z;
+
+				if(NoL <= 0.0f)
+				{
+					continue;
+				}
+
+				float G = (NoV / (NoV * (1.0f - k) + k)) * (NoL / (NoL * (1.0f - k) + k));
+				float visibility = G * std::max(VoH, 0.0f) / (NoH * NoV);
+				float fresnel = std::pow(1.0f - std::max(VoH, 0.0f), 5.0f);
+
+				scale += (1.0f - fresnel) * visibility;
+				bias += fresnel * visibility;
+			}
+
+			float* pixel = output.data() + (static_cast<size_t>(y) * size + x) * 4;
+			pixel[0] = scale / BRDFSampleCount;
+			pixel[1] = bias / BRDFSampleCount;
+			pixel[2] = 0.0f;
+			pixel[3] = 1.0f;
+		}
+	});
+}
@@ -0,0 +1,133 @@
+#include "Graphics/InstanceBatcher.h"
+#include "Graphics/DXConstantRing.h"
+#include "Graphics/RenderStage.h"
+#include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
+
+#include <algorithm>
+#include <cstring>
+
+void InstanceBatcher::Build(const std::vector<Model*>& models, const ModelVisibility& visibility, const glm::vec3& viewPosition)
+{
+	batches.clear();
+	transforms.clear();
+	batchLookup.clear();
+	meshIDs.clear();
+	meshBatches.resize(visibility.Meshes.size());
+
+	// 1. Count the instances of every mesh, the matrix of every visible model is kept once //
+	for(unsigned int i = 0; i < models.size(); i++)
+	{
+		if(visibility.DrawCounts[i] == 0)
+		{
+			continue;
+		}
+
+		const std::vector<Mesh*>& meshes = models[i]->GetMeshes();
+		unsigned int meshOffset = visibility.MeshOffsets[i];
+		glm::mat4 modelMatrix = models[i]->Transform.GetModelMatrix();
+
+		for(unsigned int j = 0; j < meshes.size(); j++)
+		{
+			if(!visibility.Meshes[meshOffset + j])
+			{
+				continue;
+			}
+
+			Mesh* mesh = meshes[j];
+			unsigned int meshID = meshIDs.emplace(mesh, static_cast<unsigned int>(meshIDs.size())).first->second;
+
+			const BoundingBox& bounds = mesh->GetBounds();
+			glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((bounds.Min + bounds.Max) * 0.5f, 1.0f));
+			float depth = glm::length(center - viewPosition);
+
+			// Transparent placements are never merged, they have to be sorted one by one //
+			unsigned int batchIndex = static_cast<unsigned int>(batches.size());
+			if(!mesh->IsTransparent())
+			{
+				batchIndex = batchLookup.emplace(mesh, batchIndex).first->second;
+			}
+
+			if(batchIndex == batches.size())
+			{
+				batches.push_back({ mesh, 0, 0, meshID, depth });
+			}
+
+			InstanceBatch& batch = batches[batchIndex];
+			batch.InstanceCount++;
+			batch.Depth = std::min(batch.Depth, depth);
+			meshBatches[meshOffset + j] = batchIndex;
+		}
+	}
+
+	// 2. Every batch gets a range of instance indices //
+	unsigned int instanceCount = 0;
+	for(InstanceBatch& batch : batches)
+	{
+		batch.FirstInstance = instanceCount;
+		instanceCount += batch.InstanceCount;
+		batch.InstanceCount = 0;
+	}
+
+	// 3. Fill the ranges with the transform of the model every instance belongs to //
+	instanceIndices.resize(instanceCount);
+
+	for(unsigned int i = 0; i < models.size(); i++)
+	{
+		if(visibility.DrawCounts[i] == 0)
+		{
+			continue;
+		}
+
+		unsigned int transform = static_cast<unsigned int>(transforms.size());
+		transforms.push_back(models[i]->Transform.GetModelMatrix());
+
+		unsigned int meshOffset = visibility.MeshOffsets[i];
+		for(unsigned int j = 0; j < models[i]->GetMeshes().size(); j++)
+		{
+			if(visibility.Meshes[meshOffset + j])
+			{
+				InstanceBatch& batch = batches[meshBatches[meshOffset + j]];
+				instanceIndices[batch.FirstInstance + batch.InstanceCount++] = transform;
+			}
+		}
+	}
+
+	drawCounts.assign(batches.size(), 1);
+}
+
+InstanceBuffers InstanceBatcher::Upload(DXConstantRing* constantRing)
+{
+	// Never empty, so there's always a valid address to bind //
+	size_t indexCount = std::max(instanceIndices.size(), size_t(1));
+	size_t transformCount = std::max(transforms.size(), size_t(1));
+
+	ConstantAllocation indices = constantRing->Allocate(static_cast<unsigned int>(indexCount * sizeof(unsigned int)));
+	ConstantAllocation matrices = constantRing->Allocate(static_cast<unsigned int>(transformCount * sizeof(glm::mat4)));
+
+	if(!instanceIndices.empty())
+	{
+		memcpy(indices.CPU, instanceIndices.data(), instanceIndices.size() * sizeof(unsigned int));
+		memcpy(matrices.CPU, transforms.data(), transforms.size() * sizeof(glm::mat4));
+	}
+
+	InstanceBuffers buffers;
+	buffers.Indices = indices.GPU;
+	buffers.Transforms = matrices.GPU;
+	return buffers;
+}
+
+const std::vector<InstanceBatch>& InstanceBatcher::GetBatches()
+{
+	return batches;
+}
+
+const std::vector<unsigned int>& InstanceBatcher::GetDrawCounts()
+{
+	return drawCounts;
+}
+
+unsigned int InstanceBatcher::GetInstanceCount()
+{
+	return static_cast<unsigned int>(instanceIndices.size());
+}
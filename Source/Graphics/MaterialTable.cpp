@@ -0,0 +1,144 @@
+#include "Graphics/MaterialTable.h"
+#include "Graphics/DXConstantRing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+unsigned int MaterialTable::Acquire(const MaterialData& material)
+{
+	// MaterialData has no padding, so identical materials are identical bytes //
+	uint64_t hash = Hash(material);
+	auto range = lookup.equal_range(hash);
+
+	for(auto entry = range.first; entry != range.second; entry++)
+	{
+		if(memcmp(&materials[entry->second], &material, sizeof(MaterialData)) == 0)
+		{
+			referenceCounts[entry->second]++;
+			referenceCount++;
+			return entry->second;
+		}
+	}
+
+	unsigned int index;
+	if(!freeSlots.empty())
+	{
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<unsigned int>(materials.size());
+		materials.emplace_back();
+		referenceCounts.push_back(0);
+	}
+
+	materials[index] = material;
+	referenceCounts[index] = 1;
+	referenceCount++;
+	lookup.emplace(hash, index);
+
+	return index;
+}
+
+void MaterialTable::Release(unsigned int index)
+{
+	if(index >= materials.size() || referenceCounts[index] == 0)
+	{
+		assert(false && "Releasing a material that isn't in the table");
+		return;
+	}
+
+	referenceCount--;
+	referenceCounts[index]--;
+	if(referenceCounts[index] > 0)
+	{
+		return;
+	}
+
+	auto range = lookup.equal_range(Hash(materials[index]));
+	for(auto entry = range.first; entry != range.second; entry++)
+	{
+		if(entry->second == index)
+		{
+			lookup.erase(entry);
+			break;
+		}
+	}
+
+	freeSlots.push_back(index);
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS MaterialTable::Upload(DXConstantRing* constantRing)
+{
+	// Never empty, so there's always a valid address to bind. Released slots get copied as well,
+	// nothing indexes them, this keeps it a single copy
+	unsigned int materialCount = std::max(static_cast<unsigned int>(materials.size()), 1u);
+	ConstantAllocation allocation = constantRing->Allocate(materialCount * sizeof(MaterialData));
+
+	if(!materials.empty())
+	{
+		memcpy(allocation.CPU, materials.data(), materials.size() * sizeof(MaterialData));
+	}
+
+	return allocation.GPU;
+}
+
+unsigned int MaterialTable::GetMaterialCount()
+{
+	return static_cast<unsigned int>(materials.size() - freeSlots.size());
+}
+
+unsigned int MaterialTable::GetReferenceCount()
+{
+	return referenceCount;
+}
+
+MaterialData MaterialTable::Pack(const Material& material, const unsigned int textureIndices[MATERIAL_TEXTURE_COUNT])
+{
+	MaterialData data = {};
+	data.Color = material.Color;
+	data.Metallic = material.Metallic;
+	data.Roughness = material.Roughness;
+	data.Opacity = material.Opacity;
+	data.AlphaCutoff = material.alphaMask ? material.AlphaCutoff : 0.0f;
+
+	data.Flags |= material.hasAlbedo ? MATERIAL_HAS_ALBEDO : 0;
+	data.Flags |= material.hasNormal ? MATERIAL_HAS_NORMAL : 0;
+	data.Flags |= material.hasMetallicRoughness ? MATERIAL_HAS_METALLIC_ROUGHNESS : 0;
+	data.Flags |= material.hasOcclusion ? MATERIAL_HAS_OCCLUSION : 0;
+	data.Flags |= material.hasEmissive ? MATERIAL_HAS_EMISSIVE : 0;
+	data.Flags |= material.useTextures ? MATERIAL_USE_TEXTURES : 0;
+	data.Flags |= material.alphaMask ? MATERIAL_ALPHA_TEST : 0;
+
+	data.Flags |= (material.oChannel & 3u) << MATERIAL_OCCLUSION_CHANNEL_SHIFT;
+	data.Flags |= (material.rChannel & 3u) << MATERIAL_ROUGHNESS_CHANNEL_SHIFT;
+	data.Flags |= (material.mChannel & 3u) << MATERIAL_METALLIC_CHANNEL_SHIFT;
+
+	// A texture that isn't used doesn't make a material unique, so its index isn't stored //
+	const unsigned int textureFlags[MATERIAL_TEXTURE_COUNT] = { MATERIAL_HAS_ALBEDO, MATERIAL_HAS_NORMAL,
+		MATERIAL_HAS_METALLIC_ROUGHNESS, MATERIAL_HAS_OCCLUSION, MATERIAL_HAS_EMISSIVE };
+
+	for(int i = 0; i < MATERIAL_TEXTURE_COUNT; i++)
+	{
+		data.TextureIndices[i] = (data.Flags & textureFlags[i]) ? textureIndices[i] : 0;
+	}
+
+	return data;
+}
+
+uint64_t MaterialTable::Hash(const MaterialData& material)
+{
+	// FNV-1a //
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&material);
+	uint64_t hash = 14695981039346656037ull;
+
+	for(size_t i = 0; i < sizeof(MaterialData); i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
@@ -1,28 +1,37 @@
 #include "Graphics/Mesh.h"
 #include "Graphics/DXAccess.h"
 #include "Graphics/DXUtilities.h"
+#include "Graphics/DXUploadQueue.h"
 #include "Graphics/Texture.h"
+#include "Graphics/TextureRegistry.h"
+#include "Graphics/MaterialTable.h"
 #include <cassert>
 
-Mesh::Mesh(tinygltf::Model& model, tinygltf::Primitive& primitive, glm::mat4& transform)
+Mesh::Mesh(ImportedMesh& importedMesh, const std::string& modelPath, const std::vector<ImportedTexture>& textures)
 {
-	// A 'Mesh' exists out of multiple primitives, usually this is one
-	// but it can be more. Each primitive contains the geometry data (triangles, lines etc. )
-	// to render the model
-	LoadAttribute(model, primitive, "POSITION");
-	LoadAttribute(model, primitive, "NORMAL");
-	LoadAttribute(model, primitive, "TANGENT");
-	LoadAttribute(model, primitive, "TEXCOORD_0");
+	// All decoding already happened in the ModelImporter, what's
+	// left is moving the data in & creating the GPU resources
+	Name = importedMesh.Name;
+	Material = importedMesh.Material;
 
-	LoadIndices(model, primitive);
-	LoadMaterial(model, primitive);
+	vertices = std::move(importedMesh.Vertices);
+	indices = std::move(importedMesh.Indices);
+	bounds = importedMesh.Bounds;
+	boundingSphere = importedMesh.Sphere;
 
-	GenerateTangents();
-	
-	ApplyNodeTransform(transform);
+	LoadTexture(&albedoTexture, modelPath, textures, importedMesh.AlbedoTexture, Material.hasAlbedo);
+	LoadTexture(&normalTexture, modelPath, textures, importedMesh.NormalTexture, Material.hasNormal);
+	LoadTexture(&metallicRoughnessTexture, modelPath, textures, importedMesh.MetallicRoughnessTexture, Material.hasMetallicRoughness);
+	LoadTexture(&occlusionTexture, modelPath, textures, importedMesh.OcclusionTexture, Material.hasOcclusion);
+	LoadTexture(&emissiveTexture, modelPath, textures, importedMesh.EmissiveTexture, Material.hasEmissive);
+	UpdateMaterial();
+
+	// Incase a mesh is loaded through the importer, it is assumed
+	// either textures or colors were present, when the other Mesh constructor is used
+	// with raw data, then it's assumed no textures are present. For example with the Screen Quad.
+	hasTextures = true;
 
 	UploadBuffers();
-	UpdateMaterialData();
 }
 
 Mesh::Mesh(Vertex* verts, unsigned int vertexCount, unsigned int* indi, unsigned int indexCount)
@@ -37,19 +46,40 @@ Mesh::Mesh(Vertex* verts, unsigned int vertexCount, unsigned int* indi, unsigned
 		indices.push_back(indi[i]);
 	}
 
+	if(vertexCount > 0)
+	{
+		bounds = ComputeBoundingBox(&verts[0].Position, vertexCount, sizeof(Vertex));
+		boundingSphere = ComputeBoundingSphere(&verts[0].Position, vertexCount, bounds, sizeof(Vertex));
+	}
+
 	UploadBuffers();
-	UpdateMaterialData();
 }
 
-void Mesh::UpdateMaterialData()
+Mesh::~Mesh()
 {
-	if(materialCBVIndex < 0)
+	TextureRegistry* textureRegistry = DXAccess::GetTextureRegistry();
+	Texture* textures[5] = { albedoTexture, normalTexture, metallicRoughnessTexture, occlusionTexture, emissiveTexture };
+
+	for(Texture* texture : textures)
 	{
-		DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		materialCBVIndex = CBVHeap->GetNextAvailableIndex();
+		if(texture)
+		{
+			textureRegistry->Release(texture);
+		}
+	}
+
+	if(materialIndex != MaterialTable::InvalidIndex)
+	{
+		DXAccess::GetMaterialTable()->Release(materialIndex);
 	}
 
-	UpdateInFlightCBV(materialBuffer, materialCBVIndex, 1, sizeof(Material), &Material);
+	// The buffers are ranges within a shared heap, so the copy into them has to be done before they're reused.
+	// Like textures, it's up to the owner to make sure the GPU is no longer drawing the mesh.
+	DXAccess::GetUploadQueue()->GetQueue().Wait(uploadTicket);
+
+	DXMemoryAllocator* memoryAllocator = DXAccess::GetMemoryAllocator();
+	memoryAllocator->FreeBuffer(vertexBuffer);
+	memoryAllocator->FreeBuffer(indexBuffer);
 }
 
 const D3D12_VERTEX_BUFFER_VIEW& Mesh::GetVertexBufferView()
@@ -62,13 +92,6 @@ const D3D12_INDEX_BUFFER_VIEW& Mesh::GetIndexBufferView()
 	return indexBufferView;
 }
 
-const CD3DX12_GPU_DESCRIPTOR_HANDLE Mesh::GetMaterialView()
-{
-	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	CD3DX12_GPU_DESCRIPTOR_HANDLE handle = CBVHeap->GetGPUHandleAt(materialCBVIndex);
-	return handle;
-}
-
 const unsigned int Mesh::GetIndicesCount()
 {
 	return indicesCount;
@@ -79,247 +102,93 @@ bool Mesh::HasTextures()
 	return hasTextures;
 }
 
-unsigned int Mesh::GetTextureID()
+bool Mesh::IsTransparent()
 {
-	// Returns the first SRV of the group:
-	// Albedo, Normal, MetallicRoughness, Ambient Occlusion
-	return albedoTexture->GetSRVIndex();
+	return Material.alphaBlend || (!Material.alphaMask && Material.Opacity < 1.0f);
 }
 
-void Mesh::LoadAttribute(tinygltf::Model& model, tinygltf::Primitive& primitive, const std::string& attributeType)
+unsigned int Mesh::GetMaterialIndex()
 {
-	auto attribute = primitive.attributes.find(attributeType);
-
-	// Check if within the primitives's attributes the type is present. For example 'Normals'
-	// If not, stop here, the model isn't valid
-	if (attribute == primitive.attributes.end())
-	{
-		std::string message = "Attribute Type: '" + attributeType + "' missing from model.";
-		LOG(Log::MessageType::Debug, message);
-		return;
-	}
-
-	// Accessor: Tells use which view we need, what type of data is in it, and the amount/count of data.
-	// BufferView: Tells which buffer we need, and where we need to be in the buffer
-	// Buffer: Binary data of our mesh
-	tinygltf::Accessor& accessor = model.accessors[primitive.attributes.at(attributeType)];
-	tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-	tinygltf::Buffer& buffer = model.buffers[view.buffer];
-
-	// Component: default type like float, int
-	// Type: a structure made out of components, e.g VEC2 ( 2x float )
-	unsigned int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-	unsigned int objectSize = tinygltf::GetNumComponentsInType(accessor.type);
-	unsigned int dataSize = componentSize * objectSize;
-
-	// Accessor byteoffset: Offset to first element of type
-	// BufferView byteoffset: Offset to get to this primitives buffer data in the overall buffer
-	unsigned int bufferStart = accessor.byteOffset + view.byteOffset;
-
-	// Stride: Distance in buffer till next elelemt occurs
-	unsigned int stride = accessor.ByteStride(view);
-
-	// In case it hasn't happened, resize the vertex buffer since we're 
-	// going to directly memcpy the data into an already existing buffer
-	if (vertices.size() < accessor.count)
-	{
-		vertices.resize(accessor.count);
-	}
-
-	for (int i = 0; i < accessor.count; i++)
-	{
-		Vertex& vertex = vertices[i];
-		size_t bufferLocation = bufferStart + (i * stride);
-
-		// TODO: Add 'offsetto' to this and use pointers to vertices instead of a reference
-		if (attributeType == "POSITION")
-		{
-			memcpy(&vertex.Position, &buffer.data[bufferLocation], dataSize);
-		}
-		else if (attributeType == "NORMAL")
-		{
-			memcpy(&vertex.Normal, &buffer.data[bufferLocation], dataSize);
-		}
-		else if(attributeType == "TANGENT")
-		{
-			memcpy(&vertex.Tangent, &buffer.data[bufferLocation], dataSize);
-		}
-		else if(attributeType == "TEXCOORD_0")
-		{
-			memcpy(&vertex.TexCoord, &buffer.data[bufferLocation], dataSize);
-		}
-	}
+	return materialIndex;
 }
 
-void Mesh::LoadIndices(tinygltf::Model& model, tinygltf::Primitive& primitive)
+const BoundingBox& Mesh::GetBounds()
 {
-	tinygltf::Accessor& accessor = model.accessors[primitive.indices];
-	tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-	tinygltf::Buffer& buffer = model.buffers[view.buffer];
-
-	unsigned int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-	unsigned int objectSize = tinygltf::GetNumComponentsInType(accessor.type);
-	unsigned int dataSize = componentSize * objectSize;
-
-	unsigned int bufferStart = accessor.byteOffset + view.byteOffset;
-	unsigned int stride = accessor.ByteStride(view);
-
-	for (int i = 0; i < accessor.count; i++)
-	{
-		size_t bufferLocation = bufferStart + (i * stride);
-
-		if (componentSize == 2)
-		{
-			short index;
-			memcpy(&index, &buffer.data[bufferLocation], dataSize);
-			indices.push_back(index);
-		}
-		else if (componentSize == 4)
-		{
-			unsigned int index;
-			memcpy(&index, &buffer.data[bufferLocation], dataSize);
-			indices.push_back(index);
-		}
-	}
+	return bounds;
 }
 
-void Mesh::LoadMaterial(tinygltf::Model& model, tinygltf::Primitive& primitive)
+const BoundingSphere& Mesh::GetBoundingSphere()
 {
-	// For now, do only color //
-	tinygltf::Accessor& accessor = model.accessors[primitive.attributes.at("POSITION")];
-	tinygltf::Material& mat = model.materials[primitive.material];
-
-	for (int i = 0; i < accessor.count; i++)
-	{
-		Vertex& vertex = vertices[i];
-
-		// TODO: Memcpy or send pointer
-		vertex.Color.x = mat.pbrMetallicRoughness.baseColorFactor[0];
-		vertex.Color.y = mat.pbrMetallicRoughness.baseColorFactor[1];
-		vertex.Color.z = mat.pbrMetallicRoughness.baseColorFactor[2];
-	}
-
-	int albedoID = mat.pbrMetallicRoughness.baseColorTexture.index;
-	int normalID = mat.normalTexture.index;
-	int metallicRoughnessID = mat.pbrMetallicRoughness.metallicRoughnessTexture.index;
-	int occlusionID = mat.occlusionTexture.index;
-	int emissiveID = mat.emissiveTexture.index;
-
-	LoadTexture(model, &albedoTexture, albedoID, Material.hasAlbedo);
-	LoadTexture(model, &normalTexture, normalID, Material.hasNormal);
-	LoadTexture(model, &metallicRoughnessTexture, metallicRoughnessID, Material.hasMetallicRoughness);
-	LoadTexture(model, &occlusionTexture, occlusionID, Material.hasOcclusion);
-	LoadTexture(model, &emissiveTexture, emissiveID, Material.hasEmissive);
+	return boundingSphere;
+}
 
-	// Incase a mesh is loaded through a TinyglTF primitive, it is assumed
-	// either textures or colors were present, when the other Mesh constructor is used
-	// with raw data, then it's assumed no textures are present. For example with the Screen Quad.
-	hasTextures = true;
+const UploadTicket& Mesh::GetUploadTicket()
+{
+	return uploadTicket;
 }
 
-void Mesh::LoadTexture(tinygltf::Model& model, Texture** texture, int textureID, int& materialCheck)
+void Mesh::LoadTexture(Texture** texture, const std::string& modelPath, const std::vector<ImportedTexture>& textures,
+	int textureIndex, int& materialCheck)
 {
-	if(textureID != -1)
+	// Textures are shared through the registry, so images used by
+	// multiple meshes only get uploaded once
+	TextureRegistry* textureRegistry = DXAccess::GetTextureRegistry();
+
+	if(textureIndex != -1 && !textures[textureIndex].Pixels.empty())
 	{
-		*texture = new Texture(model, model.textures[textureID]);
+		*texture = textureRegistry->Acquire(modelPath, textureIndex, textures[textureIndex]);
 		materialCheck = 1;
 	}
 	else
 	{
-		// TODO: Incase we are allowed to bind Individual SRVs, then do this, temporarily we do this 
-		//*texture = DXAccess::GetDefaultTexture();
-		*texture = new Texture("Assets/Textures/error.jpg");
+		*texture = textureRegistry->Acquire("Assets/Textures/error.jpg");
 		materialCheck = 0;
 	}
 }
 
-void Mesh::GenerateTangents()
+void Mesh::UpdateMaterial()
 {
-	Vertex& vertex = vertices[0];
+	// The shader indexes the heap directly, so the views the textures already own are enough //
+	Texture* textures[MATERIAL_TEXTURE_COUNT] = { albedoTexture, normalTexture, metallicRoughnessTexture, occlusionTexture, emissiveTexture };
+	unsigned int textureIndices[MATERIAL_TEXTURE_COUNT];
 
-	// Incase the vertex doesn't have the default value of a zero-vector
-	// it means that the Tangent attribute was present for the model
-	// if not, we need to generate them.
-	if(vertex.Tangent != glm::vec3(0.0f))
+	for(int i = 0; i < MATERIAL_TEXTURE_COUNT; i++)
 	{
-		return;
+		textureIndices[i] = textures[i]->GetSRVIndex();
 	}
 
-	// Grab the average tangent of all triangles in the model //
-	for(unsigned int i = 0; i < indices.size(); i += 3)
-	{
-		Vertex& v0 = vertices[indices[i]];
-		Vertex& v1 = vertices[indices[i + 1]];
-		Vertex& v2 = vertices[indices[i + 2]];
-
-		glm::vec3 tangent;
-
-		// Edges of triangles //
-		glm::vec3 edge1 = v1.Position - v0.Position;
-		glm::vec3 edge2 = v2.Position - v0.Position;
-		
-		// UV deltas //
-		glm::vec2 deltaUV1 = v1.TexCoord - v0.TexCoord;
-		glm::vec2 deltaUV2 = v2.TexCoord - v0.TexCoord;
-
-		float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-		tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * f;
-
-		v0.Tangent += tangent;
-		v1.Tangent += tangent;
-		v2.Tangent += tangent;
-
-		v0.Tangent = glm::normalize(v0.Tangent);
-		v1.Tangent = glm::normalize(v1.Tangent);
-		v2.Tangent = glm::normalize(v2.Tangent);
-	}
-}
+	// Acquired before the old one is released, so an unchanged material keeps its entry //
+	MaterialTable* materialTable = DXAccess::GetMaterialTable();
+	unsigned int previousIndex = materialIndex;
+	materialIndex = materialTable->Acquire(MaterialTable::Pack(Material, textureIndices));
 
-void Mesh::ApplyNodeTransform(const glm::mat4& transform)
-{
-	for (Vertex& vertex : vertices)
+	if(previousIndex != MaterialTable::InvalidIndex)
 	{
-		glm::vec4 vert = glm::vec4(vertex.Position.x, vertex.Position.y, vertex.Position.z, 1.0f);
-		vertex.Position = transform * vert;
-
-		glm::vec4 norm = glm::vec4(vertex.Normal.x, vertex.Normal.y, vertex.Normal.z, 0.0f);
-		vertex.Normal = glm::normalize(transform * norm);
-
-		glm::vec4 tang = glm::vec4(vertex.Tangent.x, vertex.Tangent.y, vertex.Tangent.z, 0.0f);
-		vertex.Tangent = glm::normalize(transform * tang);
+		materialTable->Release(previousIndex);
 	}
 }
 
 void Mesh::UploadBuffers()
 {
-	DXCommands* copyCommands = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_COPY);
-	ComPtr<ID3D12GraphicsCommandList2> copyCommandList = copyCommands->GetGraphicsCommandList();
-	copyCommands->ResetCommandList();
+	// 1. Sub-allocate & queue the vertex & index buffers, both end up in the same batch as the rest of the model //
+	DXMemoryAllocator* memoryAllocator = DXAccess::GetMemoryAllocator();
+	vertexBuffer = memoryAllocator->AllocateBuffer(vertices.size() * sizeof(Vertex));
+	indexBuffer = memoryAllocator->AllocateBuffer(indices.size() * sizeof(unsigned int));
 
-	// 1. Record commands to upload vertex & index buffers //
-	ComPtr<ID3D12Resource> intermediateVertexBuffer;
-	UpdateBufferResource(copyCommandList, &vertexBuffer, &intermediateVertexBuffer, vertices.size(),
-		sizeof(Vertex), vertices.data(), D3D12_RESOURCE_FLAG_NONE);
-
-	ComPtr<ID3D12Resource> intermediateIndexBuffer;
-	UpdateBufferResource(copyCommandList, &indexBuffer, &intermediateIndexBuffer, indices.size(),
-		sizeof(unsigned int), indices.data(), D3D12_RESOURCE_FLAG_NONE);
+	DXUploadQueue* uploadQueue = DXAccess::GetUploadQueue();
+	uploadQueue->UploadBuffer(vertexBuffer, vertices.data(), vertices.size() * sizeof(Vertex));
+	uploadTicket = uploadQueue->UploadBuffer(indexBuffer, indices.data(), indices.size() * sizeof(unsigned int));
 
 	// 2. Retrieve info about from the buffers to create Views  // 
-	vertexBufferView.BufferLocation = vertexBuffer->GetGPUVirtualAddress();
+	vertexBufferView.BufferLocation = vertexBuffer.GPU;
 	vertexBufferView.SizeInBytes = vertices.size() * sizeof(Vertex);
 	vertexBufferView.StrideInBytes = sizeof(Vertex);
 
-	indexBufferView.BufferLocation = indexBuffer->GetGPUVirtualAddress();
+	indexBufferView.BufferLocation = indexBuffer.GPU;
 	indexBufferView.SizeInBytes = indices.size() * sizeof(unsigned int);
 	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
 
-	// 3.Execute the copying on the command queue & wait until it's done // 
-	copyCommands->ExecuteCommandList(DXAccess::GetCurrentBackBufferIndex());
-	copyCommands->Signal();
-	copyCommands->WaitForFenceValue(DXAccess::GetCurrentBackBufferIndex());
-
-	// 4. Clear CPU data // 
+	// 3. Clear CPU data, it has already been copied into staging memory // 
 	indicesCount = indices.size();
 	vertices.clear();
 	indices.clear();
@@ -0,0 +1,358 @@
+#include "Graphics/MipGenerator.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVA_SSE_MIPS
+#include <xmmintrin.h>
+#endif
+
+// Lookup tables for sRGB conversions //
+// Decoding goes through a direct table, encoding searches the linear value
+// of every halfway point between two bytes, which rounds the same as the exact formula would.
+struct SRGBTables
+{
+	float Decode[256];
+	float Thresholds[255];
+
+	SRGBTables()
+	{
+		for(int i = 0; i < 256; i++)
+		{
+			Decode[i] = ToLinear(i / 255.0f);
+		}
+
+		for(int i = 0; i < 255; i++)
+		{
+			Thresholds[i] = ToLinear((i + 0.5f) / 255.0f);
+		}
+	}
+
+	static float ToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	unsigned char Encode(float value) const
+	{
+		int low = 0;
+		int high = 255;
+
+		// Finds the amount of thresholds below the value //
+		while(low < high)
+		{
+			int middle = (low + high) / 2;
+			if(Thresholds[middle] < value)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		return static_cast<unsigned char>(low);
+	}
+};
+
+static const SRGBTables& GetSRGBTables()
+{
+	static SRGBTables tables;
+	return tables;
+}
+
+static unsigned char ToUnorm8(float value)
+{
+	value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	return static_cast<unsigned char>(value * 255.0f + 0.5f);
+}
+
+int MipGenerator::GenerateRGBA8(std::vector<unsigned char>& pixels, int width, int height, bool isSRGB, MipFilter filter)
+{
+	int mipCount = GetMipCount(width, height);
+	if(mipCount == 1)
+	{
+		return 1;
+	}
+
+	const SRGBTables& tables = GetSRGBTables();
+
+	// 1. Convert to linear floats, alpha is always linear //
+	std::vector<float> linear(static_cast<size_t>(width) * height * 4);
+	for(size_t i = 0; i < linear.size(); i++)
+	{
+		bool isColor = (i & 3) != 3;
+		linear[i] = isSRGB && isColor ? tables.Decode[pixels[i]] : pixels[i] / 255.0f;
+	}
+
+	pixels.resize(GetMipOffset(width, height, mipCount) * 4);
+
+	// 2. Every level gets filtered from the previous ( float ) level //
+	std::vector<float> next;
+	int sourceWidth = width;
+	int sourceHeight = height;
+
+	for(int level = 1; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		GetMipSize(width, height, level, mipWidth, mipHeight);
+
+		next.resize(static_cast<size_t>(mipWidth) * mipHeight * 4);
+		Downsample(linear.data(), sourceWidth, sourceHeight, next.data(), mipWidth, mipHeight, filter);
+
+		// 3. Store the level back into 8 bits //
+		unsigned char* destination = pixels.data() + GetMipOffset(width, height, level) * 4;
+		for(size_t i = 0; i < next.size(); i++)
+		{
+			bool isColor = (i & 3) != 3;
+			destination[i] = isSRGB && isColor ? tables.Encode(next[i]) : ToUnorm8(next[i]);
+		}
+
+		linear.swap(next);
+		sourceWidth = mipWidth;
+		sourceHeight = mipHeight;
+	}
+
+	return mipCount;
+}
+
+int MipGenerator::GenerateRGBA32F(std::vector<float>& pixels, int width, int height, MipFilter filter)
+{
+	int mipCount = GetMipCount(width, height);
+	pixels.resize(GetMipOffset(width, height, mipCount) * 4);
+
+	for(int level = 1; level < mipCount; level++)
+	{
+		int sourceWidth;
+		int sourceHeight;
+		int mipWidth;
+		int mipHeight;
+		GetMipSize(width, height, level - 1, sourceWidth, sourceHeight);
+		GetMipSize(width, height, level, mipWidth, mipHeight);
+
+		const float* source = pixels.data() + GetMipOffset(width, height, level - 1) * 4;
+		float* destination = pixels.data() + GetMipOffset(width, height, level) * 4;
+		Downsample(source, sourceWidth, sourceHeight, destination, mipWidth, mipHeight, filter);
+
+		// HDR data can't go negative, which the negative lobes of the Kaiser filter could cause //
+		if(filter == MipFilter::Kaiser)
+		{
+			for(size_t i = 0; i < static_cast<size_t>(mipWidth) * mipHeight * 4; i++)
+			{
+				destination[i] = destination[i] < 0.0f ? 0.0f : destination[i];
+			}
+		}
+	}
+
+	return mipCount;
+}
+
+int MipGenerator::GetMipCount(int width, int height)
+{
+	int largest = width > height ? width : height;
+	int mipCount = 1;
+
+	while(largest > 1)
+	{
+		largest /= 2;
+		mipCount++;
+	}
+
+	return mipCount;
+}
+
+void MipGenerator::GetMipSize(int width, int height, int level, int& mipWidth, int& mipHeight)
+{
+	mipWidth = width >> level;
+	mipHeight = height >> level;
+
+	mipWidth = mipWidth < 1 ? 1 : mipWidth;
+	mipHeight = mipHeight < 1 ? 1 : mipHeight;
+}
+
+size_t MipGenerator::GetMipOffset(int width, int height, int level)
+{
+	size_t offset = 0;
+	for(int i = 0; i < level; i++)
+	{
+		int mipWidth;
+		int mipHeight;
+		GetMipSize(width, height, i, mipWidth, mipHeight);
+		offset += static_cast<size_t>(mipWidth) * mipHeight;
+	}
+
+	return offset;
+}
+
+void MipGenerator::Downsample(const float* source, int sourceWidth, int sourceHeight,
+	float* destination, int destinationWidth, int destinationHeight, MipFilter filter)
+{
+	switch(filter)
+	{
+	case MipFilter::Box:
+		DownsampleBox(source, sourceWidth, sourceHeight, destination, destinationWidth, destinationHeight);
+		break;
+
+	case MipFilter::Kaiser:
+		DownsampleKaiser(source, sourceWidth, sourceHeight, destination, destinationWidth, destinationHeight);
+		break;
+	}
+}
+
+void MipGenerator::DownsampleBox(const float* source, int sourceWidth, int sourceHeight,
+	float* destination, int destinationWidth, int destinationHeight)
+{
+	for(int y = 0; y < destinationHeight; y++)
+	{
+		// Odd sizes ( and 1 pixel wide levels ) reuse the last row/column //
+		int y0 = y * 2 < sourceHeight ? y * 2 : sourceHeight - 1;
+		int y1 = y * 2 + 1 < sourceHeight ? y * 2 + 1 : sourceHeight - 1;
+
+		const float* row0 = source + static_cast<size_t>(y0) * sourceWidth * 4;
+		const float* row1 = source + static_cast<size_t>(y1) * sourceWidth * 4;
+		float* output = destination + static_cast<size_t>(y) * destinationWidth * 4;
+
+		for(int x = 0; x < destinationWidth; x++)
+		{
+			int x0 = (x * 2 < sourceWidth ? x * 2 : sourceWidth - 1) * 4;
+			int x1 = (x * 2 + 1 < sourceWidth ? x * 2 + 1 : sourceWidth - 1) * 4;
+
+#ifdef NOVA_SSE_MIPS
+			// A full RGBA pixel fits in a single register //
+			__m128 sum = _mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1));
+			sum = _mm_add_ps(sum, _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+			_mm_storeu_ps(output + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+			for(int c = 0; c < 4; c++)
+			{
+				output[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+			}
+#endif
+		}
+	}
+}
+
+// Modified Bessel function of the first kind, order 0. Used by the Kaiser window //
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+
+	for(int k = 1; k < 32; k++)
+	{
+		double factor = x / (2.0 * k);
+		term *= factor * factor;
+		sum += term;
+	}
+
+	return sum;
+}
+
+void MipGenerator::DownsampleKaiser(const float* source, int sourceWidth, int sourceHeight,
+	float* destination, int destinationWidth, int destinationHeight)
+{
+	// The destination pixel x lies between source pixels 2x and 2x + 1.
+	// Taps are placed at distances 0.5, 1.5 & 2.5 on both sides of it.
+	const int tapCount = 6;
+	const double alpha = 4.0;
+	const double radius = 3.0;
+	const double pi = 3.14159265358979323846;
+
+	float weights[tapCount];
+	float weightSum = 0.0f;
+
+	for(int i = 0; i < tapCount; i++)
+	{
+		double distance = (i - 2) - 0.5;
+		double x = distance * 0.5;
+		double sinc = sin(pi * x) / (pi * x);
+
+		double ratio = distance / radius;
+		double window = BesselI0(alpha * sqrt(1.0 - ratio * ratio)) / BesselI0(alpha);
+
+		weights[i] = static_cast<float>(sinc * window);
+		weightSum += weights[i];
+	}
+
+	for(float& weight : weights)
+	{
+		weight /= weightSum;
+	}
+
+	// 1. Horizontal pass: destinationWidth x sourceHeight //
+	std::vector<float> horizontal(static_cast<size_t>(destinationWidth) * sourceHeight * 4);
+
+	for(int y = 0; y < sourceHeight; y++)
+	{
+		const float* row = source + static_cast<size_t>(y) * sourceWidth * 4;
+		float* output = horizontal.data() + static_cast<size_t>(y) * destinationWidth * 4;
+
+		for(int x = 0; x < destinationWidth; x++)
+		{
+#ifdef NOVA_SSE_MIPS
+			__m128 sum = _mm_setzero_ps();
+#else
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+#endif
+			for(int i = 0; i < tapCount; i++)
+			{
+				int sourceX = x * 2 - 2 + i;
+				sourceX = sourceX < 0 ? 0 : (sourceX >= sourceWidth ? sourceWidth - 1 : sourceX);
+
+#ifdef NOVA_SSE_MIPS
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + sourceX * 4), _mm_set1_ps(weights[i])));
+#else
+				for(int c = 0; c < 4; c++)
+				{
+					sum[c] += row[sourceX * 4 + c] * weights[i];
+				}
+#endif
+			}
+
+#ifdef NOVA_SSE_MIPS
+			_mm_storeu_ps(output + x * 4, sum);
+#else
+			for(int c = 0; c < 4; c++)
+			{
+				output[x * 4 + c] = sum[c];
+			}
+#endif
+		}
+	}
+
+	// 2. Vertical pass: destinationWidth x destinationHeight //
+	const size_t rowSize = static_cast<size_t>(destinationWidth) * 4;
+
+	for(int y = 0; y < destinationHeight; y++)
+	{
+		float* output = destination + y * rowSize;
+
+		for(size_t i = 0; i < rowSize; i++)
+		{
+			output[i] = 0.0f;
+		}
+
+		for(int i = 0; i < tapCount; i++)
+		{
+			int sourceY = y * 2 - 2 + i;
+			sourceY = sourceY < 0 ? 0 : (sourceY >= sourceHeight ? sourceHeight - 1 : sourceY);
+
+			const float* row = horizontal.data() + sourceY * rowSize;
+			size_t c = 0;
+
+#ifdef NOVA_SSE_MIPS
+			__m128 weight = _mm_set1_ps(weights[i]);
+			for(; c < rowSize; c += 4)
+			{
+				_mm_storeu_ps(output + c, _mm_add_ps(_mm_loadu_ps(output + c), _mm_mul_ps(_mm_loadu_ps(row + c), weight)));
+			}
+#endif
+			for(; c < rowSize; c++)
+			{
+				output[c] += row[c] * weights[i];
+			}
+		}
+	}
+}
@@ -0,0 +1,294 @@
+#include "Graphics/ModelCache.h"
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/MipGenerator.h"
+
+#include "Utilities/CacheFile.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Logger.h"
+#include "Utilities/MappedFile.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+// Layout of a cache file:
+// - CacheHeader
+// - Per source file: path, size, modification time, content hash
+// - Per mesh: name, counts, bounds, material, texture indices, vertices, indices
+// - Per texture: width, height, mip count, format, pixels ( full mip chain, possibly block compressed )
+// Bump the version whenever this layout or the imported data itself changes.
+static const unsigned int cacheMagic = 0x434D564E; // 'NVMC'
+static const unsigned int cacheVersion = 7;
+
+struct CacheHeader
+{
+	unsigned int Magic;
+	unsigned int Version;
+	unsigned int VertexSize;
+	unsigned int MaterialSize;
+
+	unsigned int SourceFileCount;
+	unsigned int MeshCount;
+	unsigned int TextureCount;
+	CompressionQuality TextureQuality;
+};
+
+// -1 means the material doesn't use the slot //
+static bool IsValidTextureIndex(int textureIndex, unsigned int textureCount)
+{
+	return textureIndex >= -1 && textureIndex < static_cast<long long>(textureCount);
+}
+
+ModelCache::ModelCache(const std::string& cacheDirectory) : cacheDirectory(cacheDirectory) {}
+
+bool ModelCache::Load(const std::string& filePath, ImportedModel& importedModel, CompressionQuality textureQuality)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::string cachePath = GetCachePath(filePath);
+
+	std::error_code error;
+	if(!std::filesystem::exists(cachePath, error))
+	{
+		return false;
+	}
+
+	MappedFile cacheFile;
+	if(!cacheFile.Open(cachePath))
+	{
+		return false;
+	}
+
+	CacheReader reader(cacheFile.GetData(), cacheFile.GetSize());
+
+	// 1. Check if the entry was written by this version of the engine //
+	CacheHeader header;
+	if(!reader.Read(header) || header.Magic != cacheMagic || header.Version != cacheVersion ||
+		header.VertexSize != sizeof(Vertex) || header.MaterialSize != sizeof(Material))
+	{
+		LOG(Log::MessageType::Debug, "Cache entry has an outdated format: " + cachePath);
+		return false;
+	}
+
+	if(header.TextureQuality != textureQuality)
+	{
+		LOG(Log::MessageType::Debug, "Cache entry uses a different texture compression: " + cachePath);
+		return false;
+	}
+
+	// 2. Check if the source files are unchanged. The modification time is enough most of the time,
+	// only if that changed the content gets hashed, so touching a file doesn't invalidate the entry.
+	std::vector<std::string> sourceFiles;
+	for(unsigned int i = 0; i < header.SourceFileCount; i++)
+	{
+		std::string sourcePath;
+		unsigned long long cachedSize;
+		long long cachedTime;
+		unsigned long long cachedHash;
+
+		if(!reader.ReadString(sourcePath) || !reader.Read(cachedSize) || !reader.Read(cachedTime) || !reader.Read(cachedHash))
+		{
+			return false;
+		}
+
+		if(i == 0 && sourcePath != filePath)
+		{
+			// Two paths ended up with the same cache file //
+			return false;
+		}
+
+		unsigned long long size;
+		long long time;
+		if(!GetFileInfo(sourcePath, size, time) || size != cachedSize)
+		{
+			LOG(Log::MessageType::Debug, "Cache entry is stale, source changed: " + sourcePath);
+			return false;
+		}
+
+		unsigned long long hash;
+		if(time != cachedTime && (!HashFile(sourcePath, hash) || hash != cachedHash))
+		{
+			LOG(Log::MessageType::Debug, "Cache entry is stale, source changed: " + sourcePath);
+			return false;
+		}
+
+		sourceFiles.push_back(sourcePath);
+	}
+
+	// 3. Read the processed data //
+	ImportedModel model;
+	model.FilePath = filePath;
+	model.Name = filePath.substr(filePath.find_last_of("/\\") + 1);
+	model.SourceFiles = std::move(sourceFiles);
+	model.TextureQuality = header.TextureQuality;
+
+	model.Meshes.resize(header.MeshCount);
+	for(ImportedMesh& mesh : model.Meshes)
+	{
+		unsigned long long vertexCount;
+		unsigned long long indexCount;
+
+		bool result = reader.ReadString(mesh.Name) && reader.Read(vertexCount) && reader.Read(indexCount) &&
+			reader.Read(mesh.Bounds) && reader.Read(mesh.Sphere) && reader.Read(mesh.Material) &&
+			reader.Read(mesh.AlbedoTexture) && reader.Read(mesh.NormalTexture) && reader.Read(mesh.MetallicRoughnessTexture) && reader.Read(mesh.OcclusionTexture) &&
+			reader.Read(mesh.EmissiveTexture) && reader.ReadVector(mesh.Vertices, vertexCount) &&
+			reader.ReadVector(mesh.Indices, indexCount);
+
+		// The mesh uploads whatever is in here, so every index has to point at something that exists //
+		const int textureIndices[] = { mesh.AlbedoTexture, mesh.NormalTexture, mesh.MetallicRoughnessTexture,
+			mesh.OcclusionTexture, mesh.EmissiveTexture };
+
+		for(int textureIndex : textureIndices)
+		{
+			result = result && IsValidTextureIndex(textureIndex, header.TextureCount);
+		}
+
+		for(unsigned int index : mesh.Indices)
+		{
+			result = result && index < vertexCount;
+		}
+
+		if(!result)
+		{
+			LOG(Log::MessageType::Error, "Cache entry is corrupt: " + cachePath);
+			return false;
+		}
+	}
+
+	model.Textures.resize(header.TextureCount);
+	for(ImportedTexture& texture : model.Textures)
+	{
+		unsigned long long pixelCount;
+
+		bool result = reader.Read(texture.Width) && reader.Read(texture.Height) && reader.Read(texture.MipCount) &&
+			reader.Read(texture.Format) && reader.Read(pixelCount) && reader.ReadVector(texture.Pixels, pixelCount);
+
+		// The pixels have to match the size the GPU upload will read //
+		result = result && texture.Width >= 0 && texture.Height >= 0 && texture.Format <= TextureFormat::BC7 &&
+			texture.MipCount >= 1 && texture.MipCount <= MipGenerator::GetMipCount(texture.Width, texture.Height) &&
+			(texture.Pixels.empty() || pixelCount == BlockCompressor::GetLevelOffset(texture.Format, texture.Width, texture.Height, texture.MipCount));
+
+		if(!result)
+		{
+			LOG(Log::MessageType::Error, "Cache entry is corrupt: " + cachePath);
+			return false;
+		}
+	}
+
+	importedModel = std::move(model);
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	float milliseconds = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+
+	std::string message = "Loaded '" + importedModel.Name + "' from cache in " + std::to_string(milliseconds) + "ms";
+	LOG(message);
+
+	return true;
+}
+
+bool ModelCache::Store(const ImportedModel& importedModel)
+{
+	std::string cachePath = GetCachePath(importedModel.FilePath);
+	std::string temporaryPath = cachePath + ".tmp";
+
+	std::error_code error;
+	std::filesystem::create_directories(cacheDirectory, error);
+
+	// Write to a temporary file first, so an interrupted write never leaves a broken entry behind //
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to create cache entry: " + cachePath);
+			return false;
+		}
+
+		CacheHeader header;
+		header.Magic = cacheMagic;
+		header.Version = cacheVersion;
+		header.VertexSize = sizeof(Vertex);
+		header.MaterialSize = sizeof(Material);
+		header.SourceFileCount = static_cast<unsigned int>(importedModel.SourceFiles.size());
+		header.MeshCount = static_cast<unsigned int>(importedModel.Meshes.size());
+		header.TextureCount = static_cast<unsigned int>(importedModel.Textures.size());
+		header.TextureQuality = importedModel.TextureQuality;
+		Write(file, header);
+
+		for(const std::string& sourcePath : importedModel.SourceFiles)
+		{
+			unsigned long long size;
+			long long time;
+			unsigned long long hash;
+
+			// Models with missing files don't get cached, since the files could show up later on //
+			if(!GetFileInfo(sourcePath, size, time) || !HashFile(sourcePath, hash))
+			{
+				file.close();
+				std::filesystem::remove(temporaryPath, error);
+				return false;
+			}
+
+			WriteString(file, sourcePath);
+			Write(file, size);
+			Write(file, time);
+			Write(file, hash);
+		}
+
+		for(const ImportedMesh& mesh : importedModel.Meshes)
+		{
+			WriteString(file, mesh.Name);
+			Write(file, static_cast<unsigned long long>(mesh.Vertices.size()));
+			Write(file, static_cast<unsigned long long>(mesh.Indices.size()));
+			Write(file, mesh.Bounds);
+			Write(file, mesh.Sphere);
+			Write(file, mesh.Material);
+			Write(file, mesh.AlbedoTexture);
+			Write(file, mesh.NormalTexture);
+			Write(file, mesh.MetallicRoughnessTexture);
+			Write(file, mesh.OcclusionTexture);
+			Write(file, mesh.EmissiveTexture);
+
+			file.write(reinterpret_cast<const char*>(mesh.Vertices.data()), mesh.Vertices.size() * sizeof(Vertex));
+			file.write(reinterpret_cast<const char*>(mesh.Indices.data()), mesh.Indices.size() * sizeof(unsigned int));
+		}
+
+		for(const ImportedTexture& texture : importedModel.Textures)
+		{
+			Write(file, texture.Width);
+			Write(file, texture.Height);
+			Write(file, texture.MipCount);
+			Write(file, texture.Format);
+			Write(file, static_cast<unsigned long long>(texture.Pixels.size()));
+			file.write(reinterpret_cast<const char*>(texture.Pixels.data()), texture.Pixels.size());
+		}
+
+		if(!file)
+		{
+			LOG(Log::MessageType::Error, "Failed to write cache entry: " + cachePath);
+			file.close();
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if(error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+std::string ModelCache::GetCachePath(const std::string& filePath)
+{
+	// Name for readability, hash of the full path to keep models with the same name apart //
+	std::string name = filePath.substr(filePath.find_last_of("/\\") + 1);
+
+	char pathHash[17];
+	snprintf(pathHash, sizeof(pathHash), "%016llx", HashString(filePath));
+
+	return cacheDirectory + name + "_" + pathHash + ".model";
+}
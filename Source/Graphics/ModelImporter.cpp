@@ -0,0 +1,1064 @@
+#include "Graphics/ModelImporter.h"
+#include "Graphics/Transform.h"
+#include "Graphics/AccessorDecoder.h"
+#include "Graphics/MipGenerator.h"
+#include "Graphics/BlockCompressor.h"
+
+#include "Utilities/Logger.h"
+#include "Utilities/ThreadPool.h"
+
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+// Smallest valid buffer TinyglTF accepts. Buffers we read from mapped files get replaced
+// with this, so TinyglTF doesn't read or copy the binary data a second time
+static const char* stubBufferUri = "data:application/octet-stream;base64,AAAA";
+static const size_t stubBufferLength = 3;
+
+// glTF refers to everything by index, files aren't validated so every index gets checked before it's used //
+static bool IsValidIndex(int index, size_t count)
+{
+	return index >= 0 && static_cast<size_t>(index) < count;
+}
+
+// Vectors that are missing from the file stay zero instead of turning into NaNs //
+static glm::vec3 SafeNormalize(const glm::vec3& vector)
+{
+	return glm::dot(vector, vector) > 0.0f ? glm::normalize(vector) : vector;
+}
+
+const ModelImporter::VertexAttribute ModelImporter::vertexAttributes[VertexAttributeCount] =
+{
+	{ "POSITION", offsetof(Vertex, Position), 3 },
+	{ "NORMAL", offsetof(Vertex, Normal), 3 },
+	{ "TANGENT", offsetof(Vertex, Tangent), 3 },
+	{ "TEXCOORD_0", offsetof(Vertex, TexCoord), 2 }
+};
+
+ModelImporter::ModelImporter(CompressionQuality textureQuality) : textureQuality(textureQuality) { }
+
+CompressionQuality ModelImporter::GetTextureQuality()
+{
+	return textureQuality;
+}
+
+bool ModelImporter::Import(const std::string& filePath, ImportedModel& importedModel)
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	importedModel.FilePath = filePath;
+	importedModel.TextureQuality = textureQuality;
+	importedModel.Name = filePath.substr(filePath.find_last_of("/\\") + 1);
+	baseDirectory = filePath.substr(0, filePath.find_last_of("/\\") + 1);
+	importedModel.SourceFiles = { filePath };
+
+	// 1. Map the file, a .glb contains both the JSON & binary chunk //
+	std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>(filePath);
+	if(!file->IsOpen())
+	{
+		return false;
+	}
+
+	BufferSpan jsonChunk = { file->GetData(), file->GetSize() };
+	BufferSpan binaryChunk;
+
+	bool isBinary = file->GetSize() >= 4 && memcmp(file->GetData(), "glTF", 4) == 0;
+	if(isBinary && !ParseGLB(file->GetData(), file->GetSize(), jsonChunk, binaryChunk))
+	{
+		return false;
+	}
+
+	mappedFiles.push_back(std::move(file));
+
+	// 2. Point buffers & images to their binary data, and strip them from the JSON //
+	nlohmann::json document = nlohmann::json::parse(jsonChunk.Data, jsonChunk.Data + jsonChunk.Size, nullptr, false);
+	if(document.is_discarded())
+	{
+		LOG(Log::MessageType::Error, "Failed to parse JSON of: " + filePath);
+		return false;
+	}
+
+	std::vector<bool> mappedBuffers;
+	if(!PrepareBuffers(document, binaryChunk, mappedBuffers, importedModel.SourceFiles))
+	{
+		mappedFiles.clear();
+		return false;
+	}
+
+	PrepareImages(document);
+
+	for(const ImageSource& image : images)
+	{
+		if(image.BufferView == -1 && !image.Uri.empty() && !tinygltf::IsDataURI(image.Uri))
+		{
+			std::string decodedUri;
+			tinygltf::URIDecode(image.Uri, &decodedUri, nullptr);
+			importedModel.SourceFiles.push_back(baseDirectory + decodedUri);
+		}
+	}
+
+	// 3. Let TinyglTF parse the remaining scene description //
+	tinygltf::Model model;
+	tinygltf::TinyGLTF loader;
+	std::string error;
+	std::string warning;
+
+	std::string json = document.dump();
+	bool result = loader.LoadASCIIFromString(&model, &error, &warning, json.c_str(),
+		static_cast<unsigned int>(json.size()), baseDirectory);
+
+	if(!warning.empty())
+	{
+		LOG(Log::MessageType::Debug, warning);
+	}
+
+	if(!error.empty())
+	{
+		LOG(Log::MessageType::Error, error);
+	}
+
+	if(!result)
+	{
+		mappedFiles.clear();
+		return false;
+	}
+
+	// Data URIs were decoded by TinyglTF, so those are read from the model instead //
+	for(unsigned int i = 0; i < buffers.size(); i++)
+	{
+		if(!mappedBuffers[i])
+		{
+			buffers[i] = { model.buffers[i].data.data(), model.buffers[i].data.size() };
+		}
+	}
+
+	// 4. Collect every primitive together with its node transform //
+	primitiveJobs.clear();
+	for(DecodeStatistics& statistics : attributeStatistics)
+	{
+		statistics.Nanoseconds = 0;
+		statistics.Elements = 0;
+	}
+
+	TraverseRootNodes(model);
+
+	// 5. Decode geometry & images, every primitive and image is independent //
+	ThreadPool& threadPool = ThreadPool::Get();
+
+	importedModel.Meshes.resize(primitiveJobs.size());
+	std::vector<unsigned char> importedMeshes(primitiveJobs.size(), 0);
+	threadPool.ParallelFor(static_cast<unsigned int>(primitiveJobs.size()), [&](unsigned int index)
+	{
+		importedMeshes[index] = ImportPrimitive(model, primitiveJobs[index], importedModel.Meshes[index]);
+	});
+
+	// Primitives that couldn't be imported have been reported, the rest of the model is still usable //
+	unsigned int meshCount = 0;
+	for(unsigned int i = 0; i < importedModel.Meshes.size(); i++)
+	{
+		if(!importedMeshes[i])
+		{
+			continue;
+		}
+
+		if(meshCount != i)
+		{
+			importedModel.Meshes[meshCount] = std::move(importedModel.Meshes[i]);
+		}
+		meshCount++;
+	}
+	importedModel.Meshes.resize(meshCount);
+
+	if(importedModel.Meshes.empty())
+	{
+		LOG(Log::MessageType::Error, "Model doesn't contain any geometry that can be drawn: " + filePath);
+		buffers.clear();
+		images.clear();
+		mappedFiles.clear();
+		return false;
+	}
+
+	// The material slots an image is used for decide how it gets filtered & compressed //
+	std::vector<unsigned int> imageUsage(images.size(), 0);
+	for(const ImportedMesh& mesh : importedModel.Meshes)
+	{
+		if(mesh.AlbedoTexture != -1) { imageUsage[mesh.AlbedoTexture] |= AlbedoUsage; }
+		if(mesh.NormalTexture != -1) { imageUsage[mesh.NormalTexture] |= NormalUsage; }
+		if(mesh.MetallicRoughnessTexture != -1) { imageUsage[mesh.MetallicRoughnessTexture] |= MetallicRoughnessUsage; }
+		if(mesh.OcclusionTexture != -1) { imageUsage[mesh.OcclusionTexture] |= OcclusionUsage; }
+		if(mesh.EmissiveTexture != -1) { imageUsage[mesh.EmissiveTexture] |= EmissiveUsage; }
+	}
+
+	importedModel.Textures.resize(decodeImages ? images.size() : 0);
+	threadPool.ParallelFor(static_cast<unsigned int>(importedModel.Textures.size()), [&](unsigned int index)
+	{
+		ImportedTexture& texture = importedModel.Textures[index];
+		DecodeImage(model, index, texture);
+
+		if(texture.Pixels.empty())
+		{
+			return;
+		}
+
+		// Color textures are stored as sRGB, so their mips need to be filtered in linear space //
+		bool isSRGB = (imageUsage[index] & (AlbedoUsage | EmissiveUsage)) != 0;
+		texture.MipCount = MipGenerator::GenerateRGBA8(texture.Pixels, texture.Width, texture.Height, isSRGB);
+
+		TextureFormat format = GetTextureFormat(imageUsage[index], texture);
+		if(BlockCompressor::Compress(texture.Pixels, texture.Width, texture.Height, texture.MipCount, format, textureQuality))
+		{
+			texture.Format = format;
+		}
+	});
+
+	// Everything got copied into its final layout, so the files can be unmapped //
+	buffers.clear();
+	images.clear();
+	mappedFiles.clear();
+
+	// 6. Report import throughput //
+	auto endTime = std::chrono::high_resolution_clock::now();
+	float milliseconds = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+
+	size_t vertexCount = 0;
+	for(const ImportedMesh& mesh : importedModel.Meshes)
+	{
+		vertexCount += mesh.Vertices.size();
+	}
+
+	std::string message = "Imported '" + importedModel.Name + "' in " + std::to_string(milliseconds) + "ms - " +
+		std::to_string(importedModel.Meshes.size()) + " meshes, " + std::to_string(vertexCount) + " vertices, " +
+		std::to_string(importedModel.Textures.size()) + " images";
+	LOG(message);
+
+	// Decode throughput in million elements per second, summed over all threads //
+	std::string throughput = "Decode throughput (M/s) -";
+	for(unsigned int i = 0; i <= VertexAttributeCount; i++)
+	{
+		const char* name = i < VertexAttributeCount ? vertexAttributes[i].Name : "INDICES";
+		double seconds = attributeStatistics[i].Nanoseconds.load() * 1e-9;
+		double elements = static_cast<double>(attributeStatistics[i].Elements.load());
+
+		if(seconds > 0.0)
+		{
+			throughput += " " + std::string(name) + ": " + std::to_string(elements / seconds * 1e-6);
+		}
+	}
+	LOG(Log::MessageType::Debug, throughput);
+
+	return true;
+}
+
+bool ModelImporter::ParseGLB(const unsigned char* data, size_t size, BufferSpan& jsonChunk, BufferSpan& binaryChunk)
+{
+	// Layout: 12 byte header ( magic, version, length ) followed by
+	// chunks that each start with their length & type. The JSON chunk is always first.
+	const unsigned int jsonChunkType = 0x4E4F534A;
+	const unsigned int binaryChunkType = 0x004E4942;
+
+	if(size < 20)
+	{
+		LOG(Log::MessageType::Error, "GLB file is too small to contain a header.");
+		return false;
+	}
+
+	unsigned int version;
+	unsigned int length;
+	memcpy(&version, data + 4, sizeof(unsigned int));
+	memcpy(&length, data + 8, sizeof(unsigned int));
+
+	if(version != 2 || length > size)
+	{
+		LOG(Log::MessageType::Error, "GLB header is invalid, only version 2 is supported.");
+		return false;
+	}
+
+	size_t offset = 12;
+	while(offset + 8 <= length)
+	{
+		unsigned int chunkLength;
+		unsigned int chunkType;
+		memcpy(&chunkLength, data + offset, sizeof(unsigned int));
+		memcpy(&chunkType, data + offset + 4, sizeof(unsigned int));
+		offset += 8;
+
+		if(offset + chunkLength > length)
+		{
+			LOG(Log::MessageType::Error, "GLB chunk exceeds the size of the file.");
+			return false;
+		}
+
+		if(chunkType == jsonChunkType && offset == 20)
+		{
+			jsonChunk = { data + offset, chunkLength };
+		}
+		else if(chunkType == binaryChunkType && binaryChunk.Data == nullptr)
+		{
+			binaryChunk = { data + offset, chunkLength };
+		}
+
+		offset += chunkLength;
+	}
+
+	if(jsonChunk.Data == data)
+	{
+		LOG(Log::MessageType::Error, "GLB file is missing its JSON chunk.");
+		return false;
+	}
+
+	return true;
+}
+
+bool ModelImporter::PrepareBuffers(nlohmann::json& document, const BufferSpan& binaryChunk,
+	std::vector<bool>& mappedBuffers, std::vector<std::string>& sourceFiles)
+{
+	buffers.clear();
+	mappedBuffers.clear();
+
+	if(!document.contains("buffers") || !document["buffers"].is_array())
+	{
+		return true;
+	}
+
+	for(nlohmann::json& buffer : document["buffers"])
+	{
+		size_t byteLength = buffer.value("byteLength", size_t(0));
+		std::string uri = buffer.value("uri", std::string());
+
+		BufferSpan span;
+
+		if(uri.empty())
+		{
+			// Buffer without a URI refers to the binary chunk of the .glb //
+			if(binaryChunk.Data == nullptr || byteLength > binaryChunk.Size)
+			{
+				LOG(Log::MessageType::Error, "Buffer refers to a missing or too small GLB binary chunk.");
+				return false;
+			}
+
+			span = binaryChunk;
+		}
+		else if(tinygltf::IsDataURI(uri))
+		{
+			// Embedded base64 data, TinyglTF decodes this one for us //
+			buffers.push_back(span);
+			mappedBuffers.push_back(false);
+			continue;
+		}
+		else
+		{
+			std::string decodedUri;
+			tinygltf::URIDecode(uri, &decodedUri, nullptr);
+
+			std::unique_ptr<MappedFile> bufferFile = std::make_unique<MappedFile>(baseDirectory + decodedUri);
+			if(!bufferFile->IsOpen() || bufferFile->GetSize() < byteLength)
+			{
+				LOG(Log::MessageType::Error, "Buffer file is missing or smaller than its byteLength: " + decodedUri);
+				return false;
+			}
+
+			span = { bufferFile->GetData(), bufferFile->GetSize() };
+			mappedFiles.push_back(std::move(bufferFile));
+			sourceFiles.push_back(baseDirectory + decodedUri);
+		}
+
+		buffer["uri"] = stubBufferUri;
+		buffer["byteLength"] = stubBufferLength;
+
+		buffers.push_back(span);
+		mappedBuffers.push_back(true);
+	}
+
+	return true;
+}
+
+void ModelImporter::PrepareImages(nlohmann::json& document)
+{
+	images.clear();
+
+	if(!document.contains("images") || !document["images"].is_array())
+	{
+		return;
+	}
+
+	for(const nlohmann::json& image : document["images"])
+	{
+		ImageSource source;
+		source.Uri = image.value("uri", std::string());
+		source.BufferView = image.value("bufferView", -1);
+		images.push_back(source);
+	}
+
+	// Textures still refer to images by index, which stays valid since
+	// ImportedModel::Textures gets filled in the same order
+	document.erase("images");
+}
+
+void ModelImporter::TraverseRootNodes(tinygltf::Model& model)
+{
+	if(model.scenes.empty())
+	{
+		LOG(Log::MessageType::Error, "Model doesn't contain a scene.");
+		return;
+	}
+
+	// The default scene is optional, without it the first one is used //
+	bool hasDefaultScene = model.defaultScene >= 0 && static_cast<size_t>(model.defaultScene) < model.scenes.size();
+	const tinygltf::Scene& scene = model.scenes[hasDefaultScene ? model.defaultScene : 0];
+	glm::mat4 transform;
+
+	// Traverse the 'root' nodes from the scene
+	for(size_t i = 0; i < scene.nodes.size(); i++)
+	{
+		if(!IsValidIndex(scene.nodes[i], model.nodes.size()))
+		{
+			continue;
+		}
+
+		tinygltf::Node& rootNode = model.nodes[scene.nodes[i]];
+
+		if(rootNode.matrix.size() > 0)
+		{
+			// Converting from double to float...
+			std::vector<float> matrix;
+			for(int j = 0; j < 16; j++)
+			{
+				matrix.push_back(static_cast<float>(rootNode.matrix[j]));
+			}
+
+			transform = glm::make_mat4(matrix.data());
+		}
+		else
+		{
+			transform = GetTransformFromNode(rootNode);
+		}
+
+		AddPrimitiveJobs(model, rootNode.mesh, transform);
+
+		// Process Child Nodes //
+		for(int noteID : rootNode.children)
+		{
+			if(IsValidIndex(noteID, model.nodes.size()))
+			{
+				TraverseChildNodes(model, model.nodes[noteID], transform);
+			}
+		}
+	}
+}
+
+void ModelImporter::TraverseChildNodes(tinygltf::Model& model, tinygltf::Node& node, const glm::mat4& parentTransform)
+{
+	glm::mat4 transform;
+
+	// 1. Load matrix from node //
+	if(node.matrix.size() > 0)
+	{
+		std::vector<float> matrix;
+		for(int i = 0; i < 16; i++)
+		{
+			matrix.push_back(static_cast<float>(node.matrix[i]));
+		}
+
+		transform = glm::make_mat4(matrix.data());
+	}
+	else
+	{
+		// 1b. incase matrix data doesn't exist,
+		// its assumed transform data is either Identity or
+		// stored as vectors Position, Rotation, Scale )
+		transform = GetTransformFromNode(node);
+	}
+
+	glm::mat4 childNodeTransform = parentTransform * transform;
+
+	// 2. Apply to meshes in note //
+	AddPrimitiveJobs(model, node.mesh, childNodeTransform);
+
+	// 3. Loop for children //
+	for(int noteID : node.children)
+	{
+		if(IsValidIndex(noteID, model.nodes.size()))
+		{
+			TraverseChildNodes(model, model.nodes[noteID], childNodeTransform);
+		}
+	}
+}
+
+void ModelImporter::AddPrimitiveJobs(tinygltf::Model& model, int meshID, const glm::mat4& transform)
+{
+	if(!IsValidIndex(meshID, model.meshes.size()))
+	{
+		return;
+	}
+
+	tinygltf::Mesh& mesh = model.meshes[meshID];
+
+	for(tinygltf::Primitive& primitive : mesh.primitives)
+	{
+		primitiveJobs.push_back({ &primitive, mesh.name, transform });
+	}
+}
+
+glm::mat4 ModelImporter::GetTransformFromNode(tinygltf::Node& node)
+{
+	::Transform transform;
+
+	// The size of any type of transformation data defaults to 0.
+	// When a vector isn't 0, it means it contains data
+	if(node.translation.size() > 0)
+	{
+		transform.Position.x = node.translation[0];
+		transform.Position.y = node.translation[1];
+		transform.Position.z = node.translation[2];
+	}
+
+	if(node.rotation.size() > 0)
+	{
+		glm::quat rotation;
+		rotation.x = node.rotation[0];
+		rotation.y = node.rotation[1];
+		rotation.z = node.rotation[2];
+		rotation.w = node.rotation[3];
+
+		glm::vec3 euler = glm::eulerAngles(rotation) * 180.0f / 3.14159265f;
+		transform.Rotation = euler;
+	}
+
+	if(node.scale.size() > 0)
+	{
+		transform.Scale.x = node.scale[0];
+		transform.Scale.y = node.scale[1];
+		transform.Scale.z = node.scale[2];
+	}
+
+	return transform.GetModelMatrix();
+}
+
+bool ModelImporter::ImportPrimitive(tinygltf::Model& model, const PrimitiveJob& job, ImportedMesh& mesh)
+{
+	// A 'Mesh' exists out of multiple primitives, usually this is one
+	// but it can be more. Each primitive contains the geometry data (triangles, lines etc. )
+	// to render the model
+	const tinygltf::Primitive& primitive = *job.Primitive;
+	mesh.Name = job.Name;
+
+	// Only triangles get drawn, points & lines are left out //
+	if(primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES)
+	{
+		LOG(Log::MessageType::Error, "Primitive of '" + job.Name + "' isn't made out of triangles, it's skipped.");
+		return false;
+	}
+
+	if(primitive.attributes.find("POSITION") == primitive.attributes.end())
+	{
+		LOG(Log::MessageType::Error, "Primitive of '" + job.Name + "' has no positions, it's skipped.");
+		return false;
+	}
+
+	for(const VertexAttribute& attribute : vertexAttributes)
+	{
+		if(!LoadAttribute(model, primitive, mesh, attribute))
+		{
+			return false;
+		}
+	}
+
+	if(mesh.Vertices.empty() || !LoadIndices(model, primitive, mesh))
+	{
+		LOG(Log::MessageType::Error, "Primitive of '" + job.Name + "' has no geometry, it's skipped.");
+		return false;
+	}
+
+	// Every index has to point to a vertex, the GPU would read past the vertex buffer otherwise //
+	for(unsigned int index : mesh.Indices)
+	{
+		if(index >= mesh.Vertices.size())
+		{
+			LOG(Log::MessageType::Error, "Primitive of '" + job.Name + "' has indices out of range, it's skipped.");
+			return false;
+		}
+	}
+
+	LoadMaterial(model, primitive, mesh);
+
+	GenerateTangents(mesh);
+
+	ApplyNodeTransform(mesh, job.Transform);
+
+	// Bounds outlive the vertices, which are released once they're uploaded //
+	const glm::vec3* positions = mesh.Vertices.empty() ? nullptr : &mesh.Vertices[0].Position;
+	mesh.Bounds = ComputeBoundingBox(positions, mesh.Vertices.size(), sizeof(Vertex));
+	mesh.Sphere = ComputeBoundingSphere(positions, mesh.Vertices.size(), mesh.Bounds, sizeof(Vertex));
+	return true;
+}
+
+bool ModelImporter::GetAccessorView(tinygltf::Model& model, int bufferViewID, size_t byteOffset, size_t count,
+	int componentType, int type, bool normalized, AccessorView& accessorView)
+{
+	// Component: default type like float, int
+	// Type: a structure made out of components, e.g VEC2 ( 2x float )
+	int componentSize = tinygltf::GetComponentSizeInBytes(componentType);
+	int componentCount = tinygltf::GetNumComponentsInType(type);
+
+	if(!IsValidIndex(bufferViewID, model.bufferViews.size()) || componentSize <= 0 || componentCount <= 0)
+	{
+		return false;
+	}
+
+	// BufferView: Tells which buffer we need, and where we need to be in the buffer
+	// Buffer: Binary data of our mesh, mapped straight from the file
+	tinygltf::BufferView& view = model.bufferViews[bufferViewID];
+	if(!IsValidIndex(view.buffer, buffers.size()))
+	{
+		return false;
+	}
+
+	const BufferSpan& buffer = buffers[view.buffer];
+
+	size_t elementSize = componentSize * componentCount;
+
+	// Stride: Distance in buffer till next element occurs, 0 means tightly packed
+	size_t stride = view.byteStride != 0 ? view.byteStride : elementSize;
+
+	// Accessor byteoffset: Offset to first element of type
+	// BufferView byteoffset: Offset to get to this primitives buffer data in the overall buffer
+	size_t bufferStart = byteOffset + view.byteOffset;
+
+	if(count > 0 && bufferStart + (count - 1) * stride + elementSize > buffer.Size)
+	{
+		return false;
+	}
+
+	accessorView.Data = buffer.Data + bufferStart;
+	accessorView.Stride = stride;
+	accessorView.Count = count;
+	accessorView.ComponentType = componentType;
+	accessorView.ComponentCount = componentCount;
+	accessorView.Normalized = normalized;
+	return true;
+}
+
+bool ModelImporter::LoadAttribute(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh, const VertexAttribute& attribute)
+{
+	auto attributeEntry = primitive.attributes.find(attribute.Name);
+
+	// Check if within the primitives's attributes the type is present. For example 'Normals'
+	// If not, the vertices keep zeros for it, tangents get generated later on
+	if(attributeEntry == primitive.attributes.end())
+	{
+		std::string message = "Attribute Type: '" + std::string(attribute.Name) + "' missing from model.";
+		LOG(Log::MessageType::Debug, message);
+		return true;
+	}
+
+	if(!IsValidIndex(attributeEntry->second, model.accessors.size()))
+	{
+		LOG(Log::MessageType::Error, "Attribute Type: '" + std::string(attribute.Name) + "' refers to a missing accessor.");
+		return false;
+	}
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	// Accessor: Tells use which view we need, what type of data is in it, and the amount/count of data.
+	tinygltf::Accessor& accessor = model.accessors[attributeEntry->second];
+
+	// In case it hasn't happened, resize the vertex buffer since the
+	// attribute gets decoded directly into the interleaved vertices
+	std::vector<Vertex>& vertices = mesh.Vertices;
+	if(vertices.size() < accessor.count)
+	{
+		vertices.resize(accessor.count);
+	}
+
+	unsigned char* destination = reinterpret_cast<unsigned char*>(vertices.data()) + attribute.Offset;
+
+	// Sparse accessors without a bufferView start out as zeros, which the vertices already are //
+	if(accessor.bufferView != -1)
+	{
+		AccessorView accessorView;
+		if(!GetAccessorView(model, accessor.bufferView, accessor.byteOffset, accessor.count,
+			accessor.componentType, accessor.type, accessor.normalized, accessorView) ||
+			!AccessorDecoder::DecodeFloats(accessorView, destination, sizeof(Vertex), attribute.Components))
+		{
+			std::string message = "Attribute Type: '" + std::string(attribute.Name) + "' couldn't be decoded.";
+			LOG(Log::MessageType::Error, message);
+			return false;
+		}
+	}
+
+	if(accessor.sparse.isSparse)
+	{
+		const auto& sparse = accessor.sparse;
+
+		AccessorView indicesView;
+		AccessorView valuesView;
+		bool validSparse = GetAccessorView(model, sparse.indices.bufferView, sparse.indices.byteOffset, sparse.count,
+			sparse.indices.componentType, TINYGLTF_TYPE_SCALAR, false, indicesView);
+		validSparse = validSparse && GetAccessorView(model, sparse.values.bufferView, sparse.values.byteOffset, sparse.count,
+			accessor.componentType, accessor.type, accessor.normalized, valuesView);
+
+		if(!validSparse || !AccessorDecoder::ApplySparseFloats(indicesView, valuesView, destination,
+			sizeof(Vertex), attribute.Components, accessor.count))
+		{
+			std::string message = "Attribute Type: '" + std::string(attribute.Name) + "' has an invalid sparse accessor.";
+			LOG(Log::MessageType::Error, message);
+			return false;
+		}
+	}
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	DecodeStatistics& statistics = attributeStatistics[&attribute - vertexAttributes];
+	statistics.Nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+	statistics.Elements += accessor.count;
+	return true;
+}
+
+bool ModelImporter::LoadIndices(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh)
+{
+	std::vector<unsigned int>& indices = mesh.Indices;
+
+	// Non-indexed geometry, every three vertices form a triangle //
+	if(primitive.indices == -1)
+	{
+		indices.resize(mesh.Vertices.size() - mesh.Vertices.size() % 3);
+		for(unsigned int i = 0; i < indices.size(); i++)
+		{
+			indices[i] = i;
+		}
+
+		return !indices.empty();
+	}
+
+	if(!IsValidIndex(primitive.indices, model.accessors.size()))
+	{
+		LOG(Log::MessageType::Error, "Indices refer to a missing accessor.");
+		return false;
+	}
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	tinygltf::Accessor& accessor = model.accessors[primitive.indices];
+	indices.resize(accessor.count);
+
+	AccessorView accessorView;
+	if(!GetAccessorView(model, accessor.bufferView, accessor.byteOffset, accessor.count,
+		accessor.componentType, accessor.type, false, accessorView) ||
+		!AccessorDecoder::DecodeIndices(accessorView, indices.data()))
+	{
+		LOG(Log::MessageType::Error, "Indices couldn't be decoded.");
+		indices.clear();
+		return false;
+	}
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	DecodeStatistics& statistics = attributeStatistics[VertexAttributeCount];
+	statistics.Nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+	statistics.Elements += accessor.count;
+
+	// Only whole triangles are drawn //
+	indices.resize(indices.size() - indices.size() % 3);
+	return !indices.empty();
+}
+
+void ModelImporter::LoadMaterial(tinygltf::Model& model, const tinygltf::Primitive& primitive, ImportedMesh& mesh)
+{
+	Material& material = mesh.Material;
+
+	// Primitives without a material are drawn white & untextured //
+	if(!IsValidIndex(primitive.material, model.materials.size()))
+	{
+		for(Vertex& vertex : mesh.Vertices)
+		{
+			vertex.Color = glm::vec3(1.0f);
+		}
+
+		material.hasAlbedo = 0;
+		material.hasNormal = 0;
+		material.hasMetallicRoughness = 0;
+		material.hasOcclusion = 0;
+		material.hasEmissive = 0;
+		return;
+	}
+
+	// For now, do only color //
+	tinygltf::Material& mat = model.materials[primitive.material];
+
+	for(Vertex& vertex : mesh.Vertices)
+	{
+		vertex.Color.x = mat.pbrMetallicRoughness.baseColorFactor[0];
+		vertex.Color.y = mat.pbrMetallicRoughness.baseColorFactor[1];
+		vertex.Color.z = mat.pbrMetallicRoughness.baseColorFactor[2];
+	}
+
+	material.Opacity = static_cast<float>(mat.pbrMetallicRoughness.baseColorFactor[3]);
+	material.alphaBlend = mat.alphaMode == "BLEND";
+	material.alphaMask = mat.alphaMode == "MASK";
+	material.AlphaCutoff = static_cast<float>(mat.alphaCutoff);
+
+	mesh.AlbedoTexture = GetImageIndex(model, mat.pbrMetallicRoughness.baseColorTexture.index, material.hasAlbedo);
+	mesh.NormalTexture = GetImageIndex(model, mat.normalTexture.index, material.hasNormal);
+	mesh.MetallicRoughnessTexture = GetImageIndex(model, mat.pbrMetallicRoughness.metallicRoughnessTexture.index, material.hasMetallicRoughness);
+	mesh.OcclusionTexture = GetImageIndex(model, mat.occlusionTexture.index, material.hasOcclusion);
+	mesh.EmissiveTexture = GetImageIndex(model, mat.emissiveTexture.index, material.hasEmissive);
+}
+
+TextureFormat ModelImporter::GetTextureFormat(unsigned int usage, const ImportedTexture& texture)
+{
+	if(textureQuality == CompressionQuality::None || usage == 0 ||
+		!BlockCompressor::CanCompress(texture.Width, texture.Height))
+	{
+		return TextureFormat::RGBA8;
+	}
+
+	// Two channels are enough, the shader reconstructs z //
+	if(usage == NormalUsage)
+	{
+		return TextureFormat::BC5;
+	}
+
+	if(usage == OcclusionUsage)
+	{
+		return TextureFormat::BC4;
+	}
+
+	// Packed maps only need RGB, the shader picks the channels it uses //
+	if((usage & ~(MetallicRoughnessUsage | OcclusionUsage)) == 0 || usage == EmissiveUsage)
+	{
+		return TextureFormat::BC1;
+	}
+
+	// Albedo, or an image shared between unrelated slots //
+	if(textureQuality == CompressionQuality::Fast)
+	{
+		size_t pixelCount = static_cast<size_t>(texture.Width) * texture.Height;
+		for(size_t i = 0; i < pixelCount; i++)
+		{
+			if(texture.Pixels[i * 4 + 3] != 255)
+			{
+				return TextureFormat::BC3;
+			}
+		}
+
+		return TextureFormat::BC1;
+	}
+
+	return TextureFormat::BC7;
+}
+
+int ModelImporter::GetImageIndex(tinygltf::Model& model, int textureID, int& materialCheck)
+{
+	// Textures that don't lead to an image are treated as absent //
+	if(!IsValidIndex(textureID, model.textures.size()) || !IsValidIndex(model.textures[textureID].source, images.size()))
+	{
+		materialCheck = 0;
+		return -1;
+	}
+
+	materialCheck = 1;
+	return model.textures[textureID].source;
+}
+
+void ModelImporter::GenerateTangents(ImportedMesh& mesh)
+{
+	std::vector<Vertex>& vertices = mesh.Vertices;
+	std::vector<unsigned int>& indices = mesh.Indices;
+
+	// Incase the vertex doesn't have the default value of a zero-vector
+	// it means that the Tangent attribute was present for the model
+	// if not, we need to generate them.
+	if(vertices.empty() || vertices[0].Tangent != glm::vec3(0.0f))
+	{
+		return;
+	}
+
+	// Grab the average tangent of all triangles in the model //
+	for(unsigned int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		Vertex& v0 = vertices[indices[i]];
+		Vertex& v1 = vertices[indices[i + 1]];
+		Vertex& v2 = vertices[indices[i + 2]];
+
+		// Edges of triangles //
+		glm::vec3 edge1 = v1.Position - v0.Position;
+		glm::vec3 edge2 = v2.Position - v0.Position;
+
+		// UV deltas //
+		glm::vec2 deltaUV1 = v1.TexCoord - v0.TexCoord;
+		glm::vec2 deltaUV2 = v2.TexCoord - v0.TexCoord;
+
+		// Triangles without UV area ( or no UVs at all ) don't have a direction to contribute //
+		float determinant = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+		if(std::fabs(determinant) < 1e-12f)
+		{
+			continue;
+		}
+
+		glm::vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) / determinant;
+
+		v0.Tangent += tangent;
+		v1.Tangent += tangent;
+		v2.Tangent += tangent;
+	}
+
+	// Vertices that didn't get a tangent from their triangles get any direction perpendicular to their normal //
+	for(Vertex& vertex : vertices)
+	{
+		if(glm::dot(vertex.Tangent, vertex.Tangent) > 1e-12f)
+		{
+			vertex.Tangent = glm::normalize(vertex.Tangent);
+			continue;
+		}
+
+		glm::vec3 axis = std::fabs(vertex.Normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::vec3 tangent = glm::cross(vertex.Normal, axis);
+		vertex.Tangent = glm::dot(tangent, tangent) > 1e-12f ? glm::normalize(tangent) : axis;
+	}
+}
+
+void ModelImporter::ApplyNodeTransform(ImportedMesh& mesh, const glm::mat4& transform)
+{
+	for(Vertex& vertex : mesh.Vertices)
+	{
+		glm::vec4 vert = glm::vec4(vertex.Position.x, vertex.Position.y, vertex.Position.z, 1.0f);
+		vertex.Position = transform * vert;
+
+		glm::vec4 norm = glm::vec4(vertex.Normal.x, vertex.Normal.y, vertex.Normal.z, 0.0f);
+		vertex.Normal = SafeNormalize(transform * norm);
+
+		glm::vec4 tang = glm::vec4(vertex.Tangent.x, vertex.Tangent.y, vertex.Tangent.z, 0.0f);
+		vertex.Tangent = SafeNormalize(transform * tang);
+	}
+}
+
+void ModelImporter::DecodeImage(tinygltf::Model& model, unsigned int imageIndex, ImportedTexture& texture)
+{
+	const ImageSource& source = images[imageIndex];
+	std::string imageName = source.Uri.empty() ? "image[" + std::to_string(imageIndex) + "]" : source.Uri;
+
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+	// Only one of these gets used, depending on where the image is stored //
+	MappedFile imageFile;
+	std::vector<unsigned char> decodedUri;
+
+	if(source.BufferView != -1)
+	{
+		// Embedded in a buffer, usually the binary chunk of a .glb. Left undecoded when it points outside of them //
+		if(!IsValidIndex(source.BufferView, model.bufferViews.size()) ||
+			!IsValidIndex(model.bufferViews[source.BufferView].buffer, buffers.size()))
+		{
+			LOG(Log::MessageType::Error, "Image refers to a buffer that doesn't exist: " + imageName);
+			return;
+		}
+
+		tinygltf::BufferView& view = model.bufferViews[source.BufferView];
+		const BufferSpan& buffer = buffers[view.buffer];
+
+		if(view.byteOffset + view.byteLength <= buffer.Size)
+		{
+			data = buffer.Data + view.byteOffset;
+			size = view.byteLength;
+		}
+	}
+	else if(tinygltf::IsDataURI(source.Uri))
+	{
+		std::string mimeType;
+		if(tinygltf::DecodeDataURI(&decodedUri, mimeType, source.Uri, 0, false))
+		{
+			data = decodedUri.data();
+			size = decodedUri.size();
+		}
+	}
+	else if(!source.Uri.empty())
+	{
+		std::string filePath;
+		tinygltf::URIDecode(source.Uri, &filePath, nullptr);
+
+		if(imageFile.Open(baseDirectory + filePath))
+		{
+			data = imageFile.GetData();
+			size = imageFile.GetSize();
+		}
+	}
+
+	unsigned char* pixels = nullptr;
+	if(data != nullptr)
+	{
+		int channels;
+		pixels = stbi_load_from_memory(data, static_cast<int>(size), &texture.Width, &texture.Height, &channels, 4);
+	}
+
+	if(pixels == nullptr)
+	{
+		LOG(Log::MessageType::Error, "Unsuccesful with decoding image: " + imageName);
+		return;
+	}
+
+	texture.Pixels.assign(pixels, pixels + (texture.Width * texture.Height * 4));
+	stbi_image_free(pixels);
+}
+
+void ModelImporter::RunBenchmark(const std::vector<std::string>& modelPaths)
+{
+	std::vector<std::string> paths = modelPaths;
+	if(paths.empty())
+	{
+		paths = { "Assets/Models/DamagedHelmet/DamagedHelmet.gltf", "Assets/Models/Skydome/skydome.gltf" };
+	}
+
+	const int runCount = 10;
+
+	for(const std::string& path : paths)
+	{
+		ModelImporter importer(CompressionQuality::None);
+		importer.decodeImages = false;
+
+		// Throughput is elements over the time spent decoding them, so it's per thread //
+		double bestThroughput[VertexAttributeCount + 1] = { };
+		unsigned long long elementCounts[VertexAttributeCount + 1] = { };
+		bool imported = true;
+
+		for(int run = 0; run < runCount && imported; run++)
+		{
+			ImportedModel model;
+			imported = importer.Import(path, model);
+
+			for(unsigned int i = 0; i <= VertexAttributeCount; i++)
+			{
+				double seconds = importer.attributeStatistics[i].Nanoseconds.load() * 1e-9;
+				elementCounts[i] = importer.attributeStatistics[i].Elements.load();
+
+				if(seconds > 0.0)
+				{
+					bestThroughput[i] = std::max(bestThroughput[i], elementCounts[i] / seconds);
+				}
+			}
+		}
+
+		if(!imported)
+		{
+			LOG(Log::MessageType::Error, "Couldn't import '" + path + "' for the decode benchmark.");
+			continue;
+		}
+
+		LOG("Decode benchmark: '" + path + "' ( best of " + std::to_string(runCount) + " imports )");
+		for(unsigned int i = 0; i <= VertexAttributeCount; i++)
+		{
+			const char* name = i < VertexAttributeCount ? vertexAttributes[i].Name : "INDICES";
+			const char* unit = i < VertexAttributeCount ? " vertices/s" : " indices/s";
+
+			if(elementCounts[i] == 0)
+			{
+				LOG("    " + std::string(name) + ": not present");
+				continue;
+			}
+
+			LOG("    " + std::string(name) + ": " + std::to_string(elementCounts[i]) + " elements, " +
+				std::to_string(bestThroughput[i] * 1e-6) + "M" + unit);
+		}
+	}
+}
@@ -0,0 +1,257 @@
+#include "Graphics/ParallelRecorder.h"
+
+#include "Utilities/Logger.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <glm.hpp>
+
+std::vector<RecordRange> ParallelRecorder::Partition(const std::vector<unsigned int>& drawCounts, unsigned int maxRanges,
+	unsigned int minimumDraws)
+{
+	std::vector<RecordRange> ranges;
+	if(drawCounts.empty())
+	{
+		return ranges;
+	}
+
+	uint64_t totalDraws = 0;
+	for(unsigned int drawCount : drawCounts)
+	{
+		totalDraws += drawCount;
+	}
+
+	uint64_t rangeCount = std::max<uint64_t>(totalDraws / std::max(minimumDraws, 1u), 1);
+	rangeCount = std::min<uint64_t>(rangeCount, std::max(maxRanges, 1u));
+	rangeCount = std::min<uint64_t>(rangeCount, drawCounts.size());
+
+	// Cut whenever the draws so far pass the next multiple of the average, so rounding doesn't add up //
+	RecordRange range = { 0, 0 };
+	uint64_t draws = 0;
+
+	for(unsigned int i = 0; i < drawCounts.size(); i++)
+	{
+		draws += drawCounts[i];
+		range.End = i + 1;
+
+		uint64_t threshold = totalDraws * (ranges.size() + 1) / rangeCount;
+		if(draws >= threshold && ranges.size() + 1 < rangeCount)
+		{
+			ranges.push_back(range);
+			range.Begin = range.End;
+		}
+	}
+
+	if(range.End > range.Begin)
+	{
+		ranges.push_back(range);
+	}
+
+	return ranges;
+}
+
+void ParallelRecorder::Record(ThreadPool& threadPool, const std::vector<RecordRange>& ranges,
+	const std::function<void(unsigned int, const RecordRange&)>& record)
+{
+	threadPool.ParallelFor(static_cast<unsigned int>(ranges.size()), [&](unsigned int i)
+	{
+		record(i, ranges[i]);
+	});
+}
+
+#pragma region Benchmark
+namespace
+{
+	struct MockVertexBufferView
+	{
+		uint64_t Location;
+		unsigned int Size;
+		unsigned int Stride;
+	};
+
+	struct MockIndexBufferView
+	{
+		uint64_t Location;
+		unsigned int Size;
+		unsigned int Format;
+	};
+
+	// Encodes calls into a command buffer, like a driver would, with the calls a draw of a model makes //
+	class MockCommandList
+	{
+	public:
+		void Reset()
+		{
+			commands.clear();
+		}
+
+		void SetGraphicsRoot32BitConstants(unsigned int parameter, unsigned int count, const void* data, unsigned int offset)
+		{
+			unsigned int header[3] = { 0, parameter, offset };
+			Write(header, sizeof(header));
+			Write(data, count * sizeof(uint32_t));
+		}
+
+		void SetGraphicsRoot32BitConstant(unsigned int parameter, unsigned int value, unsigned int offset)
+		{
+			unsigned int command[4] = { 1, parameter, value, offset };
+			Write(command, sizeof(command));
+		}
+
+		void IASetVertexBuffers(const MockVertexBufferView& view)
+		{
+			unsigned int header = 2;
+			Write(&header, sizeof(header));
+			Write(&view, sizeof(view));
+		}
+
+		void IASetIndexBuffer(const MockIndexBufferView& view)
+		{
+			unsigned int header = 3;
+			Write(&header, sizeof(header));
+			Write(&view, sizeof(view));
+		}
+
+		void DrawIndexedInstanced(unsigned int indexCount, unsigned int instanceCount, unsigned int startIndex,
+			int baseVertex, unsigned int startInstance)
+		{
+			unsigned int command[6] = { 4, indexCount, instanceCount, startIndex, static_cast<unsigned int>(baseVertex), startInstance };
+			Write(command, sizeof(command));
+		}
+
+		size_t GetSize()
+		{
+			return commands.size();
+		}
+
+	private:
+		void Write(const void* data, size_t size)
+		{
+			size_t offset = commands.size();
+			commands.resize(offset + size);
+			memcpy(commands.data() + offset, data, size);
+		}
+
+	private:
+		std::vector<unsigned char> commands;
+	};
+
+	struct MockMesh
+	{
+		MockVertexBufferView VertexBuffer;
+		MockIndexBufferView IndexBuffer;
+		unsigned int IndexCount;
+		unsigned int MaterialIndex;
+	};
+
+	struct MockModel
+	{
+		glm::mat4 Transform;
+		std::vector<MockMesh> Meshes;
+	};
+}
+
+void ParallelRecorder::RunBenchmark()
+{
+	const unsigned int modelCount = 10000;
+	const int frameCount = 30;
+
+	// 1. Models with 1 to 16 meshes, the same shape as the scenes the SceneStage draws //
+	std::mt19937 random(1337);
+	std::vector<MockModel> models(modelCount);
+	std::vector<unsigned int> drawCounts(modelCount);
+	unsigned int totalDraws = 0;
+
+	for(unsigned int i = 0; i < modelCount; i++)
+	{
+		models[i].Transform = glm::mat4(1.0f + (random() % 100) * 0.01f);
+		models[i].Meshes.resize(1 + random() % 16);
+
+		for(MockMesh& mesh : models[i].Meshes)
+		{
+			mesh.VertexBuffer = { random(), static_cast<unsigned int>(random() % (1 << 20)), 48 };
+			mesh.IndexBuffer = { random(), static_cast<unsigned int>(random() % (1 << 20)), 42 };
+			mesh.IndexCount = static_cast<unsigned int>(random() % 30000);
+			mesh.MaterialIndex = static_cast<unsigned int>(random() % 512);
+		}
+
+		drawCounts[i] = static_cast<unsigned int>(models[i].Meshes.size());
+		totalDraws += drawCounts[i];
+	}
+
+	const glm::mat4 viewProjection(0.5f);
+	const glm::mat4 lightMatrix(0.25f);
+
+	// 2. Record every frame with 1, 2, 4... threads, each thread records its own list //
+	std::vector<unsigned int> threadCounts;
+	unsigned int hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	for(unsigned int threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+
+	threadCounts.push_back(hardwareThreads);
+	double singleThreadedRate = 0.0;
+
+	for(unsigned int threadCount : threadCounts)
+	{
+		// The calling thread works as well, a single thread doesn't use the workers at all //
+		ThreadPool threadPool(std::max(threadCount - 1, 1u));
+		std::vector<RecordRange> ranges = Partition(drawCounts, threadCount, MinimumDrawsPerList);
+		std::vector<MockCommandList> commandLists(ranges.size());
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for(int frame = 0; frame < frameCount; frame++)
+		{
+			Record(threadPool, ranges, [&](unsigned int list, const RecordRange& range)
+			{
+				MockCommandList& commandList = commandLists[list];
+				commandList.Reset();
+
+				for(unsigned int i = range.Begin; i < range.End; i++)
+				{
+					MockModel& model = models[i];
+					glm::mat4 transform[3] = { viewProjection * model.Transform, model.Transform, lightMatrix };
+					commandList.SetGraphicsRoot32BitConstants(0, 48, transform, 0);
+
+					for(const MockMesh& mesh : model.Meshes)
+					{
+						commandList.SetGraphicsRoot32BitConstant(3, mesh.MaterialIndex, 0);
+						commandList.IASetVertexBuffers(mesh.VertexBuffer);
+						commandList.IASetIndexBuffer(mesh.IndexBuffer);
+						commandList.DrawIndexedInstanced(mesh.IndexCount, 1, 0, 0, 0);
+					}
+				}
+			});
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		double milliseconds = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+		double drawsPerMillisecond = static_cast<double>(totalDraws) * frameCount / milliseconds;
+
+		if(threadCount == 1)
+		{
+			singleThreadedRate = drawsPerMillisecond;
+		}
+
+		size_t commandBytes = 0;
+		for(MockCommandList& commandList : commandLists)
+		{
+			commandBytes += commandList.GetSize();
+		}
+
+		LOG("Parallel recording benchmark: " + std::to_string(threadCount) + " threads, " + std::to_string(ranges.size()) +
+			" lists, " + std::to_string(totalDraws) + " draws");
+		LOG("  " + std::to_string(drawsPerMillisecond) + " draws/ms, " + std::to_string(milliseconds / frameCount) + " ms per frame" +
+			", speedup " + std::to_string(drawsPerMillisecond / singleThreadedRate) + "x");
+		LOG("  Command data: " + std::to_string(commandBytes / (1024.0 * 1024.0)) + " MB per frame");
+	}
+}
+#pragma endregion
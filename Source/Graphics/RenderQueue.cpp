@@ -0,0 +1,377 @@
+#include "Graphics/RenderQueue.h"
+
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace
+{
+	const unsigned int RadixBits = 8;
+	const unsigned int BucketCount = 1 << RadixBits;
+	const unsigned int PassCount = 64 / RadixBits;
+
+	// Below this a pass is cheaper than waking up the pool //
+	const unsigned int MinChunkSize = 8192;
+
+	// Positive floats compare the same as their bits, the top bits are the exponent & the start of the mantissa //
+	uint64_t QuantizeDepth(float depth)
+	{
+		depth = std::max(depth, 0.0f);
+
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(float));
+		return bits >> (31 - RenderQueue::DepthBits);
+	}
+}
+
+void RenderQueue::Clear()
+{
+	draws.clear();
+
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	statistics = RenderQueueStatistics();
+}
+
+void RenderQueue::Add(unsigned int pipeline, unsigned int material, unsigned int mesh, float depth, unsigned int item)
+{
+	bool blended = (blendedPipelines >> pipeline) & 1;
+	draws.push_back({ MakeKey(pipeline, blended, material, mesh, depth), item });
+}
+
+void RenderQueue::Sort(ThreadPool* threadPool)
+{
+	unsigned int count = static_cast<unsigned int>(draws.size());
+	if(count < 2)
+	{
+		return;
+	}
+
+	// 1. Only digits that differ between keys need a pass, the pipeline & high material bits rarely do //
+	uint64_t differentBits = 0;
+	for(const SortItem& draw : draws)
+	{
+		differentBits |= draw.Key ^ draws[0].Key;
+	}
+
+	unsigned int chunkCount = 1;
+	if(threadPool)
+	{
+		chunkCount = std::max(1u, std::min(threadPool->GetThreadCount(), count / MinChunkSize));
+	}
+
+	unsigned int chunkSize = (count + chunkCount - 1) / chunkCount;
+	histograms.resize(chunkCount * BucketCount);
+	scratch.resize(count);
+
+	auto forEachChunk = [&](const std::function<void(unsigned int)>& job)
+	{
+		if(chunkCount == 1)
+		{
+			job(0);
+			return;
+		}
+
+		threadPool->ParallelFor(chunkCount, job);
+	};
+
+	SortItem* source = draws.data();
+	SortItem* destination = scratch.data();
+
+	for(unsigned int pass = 0; pass < PassCount; pass++)
+	{
+		unsigned int shift = pass * RadixBits;
+		if(((differentBits >> shift) & (BucketCount - 1)) == 0)
+		{
+			continue;
+		}
+
+		// 2. Every chunk counts its own digits //
+		forEachChunk([&](unsigned int chunk)
+		{
+			unsigned int* histogram = &histograms[chunk * BucketCount];
+			memset(histogram, 0, BucketCount * sizeof(unsigned int));
+
+			unsigned int end = std::min(count, (chunk + 1) * chunkSize);
+			for(unsigned int i = chunk * chunkSize; i < end; i++)
+			{
+				histogram[(source[i].Key >> shift) & (BucketCount - 1)]++;
+			}
+		});
+
+		// 3. Offsets go bucket by bucket, chunk after chunk within a bucket, that keeps the sort stable //
+		unsigned int offset = 0;
+		for(unsigned int bucket = 0; bucket < BucketCount; bucket++)
+		{
+			for(unsigned int chunk = 0; chunk < chunkCount; chunk++)
+			{
+				unsigned int& entry = histograms[chunk * BucketCount + bucket];
+				unsigned int bucketCount = entry;
+
+				entry = offset;
+				offset += bucketCount;
+			}
+		}
+
+		// 4. Scatter, every chunk writes into its own part of every bucket //
+		forEachChunk([&](unsigned int chunk)
+		{
+			unsigned int* offsets = &histograms[chunk * BucketCount];
+
+			unsigned int end = std::min(count, (chunk + 1) * chunkSize);
+			for(unsigned int i = chunk * chunkSize; i < end; i++)
+			{
+				destination[offsets[(source[i].Key >> shift) & (BucketCount - 1)]++] = source[i];
+			}
+		});
+
+		std::swap(source, destination);
+	}
+
+	if(source != draws.data())
+	{
+		draws.swap(scratch);
+	}
+}
+
+void RenderQueue::SetBlended(unsigned int pipeline, bool blended)
+{
+	if(pipeline >= (1u << PipelineBits))
+	{
+		LOG(Log::MessageType::Error, "Pipeline doesn't fit in a sort key: " + std::to_string(pipeline));
+		assert(false && "Pipeline doesn't fit in a sort key");
+		return;
+	}
+
+	blendedPipelines = blended ? blendedPipelines | (1u << pipeline) : blendedPipelines & ~(1u << pipeline);
+}
+
+unsigned int RenderQueue::GetDrawCount()
+{
+	return static_cast<unsigned int>(draws.size());
+}
+
+unsigned int RenderQueue::GetItem(unsigned int draw)
+{
+	return draws[draw].Item;
+}
+
+unsigned int RenderQueue::GetPipeline(unsigned int draw)
+{
+	return static_cast<unsigned int>(draws[draw].Key >> (64 - PipelineBits));
+}
+
+uint64_t RenderQueue::GetKey(unsigned int draw)
+{
+	return draws[draw].Key;
+}
+
+void RenderQueue::AddStatistics(const RenderQueueStatistics& listStatistics)
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	statistics.Draws += listStatistics.Draws;
+	statistics.PipelineBinds += listStatistics.PipelineBinds;
+	statistics.MaterialBinds += listStatistics.MaterialBinds;
+	statistics.GeometryBinds += listStatistics.GeometryBinds;
+	statistics.PipelinesSkipped += listStatistics.PipelinesSkipped;
+	statistics.MaterialsSkipped += listStatistics.MaterialsSkipped;
+	statistics.GeometrySkipped += listStatistics.GeometrySkipped;
+}
+
+RenderQueueStatistics RenderQueue::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	return statistics;
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int pipeline, bool blended, unsigned int material, unsigned int mesh, float depth)
+{
+	const uint64_t pipelineMask = (1ull << PipelineBits) - 1;
+	const uint64_t materialMask = (1ull << MaterialBits) - 1;
+	const uint64_t meshMask = (1ull << MeshBits) - 1;
+	const uint64_t depthMask = (1ull << DepthBits) - 1;
+
+	uint64_t key = (pipeline & pipelineMask) << (64 - PipelineBits);
+	uint64_t quantizedDepth = QuantizeDepth(depth);
+
+	if(blended)
+	{
+		// Pipeline | Depth, inverted so far draws come first | Material | Mesh //
+		key |= (~quantizedDepth & depthMask) << (MaterialBits + MeshBits);
+		key |= (material & materialMask) << MeshBits;
+		key |= mesh & meshMask;
+	}
+	else
+	{
+		// Pipeline | Material | Depth | Mesh, front to back within a material, the mesh only breaks ties //
+		key |= (material & materialMask) << (DepthBits + MeshBits);
+		key |= (quantizedDepth & depthMask) << MeshBits;
+		key |= mesh & meshMask;
+	}
+
+	return key;
+}
+
+#pragma region Benchmark
+void RenderQueue::RunBenchmark()
+{
+	const unsigned int drawCount = 100000;
+	const unsigned int materialCount = 512;
+	const unsigned int meshCount = 4096;
+	const int iterations = 20;
+
+	// 1. Synthetic draws, a tenth of them blended, in the order a scene would hand them over //
+	struct BenchmarkDraw
+	{
+		unsigned int Pipeline;
+		unsigned int Material;
+		unsigned int Mesh;
+		float Depth;
+	};
+
+	std::mt19937 random(1337);
+	std::uniform_int_distribution<unsigned int> material(0, materialCount - 1);
+	std::uniform_int_distribution<unsigned int> mesh(0, meshCount - 1);
+	std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+	std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+	std::vector<BenchmarkDraw> benchmarkDraws(drawCount);
+	for(BenchmarkDraw& draw : benchmarkDraws)
+	{
+		draw.Pipeline = chance(random) < 0.1f ? 1 : 0;
+		draw.Material = material(random);
+		draw.Mesh = mesh(random);
+		draw.Depth = depth(random);
+	}
+
+	RenderQueue queue;
+	queue.SetBlended(1, true);
+
+	auto fillQueue = [&]()
+	{
+		queue.Clear();
+		for(unsigned int i = 0; i < drawCount; i++)
+		{
+			const BenchmarkDraw& draw = benchmarkDraws[i];
+			queue.Add(draw.Pipeline, draw.Material, draw.Mesh, draw.Depth, i);
+		}
+	};
+
+	// 2. Reference order, std::sort on the same keys //
+	fillQueue();
+	std::vector<uint64_t> referenceKeys(drawCount);
+	double referenceTime = 0.0;
+
+	for(int i = 0; i < iterations; i++)
+	{
+		for(unsigned int j = 0; j < drawCount; j++)
+		{
+			referenceKeys[j] = queue.GetKey(j);
+		}
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		std::sort(referenceKeys.begin(), referenceKeys.end());
+		auto endTime = std::chrono::high_resolution_clock::now();
+		referenceTime += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+	}
+
+	LOG("Render queue benchmark: std::sort, " + std::to_string(drawCount) + " draws - " +
+		std::to_string(referenceTime / iterations) + " ms");
+
+	// 3. Radix sort on a single thread & spread over the pool //
+	ThreadPool& threadPool = ThreadPool::Get();
+	ThreadPool* sortPools[2] = { nullptr, &threadPool };
+	std::string sortNames[2] = { "radix, 1 thread", "radix, " + std::to_string(threadPool.GetThreadCount()) + " threads" };
+
+	for(int path = 0; path < 2; path++)
+	{
+		double fillTime = 0.0;
+		double sortTime = 0.0;
+
+		for(int i = 0; i < iterations; i++)
+		{
+			auto startTime = std::chrono::high_resolution_clock::now();
+			fillQueue();
+			auto sortStart = std::chrono::high_resolution_clock::now();
+			queue.Sort(sortPools[path]);
+			auto endTime = std::chrono::high_resolution_clock::now();
+
+			fillTime += std::chrono::duration<double, std::milli>(sortStart - startTime).count();
+			sortTime += std::chrono::duration<double, std::milli>(endTime - sortStart).count();
+		}
+
+		LOG("Render queue benchmark: " + sortNames[path] + " - " + std::to_string(fillTime / iterations) +
+			" ms building keys, " + std::to_string(sortTime / iterations) + " ms sorting");
+
+		// Items have to travel with their keys //
+		bool matches = true;
+		for(unsigned int j = 0; j < drawCount && matches; j++)
+		{
+			const BenchmarkDraw& draw = benchmarkDraws[queue.GetItem(j)];
+			uint64_t itemKey = MakeKey(draw.Pipeline, draw.Pipeline == 1, draw.Material, draw.Mesh, draw.Depth);
+			matches = queue.GetKey(j) == referenceKeys[j] && queue.GetKey(j) == itemKey;
+		}
+
+		if(!matches)
+		{
+			LOG(Log::MessageType::Error, sortNames[path] + " order doesn't match std::sort!");
+		}
+	}
+
+	// 4. Blended draws have to come out back to front, up to the precision depth is kept at //
+	uint64_t lastDepth = ~0ull;
+	for(unsigned int i = 0; i < drawCount; i++)
+	{
+		const BenchmarkDraw& draw = benchmarkDraws[queue.GetItem(i)];
+		if(draw.Pipeline == 1)
+		{
+			if(QuantizeDepth(draw.Depth) > lastDepth)
+			{
+				LOG(Log::MessageType::Error, "Blended draws aren't sorted back to front!");
+				break;
+			}
+
+			lastDepth = QuantizeDepth(draw.Depth);
+		}
+	}
+
+	// 5. Binds a single list would make, in submission order against sorted order //
+	auto countBinds = [&](bool sorted)
+	{
+		RenderQueueStatistics binds;
+		unsigned int pipeline = ~0u;
+		unsigned int material = ~0u;
+		unsigned int mesh = ~0u;
+
+		for(unsigned int i = 0; i < drawCount; i++)
+		{
+			const BenchmarkDraw& draw = benchmarkDraws[sorted ? queue.GetItem(i) : i];
+
+			draw.Pipeline != pipeline ? binds.PipelineBinds++ : binds.PipelinesSkipped++;
+			draw.Material != material ? binds.MaterialBinds++ : binds.MaterialsSkipped++;
+			draw.Mesh != mesh ? binds.GeometryBinds++ : binds.GeometrySkipped++;
+
+			pipeline = draw.Pipeline;
+			material = draw.Material;
+			mesh = draw.Mesh;
+		}
+
+		return binds;
+	};
+
+	const char* orderNames[2] = { "submission order", "sorted" };
+	for(int sorted = 0; sorted < 2; sorted++)
+	{
+		RenderQueueStatistics binds = countBinds(sorted == 1);
+		LOG("Render queue benchmark: " + std::string(orderNames[sorted]) + " - " + std::to_string(binds.PipelineBinds) +
+			" pipeline, " + std::to_string(binds.MaterialBinds) + " material, " + std::to_string(binds.GeometryBinds) +
+			" geometry binds ( " + std::to_string(binds.PipelinesSkipped + binds.MaterialsSkipped + binds.GeometrySkipped) + " skipped )");
+	}
+}
+#pragma endregion
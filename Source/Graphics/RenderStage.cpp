@@ -1,3 +1,93 @@
 #include "Graphics/RenderStage.h"
+#include "Graphics/DXAccess.h"
+#include "Graphics/DXCommands.h"
+#include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
 
-RenderStage::RenderStage(Window* window) : window(window) { }
\ No newline at end of file
+#include "Framework/Scene.h"
+
+#include "Utilities/ThreadPool.h"
+
+RenderStage::RenderStage(Window* window) : window(window) { }
+
+ComPtr<ID3D12GraphicsCommandList2> RenderStage::RecordParallel(ComPtr<ID3D12GraphicsCommandList2> commandList,
+	const std::vector<unsigned int>& drawCounts, const std::function<void(ID3D12GraphicsCommandList2*, const RecordRange&)>& record)
+{
+	ThreadPool& threadPool = ThreadPool::Get();
+	std::vector<RecordRange> ranges = ParallelRecorder::Partition(drawCounts, threadPool.GetThreadCount(),
+		ParallelRecorder::MinimumDrawsPerList);
+
+	// Not worth the extra lists, record like before //
+	if(ranges.size() <= 1)
+	{
+		for(const RecordRange& range : ranges)
+		{
+			record(commandList.Get(), range);
+		}
+
+		return commandList;
+	}
+
+	DXCommands* directCommands = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT);
+	const std::vector<ID3D12GraphicsCommandList2*>& lists = directCommands->BeginParallelLists(static_cast<unsigned int>(ranges.size()));
+
+	ParallelRecorder::Record(threadPool, ranges, [&](unsigned int list, const RecordRange& range)
+	{
+		record(lists[list], range);
+	});
+
+	directCommands->EndParallelLists();
+	return directCommands->GetGraphicsCommandList();
+}
+
+void RenderStage::CullModels(Scene* scene, const glm::mat4& viewProjection, ModelVisibility& visibility)
+{
+	const std::vector<Model*>& models = scene->GetModels();
+	Frustum frustum = FrustumCuller::ExtractFrustum(viewProjection);
+
+	// 1. Whole models through the hierarchy, branches outside of the frustum get skipped at once //
+	visibleModels.clear();
+	scene->GetHierarchy().QueryFrustum(frustum, visibleModels);
+
+	modelVisibility.assign(models.size(), 0);
+	for(unsigned int model : visibleModels)
+	{
+		modelVisibility[model] = 1;
+	}
+
+	frustumCuller.Clear();
+
+	// 2. Meshes of the visible models //
+	for(unsigned int i = 0; i < models.size(); i++)
+	{
+		if(modelVisibility[i])
+		{
+			const glm::mat4& modelMatrix = models[i]->Transform.GetModelMatrix();
+
+			for(Mesh* mesh : models[i]->GetMeshes())
+			{
+				frustumCuller.AddBox(TransformBoundingBox(mesh->GetBounds(), modelMatrix));
+			}
+		}
+	}
+
+	frustumCuller.CullBoxes(frustum, meshVisibility);
+
+	// 3. Spread the results back over every mesh of every model //
+	visibility.DrawCounts.assign(models.size(), 0);
+	visibility.MeshOffsets.resize(models.size());
+	visibility.Meshes.clear();
+
+	unsigned int box = 0;
+	for(unsigned int i = 0; i < models.size(); i++)
+	{
+		visibility.MeshOffsets[i] = static_cast<unsigned int>(visibility.Meshes.size());
+
+		for(unsigned int j = 0; j < models[i]->GetMeshes().size(); j++)
+		{
+			unsigned char visible = modelVisibility[i] ? meshVisibility[box++] : 0;
+			visibility.Meshes.push_back(visible);
+			visibility.DrawCounts[i] += visible;
+		}
+	}
+}
@@ -6,55 +6,163 @@
 #include "Graphics/DXPipeline.h"
 #include "Graphics/Camera.h"
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXFrameGraph.h"
+#include "Graphics/DXConstantRing.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/RenderQueue.h"
 #include "Graphics/Model.h"
+#include "Graphics/Mesh.h"
 #include "Graphics/DepthBuffer.h"
+#include "Graphics/HDRI.h"
 
 #include "Framework/Scene.h"
+#include "Utilities/ThreadPool.h"
+
 #include <imgui_impl_dx12.h>
 
+namespace
+{
+	// Index into the sort key, blended draws come after every opaque one //
+	const unsigned int OpaquePipeline = 0;
+	const unsigned int BlendedPipeline = 1;
+}
+
 SceneStage::SceneStage(Window* window, Scene* scene, ShadowStage* shadowStage) 
 	: RenderStage(window), scene(scene), shadowStage(shadowStage)
 {
 	CreatePipeline();
 }
 
+void SceneStage::DeclareResources(DXFrameGraph& frameGraph, unsigned int pass)
+{
+	frameGraph.Read(pass, frameGraph.LookupResource("ShadowMap"), ResourceUsage::ShaderResource);
+	frameGraph.Write(pass, frameGraph.LookupResource("RenderBuffer"), ResourceUsage::RenderTarget);
+	frameGraph.Write(pass, frameGraph.LookupResource("DepthBuffer"), ResourceUsage::DepthWrite);
+}
+
 void SceneStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 {
 	// 0. Grab all relevant objects to perform stage //
 	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	DXDescriptorHeap* DSVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-
-	ComPtr<ID3D12Resource> renderBuffer = window->GetCurrentRenderBuffer();
 
 	CD3DX12_CPU_DESCRIPTOR_HANDLE depthView = window->GetDepthDSV();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE renderRTV = window->GetCurrentRenderRTV();
 	Camera& camera = scene->GetCamera();
 
-	// 1. Transition Render (Texture) to Render Target, afterwards bind target //
-	TransitionResource(renderBuffer.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	// 1. Clear the render target, the frame graph already transitioned it //
 	BindAndClearRenderTarget(window, &renderRTV, &depthView);
 
-	// 2. Bind pipeline & root //
-	commandList->SetGraphicsRootSignature(rootSignature->GetAddress());
-	commandList->SetPipelineState(pipeline->GetAddress());
+	// 2. Shared by every list, so pushed once, before recording starts //
+	DXConstantRing* constantRing = DXAccess::GetConstantRing();
+	D3D12_GPU_VIRTUAL_ADDRESS lightData = constantRing->Push(scene->GetLightData());
+	D3D12_GPU_VIRTUAL_ADDRESS materialTable = DXAccess::GetMaterialTable()->Upload(constantRing);
+	const glm::mat4& viewProjection = camera.GetViewProjectionMatrix();
+	const glm::mat4& lightMatrix = shadowStage->GetLightMatrix();
+
+	// 3. Skip everything outside of the camera's frustum, what's left is grouped into a draw per unique mesh //
+	CullModels(scene, viewProjection, visibility);
+	instances.Build(scene->GetModels(), visibility, camera.Position);
+
+	InstanceBuffers instanceBuffers = instances.Upload(constantRing);
+	const std::vector<InstanceBatch>& batches = instances.GetBatches();
+	glm::mat4 transform[2] = { viewProjection, lightMatrix };
 
-	// 3. Bind root arguments  //
-	commandList->SetGraphicsRoot32BitConstants(1, 3, &camera.Position, 0);
-	commandList->SetGraphicsRootDescriptorTable(2, scene->GetLightBufferHandle());
-	commandList->SetGraphicsRootDescriptorTable(4, skydomeHandle);
-	commandList->SetGraphicsRootDescriptorTable(5, shadowStage->GetDepthBuffer()->GetSRV());
+	// 4. Order the draws by the state they need, opaque front to back, blended back to front after them //
+	RenderQueue* renderQueue = DXAccess::GetRenderQueue();
+	renderQueue->Clear();
 
-	// 4. Draw Calls & Bind MVPs ( happens in Model.cpp ) // 
-	for(Model* model : scene->GetModels())
+	for(unsigned int i = 0; i < batches.size(); i++)
 	{
-		model->Draw(camera.GetViewProjectionMatrix(), shadowStage->GetLightMatrix());
+		Mesh* mesh = batches[i].Geometry;
+		unsigned int pipelineIndex = mesh->IsTransparent() ? BlendedPipeline : OpaquePipeline;
+		renderQueue->Add(pipelineIndex, mesh->GetMaterialIndex(), batches[i].MeshID, batches[i].Depth, i);
 	}
 
-	// 5. Draw UI/Editor //
-	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandList.Get());
+	renderQueue->Sort(&ThreadPool::Get());
+	DXPipeline* pipelines[2] = { pipeline, blendedPipeline };
 
-	// 6. Prepare Render Target to be used as Render Texture //
-	TransitionResource(renderBuffer.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	// 5. Instanced draw calls, every list binds the whole stage, then only what changes between its draws // 
+	commandList = RecordParallel(commandList, instances.GetDrawCounts(), [&](ID3D12GraphicsCommandList2* list, const RecordRange& range)
+	{
+		list->RSSetViewports(1, &window->GetViewport());
+		list->RSSetScissorRects(1, &window->GetScissorRect());
+		list->OMSetRenderTargets(1, &renderRTV, FALSE, &depthView);
+
+		list->SetGraphicsRootSignature(rootSignature->GetAddress());
+
+		// Transforms, materials & textures are shared by every draw //
+		list->SetGraphicsRoot32BitConstants(0, 32, transform, 0);
+		list->SetGraphicsRoot32BitConstants(1, 3, &camera.Position, 0);
+		list->SetGraphicsRootConstantBufferView(2, lightData);
+		list->SetGraphicsRootDescriptorTable(4, environment->GetSpecularSRVHandle());
+		list->SetGraphicsRootDescriptorTable(5, shadowStage->GetDepthBuffer()->GetSRV());
+		list->SetGraphicsRootDescriptorTable(7, environment->GetIrradianceCBVHandle());
+		list->SetGraphicsRootDescriptorTable(8, environment->GetBRDFSRVHandle());
+		list->SetGraphicsRootShaderResourceView(6, materialTable);
+		list->SetGraphicsRootDescriptorTable(9, CBVHeap->GetGPUHandleAt(0));
+		list->SetGraphicsRootShaderResourceView(10, instanceBuffers.Indices);
+		list->SetGraphicsRootShaderResourceView(11, instanceBuffers.Transforms);
+
+		// Lists start without any of this bound //
+		RenderQueueStatistics listStatistics;
+		unsigned int boundPipeline = ~0u;
+		unsigned int boundMaterial = ~0u;
+		Mesh* boundMesh = nullptr;
+
+		for(unsigned int i = range.Begin; i < range.End; i++)
+		{
+			const InstanceBatch& batch = batches[renderQueue->GetItem(i)];
+			Mesh* mesh = batch.Geometry;
+
+			unsigned int pipelineIndex = renderQueue->GetPipeline(i);
+			if(pipelineIndex != boundPipeline)
+			{
+				list->SetPipelineState(pipelines[pipelineIndex]->GetAddress());
+				boundPipeline = pipelineIndex;
+				listStatistics.PipelineBinds++;
+			}
+			else
+			{
+				listStatistics.PipelinesSkipped++;
+			}
+
+			unsigned int materialIndex = mesh->GetMaterialIndex();
+			if(materialIndex != boundMaterial)
+			{
+				list->SetGraphicsRoot32BitConstant(3, materialIndex, 0);
+				boundMaterial = materialIndex;
+				listStatistics.MaterialBinds++;
+			}
+			else
+			{
+				listStatistics.MaterialsSkipped++;
+			}
+
+			if(mesh != boundMesh)
+			{
+				list->IASetVertexBuffers(0, 1, &mesh->GetVertexBufferView());
+				list->IASetIndexBuffer(&mesh->GetIndexBufferView());
+				boundMesh = mesh;
+				listStatistics.GeometryBinds++;
+			}
+			else
+			{
+				listStatistics.GeometrySkipped++;
+			}
+
+			list->SetGraphicsRoot32BitConstant(0, batch.FirstInstance, 32);
+			list->DrawIndexedInstanced(mesh->GetIndicesCount(), batch.InstanceCount, 0, 0, 0);
+			listStatistics.Draws++;
+		}
+
+		renderQueue->AddStatistics(listStatistics);
+	});
+
+	// 6. Draw UI/Editor, after the parallel lists recording continues in a new list //
+	commandList->RSSetViewports(1, &window->GetViewport());
+	commandList->RSSetScissorRects(1, &window->GetScissorRect());
+	commandList->OMSetRenderTargets(1, &renderRTV, FALSE, &depthView);
+	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandList.Get());
 }
 
 void SceneStage::SetScene(Scene* newScene)
@@ -62,37 +170,43 @@ void SceneStage::SetScene(Scene* newScene)
 	scene = newScene;
 }
 
-void SceneStage::SetSkydome(CD3DX12_GPU_DESCRIPTOR_HANDLE skydomeHandle)
+void SceneStage::SetEnvironment(HDRI* environment)
 {
-	this->skydomeHandle = skydomeHandle;
+	this->environment = environment;
 }
 
 void SceneStage::CreatePipeline()
 {
-	CD3DX12_DESCRIPTOR_RANGE1 cbvRanges[1]; // placeholder cause there is no guarantee they are next too each other...
-	cbvRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 1); // Lighting buffer
-
+	// The whole heap as an unbounded table, materials index it directly. Not every descriptor
+	// in the heap is a texture or even initialized, so the range has to be volatile
 	CD3DX12_DESCRIPTOR_RANGE1 textureRanges[1];
-	// Albedo, Normal, Metallic Roughess, Ambient Occlusion, Emissive //
-	textureRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 5, 0);
+	textureRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 3, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE, 0);
 
 	CD3DX12_DESCRIPTOR_RANGE1 skydomeRange[1];
-	skydomeRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 1); 
+	skydomeRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 1); // Prefiltered specular environment
 
 	CD3DX12_DESCRIPTOR_RANGE1 shadowRange[1];
 	shadowRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 1, 1);
 
-	CD3DX12_DESCRIPTOR_RANGE1 materialRange[1];
-	materialRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 2);
+	CD3DX12_DESCRIPTOR_RANGE1 irradianceRange[1];
+	irradianceRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1, 1);
+
+	CD3DX12_DESCRIPTOR_RANGE1 brdfRange[1];
+	brdfRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 2, 1);
 
-	CD3DX12_ROOT_PARAMETER1 rootParameters[7];
-	rootParameters[0].InitAsConstants(48, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // MVP, Model, Light
+	CD3DX12_ROOT_PARAMETER1 rootParameters[12];
+	rootParameters[0].InitAsConstants(33, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // View projection, Light, First instance
 	rootParameters[1].InitAsConstants(3, 1, 0, D3D12_SHADER_VISIBILITY_VERTEX); // Scene info ( Camera... etc. ) 
-	rootParameters[2].InitAsDescriptorTable(1, &cbvRanges[0], D3D12_SHADER_VISIBILITY_PIXEL); // Lighting data
-	rootParameters[3].InitAsDescriptorTable(1, &textureRanges[0], D3D12_SHADER_VISIBILITY_PIXEL); // Textures
+	rootParameters[2].InitAsConstantBufferView(0, 1, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_PIXEL); // Lighting data
+	rootParameters[3].InitAsConstants(1, 2, 0, D3D12_SHADER_VISIBILITY_PIXEL); // Material index
 	rootParameters[4].InitAsDescriptorTable(1, &skydomeRange[0], D3D12_SHADER_VISIBILITY_PIXEL); // Skydome
 	rootParameters[5].InitAsDescriptorTable(1, &shadowRange[0], D3D12_SHADER_VISIBILITY_PIXEL); // Shadow
-	rootParameters[6].InitAsDescriptorTable(1, &materialRange[0], D3D12_SHADER_VISIBILITY_PIXEL); // material
+	rootParameters[6].InitAsShaderResourceView(0, 2, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_PIXEL); // Material table
+	rootParameters[7].InitAsDescriptorTable(1, &irradianceRange[0], D3D12_SHADER_VISIBILITY_PIXEL); // Irradiance SH
+	rootParameters[8].InitAsDescriptorTable(1, &brdfRange[0], D3D12_SHADER_VISIBILITY_PIXEL); // BRDF lookup
+	rootParameters[9].InitAsDescriptorTable(1, &textureRanges[0], D3D12_SHADER_VISIBILITY_PIXEL); // Textures
+	rootParameters[10].InitAsShaderResourceView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_VERTEX); // Instance indices
+	rootParameters[11].InitAsShaderResourceView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_VERTEX); // Instance transforms
 
 	rootSignature = new DXRootSignature(rootParameters, _countof(rootParameters), D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -100,7 +214,13 @@ void SceneStage::CreatePipeline()
 	description.VertexPath = "Source/Shaders/default.vertex.hlsl";
 	description.PixelPath = "Source/Shaders/default.pixel.hlsl";
 	description.RootSignature = rootSignature;
-	description.DoAlphaBlending = true;
 
 	pipeline = new DXPipeline(description);
+
+	// Blended draws are sorted back to front, they test against the opaque depth but don't hide what's behind them //
+	description.DoAlphaBlending = true;
+	description.DoDepthWrite = false;
+	blendedPipeline = new DXPipeline(description);
+
+	DXAccess::GetRenderQueue()->SetBlended(BlendedPipeline, true);
 }
\ No newline at end of file
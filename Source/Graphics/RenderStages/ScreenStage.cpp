@@ -1,6 +1,7 @@
 #include "Graphics/RenderStages/ScreenStage.h"
 
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXFrameGraph.h"
 #include "Graphics/DXPipeline.h"
 #include "Graphics/DXRootSignature.h"
 #include "Graphics/DXDescriptorHeap.h"
@@ -14,12 +15,20 @@ ScreenStage::ScreenStage(Window* window) : RenderStage(window)
 	CreateScreenMesh();
 }
 
+void ScreenStage::DeclareResources(DXFrameGraph& frameGraph, unsigned int pass)
+{
+	// Drawn on top of the skydome, so the screen buffer's contents are kept //
+	frameGraph.ReadWrite(pass, frameGraph.LookupResource("ScreenBuffer"), ResourceUsage::RenderTarget);
+	frameGraph.Read(pass, frameGraph.LookupResource("RenderBuffer"), ResourceUsage::ShaderResource);
+	frameGraph.Write(pass, frameGraph.LookupResource("DepthBuffer"), ResourceUsage::DepthWrite);
+}
+
 void ScreenStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 {
 	// 0. Grab all relevant variables //
 	DXDescriptorHeap* DSVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 
-	ComPtr<ID3D12Resource> screenBuffer = window->GetCurrentScreenBuffer();
+	CD3DX12_CPU_DESCRIPTOR_HANDLE screenRTV = window->GetCurrentScreenRTV();
 	CD3DX12_GPU_DESCRIPTOR_HANDLE renderTexture = window->GetCurrentRenderSRV();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE depthView = window->GetDepthDSV();
 
@@ -27,7 +36,10 @@ void ScreenStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 	commandList->SetGraphicsRootSignature(rootSignature->GetAddress());
 	commandList->SetPipelineState(pipeline->GetAddress());
 
-	// 2. Clear depth buffer before use //
+	// 2. Bind the screen buffer without clearing it, & clear depth buffer before use //
+	commandList->RSSetViewports(1, &window->GetViewport());
+	commandList->RSSetScissorRects(1, &window->GetScissorRect());
+	commandList->OMSetRenderTargets(1, &screenRTV, FALSE, &depthView);
 	commandList->ClearDepthStencilView(depthView, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 
 	// 3. Use Render Target as Texture //
@@ -37,9 +49,6 @@ void ScreenStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 	commandList->IASetVertexBuffers(0, 1, &screenMesh->GetVertexBufferView());
 	commandList->IASetIndexBuffer(&screenMesh->GetIndexBufferView());
 	commandList->DrawIndexedInstanced(screenMesh->GetIndicesCount(), 1, 0, 0, 0);
-
-	// 5. Prepare screen buffer to be presented, since this is the last stage //
-	TransitionResource(screenBuffer.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
 }
 
 void ScreenStage::CreatePipeline()
@@ -4,6 +4,8 @@
 
 #include "Graphics/DepthBuffer.h"
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXConstantRing.h"
+#include "Graphics/DXFrameGraph.h"
 #include "Graphics/DXRootSignature.h"
 #include "Graphics/DXPipeline.h"
 #include "Graphics/Model.h"
@@ -52,43 +54,53 @@ void ShadowStage::Update(float deltaTime)
 	lightMatrix = projection * view;
 }
 
+void ShadowStage::DeclareResources(DXFrameGraph& frameGraph, unsigned int pass)
+{
+	// The shadow map is sampled by other stages, so outside of this stage it stays a shader resource //
+	unsigned int shadowMap = frameGraph.ImportResource("ShadowMap", depthBuffer->GetResource().Get(), ResourceUsage::ShaderResource);
+	frameGraph.Write(pass, shadowMap, ResourceUsage::DepthWrite);
+}
+
 void ShadowStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 {
-	ComPtr<ID3D12Resource> depthResource = depthBuffer->GetResource();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE depthView = depthBuffer->GetDSV();
 
-	TransitionResource(depthResource.Get(), 
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-
 	// 1. Clear Light DepthBuffer //
 	commandList->ClearDepthStencilView(depthView, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 
-	// 2. Bind pipeline & root // 
-	commandList->SetGraphicsRootSignature(rootSignature->GetAddress());
-	commandList->SetPipelineState(pipeline->GetAddress());
+	// 2. Only what's within the light's frustum can cast a shadow onto the map, a draw per unique mesh //
+	CullModels(scene, lightMatrix, visibility);
+	instances.Build(scene->GetModels(), visibility, lightPosition);
 
-	// Bind viewport & rect, followed by the depth buffer //
-	commandList->RSSetViewports(1, &viewport);
-	commandList->RSSetScissorRects(1, &scissorRect);
-	commandList->OMSetRenderTargets(0, nullptr, FALSE, &depthView);
+	InstanceBuffers instanceBuffers = instances.Upload(DXAccess::GetConstantRing());
+	const std::vector<InstanceBatch>& batches = instances.GetBatches();
 
-	// Render scene //
-	for(Model* model : scene->GetModels())
+	// 3. Render scene, split over lists that each bind the whole stage //
+	commandList = RecordParallel(commandList, instances.GetDrawCounts(), [&](ID3D12GraphicsCommandList2* list, const RecordRange& range)
 	{
-		commandList->SetGraphicsRoot32BitConstants(0, 16, &lightMatrix, 0);
-		commandList->SetGraphicsRoot32BitConstants(0, 16, &model->Transform.GetModelMatrix(), 16);
-
-		for(Mesh* mesh : model->GetMeshes())
+		list->SetGraphicsRootSignature(rootSignature->GetAddress());
+		list->SetPipelineState(pipeline->GetAddress());
+
+		// Bind viewport & rect, followed by the depth buffer //
+		list->RSSetViewports(1, &viewport);
+		list->RSSetScissorRects(1, &scissorRect);
+		list->OMSetRenderTargets(0, nullptr, FALSE, &depthView);
+		list->SetGraphicsRoot32BitConstants(0, 16, &lightMatrix, 0);
+		list->SetGraphicsRootShaderResourceView(1, instanceBuffers.Indices);
+		list->SetGraphicsRootShaderResourceView(2, instanceBuffers.Transforms);
+
+		for(unsigned int i = range.Begin; i < range.End; i++)
 		{
-			commandList->IASetVertexBuffers(0, 1, &mesh->GetVertexBufferView());
-			commandList->IASetIndexBuffer(&mesh->GetIndexBufferView());
+			const InstanceBatch& batch = batches[i];
+			Mesh* mesh = batch.Geometry;
 
-			commandList->DrawIndexedInstanced(mesh->GetIndicesCount(), 1, 0, 0, 0);
-		}
-	}
+			list->SetGraphicsRoot32BitConstant(0, batch.FirstInstance, 16);
+			list->IASetVertexBuffers(0, 1, &mesh->GetVertexBufferView());
+			list->IASetIndexBuffer(&mesh->GetIndexBufferView());
 
-	TransitionResource(depthResource.Get(),
-	D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+			list->DrawIndexedInstanced(mesh->GetIndicesCount(), batch.InstanceCount, 0, 0, 0);
+		}
+	});
 }
 
 DepthBuffer* ShadowStage::GetDepthBuffer()
@@ -103,8 +115,10 @@ const glm::mat4& ShadowStage::GetLightMatrix()
 
 void ShadowStage::CreatePipeline()
 {
-	CD3DX12_ROOT_PARAMETER1 rootParameters[1];
-	rootParameters[0].InitAsConstants(32, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // Light & Model Matrix
+	CD3DX12_ROOT_PARAMETER1 rootParameters[3];
+	rootParameters[0].InitAsConstants(17, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX); // Light Matrix & First instance
+	rootParameters[1].InitAsShaderResourceView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_VERTEX); // Instance indices
+	rootParameters[2].InitAsShaderResourceView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_NONE, D3D12_SHADER_VISIBILITY_VERTEX); // Instance transforms
 
 	rootSignature = new DXRootSignature(rootParameters, _countof(rootParameters), D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -5,13 +5,16 @@
 #include "Graphics/Camera.h"
 #include "Graphics/Model.h"
 #include "Graphics/Mesh.h"
-#include "Graphics/Texture.h"
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXFrameGraph.h"
 #include "Graphics/DXPipeline.h"
 #include "Graphics/DXRootSignature.h"
 #include "Graphics/DXDescriptorHeap.h"
 #include "Graphics/HDRI.h"
 
+#include "Utilities/Logger.h"
+#include <cassert>
+
 HDRI* testDome;
 
 SkydomeStage::SkydomeStage(Window* window, Scene* scene) : RenderStage(window), scene(scene)
@@ -19,19 +22,29 @@ SkydomeStage::SkydomeStage(Window* window, Scene* scene) : RenderStage(window),
 	CreatePipeline();
 
 	Model* skydome = new Model("Assets/Models/Skydome/skydome.gltf");
+	if(!skydome->IsLoaded())
+	{
+		LOG(Log::MessageType::Error, "Skydome model couldn't be loaded, the stage can't draw without it.");
+		assert(false && "Skydome model couldn't be loaded");
+	}
+
 	skydomeMesh = skydome->GetMesh(0);
 
-	skydomeTexture = new Texture("Assets/HDRI/testDome.hdr");
 	testDome = new HDRI("Assets/HDRI/testDome.hdr");
 }
 
+void SkydomeStage::DeclareResources(DXFrameGraph& frameGraph, unsigned int pass)
+{
+	frameGraph.Write(pass, frameGraph.LookupResource("ScreenBuffer"), ResourceUsage::RenderTarget);
+	frameGraph.Write(pass, frameGraph.LookupResource("DepthBuffer"), ResourceUsage::DepthWrite);
+}
+
 void SkydomeStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 {
 	// 0. Get all relevant objects //
 	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	DXDescriptorHeap* DSVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 
-	ComPtr<ID3D12Resource> screenBuffer = window->GetCurrentScreenBuffer();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE screenRTV = window->GetCurrentScreenRTV();
 	CD3DX12_CPU_DESCRIPTOR_HANDLE depthView = window->GetDepthDSV();
 	CD3DX12_GPU_DESCRIPTOR_HANDLE skydomeData = CBVHeap->GetGPUHandleAt(testDome->GetHDRiSRVIndex());
@@ -41,8 +54,7 @@ void SkydomeStage::RecordStage(ComPtr<ID3D12GraphicsCommandList2> commandList)
 	glm::mat4 projection = camera.GetProjectionMatrix();
 	skydomeMatrix = projection * view;
 
-	// 1. Prepare the screen buffer to be used as Render Target //
-	TransitionResource(screenBuffer.Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	// 1. Bind & clear the screen buffer as Render Target //
 	BindAndClearRenderTarget(window, &screenRTV, &depthView);
 
 	// 2. Bind pipeline & root //
@@ -71,7 +83,7 @@ void SkydomeStage::SetScene(Scene* newScene)
 CD3DX12_GPU_DESCRIPTOR_HANDLE SkydomeStage::GetSkydomeHandle()
 {
 	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	return CBVHeap->GetGPUHandleAt(testDome->GetIrradianceSRVIndex());
+	return CBVHeap->GetGPUHandleAt(testDome->GetHDRiSRVIndex());
 }
 
 HDRI* SkydomeStage::GetHDRI()
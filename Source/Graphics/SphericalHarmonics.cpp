@@ -0,0 +1,377 @@
+#include "Graphics/SphericalHarmonics.h"
+#include "Graphics/MipGenerator.h"
+
+#include "Utilities/Logger.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stb_image.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVA_SSE_PROJECTION
+#include <xmmintrin.h>
+#endif
+
+static const float PI = 3.14159265359f;
+
+// Same clamp the convolution pass used, keeps a single sun texel from ringing through every coefficient //
+static const float maxRadiance = 2500.0f;
+
+// Cosine lobe convolution per band ( A0 = PI, A1 = 2PI/3, A2 = PI/4 ), divided by PI //
+static const float bandScales[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+	0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+// Real spherical harmonics basis, bands 0-2 //
+static void EvaluateBasis(float x, float y, float z, float* basis)
+{
+	basis[0] = 0.282095f;
+	basis[1] = 0.488603f * y;
+	basis[2] = 0.488603f * z;
+	basis[3] = 0.488603f * x;
+	basis[4] = 1.092548f * x * y;
+	basis[5] = 1.092548f * y * z;
+	basis[6] = 0.315392f * (3.0f * z * z - 1.0f);
+	basis[7] = 1.092548f * x * z;
+	basis[8] = 0.546274f * (x * x - y * y);
+}
+
+#ifdef NOVA_SSE_PROJECTION
+static void EvaluateBasis(__m128 x, __m128 y, __m128 z, __m128* basis)
+{
+	const __m128 band1 = _mm_set1_ps(0.488603f);
+	const __m128 band2 = _mm_set1_ps(1.092548f);
+
+	basis[0] = _mm_set1_ps(0.282095f);
+	basis[1] = _mm_mul_ps(band1, y);
+	basis[2] = _mm_mul_ps(band1, z);
+	basis[3] = _mm_mul_ps(band1, x);
+	basis[4] = _mm_mul_ps(band2, _mm_mul_ps(x, y));
+	basis[5] = _mm_mul_ps(band2, _mm_mul_ps(y, z));
+	basis[6] = _mm_mul_ps(_mm_set1_ps(0.315392f),
+		_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(z, z)), _mm_set1_ps(1.0f)));
+	basis[7] = _mm_mul_ps(band2, _mm_mul_ps(x, z));
+	basis[8] = _mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+}
+#endif
+
+// Bilinear lookup with wrapping, like the static sampler does //
+static glm::vec3 SampleBilinear(const float* pixels, int width, int height, float u, float v)
+{
+	float x = u * width - 0.5f;
+	float y = v * height - 0.5f;
+
+	int x0 = static_cast<int>(std::floor(x));
+	int y0 = static_cast<int>(std::floor(y));
+	float fx = x - x0;
+	float fy = y - y0;
+
+	auto fetch = [&](int px, int py)
+	{
+		px = ((px % width) + width) % width;
+		py = ((py % height) + height) % height;
+
+		const float* pixel = pixels + (static_cast<size_t>(py) * width + px) * 4;
+		return glm::vec3(pixel[0], pixel[1], pixel[2]);
+	};
+
+	glm::vec3 top = glm::mix(fetch(x0, y0), fetch(x0 + 1, y0), fx);
+	glm::vec3 bottom = glm::mix(fetch(x0, y0 + 1), fetch(x0 + 1, y0 + 1), fx);
+	return glm::mix(top, bottom, fy);
+}
+
+SHIrradiance SphericalHarmonics::ProjectIrradiance(const float* pixels, int width, int height)
+{
+	// Within a row only phi changes, so its sine & cosine get shared by every row //
+	std::vector<float> cosPhi(width);
+	std::vector<float> sinPhi(width);
+
+	for(int x = 0; x < width; x++)
+	{
+		float phi = ((x + 0.5f) / width) * 2.0f * PI - PI;
+		cosPhi[x] = std::cos(phi);
+		sinPhi[x] = std::sin(phi);
+	}
+
+	// Rows get summed in order afterwards, which keeps the result independent of the thread count //
+	std::vector<double> rowSums(static_cast<size_t>(height) * 27);
+
+	ThreadPool::Get().ParallelFor(static_cast<unsigned int>(height), [&](unsigned int y)
+	{
+		ProjectRow(pixels, width, height, y, cosPhi.data(), sinPhi.data(), rowSums.data() + static_cast<size_t>(y) * 27);
+	});
+
+	double sums[27] = {};
+	for(int y = 0; y < height; y++)
+	{
+		for(int i = 0; i < 27; i++)
+		{
+			sums[i] += rowSums[static_cast<size_t>(y) * 27 + i];
+		}
+	}
+
+	SHIrradiance irradiance = {};
+	for(int k = 0; k < 9; k++)
+	{
+		irradiance.Coefficients[k] = glm::vec4(static_cast<float>(sums[k * 3 + 0] * bandScales[k]),
+			static_cast<float>(sums[k * 3 + 1] * bandScales[k]), static_cast<float>(sums[k * 3 + 2] * bandScales[k]), 0.0f);
+	}
+
+	return irradiance;
+}
+
+glm::vec3 SphericalHarmonics::EvaluateIrradiance(const SHIrradiance& irradiance, const glm::vec3& normal)
+{
+	glm::vec3 n = glm::normalize(normal);
+
+	float basis[9];
+	EvaluateBasis(n.x, n.y, n.z, basis);
+
+	glm::vec3 result = glm::vec3(0.0f);
+	for(int k = 0; k < 9; k++)
+	{
+		result += glm::vec3(irradiance.Coefficients[k]) * basis[k];
+	}
+
+	return glm::max(result, glm::vec3(0.0f));
+}
+
+glm::vec3 SphericalHarmonics::IntegrateIrradiance(const float* pixels, int width, int height,
+	const glm::vec3& normal, float sampleDelta)
+{
+	glm::vec3 n = glm::normalize(normal);
+
+	// Any tangent frame works, the integral covers the whole hemisphere //
+	glm::vec3 helper = std::abs(n.y) < 0.999f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+	glm::vec3 right = glm::normalize(glm::cross(helper, n));
+	glm::vec3 up = glm::cross(n, right);
+
+	glm::vec3 irradiance = glm::vec3(0.0f);
+	float sampleCount = 0.0f;
+
+	for(float phi = 0.0f; phi < 2.0f * PI; phi += sampleDelta)
+	{
+		for(float theta = 0.0f; theta < 0.5f * PI; theta += sampleDelta)
+		{
+			glm::vec3 tangentSample = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			glm::vec3 sampleDirection = tangentSample.x * right + tangentSample.y * n + tangentSample.z * up;
+
+			float u = (std::atan2(sampleDirection.z, sampleDirection.x) + PI) / (2.0f * PI);
+			float v = 1.0f - std::acos(glm::clamp(sampleDirection.y, -1.0f, 1.0f)) / PI;
+
+			glm::vec3 sample = glm::min(SampleBilinear(pixels, width, height, u, v), glm::vec3(maxRadiance));
+			irradiance += sample * std::cos(theta) * std::sin(theta);
+			sampleCount += 1.0f;
+		}
+	}
+
+	return PI * irradiance * (1.0f / sampleCount);
+}
+
+void SphericalHarmonics::RunBenchmark(const std::vector<std::string>& hdriPaths)
+{
+	if(hdriPaths.empty())
+	{
+		LOG(Log::MessageType::Error, "No HDRIs passed to the irradiance benchmark.");
+		return;
+	}
+
+	// Evenly spread directions ( Fibonacci sphere ) to compare irradiance in //
+	const int directionCount = 64;
+	std::vector<glm::vec3> directions(directionCount);
+	for(int i = 0; i < directionCount; i++)
+	{
+		float y = 1.0f - (i + 0.5f) * (2.0f / directionCount);
+		float radius = std::sqrt(1.0f - y * y);
+		float phi = i * PI * (3.0f - std::sqrt(5.0f));
+		directions[i] = glm::vec3(radius * std::cos(phi), y, radius * std::sin(phi));
+	}
+
+	for(const std::string& hdriPath : hdriPaths)
+	{
+		int width;
+		int height;
+		int channels;
+
+		stbi_set_flip_vertically_on_load(true);
+		float* buffer = stbi_loadf(hdriPath.c_str(), &width, &height, &channels, 4);
+		stbi_set_flip_vertically_on_load(false);
+
+		if(!buffer)
+		{
+			LOG(Log::MessageType::Error, "Couldn't load '" + hdriPath + "' for the irradiance benchmark.");
+			continue;
+		}
+
+		std::vector<float> pixels(buffer, buffer + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(buffer);
+
+		int mipCount = MipGenerator::GenerateRGBA32F(pixels, width, height);
+
+		LOG("Irradiance benchmark: '" + hdriPath + "' ( " + std::to_string(width) + "x" +
+			std::to_string(height) + ", " + std::to_string(ThreadPool::Get().GetThreadCount()) + " threads )");
+
+		// 1. Projection time versus resolution, every level of the mip chain gets projected //
+		SHIrradiance topLevel = ProjectIrradiance(pixels.data(), width, height);
+
+		// Errors are relative to the average irradiance, directions facing away from a bright
+		// sun receive almost nothing, which would make any per direction relative error meaningless.
+		float averageIrradiance = 0.0f;
+		for(const glm::vec3& direction : directions)
+		{
+			averageIrradiance += glm::length(EvaluateIrradiance(topLevel, direction)) / directionCount;
+		}
+		averageIrradiance = std::max(averageIrradiance, 1e-6f);
+
+		for(int level = 0; level < mipCount; level++)
+		{
+			int mipWidth;
+			int mipHeight;
+			MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+			const float* mipPixels = pixels.data() + MipGenerator::GetMipOffset(width, height, level) * 4;
+
+			// Best of a few runs, small levels are otherwise dominated by noise //
+			SHIrradiance irradiance;
+			float bestSeconds = 1e30f;
+			for(int run = 0; run < 5; run++)
+			{
+				auto startTime = std::chrono::high_resolution_clock::now();
+				irradiance = ProjectIrradiance(mipPixels, mipWidth, mipHeight);
+				auto endTime = std::chrono::high_resolution_clock::now();
+
+				bestSeconds = std::min(bestSeconds, std::chrono::duration<float>(endTime - startTime).count());
+			}
+
+			float maxError = 0.0f;
+			for(const glm::vec3& direction : directions)
+			{
+				maxError = std::max(maxError, glm::length(EvaluateIrradiance(irradiance, direction) -
+					EvaluateIrradiance(topLevel, direction)) / averageIrradiance);
+			}
+
+			float megapixelsPerSecond = static_cast<float>(mipWidth) * mipHeight / std::max(bestSeconds, 1e-7f) / 1e6f;
+
+			char line[128];
+			snprintf(line, sizeof(line), "  %5dx%-5d - %9.3f ms, %8.2f MPixel/s, %6.2f%% max difference to level 0",
+				mipWidth, mipHeight, bestSeconds * 1000.0f, megapixelsPerSecond, maxError * 100.0f);
+			LOG(line);
+		}
+
+		// 2. Reference, the hemisphere integral the convolution pass evaluated for every pixel //
+		std::vector<glm::vec3> reference(directionCount);
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+		ThreadPool::Get().ParallelFor(static_cast<unsigned int>(directionCount), [&](unsigned int i)
+		{
+			reference[i] = IntegrateIrradiance(pixels.data(), width, height, directions[i]);
+		});
+		auto endTime = std::chrono::high_resolution_clock::now();
+
+		float meanError = 0.0f;
+		float maxError = 0.0f;
+		for(int i = 0; i < directionCount; i++)
+		{
+			float error = glm::length(EvaluateIrradiance(topLevel, directions[i]) - reference[i]) / averageIrradiance;
+			meanError += error / directionCount;
+			maxError = std::max(maxError, error);
+		}
+
+		float seconds = std::chrono::duration<float>(endTime - startTime).count();
+
+		char line[160];
+		snprintf(line, sizeof(line), "  Brute force integral - %9.3f ms for %d directions",
+			seconds * 1000.0f, directionCount);
+		LOG(line);
+
+		snprintf(line, sizeof(line), "  SH against brute force - %6.2f%% mean, %6.2f%% max error",
+			meanError * 100.0f, maxError * 100.0f);
+		LOG(line);
+	}
+}
+
+void SphericalHarmonics::ProjectRow(const float* pixels, int width, int height, int y,
+	const float* cosPhi, const float* sinPhi, double* sums)
+{
+	// Row 0 is the bottom of the environment ( v = 0 ), looking straight down //
+	float theta = (1.0f - (y + 0.5f) / height) * PI;
+	float sinTheta = std::sin(theta);
+	float cosTheta = std::cos(theta);
+
+	const float* row = pixels + static_cast<size_t>(y) * width * 4;
+	float accumulated[27] = {};
+	int x = 0;
+
+#ifdef NOVA_SSE_PROJECTION
+	__m128 accumulators[27];
+	for(int i = 0; i < 27; i++)
+	{
+		accumulators[i] = _mm_setzero_ps();
+	}
+
+	const __m128 sinThetas = _mm_set1_ps(sinTheta);
+	const __m128 directionY = _mm_set1_ps(cosTheta);
+	const __m128 minimum = _mm_setzero_ps();
+	const __m128 maximum = _mm_set1_ps(maxRadiance);
+
+	for(; x + 4 <= width; x += 4)
+	{
+		// Transposing RGBA pixels gives a register per channel //
+		__m128 red = _mm_loadu_ps(row + x * 4);
+		__m128 green = _mm_loadu_ps(row + x * 4 + 4);
+		__m128 blue = _mm_loadu_ps(row + x * 4 + 8);
+		__m128 alpha = _mm_loadu_ps(row + x * 4 + 12);
+		_MM_TRANSPOSE4_PS(red, green, blue, alpha);
+
+		__m128 colors[3];
+		colors[0] = _mm_min_ps(_mm_max_ps(red, minimum), maximum);
+		colors[1] = _mm_min_ps(_mm_max_ps(green, minimum), maximum);
+		colors[2] = _mm_min_ps(_mm_max_ps(blue, minimum), maximum);
+
+		__m128 directionX = _mm_mul_ps(sinThetas, _mm_loadu_ps(cosPhi + x));
+		__m128 directionZ = _mm_mul_ps(sinThetas, _mm_loadu_ps(sinPhi + x));
+
+		__m128 basis[9];
+		EvaluateBasis(directionX, directionY, directionZ, basis);
+
+		for(int k = 0; k < 9; k++)
+		{
+			for(int c = 0; c < 3; c++)
+			{
+				accumulators[k * 3 + c] = _mm_add_ps(accumulators[k * 3 + c], _mm_mul_ps(basis[k], colors[c]));
+			}
+		}
+	}
+
+	for(int i = 0; i < 27; i++)
+	{
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, accumulators[i]);
+		accumulated[i] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+#endif
+
+	for(; x < width; x++)
+	{
+		const float* pixel = row + x * 4;
+
+		float basis[9];
+		EvaluateBasis(sinTheta * cosPhi[x], cosTheta, sinTheta * sinPhi[x], basis);
+
+		for(int c = 0; c < 3; c++)
+		{
+			float color = std::min(std::max(pixel[c], 0.0f), maxRadiance);
+			for(int k = 0; k < 9; k++)
+			{
+				accumulated[k * 3 + c] += basis[k] * color;
+			}
+		}
+	}
+
+	// Solid angle of a texel in this row //
+	double solidAngle = static_cast<double>(sinTheta) * (2.0 * PI / width) * (PI / height);
+	for(int i = 0; i < 27; i++)
+	{
+		sums[i] = accumulated[i] * solidAngle;
+	}
+}
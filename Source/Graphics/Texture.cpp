@@ -1,16 +1,11 @@
 #include "Graphics/Texture.h"
 #include "Graphics/DXUtilities.h"
 #include "Graphics/DXAccess.h"
+#include "Graphics/DXUploadQueue.h"
+#include "Graphics/DXMemoryAllocator.h"
+#include "Graphics/MipGenerator.h"
 #include <stb_image.h>
 
-// TODO: Learn about mipmapping with DX12 
-Texture::Texture(tinygltf::Model& model, tinygltf::Texture& texture)
-{
-	tinygltf::Image& image = model.images[texture.source];
-
-	UploadData(image.image.data(), image.width, image.height);
-}
-
 Texture::Texture(const std::string& filePath)
 {
 	int width;
@@ -27,19 +22,41 @@ Texture::Texture(const std::string& filePath)
 		assert(false);
 	}
 
-	UploadData(buffer, width, height);
-
+	// Files loaded this way are color textures, so they get filtered as sRGB //
+	std::vector<unsigned char> pixels(buffer, buffer + static_cast<size_t>(width) * height * 4);
 	stbi_image_free(buffer);
+
+	int mipCount = MipGenerator::GenerateRGBA8(pixels, width, height, true);
+	UploadData(pixels.data(), width, height, mipCount, TextureFormat::RGBA8);
 }
 
-Texture::Texture(unsigned char* data, int width, int height)
+Texture::Texture(unsigned char* data, int width, int height, int mipCount, TextureFormat format)
 {
-	UploadData(data, width, height);
+	UploadData(data, width, height, mipCount, format);
 }
 
 Texture::~Texture()
 {
+	// Placed memory can be handed out again right away, so the copy into it has to be done, and the texture
+	// can't be left waiting for its transition to a shader resource //
+	DXUploadQueue* uploadQueue = DXAccess::GetUploadQueue();
+	uploadQueue->GetQueue().Wait(uploadTicket);
+	uploadQueue->RemovePendingTexture(textureResource.Get());
+
 	textureResource.Reset();
+	DXAccess::GetMemoryAllocator()->FreeTexture(textureAllocation);
+	DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)->Free(srvIndex);
+}
+
+void Texture::CreateSRV(D3D12_CPU_DESCRIPTOR_HANDLE handle)
+{
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = GetDXGIFormat(format);
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Texture2D.MipLevels = mipCount;
+
+	DXAccess::GetDevice()->CreateShaderResourceView(textureResource.Get(), &srvDesc, handle);
 }
 
 int Texture::GetSRVIndex()
@@ -63,27 +80,69 @@ ComPtr<ID3D12Resource> Texture::GetResource()
 	return textureResource;
 }
 
-void Texture::UploadData(unsigned char* data, int width, int height)
+int Texture::GetWidth()
+{
+	return width;
+}
+
+int Texture::GetHeight()
+{
+	return height;
+}
+
+int Texture::GetMipCount()
 {
+	return mipCount;
+}
+
+TextureFormat Texture::GetFormat()
+{
+	return format;
+}
+
+unsigned long long Texture::GetByteSize()
+{
+	return BlockCompressor::GetLevelOffset(format, width, height, mipCount);
+}
+
+const UploadTicket& Texture::GetUploadTicket()
+{
+	return uploadTicket;
+}
+
+void Texture::UploadData(unsigned char* data, int width, int height, int mipCount, TextureFormat format)
+{
+	this->width = width;
+	this->height = height;
+	this->mipCount = mipCount;
+	this->format = format;
+
+	// Uploaded textures are only ever sampled, without render target access they can be placed in a shared heap //
 	D3D12_RESOURCE_DESC description = CD3DX12_RESOURCE_DESC::Tex2D(
-		DXGI_FORMAT_R8G8B8A8_UNORM, width, height);
-	description.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+		GetDXGIFormat(format), width, height, 1, mipCount);
 
-	D3D12_SUBRESOURCE_DATA subresource;
-	subresource.pData = data;
-	subresource.RowPitch = width * sizeof(unsigned int);
+	// Every mip level is a subresource, the levels are tightly packed after each other.
+	// For block compressed formats a row is a row of 4x4 blocks.
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources(mipCount);
+	for(int level = 0; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
 
-	ComPtr<ID3D12Resource> intermediateTexture;
-	UploadPixelShaderResource(textureResource, intermediateTexture, description, subresource);
+		subresources[level].pData = data + BlockCompressor::GetLevelOffset(format, width, height, level);
+		subresources[level].RowPitch = BlockCompressor::GetRowPitch(format, mipWidth);
+		subresources[level].SlicePitch = BlockCompressor::GetLevelSize(format, mipWidth, mipHeight);
+	}
 
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.Texture2D.MipLevels = 1;
+	textureAllocation = DXAccess::GetMemoryAllocator()->CreateTexture(description, D3D12_RESOURCE_STATE_COMMON, textureResource);
+
+	// The data gets copied into staging memory right away, the copy itself happens with the next batch //
+	DXUploadQueue* uploadQueue = DXAccess::GetUploadQueue();
+	uploadTicket = uploadQueue->UploadTexture(textureResource, subresources.data(), mipCount);
 
 	DXDescriptorHeap* SRVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	srvIndex = SRVHeap->GetNextAvailableIndex();
 
-	DXAccess::GetDevice()->CreateShaderResourceView(textureResource.Get(), &srvDesc, SRVHeap->GetCPUHandleAt(srvIndex));
+	CreateSRV(SRVHeap->GetCPUHandleAt(srvIndex));
 }
\ No newline at end of file
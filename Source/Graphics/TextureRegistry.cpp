@@ -0,0 +1,92 @@
+#include "Graphics/TextureRegistry.h"
+#include "Graphics/Texture.h"
+
+#include <cassert>
+
+TextureRegistry::~TextureRegistry()
+{
+	for(auto& entry : entries)
+	{
+		delete entry.second.Texture;
+	}
+}
+
+Texture* TextureRegistry::Acquire(const std::string& modelPath, int imageIndex, const ImportedTexture& image)
+{
+	std::string key = modelPath + "#" + std::to_string(imageIndex);
+
+	Texture* texture = Find(key);
+	if(!texture)
+	{
+		texture = new Texture(const_cast<unsigned char*>(image.Pixels.data()), image.Width, image.Height, image.MipCount, image.Format);
+		Add(key, texture);
+	}
+
+	return texture;
+}
+
+Texture* TextureRegistry::Acquire(const std::string& filePath)
+{
+	Texture* texture = Find(filePath);
+	if(!texture)
+	{
+		texture = new Texture(filePath);
+		Add(filePath, texture);
+	}
+
+	return texture;
+}
+
+void TextureRegistry::Release(Texture* texture)
+{
+	auto key = keys.find(texture);
+	if(key == keys.end())
+	{
+		assert(false && "Released a texture that isn't owned by the registry!");
+		return;
+	}
+
+	Entry& entry = entries[key->second];
+	entry.ReferenceCount--;
+
+	if(entry.ReferenceCount == 0)
+	{
+		entries.erase(key->second);
+		keys.erase(key);
+		delete texture;
+	}
+}
+
+const TextureRegistryStatistics& TextureRegistry::GetStatistics()
+{
+	return statistics;
+}
+
+unsigned int TextureRegistry::GetTextureCount()
+{
+	return static_cast<unsigned int>(entries.size());
+}
+
+Texture* TextureRegistry::Find(const std::string& key)
+{
+	auto entry = entries.find(key);
+	if(entry == entries.end())
+	{
+		return nullptr;
+	}
+
+	entry->second.ReferenceCount++;
+
+	statistics.Hits++;
+	statistics.SavedBytes += entry->second.Texture->GetByteSize();
+	return entry->second.Texture;
+}
+
+void TextureRegistry::Add(const std::string& key, Texture* texture)
+{
+	entries[key] = { texture, 1 };
+	keys[texture] = key;
+
+	statistics.Misses++;
+	statistics.UploadedBytes += texture->GetByteSize();
+}
@@ -0,0 +1,223 @@
+#include "Graphics/UploadQueue.h"
+
+#include <cassert>
+
+UploadQueue::UploadQueue(UploadBackend* backend, uint64_t batchSize, uint64_t maxInFlightSize) :
+	backend(backend), batchSize(batchSize), maxInFlightSize(maxInFlightSize)
+{
+	if(!backend)
+	{
+		assert(false && "Upload queue needs a backend");
+	}
+}
+
+UploadQueue::~UploadQueue()
+{
+	Flush();
+}
+
+StagingBuffer UploadQueue::Allocate(uint64_t size, UploadTicket& ticket)
+{
+	Retire();
+
+	// 1. Keep batches within their budget, a single upload larger than it gets a batch of its own //
+	if(!openBatch.Staging.empty() && openBatch.Size + size > batchSize)
+	{
+		Submit();
+	}
+
+	// 2. Bound the staging memory that is waiting on the GPU, the oldest batches finish first //
+	while(!inFlightBatches.empty() && inFlightSize + openBatch.Size + size > maxInFlightSize)
+	{
+		statistics.Stalls++;
+		backend->WaitForValue(inFlightBatches.front().FenceValue);
+		Retire();
+	}
+
+	StagingBuffer staging = backend->CreateStaging(size);
+	openBatch.Staging.push_back(staging);
+	openBatch.Size += size;
+
+	ticket = GetOpenTicket();
+	return staging;
+}
+
+UploadTicket UploadQueue::Submit()
+{
+	if(openBatch.Staging.empty())
+	{
+		return GetSubmittedTicket();
+	}
+
+	submittedValue++;
+	openBatch.FenceValue = submittedValue;
+	backend->Submit(submittedValue);
+
+	statistics.SubmittedBatches++;
+	statistics.SubmittedBytes += openBatch.Size;
+
+	inFlightSize += openBatch.Size;
+	inFlightBatches.push_back(std::move(openBatch));
+	openBatch = Batch();
+
+	return GetSubmittedTicket();
+}
+
+bool UploadQueue::IsComplete(const UploadTicket& ticket)
+{
+	return ticket.FenceValue <= backend->GetCompletedValue();
+}
+
+void UploadQueue::Wait(const UploadTicket& ticket)
+{
+	// Tickets of the open batch can only finish once they're submitted //
+	if(ticket.FenceValue > submittedValue)
+	{
+		Submit();
+	}
+
+	if(!IsComplete(ticket))
+	{
+		backend->WaitForValue(ticket.FenceValue);
+	}
+
+	Retire();
+}
+
+void UploadQueue::Flush()
+{
+	Wait(Submit());
+}
+
+void UploadQueue::Retire()
+{
+	uint64_t completedValue = backend->GetCompletedValue();
+
+	while(!inFlightBatches.empty() && inFlightBatches.front().FenceValue <= completedValue)
+	{
+		Batch& batch = inFlightBatches.front();
+		inFlightSize -= batch.Size;
+		ReleaseBatch(batch);
+
+		inFlightBatches.pop_front();
+		statistics.RetiredBatches++;
+	}
+}
+
+UploadTicket UploadQueue::GetOpenTicket()
+{
+	UploadTicket ticket;
+	ticket.FenceValue = submittedValue + 1;
+	return ticket;
+}
+
+UploadTicket UploadQueue::GetSubmittedTicket()
+{
+	UploadTicket ticket;
+	ticket.FenceValue = submittedValue;
+	return ticket;
+}
+
+uint64_t UploadQueue::GetPendingSize()
+{
+	return openBatch.Size;
+}
+
+uint64_t UploadQueue::GetInFlightSize()
+{
+	return inFlightSize;
+}
+
+unsigned int UploadQueue::GetInFlightBatchCount()
+{
+	return static_cast<unsigned int>(inFlightBatches.size());
+}
+
+const UploadQueueStatistics& UploadQueue::GetStatistics()
+{
+	return statistics;
+}
+
+void UploadQueue::ReleaseBatch(Batch& batch)
+{
+	for(StagingBuffer& staging : batch.Staging)
+	{
+		backend->ReleaseStaging(staging);
+	}
+
+	batch.Staging.clear();
+	batch.Size = 0;
+}
+
+#pragma region NullUploadBackend
+StagingBuffer NullUploadBackend::CreateStaging(uint64_t size)
+{
+	StagingBuffer staging;
+	staging.Data = new unsigned char[size];
+	staging.Handle = staging.Data;
+	staging.Size = size;
+
+	liveStagingSize += size;
+	liveStagingCount++;
+
+	return staging;
+}
+
+void NullUploadBackend::ReleaseStaging(StagingBuffer& staging)
+{
+	liveStagingSize -= staging.Size;
+	liveStagingCount--;
+
+	delete[] staging.Data;
+	staging = StagingBuffer();
+}
+
+void NullUploadBackend::Submit(uint64_t fenceValue)
+{
+	if(fenceValue <= submittedValue)
+	{
+		assert(false && "Fence values have to increase with every submission");
+	}
+
+	submittedValue = fenceValue;
+}
+
+uint64_t NullUploadBackend::GetCompletedValue()
+{
+	return completedValue;
+}
+
+void NullUploadBackend::WaitForValue(uint64_t fenceValue)
+{
+	CompleteUpTo(fenceValue);
+}
+
+void NullUploadBackend::CompleteUpTo(uint64_t fenceValue)
+{
+	// Like a real queue, nothing can finish before it has been submitted //
+	if(fenceValue > submittedValue)
+	{
+		fenceValue = submittedValue;
+	}
+
+	if(fenceValue > completedValue)
+	{
+		completedValue = fenceValue;
+	}
+}
+
+uint64_t NullUploadBackend::GetSubmittedValue()
+{
+	return submittedValue;
+}
+
+uint64_t NullUploadBackend::GetLiveStagingSize()
+{
+	return liveStagingSize;
+}
+
+unsigned int NullUploadBackend::GetLiveStagingCount()
+{
+	return liveStagingCount;
+}
+#pragma endregion
@@ -6,6 +6,7 @@
 #include "Graphics/Texture.h"
 
 #include <cassert>
+#include <string>
 
 Window::Window(const std::wstring& applicationName, unsigned int windowWidth, unsigned int windowHeight) :
 	windowName(applicationName), windowWidth(windowWidth), windowHeight(windowHeight)
@@ -21,12 +22,14 @@ Window::Window(const std::wstring& applicationName, unsigned int windowWidth, un
 
 	DXDescriptorHeap* RTVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	DXDescriptorHeap* DSVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+	DXDescriptorHeap* CBVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-	// Get RTV indices for Screen & Render Buffers //
+	// Get RTV & SRV indices for Screen & Render Buffers, resizing only recreates the views //
 	for(int i = 0; i < BackBufferCount; i++)
 	{
 		renderBufferRTVs[i] = RTVHeap->GetNextAvailableIndex();
 		screenBufferRTVs[i] = RTVHeap->GetNextAvailableIndex();
+		renderBufferSRVs[i] = CBVHeap->GetNextAvailableIndex();
 	}
 
 	depthDSVIndex = DSVHeap->GetNextAvailableIndex();
@@ -51,6 +54,25 @@ void Window::Present()
 	ThrowIfFailed(swapChain->Present(syncInterval, presentFlags));
 }
 
+void Window::SetFrameLatency(unsigned int frameLatency)
+{
+	ThrowIfFailed(swapChain->SetMaximumFrameLatency(frameLatency));
+}
+
+void Window::WaitForFrameLatency()
+{
+	DWORD result = WaitForSingleObjectEx(frameLatencyWaitable, FrameLatencyTimeout, TRUE);
+
+	if(result == WAIT_TIMEOUT)
+	{
+		LOG(Log::MessageType::Error, "Waiting for the swap chain timed out after " + std::to_string(FrameLatencyTimeout) + " ms");
+	}
+	else if(result == WAIT_FAILED)
+	{
+		LOG(Log::MessageType::Error, "Waiting for the swap chain failed, error: " + std::to_string(GetLastError()));
+	}
+}
+
 void Window::Resize()
 {
 	RECT clientRect = {};
@@ -124,12 +146,16 @@ void Window::CreateSwapChain()
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
 	swapChainDesc.Flags = tearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+	swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
 	ComPtr<ID3D12CommandQueue> commandQueue = DXAccess::GetCommands(D3D12_COMMAND_LIST_TYPE_DIRECT)->GetCommandQueue();
 	ComPtr<IDXGISwapChain1> swapChain1;
 	ThrowIfFailed(factory->CreateSwapChainForHwnd(commandQueue.Get(), windowHandle, &swapChainDesc, nullptr, nullptr, &swapChain1));
 	ThrowIfFailed(factory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
 	ThrowIfFailed(swapChain1.As(&swapChain));
+
+	// Signaled whenever the swap chain can take another present without exceeding the frame latency //
+	frameLatencyWaitable = swapChain->GetFrameLatencyWaitableObject();
 }
 
 void Window::UpdateRenderBuffers()
@@ -170,7 +196,6 @@ void Window::UpdateRenderBuffers()
 		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 		srvDesc.Texture2D.MipLevels = 1;
 
-		renderBufferSRVs[i] = CBVHeap->GetNextAvailableIndex();
 		ComPtr<ID3D12Resource> textureResource = renderBuffers[i]->GetResource();
 		device->CreateShaderResourceView(textureResource.Get(), &srvDesc, CBVHeap->GetCPUHandleAt(renderBufferSRVs[i]));
 	}
@@ -271,6 +296,11 @@ CD3DX12_CPU_DESCRIPTOR_HANDLE Window::GetCurrentScreenRTV()
 	return RTVHeap->GetCPUHandleAt(screenBufferRTVs[index]);
 }
 
+ComPtr<ID3D12Resource> Window::GetDepthBuffer()
+{
+	return depthBuffer;
+}
+
 CD3DX12_CPU_DESCRIPTOR_HANDLE Window::GetDepthDSV()
 {
 	DXDescriptorHeap* DSVHeap = DXAccess::GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
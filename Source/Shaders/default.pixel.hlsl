@@ -23,34 +23,29 @@ struct LightData
 };
 ConstantBuffer<LightData> lights : register(b0, space1);
 
-struct MaterialData
+#include "../../Headers/Graphics/MaterialLayout.h"
+StructuredBuffer<MaterialData> materials : register(t0, space2);
+
+struct DrawData
+{
+    uint MaterialIndex;
+};
+ConstantBuffer<DrawData> draw : register(b2);
+
+// L2 spherical harmonics of the HDRI, already convolved with the cosine lobe & divided by PI //
+struct IrradianceData
 {
-    bool hasAlbedo;
-    bool hasNormal;
-    bool hasMetallicRoughness;
-    bool hasOclussion;
-    bool hasEmission;
-    
-    int OclussionChannel;
-    int RoughnessChannel;
-    int MetallicChannel;
-    
-    bool useTextures;
-    float3 Color;
-    float Metallic;
-    float Roughness;
-	float Opacity;
+    float4 Coefficients[9];
 };
-ConstantBuffer<MaterialData> material : register(b0, space2);
+ConstantBuffer<IrradianceData> irradianceSH : register(b1, space1);
 
-Texture2D Diffuse : register(t0);
-Texture2D Normal : register(t1);
-Texture2D MetallicRoughness : register(t2);
-Texture2D AmbientOcclusion : register(t3);
-Texture2D Emissive : register(t4);
+// Every view in the descriptor heap, the index is the same for every pixel of a draw //
+Texture2D Textures[] : register(t0, space3);
 
-Texture2D Skydome : register(t0, space1);
+// Level i is prefiltered with GGX for roughness i / ( levels - 1 ) //
+Texture2D SpecularEnvironment : register(t0, space1);
 Texture2D ShadowMap : register(t1, space1);
+Texture2D BRDFLookup : register(t2, space1);
 
 SamplerState LinearSampler : register(s0);
 
@@ -87,19 +82,26 @@ float GetShadow(PixelIN IN, float3 normal)
     return shadow;
 }
 
-float3 GetSkydome(float3 normal)
+// Basis has to match SphericalHarmonics.cpp //
+float3 GetIrradiance(float3 normal)
 {
     float3 n = normalize(normal);
-    float phi = atan2(n.z, n.x) + PI;
-    float theta = acos(n.y);
-    
-    float u = phi / (2 * PI);
-    float v = 1.0 - (theta / PI);
     
-    return Skydome.Sample(LinearSampler, float2(u, v)).rgb;
+    float3 irradiance = irradianceSH.Coefficients[0].rgb * 0.282095;
+    irradiance += irradianceSH.Coefficients[1].rgb * 0.488603 * n.y;
+    irradiance += irradianceSH.Coefficients[2].rgb * 0.488603 * n.z;
+    irradiance += irradianceSH.Coefficients[3].rgb * 0.488603 * n.x;
+    irradiance += irradianceSH.Coefficients[4].rgb * 1.092548 * n.x * n.y;
+    irradiance += irradianceSH.Coefficients[5].rgb * 1.092548 * n.y * n.z;
+    irradiance += irradianceSH.Coefficients[6].rgb * 0.315392 * (3.0 * n.z * n.z - 1.0);
+    irradiance += irradianceSH.Coefficients[7].rgb * 1.092548 * n.x * n.z;
+    irradiance += irradianceSH.Coefficients[8].rgb * 0.546274 * (n.x * n.x - n.y * n.y);
+    
+    return max(irradiance, float3(0.0, 0.0, 0.0));
 }
 
-float3 GetSkydomeColor(PixelIN IN, float3 normal)
+// Split-sum specular, a single trilinear fetch from the prefiltered chain & the BRDF lookup //
+float3 GetSpecularIBL(PixelIN IN, float3 normal, float3 F, float roughness, float NoV)
 {
     float3 incoming = normalize(IN.FragPosition - IN.CameraPosition);
     float3 n = reflect(incoming, normal);
@@ -110,7 +112,18 @@ float3 GetSkydomeColor(PixelIN IN, float3 normal)
     float u = phi / (2 * PI);
     float v = 1.0 - (theta / PI);
     
-    return Skydome.Sample(LinearSampler, float2(u, v)).rgb;
+    // The explicit level also avoids the atan2 seam selecting the smallest mip //
+    int width, height, levels;
+    SpecularEnvironment.GetDimensions(0, width, height, levels);
+    float3 prefiltered = SpecularEnvironment.SampleLevel(LinearSampler, float2(u, v), roughness * (levels - 1)).rgb;
+    
+    // Sample texel centers at the edges, the sampler wraps //
+    int lookupSize;
+    BRDFLookup.GetDimensions(0, lookupSize, height, levels);
+    float2 lookupUV = (saturate(float2(NoV, roughness)) * (lookupSize - 1) + 0.5) / lookupSize;
+    float2 brdf = BRDFLookup.SampleLevel(LinearSampler, lookupUV, 0).rg;
+    
+    return prefiltered * (F * brdf.x + brdf.y);
 }
 
 float D_GGX(float3 n, float3 h, float roughness)
@@ -175,8 +188,11 @@ float3 fresnelSchlickRoughness(float cosTheta, float3 F0, float roughness)
 
 float4 main(PixelIN IN) : SV_TARGET
 {    
+    MaterialData material = materials[draw.MaterialIndex];
+    uint flags = material.Flags;
+    
     float3 albedo = IN.Color;
-    float alpha = 1.0;
+    float alpha = material.Opacity;
     float3 ambient = float3(0.0, 0.0, 0.0);
     float3 emission = float3(0.0, 0.0, 0.0);
     
@@ -186,41 +202,44 @@ float4 main(PixelIN IN) : SV_TARGET
     float roughness = 0.0;
     float ambientOcclusion = 1.0;
     
-    if(material.useTextures)
+    if(flags & MATERIAL_USE_TEXTURES)
     {
-        if (material.hasAlbedo)
+        if (flags & MATERIAL_HAS_ALBEDO)
         {
-            albedo = Diffuse.Sample(LinearSampler, IN.TexCoord).rgb;
-            albedo = pow(abs(albedo), 2.2);
+            float4 albedoSample = Textures[material.TextureIndices[0]].Sample(LinearSampler, IN.TexCoord);
+            albedo = pow(abs(albedoSample.rgb), 2.2);
             
-            alpha = Diffuse.Sample(LinearSampler, IN.TexCoord).a;
+            alpha *= albedoSample.a;
             
             ambient = albedo * 0.05;
         }
     
-        if (material.hasNormal)
+        if (flags & MATERIAL_HAS_NORMAL)
         {
-            float3 tangentNormal = Normal.Sample(LinearSampler, IN.TexCoord).rgb * 2.0 - float3(1.0, 1.0, 1.0);
+            // Normal maps can be stored with only two channels ( BC5 ), so z gets reconstructed
+            float3 tangentNormal;
+            tangentNormal.xy = Textures[material.TextureIndices[1]].Sample(LinearSampler, IN.TexCoord).rg * 2.0 - float2(1.0, 1.0);
+            tangentNormal.z = sqrt(saturate(1.0 - dot(tangentNormal.xy, tangentNormal.xy)));
             normal = normalize(mul(tangentNormal, IN.TBN));
         }
     
-        if (material.hasMetallicRoughness)
+        if (flags & MATERIAL_HAS_METALLIC_ROUGHNESS)
         {
-            float3 MR = MetallicRoughness.Sample(LinearSampler, IN.TexCoord).rgb;
+            float3 MR = Textures[material.TextureIndices[2]].Sample(LinearSampler, IN.TexCoord).rgb;
         
-            metallic = MR[material.MetallicChannel];
-            roughness = MR[material.RoughnessChannel];
+            metallic = MR[(flags >> MATERIAL_METALLIC_CHANNEL_SHIFT) & 3];
+            roughness = MR[(flags >> MATERIAL_ROUGHNESS_CHANNEL_SHIFT) & 3];
         }
     
-        if (material.hasOclussion)
+        if (flags & MATERIAL_HAS_OCCLUSION)
         {
-            ambientOcclusion = AmbientOcclusion.Sample(LinearSampler, IN.TexCoord).r;
+            ambientOcclusion = Textures[material.TextureIndices[3]].Sample(LinearSampler, IN.TexCoord).r;
             ambient = albedo * 0.05;
         }
     
-        if (material.hasEmission)
+        if (flags & MATERIAL_HAS_EMISSIVE)
         {
-            emission = Emissive.Sample(LinearSampler, IN.TexCoord).rgb;
+            emission = Textures[material.TextureIndices[4]].Sample(LinearSampler, IN.TexCoord).rgb;
         }
     }
     else
@@ -229,6 +248,13 @@ float4 main(PixelIN IN) : SV_TARGET
         metallic = material.Metallic;
         roughness = material.Roughness;
     }
+    
+    // Masked materials are drawn with the opaque pipeline, alpha only decides if the pixel is there
+    if (flags & MATERIAL_ALPHA_TEST)
+    {
+        clip(alpha - material.AlphaCutoff);
+        alpha = 1.0;
+    }
    
     float3 v = normalize(IN.CameraPosition - IN.FragPosition);
     
@@ -275,11 +301,11 @@ float4 main(PixelIN IN) : SV_TARGET
         float3 kS = fresnelSchlickRoughness(max(NoV, 0.0), f0, roughness);
         float3 kD = 1.0 - kS;
         kD *= 1.0 - metallic;
-        float3 irradiance = GetSkydome(normal) * irradianceIntensity;
+        float3 irradiance = GetIrradiance(normal) * irradianceIntensity;
         float3 diffuse = irradiance * albedo;
         float3 ambient = kD * diffuse * ambientOcclusion;
         
-        float3 Ls = (Fr * GetSkydomeColor(IN, normal)) * irradianceIntensity  * NoL;
+        float3 Ls = GetSpecularIBL(IN, normal, kS, roughness, NoV) * irradianceIntensity;
         
         color += ambient + Ls;
     }
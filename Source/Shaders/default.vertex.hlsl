@@ -1,10 +1,18 @@
 struct TransformData
 {
-	matrix MVP;
-	matrix Model;
+	matrix VP;
     matrix Light;
+    uint FirstInstance;
 };
 ConstantBuffer<TransformData> Transform : register(b0);
+
+// Instances of a draw index the model matrices through their own range of instance indices //
+struct InstanceData
+{
+    column_major matrix Model;
+};
+StructuredBuffer<uint> InstanceIndices : register(t0);
+StructuredBuffer<InstanceData> Instances : register(t1);
  
 struct SceneInfo
 {
@@ -33,20 +41,22 @@ struct VertexShaderOutput
 	float4 Position : SV_Position;
 };
  
-VertexShaderOutput main(VertexPosColor IN)
+VertexShaderOutput main(VertexPosColor IN, uint instanceID : SV_InstanceID)
 {
 	VertexShaderOutput OUT;
 
-	OUT.Position = mul(Transform.MVP, float4(IN.Position, 1.0f));
+    matrix model = Instances[InstanceIndices[Transform.FirstInstance + instanceID]].Model;
+    float4 worldPosition = mul(model, float4(IN.Position, 1.0f));
+	OUT.Position = mul(Transform.VP, worldPosition);
     
-    float3 normal = normalize(mul(Transform.Model, float4(IN.Normal, 0.0f)).xyz);
-    float3 tangent = normalize(mul(Transform.Model, float4(IN.Tangent, 0.0f)).xyz);
+    float3 normal = normalize(mul(model, float4(IN.Normal, 0.0f)).xyz);
+    float3 tangent = normalize(mul(model, float4(IN.Tangent, 0.0f)).xyz);
     float3 biTangent = cross(normal, tangent);
     float3x3 TBN = float3x3(tangent, biTangent, normal);
     OUT.TBN = TBN;
     OUT.Normal = normal;
     
-    OUT.FragPosition = mul(Transform.Model, float4(IN.Position, 1.0f)).rgb;
+    OUT.FragPosition = worldPosition.xyz;
     OUT.FragLight = mul(Transform.Light, float4(OUT.FragPosition, 1.0f));
     
     OUT.Color = IN.Color;
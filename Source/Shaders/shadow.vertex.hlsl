@@ -1,14 +1,21 @@
 struct Transform
 {
     matrix VP;
-    matrix Model;
+    uint FirstInstance;
 };
 ConstantBuffer<Transform> LightTransform : register(b0);
 
-float4 main( float4 pos : POSITION ) : SV_POSITION
+struct InstanceData
 {
-    matrix MVP = mul(LightTransform.VP, LightTransform.Model);
+    column_major matrix Model;
+};
+StructuredBuffer<uint> InstanceIndices : register(t0);
+StructuredBuffer<InstanceData> Instances : register(t1);
+
+float4 main( float4 pos : POSITION, uint instanceID : SV_InstanceID ) : SV_POSITION
+{
+    matrix model = Instances[InstanceIndices[LightTransform.FirstInstance + instanceID]].Model;
     
-    float4 outputPosition = mul(MVP, float4(pos.xyz, 1.0));
+    float4 outputPosition = mul(LightTransform.VP, mul(model, float4(pos.xyz, 1.0)));
     return outputPosition;
 }
\ No newline at end of file
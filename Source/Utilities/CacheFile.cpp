@@ -0,0 +1,31 @@
+#include "Utilities/CacheFile.h"
+#include "Utilities/Hash.h"
+#include "Utilities/MappedFile.h"
+
+#include <filesystem>
+#include <system_error>
+
+bool GetFileInfo(const std::string& filePath, unsigned long long& size, long long& time)
+{
+	std::error_code error;
+	size = std::filesystem::file_size(filePath, error);
+	if(error)
+	{
+		return false;
+	}
+
+	time = std::filesystem::last_write_time(filePath, error).time_since_epoch().count();
+	return !error;
+}
+
+bool HashFile(const std::string& filePath, unsigned long long& hash)
+{
+	MappedFile file;
+	if(!file.Open(filePath))
+	{
+		return false;
+	}
+
+	hash = HashData(file.GetData(), file.GetSize());
+	return true;
+}
@@ -0,0 +1,136 @@
+#include "Utilities/MappedFile.h"
+#include "Utilities/Logger.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filePath)
+{
+	Open(filePath);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		LOG(Log::MessageType::Error, "Failed to open file for mapping: " + filePath);
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		// Empty files can't be mapped, but they also don't contain anything to read //
+		CloseHandle(file);
+		LOG(Log::MessageType::Error, "File is empty or its size is unknown: " + filePath);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mapping == nullptr)
+	{
+		CloseHandle(file);
+		LOG(Log::MessageType::Error, "Failed to create file mapping: " + filePath);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		LOG(Log::MessageType::Error, "Failed to map view of file: " + filePath);
+		return false;
+	}
+
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = open(filePath.c_str(), O_RDONLY);
+	if(file == -1)
+	{
+		LOG(Log::MessageType::Error, "Failed to open file for mapping: " + filePath);
+		return false;
+	}
+
+	struct stat fileStatus;
+	if(fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		// Empty files can't be mapped, but they also don't contain anything to read //
+		close(file);
+		LOG(Log::MessageType::Error, "File is empty or its size is unknown: " + filePath);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	if(view == MAP_FAILED)
+	{
+		close(file);
+		LOG(Log::MessageType::Error, "Failed to map view of file: " + filePath);
+		return false;
+	}
+
+	fileDescriptor = file;
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if(data == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mappingHandle);
+	CloseHandle(fileHandle);
+
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+	close(fileDescriptor);
+
+	fileDescriptor = -1;
+#endif
+
+	data = nullptr;
+	size = 0;
+}
+
+bool MappedFile::IsOpen()
+{
+	return data != nullptr;
+}
+
+const unsigned char* MappedFile::GetData()
+{
+	return data;
+}
+
+size_t MappedFile::GetSize()
+{
+	return size;
+}
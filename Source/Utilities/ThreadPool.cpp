@@ -0,0 +1,128 @@
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if(threadCount == 0)
+	{
+		// The thread calling ParallelFor also does work, so leave one core for it
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	for(unsigned int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		shutdown = true;
+	}
+
+	queueCondition.notify_all();
+
+	for(std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(unsigned int count, const std::function<void(unsigned int)>& job)
+{
+	if(count == 0)
+	{
+		return;
+	}
+
+	// Not worth waking up the workers for a single item //
+	if(count == 1)
+	{
+		job(0);
+		return;
+	}
+
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	batch->job = &job;
+	batch->count = count;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		batches.push_back(batch);
+	}
+	queueCondition.notify_all();
+
+	// Help out until there is nothing left to pick up, afterwards
+	// wait for the workers that are still processing their last item
+	ProcessBatch(batch.get());
+
+	std::unique_lock<std::mutex> lock(queueMutex);
+	batchFinished.wait(lock, [&batch]() { return batch->completed.load() == batch->count; });
+}
+
+unsigned int ThreadPool::GetThreadCount()
+{
+	return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while(true)
+	{
+		std::shared_ptr<Batch> batch;
+
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return shutdown || !batches.empty(); });
+
+			if(shutdown && batches.empty())
+			{
+				return;
+			}
+
+			batch = batches.front();
+		}
+
+		ProcessBatch(batch.get());
+	}
+}
+
+void ThreadPool::ProcessBatch(Batch* batch)
+{
+	while(true)
+	{
+		unsigned int index = batch->nextIndex.fetch_add(1);
+		if(index >= batch->count)
+		{
+			break;
+		}
+
+		(*batch->job)(index);
+
+		if(batch->completed.fetch_add(1) + 1 == batch->count)
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			batchFinished.notify_all();
+		}
+	}
+
+	// Every index has been handed out, so the batch can leave the queue //
+	std::lock_guard<std::mutex> lock(queueMutex);
+	auto it = std::find_if(batches.begin(), batches.end(),
+		[batch](const std::shared_ptr<Batch>& queued) { return queued.get() == batch; });
+
+	if(it != batches.end())
+	{
+		batches.erase(it);
+	}
+}
@@ -6,4 +6,4 @@ int main()
 	engine.Run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,293 @@
+#include "Test.h"
+
+#include "Graphics/BVH.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Boxes spread through a cube, dense enough that queries hit a few hundred of them //
+static std::vector<BoundingBox> CreateScene(unsigned int count, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	float sceneSize = 8.0f * std::cbrt(static_cast<float>(count));
+	std::uniform_real_distribution<float> position(-sceneSize * 0.5f, sceneSize * 0.5f);
+	std::uniform_real_distribution<float> size(0.25f, 1.25f);
+
+	std::vector<BoundingBox> boxes(count);
+	for(BoundingBox& box : boxes)
+	{
+		glm::vec3 center = glm::vec3(position(random), position(random), position(random));
+		glm::vec3 extents = glm::vec3(size(random), size(random), size(random));
+		box.Min = center - extents;
+		box.Max = center + extents;
+	}
+
+	return boxes;
+}
+
+static std::vector<unsigned int> Sorted(std::vector<unsigned int> items)
+{
+	std::sort(items.begin(), items.end());
+	return items;
+}
+
+// The culler tests every box on its own, with the same conservative plane test the tree uses //
+static std::vector<unsigned int> CullEveryBox(const std::vector<BoundingBox>& boxes, const Frustum& frustum)
+{
+	FrustumCuller culler;
+	for(const BoundingBox& box : boxes)
+	{
+		culler.AddBox(box);
+	}
+
+	std::vector<unsigned char> visibility;
+	culler.CullBoxes(frustum, visibility);
+
+	std::vector<unsigned int> items;
+	for(unsigned int i = 0; i < visibility.size(); i++)
+	{
+		if(visibility[i])
+		{
+			items.push_back(i);
+		}
+	}
+
+	return items;
+}
+
+static RayHit RaycastEveryBox(const std::vector<BoundingBox>& boxes, const glm::vec3& origin, const glm::vec3& direction)
+{
+	RayHit hit;
+	glm::vec3 inverseDirection = 1.0f / direction;
+
+	for(unsigned int i = 0; i < boxes.size(); i++)
+	{
+		float distance;
+		if(IntersectRay(boxes[i], origin, inverseDirection, FLT_MAX, distance) && distance < hit.Distance)
+		{
+			hit.Item = i;
+			hit.Distance = distance;
+		}
+	}
+
+	return hit;
+}
+
+// Frustum, box, sphere & ray queries all have to find exactly what checking every box finds //
+static bool MatchesBruteForce(BVH& bvh, const std::vector<BoundingBox>& boxes, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	float sceneSize = 8.0f * std::cbrt(static_cast<float>(boxes.size()));
+
+	bool matches = true;
+
+	for(int query = 0; query < 20; query++)
+	{
+		glm::vec3 eye = glm::vec3(unit(random), unit(random), unit(random)) * sceneSize * 0.5f;
+		glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)));
+
+		glm::mat4 view = glm::lookAt(eye, eye + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, sceneSize * 0.25f);
+		Frustum frustum = FrustumCuller::ExtractFrustum(projection * view);
+
+		std::vector<unsigned int> items;
+		bvh.QueryFrustum(frustum, items);
+		matches &= Sorted(items) == CullEveryBox(boxes, frustum);
+
+		BoundingBox region;
+		region.Min = eye - glm::vec3(sceneSize * 0.05f);
+		region.Max = eye + glm::vec3(sceneSize * 0.05f);
+		BoundingSphere sphere;
+		sphere.Center = eye;
+		sphere.Radius = sceneSize * 0.05f;
+
+		std::vector<unsigned int> expectedBox;
+		std::vector<unsigned int> expectedSphere;
+		for(unsigned int i = 0; i < boxes.size(); i++)
+		{
+			if(Overlaps(boxes[i], region))
+			{
+				expectedBox.push_back(i);
+			}
+
+			if(Overlaps(boxes[i], sphere))
+			{
+				expectedSphere.push_back(i);
+			}
+		}
+
+		items.clear();
+		bvh.QueryBox(region, items);
+		matches &= Sorted(items) == expectedBox;
+
+		items.clear();
+		bvh.QuerySphere(sphere, items);
+		matches &= Sorted(items) == expectedSphere;
+
+		// Boxes can tie on distance, so only the distance has to match & the item has to be hit at it //
+		RayHit hit = bvh.Raycast(eye, direction);
+		RayHit expected = RaycastEveryBox(boxes, eye, direction);
+		matches &= hit.Distance == expected.Distance;
+
+		if(hit.Item != ~0u)
+		{
+			float distance;
+			matches &= IntersectRay(boxes[hit.Item], eye, 1.0f / direction, FLT_MAX, distance) && distance == hit.Distance;
+		}
+	}
+
+	return matches;
+}
+
+static void TestBuild()
+{
+	BVH empty;
+	empty.Build({});
+	std::vector<unsigned int> items;
+	empty.QueryBox(BoundingBox{ glm::vec3(-1.0f), glm::vec3(1.0f) }, items);
+	CHECK(items.empty());
+	CHECK(empty.Raycast(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f)).Item == ~0u);
+	CHECK(empty.GetNodeCount() == 0);
+
+	std::vector<BoundingBox> boxes = CreateScene(5000, 1);
+	BVH bvh;
+	bvh.Build(boxes);
+
+	CHECK(bvh.GetItemCount() == 5000);
+	CHECK(bvh.GetNodeCount() <= 2 * 5000);
+
+	// The root holds every item //
+	BoundingBox bounds = bvh.GetBounds();
+	bool contained = true;
+	for(const BoundingBox& box : boxes)
+	{
+		contained &= glm::all(glm::lessThanEqual(bounds.Min, box.Min)) && glm::all(glm::greaterThanEqual(bounds.Max, box.Max));
+	}
+	CHECK(contained);
+
+	CHECK(bvh.GetCost() > 0.0f);
+	CHECK(bvh.GetCost() == bvh.GetBuildCost());
+	CHECK(MatchesBruteForce(bvh, boxes, 2));
+}
+
+static void TestParallelBuild()
+{
+	// Large enough that subtrees get built on the workers, the tree has to come out the same //
+	std::vector<BoundingBox> boxes = CreateScene(40000, 3);
+	ThreadPool threadPool(4);
+
+	BVH serial;
+	serial.Build(boxes);
+
+	BVH parallel;
+	parallel.Build(boxes, &threadPool);
+
+	CHECK(parallel.GetNodeCount() == serial.GetNodeCount());
+	CHECK_NEAR(parallel.GetCost(), serial.GetCost(), serial.GetCost() * 1e-5f);
+	CHECK(MatchesBruteForce(parallel, boxes, 4));
+}
+
+static void TestRefit()
+{
+	std::vector<BoundingBox> boxes = CreateScene(5000, 5);
+	BVH bvh;
+	bvh.Build(boxes);
+
+	// Moving a few items across the scene stretches the nodes above them, walking up from their leaves. Cost is relative
+	// to the root, so they stay inside it //
+	std::mt19937 random(6);
+	float sceneSize = 8.0f * std::cbrt(static_cast<float>(boxes.size()));
+	std::uniform_real_distribution<float> position(-sceneSize * 0.4f, sceneSize * 0.4f);
+
+	for(unsigned int i = 0; i < boxes.size(); i += 200)
+	{
+		glm::vec3 extents = (boxes[i].Max - boxes[i].Min) * 0.5f;
+		glm::vec3 center = glm::vec3(position(random), position(random), position(random));
+		boxes[i].Min = center - extents;
+		boxes[i].Max = center + extents;
+		bvh.UpdateItem(i, boxes[i]);
+	}
+
+	bvh.Refit();
+	CHECK(MatchesBruteForce(bvh, boxes, 7));
+	CHECK(bvh.GetCost() > bvh.GetBuildCost());
+
+	// Moving every item takes the other refit path //
+	for(unsigned int i = 0; i < boxes.size(); i++)
+	{
+		boxes[i].Min.y += 3.0f;
+		boxes[i].Max.y += 3.0f;
+		bvh.UpdateItem(i, boxes[i]);
+	}
+
+	bvh.Refit();
+	CHECK(MatchesBruteForce(bvh, boxes, 8));
+
+	// Rebuilding tightens the tree again //
+	float refitCost = bvh.GetCost();
+	bvh.Rebuild();
+	CHECK(bvh.GetCost() < refitCost);
+	CHECK(MatchesBruteForce(bvh, boxes, 9));
+}
+
+static void TestPicking()
+{
+	// A row of boxes along +x, the ray goes through all of them //
+	std::vector<BoundingBox> boxes;
+	for(int i = 0; i < 10; i++)
+	{
+		float x = 10.0f + i * 5.0f;
+		boxes.push_back(BoundingBox{ glm::vec3(x - 1.0f, -1.0f, -1.0f), glm::vec3(x + 1.0f, 1.0f, 1.0f) });
+	}
+
+	BVH bvh;
+	bvh.Build(boxes);
+
+	glm::vec3 origin = glm::vec3(0.0f);
+	glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+
+	RayHit hit = bvh.Raycast(origin, direction);
+	CHECK(hit.Item == 0);
+	CHECK_NEAR(hit.Distance, 9.0f, 1e-5f);
+
+	// Out of reach //
+	CHECK(bvh.Raycast(origin, direction, 5.0f).Item == ~0u);
+	CHECK(bvh.Raycast(origin, -direction).Item == ~0u);
+
+	// Starting inside a box hits it straight away //
+	hit = bvh.Raycast(glm::vec3(30.0f, 0.0f, 0.0f), direction);
+	CHECK(hit.Item == 4 && hit.Distance == 0.0f);
+
+	// The test can reject items, like ones whose actual shape the ray misses //
+	hit = bvh.Raycast(origin, direction, FLT_MAX, [](unsigned int item, float&)
+	{
+		return item >= 3;
+	});
+	CHECK(hit.Item == 3);
+	CHECK_NEAR(hit.Distance, 24.0f, 1e-5f);
+
+	// Or push the distance back, so an item further along can be closer //
+	hit = bvh.Raycast(origin, direction, FLT_MAX, [](unsigned int item, float& distance)
+	{
+		if(item < 2)
+		{
+			distance += 100.0f;
+		}
+		return true;
+	});
+	CHECK(hit.Item == 2);
+	CHECK_NEAR(hit.Distance, 19.0f, 1e-5f);
+}
+
+int main()
+{
+	TestBuild();
+	TestParallelBuild();
+	TestRefit();
+	TestPicking();
+
+	return Test::Result();
+}
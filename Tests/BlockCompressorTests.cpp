@@ -0,0 +1,212 @@
+#include "Test.h"
+
+#include "Graphics/BlockCompressor.h"
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <stb_image.h>
+
+static void TestSizes()
+{
+	CHECK(BlockCompressor::CanCompress(4, 8));
+	CHECK(!BlockCompressor::CanCompress(6, 8));
+	CHECK(!BlockCompressor::CanCompress(0, 4));
+
+	CHECK(BlockCompressor::GetLevelSize(TextureFormat::BC1, 8, 8) == 4 * 8);
+	CHECK(BlockCompressor::GetLevelSize(TextureFormat::BC7, 8, 8) == 4 * 16);
+	CHECK(BlockCompressor::GetLevelSize(TextureFormat::RGBA8, 8, 8) == 8 * 8 * 4);
+	CHECK(BlockCompressor::GetLevelSize(TextureFormat::RGBA16F, 8, 8) == 8 * 8 * 8);
+
+	// Levels smaller than a block still take up a whole one //
+	CHECK(BlockCompressor::GetLevelSize(TextureFormat::BC4, 2, 1) == 8);
+	CHECK(BlockCompressor::GetLevelOffset(TextureFormat::BC5, 8, 8, 4) == (4 + 1 + 1 + 1) * 16);
+	CHECK(BlockCompressor::GetRowPitch(TextureFormat::BC1, 8) == 16);
+}
+
+// Compresses a chain & checks every level decodes to within 'minimumPSNR' of the source //
+static float CompressChain(const std::vector<unsigned char>& image, int width, int height,
+	TextureFormat format, CompressionQuality quality, float minimumPSNR)
+{
+	std::vector<unsigned char> chain = image;
+	int mipCount = MipGenerator::GenerateRGBA8(chain, width, height, false);
+	std::vector<unsigned char> blocks = chain;
+
+	if(!CHECK(BlockCompressor::Compress(blocks, width, height, mipCount, format, quality)))
+	{
+		return 0.0f;
+	}
+
+	CHECK(blocks.size() == BlockCompressor::GetLevelOffset(format, width, height, mipCount));
+
+	float topPSNR = 0.0f;
+	for(int level = 0; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+		size_t pixelCount = static_cast<size_t>(mipWidth) * mipHeight;
+
+		std::vector<unsigned char> decoded(pixelCount * 4);
+		BlockCompressor::Decompress(blocks.data() + BlockCompressor::GetLevelOffset(format, width, height, level),
+			mipWidth, mipHeight, format, decoded.data());
+
+		const unsigned char* source = chain.data() + MipGenerator::GetMipOffset(width, height, level) * 4;
+		float psnr = BlockCompressor::ComputePSNR(source, decoded.data(), pixelCount, BlockCompressor::GetChannelCount(format));
+		topPSNR = level == 0 ? psnr : topPSNR;
+
+		if(!CHECK(psnr >= minimumPSNR))
+		{
+			printf("  %s %s level %i: %.2f dB\n", BlockCompressor::GetFormatName(format),
+				BlockCompressor::GetQualityName(quality), level, psnr);
+		}
+	}
+
+	return topPSNR;
+}
+
+static void TestImage()
+{
+	int width;
+	int height;
+	int channels;
+	unsigned char* buffer = stbi_load("Assets/Models/DamagedHelmet/Default_albedo.jpg", &width, &height, &channels, 4);
+	if(!CHECK(buffer != nullptr))
+	{
+		return;
+	}
+
+	// A 128x128 crop from the middle keeps the test quick //
+	const int size = 128;
+	std::vector<unsigned char> crop(size * size * 4);
+	for(int y = 0; y < size; y++)
+	{
+		memcpy(crop.data() + y * size * 4, buffer + ((height / 2 + y) * static_cast<size_t>(width) + width / 2) * 4, size * 4);
+	}
+	stbi_image_free(buffer);
+
+	struct Expectation
+	{
+		TextureFormat Format;
+		float MinimumPSNR;
+	};
+
+	const Expectation expectations[] =
+	{
+		{ TextureFormat::BC1, 30.0f },
+		{ TextureFormat::BC3, 30.0f },
+		{ TextureFormat::BC4, 36.0f },
+		{ TextureFormat::BC5, 36.0f },
+		{ TextureFormat::BC7, 38.0f }
+	};
+
+	for(const Expectation& expectation : expectations)
+	{
+		float fast = CompressChain(crop, size, size, expectation.Format, CompressionQuality::Fast, expectation.MinimumPSNR);
+		float balanced = CompressChain(crop, size, size, expectation.Format, CompressionQuality::Balanced, expectation.MinimumPSNR);
+		float high = CompressChain(crop, size, size, expectation.Format, CompressionQuality::High, expectation.MinimumPSNR);
+
+		// Spending more time shouldn't make the result worse //
+		CHECK(balanced >= fast - 0.05f);
+		CHECK(high >= balanced - 0.05f);
+	}
+
+	// Uncompressed stays uncompressed //
+	std::vector<unsigned char> untouched = crop;
+	CHECK(!BlockCompressor::Compress(untouched, size, size, 1, TextureFormat::BC7, CompressionQuality::None));
+	CHECK(untouched == crop);
+}
+
+static void TestSolidColor()
+{
+	// A single color has to come back (almost) exactly, only the endpoint precision limits it //
+	const unsigned char color[4] = { 200, 100, 30, 255 };
+	std::vector<unsigned char> image(16 * 4);
+	for(size_t i = 0; i < image.size(); i++)
+	{
+		image[i] = color[i % 4];
+	}
+
+	const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC4, TextureFormat::BC5, TextureFormat::BC7 };
+	for(TextureFormat format : formats)
+	{
+		std::vector<unsigned char> blocks = image;
+		CHECK(BlockCompressor::Compress(blocks, 4, 4, 1, format, CompressionQuality::Balanced));
+
+		unsigned char decoded[16 * 4];
+		BlockCompressor::Decompress(blocks.data(), 4, 4, format, decoded);
+
+		int maximumError = 0;
+		for(int i = 0; i < 16; i++)
+		{
+			for(int c = 0; c < BlockCompressor::GetChannelCount(format); c++)
+			{
+				maximumError = std::max(maximumError, std::abs(decoded[i * 4 + c] - color[c]));
+			}
+		}
+
+		CHECK(maximumError <= (format == TextureFormat::BC1 || format == TextureFormat::BC3 ? 4 : 1));
+	}
+}
+
+static void TestHDR()
+{
+	// Tinted ramp over several stops, like the sky of an environment. Within a block the colors lie on
+	// a line, which is all a single region BC6H block can represent
+	const int width = 32;
+	const int height = 16;
+	std::vector<float> pixels(width * height * 4);
+	for(int y = 0; y < height; y++)
+	{
+		for(int x = 0; x < width; x++)
+		{
+			float intensity = std::exp2((x + y) * 0.25f - 2.0f);
+			float* pixel = &pixels[(y * width + x) * 4];
+			pixel[0] = intensity;
+			pixel[1] = intensity * 0.6f;
+			pixel[2] = intensity * 0.3f;
+			pixel[3] = 1.0f;
+		}
+	}
+
+	int mipCount = MipGenerator::GenerateRGBA32F(pixels, width, height);
+	const TextureFormat formats[] = { TextureFormat::RGBA16F, TextureFormat::BC6H };
+
+	for(TextureFormat format : formats)
+	{
+		std::vector<unsigned char> output;
+		if(!CHECK(BlockCompressor::CompressHDR(pixels, width, height, mipCount, format, CompressionQuality::Balanced, output)))
+		{
+			continue;
+		}
+
+		CHECK(output.size() == BlockCompressor::GetLevelOffset(format, width, height, mipCount));
+
+		std::vector<float> decoded(width * height * 4);
+		BlockCompressor::DecompressHDR(output.data(), width, height, format, decoded.data());
+
+		// Relative error of the colors, BC6H stores 10 bit endpoints & 4 bit weights per block //
+		float maximumError = 0.0f;
+		for(size_t i = 0; i < decoded.size(); i++)
+		{
+			if(i % 4 != 3)
+			{
+				maximumError = std::max(maximumError, std::fabs(decoded[i] - pixels[i]) / pixels[i]);
+			}
+		}
+
+		CHECK(maximumError < (format == TextureFormat::BC6H ? 0.06f : 0.001f));
+	}
+}
+
+int main()
+{
+	TestSizes();
+	TestImage();
+	TestSolidColor();
+	TestHDR();
+
+	return Test::Result();
+}
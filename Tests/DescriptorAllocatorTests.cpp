@@ -0,0 +1,93 @@
+#include "Test.h"
+
+#include "Graphics/DescriptorAllocator.h"
+
+static void TestPersistent()
+{
+	DescriptorAllocator allocator(64);
+
+	// First fit, ranges are handed out from the front //
+	unsigned int a = allocator.Allocate(4);
+	unsigned int b = allocator.Allocate(8);
+	unsigned int c = allocator.Allocate(4);
+	CHECK(a == 0 && b == 4 && c == 12);
+
+	CHECK(allocator.Allocate(0) == DescriptorAllocator::InvalidIndex);
+	CHECK(allocator.Allocate(64) == DescriptorAllocator::InvalidIndex);
+
+	// A freed range in the middle gets reused by anything that fits //
+	allocator.FreeImmediate(b);
+	CHECK(allocator.Allocate(6) == 4);
+	CHECK(allocator.Allocate(2) == 10);
+
+	// Freeing everything merges the ranges back into one //
+	allocator.FreeImmediate(a);
+	allocator.FreeImmediate(c);
+	allocator.FreeImmediate(4);
+	allocator.FreeImmediate(10);
+
+	DescriptorAllocatorStatistics statistics = allocator.GetStatistics();
+	CHECK(statistics.PersistentAllocated == 0);
+	CHECK(statistics.FreeRangeCount == 1);
+	CHECK(statistics.LargestFreeRange == 64);
+	CHECK(allocator.Allocate(64) == 0);
+}
+
+static void TestDeferredFrees()
+{
+	const unsigned int frameCount = 3;
+	DescriptorAllocator allocator(16, 0, frameCount);
+
+	allocator.BeginFrame(0);
+	unsigned int texture = allocator.Allocate(16);
+	allocator.Free(texture);
+
+	// The GPU might still read the range in frames 0, 1 & 2 //
+	CHECK(allocator.GetStatistics().PendingFrees == 16);
+	CHECK(allocator.Allocate(1) == DescriptorAllocator::InvalidIndex);
+
+	allocator.BeginFrame(1);
+	allocator.BeginFrame(2);
+	CHECK(allocator.Allocate(1) == DescriptorAllocator::InvalidIndex);
+
+	// Frame 0 coming around again means the GPU is done with it //
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetStatistics().PendingFrees == 0);
+	CHECK(allocator.Allocate(16) == 0);
+}
+
+static void TestTransient()
+{
+	const unsigned int persistentCount = 32;
+	const unsigned int transientCount = 100;
+	const unsigned int frameCount = 2;
+	DescriptorAllocator allocator(persistentCount, transientCount, frameCount);
+
+	CHECK(allocator.GetDescriptorCount() == persistentCount + transientCount * frameCount);
+
+	// Every frame has its own region behind the persistent descriptors, allocated linearly //
+	allocator.BeginFrame(0);
+	CHECK(allocator.AllocateTransient(10) == persistentCount);
+	CHECK(allocator.AllocateTransient(90) == persistentCount + 10);
+	CHECK(allocator.GetStatistics().TransientAllocated == 100);
+
+	allocator.BeginFrame(1);
+	CHECK(allocator.AllocateTransient(5) == persistentCount + transientCount);
+
+	// Beginning a frame resets its region //
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetStatistics().TransientAllocated == 0);
+	CHECK(allocator.AllocateTransient(1) == persistentCount);
+
+	// Transient tables never touch the persistent ranges //
+	CHECK(allocator.Allocate(persistentCount) == 0);
+}
+
+int main()
+{
+	TestPersistent();
+	TestDeferredFrees();
+	TestTransient();
+
+	return Test::Result();
+}
@@ -0,0 +1,233 @@
+#include "Test.h"
+
+#include "Graphics/FrameGraph.h"
+
+#include <map>
+#include <vector>
+
+// Usages the passes declared, to check the recorded barriers against //
+typedef std::map<unsigned int, std::vector<std::pair<unsigned int, ResourceUsage>>> DeclaredUsages;
+
+// Plays the barriers back & checks that every pass finds its resources in the usage it asked for,
+// and that the final barriers return everything to where it started //
+static void CheckBarriers(FrameGraph& graph, const DeclaredUsages& declared)
+{
+	std::vector<ResourceUsage> current(graph.GetResourceCount());
+	for(unsigned int i = 0; i < graph.GetResourceCount(); i++)
+	{
+		current[i] = graph.GetInitialUsage(i);
+	}
+
+	auto apply = [&](const FrameGraphBarrier& barrier)
+	{
+		CHECK(barrier.Aliasing || barrier.Before == current[barrier.Resource]);
+		if(barrier.Split != BarrierSplit::Begin)
+		{
+			current[barrier.Resource] = barrier.After;
+		}
+	};
+
+	for(const CompiledPass& pass : graph.GetCompiledPasses())
+	{
+		for(const FrameGraphBarrier& barrier : pass.Barriers)
+		{
+			apply(barrier);
+		}
+
+		for(const std::pair<unsigned int, ResourceUsage>& usage : declared.at(pass.Pass))
+		{
+			CHECK(current[usage.first] == usage.second);
+		}
+	}
+
+	for(const FrameGraphBarrier& barrier : graph.GetFinalBarriers())
+	{
+		apply(barrier);
+	}
+
+	for(unsigned int i = 0; i < graph.GetResourceCount(); i++)
+	{
+		CHECK(current[i] == graph.GetInitialUsage(i));
+	}
+}
+
+static bool Overlaps(FrameGraph& graph, unsigned int a, unsigned int b, uint64_t size)
+{
+	uint64_t offsetA = graph.GetTransientOffset(a);
+	uint64_t offsetB = graph.GetTransientOffset(b);
+	return offsetA < offsetB + size && offsetB < offsetA + size;
+}
+
+static void TestFrame()
+{
+	const uint64_t size = 4 << 20;
+	const uint64_t alignment = 64 << 10;
+
+	FrameGraph graph;
+	DeclaredUsages declared;
+
+	auto read = [&](unsigned int pass, unsigned int resource, ResourceUsage usage)
+	{
+		graph.Read(pass, resource, usage);
+		declared[pass].push_back({ resource, usage });
+	};
+
+	auto write = [&](unsigned int pass, unsigned int resource, ResourceUsage usage)
+	{
+		graph.Write(pass, resource, usage);
+		declared[pass].push_back({ resource, usage });
+	};
+
+	unsigned int backBuffer = graph.ImportResource("BackBuffer", ResourceUsage::Present);
+	unsigned int shadow = graph.CreateTransient("Shadow", size, alignment);
+	unsigned int color = graph.CreateTransient("Color", size, alignment);
+	unsigned int normals = graph.CreateTransient("Normals", size, alignment);
+	unsigned int lit = graph.CreateTransient("Lit", size, alignment);
+	unsigned int debug = graph.CreateTransient("Debug", size, alignment);
+	unsigned int post = graph.CreateTransient("Post", size, alignment);
+	graph.ExportResource(backBuffer);
+
+	unsigned int shadowPass = graph.AddPass("Shadows");
+	write(shadowPass, shadow, ResourceUsage::DepthWrite);
+
+	unsigned int geometryPass = graph.AddPass("Geometry");
+	write(geometryPass, color, ResourceUsage::RenderTarget);
+	write(geometryPass, normals, ResourceUsage::RenderTarget);
+
+	unsigned int lightingPass = graph.AddPass("Lighting");
+	read(lightingPass, shadow, ResourceUsage::ShaderResource);
+	read(lightingPass, color, ResourceUsage::ShaderResource);
+	write(lightingPass, lit, ResourceUsage::RenderTarget);
+
+	unsigned int debugPass = graph.AddPass("Debug");
+	read(debugPass, lit, ResourceUsage::ShaderResource);
+	write(debugPass, debug, ResourceUsage::RenderTarget);
+
+	unsigned int postPass = graph.AddPass("Post");
+	read(postPass, lit, ResourceUsage::ShaderResource);
+	read(postPass, normals, ResourceUsage::ShaderResource);
+	write(postPass, post, ResourceUsage::RenderTarget);
+
+	unsigned int compositePass = graph.AddPass("Composite");
+	read(compositePass, post, ResourceUsage::ShaderResource);
+	write(compositePass, backBuffer, ResourceUsage::RenderTarget);
+
+	unsigned int markerPass = graph.AddPass("Marker", true);
+	declared[markerPass]; // Uses no resources, it only has to stay
+
+	graph.Compile();
+
+	// 1. Nothing reads the debug output, passes with side effects always stay //
+	CHECK(graph.IsPassCulled(debugPass));
+	CHECK(!graph.IsPassCulled(shadowPass) && !graph.IsPassCulled(compositePass));
+	CHECK(!graph.IsPassCulled(markerPass));
+	CHECK(graph.GetCompiledPasses().size() == 6);
+
+	// 2. Shadows & geometry don't depend on each other, every later pass waits on the one before it //
+	const std::vector<CompiledPass>& passes = graph.GetCompiledPasses();
+	std::map<unsigned int, unsigned int> levels;
+	for(const CompiledPass& pass : passes)
+	{
+		levels[pass.Pass] = pass.Level;
+	}
+
+	CHECK(levels[shadowPass] == 0 && levels[geometryPass] == 0 && levels[markerPass] == 0);
+	CHECK(levels[lightingPass] == 1);
+	CHECK(levels[postPass] == 2);
+	CHECK(levels[compositePass] == 3);
+	CHECK(graph.GetLevelCount() == 4);
+
+	bool ordered = true;
+	for(size_t i = 1; i < passes.size(); i++)
+	{
+		ordered &= passes[i - 1].Level <= passes[i].Level;
+	}
+	CHECK(ordered);
+
+	// 3. The normals sit idle while lighting runs, so their transition is split around it //
+	bool splitBegins = false;
+	bool splitEnds = false;
+	for(const CompiledPass& pass : passes)
+	{
+		for(const FrameGraphBarrier& barrier : pass.Barriers)
+		{
+			if(barrier.Resource == normals && barrier.Split == BarrierSplit::Begin)
+			{
+				splitBegins |= pass.Level == 1;
+			}
+
+			if(barrier.Resource == normals && barrier.Split == BarrierSplit::End)
+			{
+				splitEnds |= pass.Level == 2;
+			}
+		}
+	}
+	CHECK(splitBegins && splitEnds);
+
+	CheckBarriers(graph, declared);
+
+	// 4. Post starts after shadows are done, so they can share memory. Resources alive together never overlap //
+	const unsigned int lighting[] = { shadow, color, normals, lit };
+	for(unsigned int a : lighting)
+	{
+		for(unsigned int b : lighting)
+		{
+			CHECK(a == b || !Overlaps(graph, a, b, size));
+		}
+	}
+
+	CHECK(!Overlaps(graph, post, normals, size) && !Overlaps(graph, post, lit, size));
+	CHECK(graph.GetTransientOffset(post) == graph.GetTransientOffset(shadow));
+	CHECK(graph.GetTransientMemorySize() == 4 * size);
+	CHECK(graph.GetUnaliasedMemorySize() == 5 * size);
+
+	// Sharing memory means the first use needs an aliasing barrier //
+	bool postAliased = false;
+	for(const CompiledPass& pass : passes)
+	{
+		for(const FrameGraphBarrier& barrier : pass.Barriers)
+		{
+			postAliased |= barrier.Resource == post && barrier.Aliasing;
+		}
+	}
+	CHECK(postAliased);
+
+	CHECK(graph.LookupResource("Lit") == lit);
+	CHECK(graph.LookupResource("Missing") == FrameGraph::InvalidIndex);
+}
+
+static void TestOverwrite()
+{
+	// A plain write replaces what came before, so the earlier writer isn't needed //
+	FrameGraph graph;
+	unsigned int target = graph.ImportResource("Target", ResourceUsage::Common);
+	graph.ExportResource(target);
+
+	unsigned int clear = graph.AddPass("Clear");
+	graph.Write(clear, target, ResourceUsage::RenderTarget);
+
+	unsigned int draw = graph.AddPass("Draw");
+	graph.Write(draw, target, ResourceUsage::RenderTarget);
+
+	unsigned int overlay = graph.AddPass("Overlay");
+	graph.ReadWrite(overlay, target, ResourceUsage::RenderTarget);
+
+	graph.Compile();
+
+	CHECK(graph.IsPassCulled(clear));
+	CHECK(!graph.IsPassCulled(draw) && !graph.IsPassCulled(overlay));
+	CHECK(graph.GetLevelCount() == 2);
+
+	// Common to render target once at the start, & back once at the end //
+	CHECK(graph.GetCompiledPasses()[0].Barriers.size() == 1);
+	CHECK(graph.GetCompiledPasses()[1].Barriers.empty());
+	CHECK(graph.GetFinalBarriers().size() == 1);
+}
+
+int main()
+{
+	TestFrame();
+	TestOverwrite();
+
+	return Test::Result();
+}
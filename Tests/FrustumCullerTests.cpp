@@ -0,0 +1,170 @@
+#include "Test.h"
+
+#include "Graphics/FrustumCuller.h"
+
+#include <random>
+#include <vector>
+
+// Built twice, once with the default SSE path & once with AVX when the compiler has it. Both get compared to //
+// the plain definition: a volume is culled once it's completely behind one of the planes
+static bool IsVisible(const Frustum& frustum, const glm::vec3& center, const glm::vec3& extents)
+{
+	for(const glm::vec4& plane : frustum.Planes)
+	{
+		float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+		float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+		if(distance + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool IsVisible(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+	for(const glm::vec4& plane : frustum.Planes)
+	{
+		if(glm::dot(glm::vec3(plane), center) + plane.w + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static Frustum CreateFrustum()
+{
+	// Camera at the origin looking down -z, sees from 1 to 100 units //
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+	return FrustumCuller::ExtractFrustum(projection);
+}
+
+static BoundingBox CreateBox(const glm::vec3& center, const glm::vec3& extents)
+{
+	BoundingBox box;
+	box.Min = center - extents;
+	box.Max = center + extents;
+	return box;
+}
+
+static void TestExtractFrustum()
+{
+	Frustum frustum = CreateFrustum();
+
+	bool normalized = true;
+	for(const glm::vec4& plane : frustum.Planes)
+	{
+		normalized &= std::fabs(glm::length(glm::vec3(plane)) - 1.0f) < 1e-5f;
+	}
+	CHECK(normalized);
+
+	// Distances are in world units, so they can be compared against a radius //
+	glm::vec3 center = glm::vec3(0.0f, 0.0f, -50.0f);
+	CHECK_NEAR(glm::dot(glm::vec3(frustum.Planes[5]), center) + frustum.Planes[5].w, 50.0f, 1e-3f); // Far
+	CHECK_NEAR(glm::dot(glm::vec3(frustum.Planes[0]), center) + frustum.Planes[0].w, 50.0f * std::sqrt(0.5f), 1e-3f); // Left
+
+	CHECK(IsVisible(frustum, center, 0.0f));
+	CHECK(!IsVisible(frustum, glm::vec3(0.0f, 0.0f, 10.0f), 0.0f));
+	CHECK(!IsVisible(frustum, glm::vec3(0.0f, 0.0f, -150.0f), 0.0f));
+}
+
+static void TestKnownVolumes()
+{
+	Frustum frustum = CreateFrustum();
+	FrustumCuller culler;
+
+	culler.AddBox(CreateBox(glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(1.0f)));		// Inside
+	culler.AddBox(CreateBox(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(1.0f)));		// Behind the camera
+	culler.AddBox(CreateBox(glm::vec3(0.0f, 0.0f, -100.0f), glm::vec3(5.0f)));		// Crosses the far plane
+	culler.AddBox(CreateBox(glm::vec3(30.0f, 0.0f, -10.0f), glm::vec3(1.0f)));		// Right of the frustum
+	culler.AddBox(BoundingBox());													// Empty
+
+	std::vector<unsigned char> visibility;
+	CHECK(culler.CullBoxes(frustum, visibility) == 2);
+	CHECK(visibility.size() == 5);
+	CHECK(visibility[0] == 1 && visibility[1] == 0 && visibility[2] == 1 && visibility[3] == 0 && visibility[4] == 0);
+
+	BoundingSphere sphere;
+	sphere.Center = glm::vec3(12.0f, 0.0f, -10.0f);
+	sphere.Radius = 1.0f;
+	culler.AddSphere(sphere);		// Just right of the frustum
+
+	sphere.Radius = 2.0f;
+	culler.AddSphere(sphere);		// Reaches into it
+
+	std::vector<unsigned char> sphereVisibility;
+	CHECK(culler.CullSpheres(frustum, sphereVisibility) == 1);
+	CHECK(sphereVisibility.size() == 2);
+	CHECK(sphereVisibility[0] == 0 && sphereVisibility[1] == 1);
+}
+
+static void TestAgainstReference()
+{
+	Frustum frustum = CreateFrustum();
+
+	std::mt19937 random(1337);
+	std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+	std::uniform_real_distribution<float> size(0.1f, 8.0f);
+
+	FrustumCuller culler;
+	std::vector<unsigned char> visibility;
+
+	// Counts that aren't a multiple of the group size leave the last group partially filled //
+	const unsigned int counts[] = { 1, 7, 8, 9, 1003, 5 };
+	for(unsigned int count : counts)
+	{
+		culler.Clear();
+
+		std::vector<unsigned char> expectedBoxes;
+		std::vector<unsigned char> expectedSpheres;
+		unsigned int expectedBoxCount = 0;
+		unsigned int expectedSphereCount = 0;
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			glm::vec3 center = glm::vec3(position(random), position(random), position(random) - 50.0f);
+			glm::vec3 extents = glm::vec3(size(random), size(random), size(random));
+
+			BoundingSphere sphere;
+			sphere.Center = center;
+			sphere.Radius = glm::length(extents);
+
+			culler.AddBox(CreateBox(center, extents));
+			culler.AddSphere(sphere);
+
+			expectedBoxes.push_back(IsVisible(frustum, center, extents));
+			expectedSpheres.push_back(IsVisible(frustum, center, sphere.Radius));
+			expectedBoxCount += expectedBoxes.back();
+			expectedSphereCount += expectedSpheres.back();
+		}
+
+		CHECK(culler.GetBoxCount() == count && culler.GetSphereCount() == count);
+
+		CHECK(culler.CullBoxes(frustum, visibility) == expectedBoxCount);
+		CHECK(visibility == expectedBoxes);
+
+		CHECK(culler.CullSpheres(frustum, visibility) == expectedSphereCount);
+		CHECK(visibility == expectedSpheres);
+	}
+}
+
+int main()
+{
+#if defined(__AVX__) && defined(__GNUC__)
+	// The AVX build can't run on a processor without it //
+	if(!__builtin_cpu_supports("avx"))
+	{
+		printf("Processor doesn't support AVX, skipped\n");
+		return 0;
+	}
+#endif
+
+	TestExtractFrustum();
+	TestKnownVolumes();
+	TestAgainstReference();
+
+	return Test::Result();
+}
@@ -0,0 +1,220 @@
+#include "Test.h"
+
+#include "Graphics/HeapAllocator.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct Range
+{
+	unsigned int Heap;
+	uint64_t Offset;
+	uint64_t Size;
+};
+
+// No two live allocations of the same heap are allowed to share a byte //
+static bool HasOverlap(std::vector<Range> ranges)
+{
+	std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b)
+	{
+		return a.Heap != b.Heap ? a.Heap < b.Heap : a.Offset < b.Offset;
+	});
+
+	for(size_t i = 1; i < ranges.size(); i++)
+	{
+		if(ranges[i].Heap == ranges[i - 1].Heap && ranges[i - 1].Offset + ranges[i - 1].Size > ranges[i].Offset)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void TestTLSF()
+{
+	const uint64_t capacity = 1000 * 3 * 256;
+	TLSFAllocator allocator(capacity, 256);
+
+	// Sizes are rounded up to the granularity, alignments above it are respected //
+	uint64_t first;
+	uint64_t second;
+	CHECK(allocator.Allocate(100, 1, first));
+	CHECK(allocator.Allocate(1000, 4096, second));
+	CHECK(first == 0);
+	CHECK(second % 4096 == 0);
+	CHECK(allocator.GetAllocatedSize() == 256 + 1024);
+	CHECK(allocator.GetAllocationCount() == 2);
+
+	// Nothing larger than the free memory fits //
+	uint64_t tooLarge;
+	CHECK(!allocator.Allocate(capacity, 1, tooLarge));
+	CHECK(allocator.GetFittingBlockSize(capacity, 1) == 0);
+
+	// Freeing merges neighbours back into a single block //
+	allocator.Free(second);
+	allocator.Free(first);
+	CHECK(allocator.GetAllocatedSize() == 0);
+	CHECK(allocator.GetLargestFreeBlock() == capacity);
+
+	// The whole range can be handed out, blocks don't have to be a power of two //
+	std::vector<uint64_t> offsets;
+	uint64_t offset;
+	while(allocator.Allocate(3 * 256, 1, offset))
+	{
+		offsets.push_back(offset);
+	}
+
+	CHECK(offsets.size() == 1000);
+	CHECK(allocator.GetLargestFreeBlock() == 0);
+
+	// Freeing every other block leaves holes that can't be merged //
+	for(size_t i = 0; i < offsets.size(); i += 2)
+	{
+		allocator.Free(offsets[i]);
+	}
+	CHECK(allocator.GetLargestFreeBlock() == 3 * 256);
+
+	for(size_t i = 1; i < offsets.size(); i += 2)
+	{
+		allocator.Free(offsets[i]);
+	}
+	CHECK(allocator.GetLargestFreeBlock() == capacity);
+}
+
+static void TestSizeClasses()
+{
+	HeapAllocator allocator(4 << 20, 64 << 10, 16 << 10);
+
+	// Small buffers share a slab, packed at their size class //
+	HeapAllocation first = allocator.Allocate(200, 256);
+	HeapAllocation second = allocator.Allocate(256, 256);
+	CHECK(first.SizeClass == 0 && second.SizeClass == 0);
+	CHECK(first.Heap == second.Heap && second.Offset == first.Offset + 256);
+	CHECK(first.Size == 200);
+
+	HeapAllocation larger = allocator.Allocate(3000, 256);
+	CHECK(larger.SizeClass == 4); // 4 KB slots
+	CHECK(larger.Offset % 4096 == 0);
+
+	// Above the largest class, allocations are blocks of their own //
+	HeapAllocation block = allocator.Allocate(100 << 10, 64 << 10);
+	CHECK(block.SizeClass == -1);
+	CHECK(block.Offset % (64 << 10) == 0);
+
+	HeapAllocatorStatistics statistics = allocator.GetStatistics();
+	CHECK(statistics.AllocationCount == 4);
+	CHECK(statistics.RequestedSize == 200 + 256 + 3000 + (100 << 10));
+
+	// Empty slabs go back to the heap //
+	allocator.Free(first);
+	allocator.Free(second);
+	allocator.Free(larger);
+	allocator.Free(block);
+
+	statistics = allocator.GetStatistics();
+	CHECK(statistics.AllocationCount == 0);
+	CHECK(statistics.AllocatedSize == 0);
+	CHECK(statistics.ExternalFragmentation == 0.0f);
+}
+
+static void TestHeaps()
+{
+	const uint64_t heapSize = 1 << 20;
+	HeapAllocator allocator(heapSize, 64 << 10);
+
+	// A new heap only gets added when none of them has room //
+	HeapAllocation a = allocator.Allocate(heapSize / 2, 64 << 10);
+	HeapAllocation b = allocator.Allocate(heapSize / 2, 64 << 10);
+	CHECK(allocator.GetHeapCount() == 1);
+
+	HeapAllocation c = allocator.Allocate(heapSize / 4, 64 << 10);
+	CHECK(allocator.GetHeapCount() == 2);
+	CHECK(c.Heap == 1);
+
+	// Best fit: the half freed in the first heap is smaller than what's left of the second //
+	allocator.Free(a);
+	HeapAllocation d = allocator.Allocate(heapSize / 4, 64 << 10);
+	CHECK(d.Heap == 0);
+
+	// Larger than a heap needs a resource of its own //
+	CHECK(!allocator.Allocate(heapSize + 1, 64 << 10).IsValid());
+	CHECK(!allocator.Allocate(0, 64 << 10).IsValid());
+
+	allocator.Free(b);
+	allocator.Free(c);
+	allocator.Free(d);
+	CHECK(allocator.GetStatistics().AllocatedSize == 0);
+}
+
+static void TestRandomWorkload()
+{
+	HeapAllocator allocator(8 << 20, 64 << 10, 32 << 10);
+
+	std::mt19937 random(1337);
+	std::uniform_int_distribution<int> sizeExponent(6, 21);
+	std::uniform_int_distribution<int> alignmentChoice(0, 2);
+
+	std::vector<HeapAllocation> allocations;
+	bool aligned = true;
+	bool noOverlap = true;
+
+	for(int step = 0; step < 4000; step++)
+	{
+		if(!allocations.empty() && random() % 3 == 0)
+		{
+			size_t index = random() % allocations.size();
+			allocator.Free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+			continue;
+		}
+
+		uint64_t size = (1ull << sizeExponent(random)) + random() % 1000;
+		uint64_t alignment = alignmentChoice(random) == 0 ? (4 << 20) : (alignmentChoice(random) == 0 ? 256 : (64 << 10));
+		HeapAllocation allocation = allocator.Allocate(size, alignment);
+
+		if(!allocation.IsValid())
+		{
+			continue;
+		}
+
+		aligned &= allocation.Offset % alignment == 0;
+		allocations.push_back(allocation);
+
+		if(step % 100 == 0)
+		{
+			std::vector<Range> ranges;
+			for(const HeapAllocation& live : allocations)
+			{
+				ranges.push_back({ live.Heap, live.Offset, live.Size });
+			}
+			noOverlap &= !HasOverlap(ranges);
+		}
+	}
+
+	CHECK(aligned);
+	CHECK(noOverlap);
+	CHECK(allocator.GetStatistics().AllocationCount == allocations.size());
+
+	for(const HeapAllocation& allocation : allocations)
+	{
+		allocator.Free(allocation);
+	}
+
+	HeapAllocatorStatistics statistics = allocator.GetStatistics();
+	CHECK(statistics.AllocationCount == 0);
+	CHECK(statistics.AllocatedSize == 0);
+	CHECK(statistics.RequestedSize == 0);
+}
+
+int main()
+{
+	TestTLSF();
+	TestSizeClasses();
+	TestHeaps();
+	TestRandomWorkload();
+
+	return Test::Result();
+}
@@ -0,0 +1,130 @@
+#include "Test.h"
+
+#include "Graphics/IBLBaker.h"
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <vector>
+
+static void TestBRDF()
+{
+	const int size = 32;
+	std::vector<float> lut;
+	IBLBaker::IntegrateBRDF(size, lut);
+
+	CHECK(lut.size() == size * size * 4);
+
+	// Scale & bias are fractions of the reflected light, together they can't exceed it //
+	bool inRange = true;
+	for(int i = 0; i < size * size; i++)
+	{
+		float scale = lut[i * 4 + 0];
+		float bias = lut[i * 4 + 1];
+		inRange &= scale >= 0.0f && bias >= 0.0f && scale + bias <= 1.01f;
+	}
+	CHECK(inRange);
+
+	// A smooth surface seen head on reflects F0 as is //
+	const float* smoothFacing = &lut[(size - 1) * 4];
+	CHECK(smoothFacing[0] > 0.95f);
+	CHECK(smoothFacing[1] < 0.02f);
+
+	// At grazing angles Fresnel takes over //
+	const float* smoothGrazing = &lut[0];
+	CHECK(smoothGrazing[1] > smoothFacing[1]);
+
+	// Rough surfaces lose energy to the single scattering GGX, head on as well //
+	const float* roughFacing = &lut[((size - 1) * size + size - 1) * 4];
+	CHECK(roughFacing[0] + roughFacing[1] < smoothFacing[0] + smoothFacing[1]);
+}
+
+// Equirectangular environment with the upper half lit, v = 0 looks down //
+static std::vector<float> CreateEnvironment(int width, int height, float above, float below)
+{
+	std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+	for(int y = 0; y < height; y++)
+	{
+		float value = y >= height / 2 ? above : below;
+		for(int x = 0; x < width; x++)
+		{
+			float* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+			pixel[0] = value;
+			pixel[1] = value;
+			pixel[2] = value;
+			pixel[3] = 1.0f;
+		}
+	}
+
+	return pixels;
+}
+
+static void TestConstantEnvironment()
+{
+	const int width = 128;
+	const int height = 64;
+	std::vector<float> environment = CreateEnvironment(width, height, 3.0f, 3.0f);
+	int mipCount = MipGenerator::GenerateRGBA32F(environment, width, height);
+
+	std::vector<float> output;
+	int outputWidth;
+	int outputHeight;
+	int levelCount = IBLBaker::PrefilterSpecular(environment, width, height, mipCount, 64, 5, output, outputWidth, outputHeight);
+
+	// Level 0 is the first environment level that fits within the maximum width //
+	CHECK(outputWidth == 64 && outputHeight == 32);
+	CHECK(levelCount == 5);
+	CHECK(output.size() == MipGenerator::GetMipOffset(outputWidth, outputHeight, levelCount) * 4);
+
+	// Samples are normalized by their weights, so uniform light stays uniform at any roughness //
+	float maximumError = 0.0f;
+	for(size_t i = 0; i < output.size(); i++)
+	{
+		float expected = i % 4 == 3 ? 1.0f : 3.0f;
+		maximumError = std::max(maximumError, std::fabs(output[i] - expected));
+	}
+	CHECK(maximumError < 1e-3f);
+}
+
+static void TestRoughnessBlurs()
+{
+	const int width = 128;
+	const int height = 64;
+	std::vector<float> environment = CreateEnvironment(width, height, 4.0f, 0.0f);
+	int mipCount = MipGenerator::GenerateRGBA32F(environment, width, height);
+
+	std::vector<float> output;
+	int outputWidth;
+	int outputHeight;
+	int levelCount = IBLBaker::PrefilterSpecular(environment, width, height, mipCount, 128, 6, output, outputWidth, outputHeight);
+	CHECK(levelCount == 6);
+
+	// Rougher levels spread the horizon further, so the difference between straight up & down shrinks //
+	float previousContrast = 1e30f;
+	for(int level = 0; level < levelCount; level++)
+	{
+		int levelWidth;
+		int levelHeight;
+		MipGenerator::GetMipSize(outputWidth, outputHeight, level, levelWidth, levelHeight);
+		const float* levelPixels = output.data() + MipGenerator::GetMipOffset(outputWidth, outputHeight, level) * 4;
+
+		float up = levelPixels[(static_cast<size_t>(levelHeight - 1) * levelWidth) * 4];
+		float down = levelPixels[0];
+		float contrast = up - down;
+
+		CHECK(contrast >= 0.0f);
+		CHECK(contrast <= previousContrast + 1e-4f);
+		previousContrast = contrast;
+	}
+
+	// Fully rough still keeps the sky brighter than the ground //
+	CHECK(previousContrast > 0.5f);
+}
+
+int main()
+{
+	TestBRDF();
+	TestConstantEnvironment();
+	TestRoughnessBlurs();
+
+	return Test::Result();
+}
@@ -0,0 +1,164 @@
+#include "Test.h"
+
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static void TestChainLayout()
+{
+	CHECK(MipGenerator::GetMipCount(1, 1) == 1);
+	CHECK(MipGenerator::GetMipCount(256, 256) == 9);
+	CHECK(MipGenerator::GetMipCount(5, 3) == 3);
+	CHECK(MipGenerator::GetMipCount(1, 8) == 4);
+
+	// Levels are halved & rounded down, but never smaller than a pixel //
+	int mipWidth;
+	int mipHeight;
+	MipGenerator::GetMipSize(5, 3, 1, mipWidth, mipHeight);
+	CHECK(mipWidth == 2 && mipHeight == 1);
+	MipGenerator::GetMipSize(1, 8, 2, mipWidth, mipHeight);
+	CHECK(mipWidth == 1 && mipHeight == 2);
+
+	CHECK(MipGenerator::GetMipOffset(4, 4, 0) == 0);
+	CHECK(MipGenerator::GetMipOffset(4, 4, 3) == 16 + 4 + 1);
+	CHECK(MipGenerator::GetMipOffset(5, 3, 3) == 15 + 2 + 1);
+}
+
+// Reference 2x2 box filter in doubles, odd sizes reuse the last row/column like the generator does //
+static std::vector<double> ReferenceBox(const std::vector<double>& source, int width, int height, int mipWidth, int mipHeight)
+{
+	std::vector<double> result(static_cast<size_t>(mipWidth) * mipHeight * 4);
+
+	for(int y = 0; y < mipHeight; y++)
+	{
+		for(int x = 0; x < mipWidth; x++)
+		{
+			for(int c = 0; c < 4; c++)
+			{
+				double sum = 0.0;
+				for(int i = 0; i < 4; i++)
+				{
+					int sourceX = std::min(x * 2 + (i & 1), width - 1);
+					int sourceY = std::min(y * 2 + (i >> 1), height - 1);
+					sum += source[(static_cast<size_t>(sourceY) * width + sourceX) * 4 + c];
+				}
+
+				result[(static_cast<size_t>(y) * mipWidth + x) * 4 + c] = sum * 0.25;
+			}
+		}
+	}
+
+	return result;
+}
+
+static void TestBoxAgainstReference()
+{
+	const int width = 7;
+	const int height = 5;
+
+	std::mt19937 random(1337);
+	std::uniform_real_distribution<float> value(0.0f, 16.0f);
+
+	std::vector<float> pixels(width * height * 4);
+	for(float& pixel : pixels)
+	{
+		pixel = value(random);
+	}
+
+	std::vector<double> reference(pixels.begin(), pixels.end());
+	int mipCount = MipGenerator::GenerateRGBA32F(pixels, width, height);
+
+	CHECK(mipCount == 3);
+	CHECK(pixels.size() == MipGenerator::GetMipOffset(width, height, mipCount) * 4);
+
+	int sourceWidth = width;
+	int sourceHeight = height;
+	for(int level = 1; level < mipCount; level++)
+	{
+		int mipWidth;
+		int mipHeight;
+		MipGenerator::GetMipSize(width, height, level, mipWidth, mipHeight);
+		reference = ReferenceBox(reference, sourceWidth, sourceHeight, mipWidth, mipHeight);
+
+		const float* levelPixels = pixels.data() + MipGenerator::GetMipOffset(width, height, level) * 4;
+		for(size_t i = 0; i < reference.size(); i++)
+		{
+			CHECK_NEAR(levelPixels[i], reference[i], 1e-4);
+		}
+
+		sourceWidth = mipWidth;
+		sourceHeight = mipHeight;
+	}
+}
+
+static void TestRGBA8()
+{
+	// Black & white checker, alpha going from transparent to opaque //
+	std::vector<unsigned char> checker =
+	{
+		0, 0, 0, 0,			255, 255, 255, 255,
+		255, 255, 255, 0,	0, 0, 0, 255
+	};
+
+	// Without sRGB the average is taken on the stored values //
+	std::vector<unsigned char> linear = checker;
+	CHECK(MipGenerator::GenerateRGBA8(linear, 2, 2, false) == 2);
+	CHECK(linear.size() == 5 * 4);
+	CHECK(linear[16] == 128 && linear[17] == 128 && linear[18] == 128 && linear[19] == 128);
+
+	// With sRGB the average is taken on the light, half of it encodes to 188. Alpha stays linear //
+	std::vector<unsigned char> srgb = checker;
+	CHECK(MipGenerator::GenerateRGBA8(srgb, 2, 2, true) == 2);
+	CHECK(srgb[16] == 188 && srgb[17] == 188 && srgb[18] == 188);
+	CHECK(srgb[19] == 128);
+
+	// The top level is left as it was //
+	CHECK(std::equal(checker.begin(), checker.end(), srgb.begin()));
+
+	// A single pixel has no chain to generate //
+	std::vector<unsigned char> single = { 1, 2, 3, 4 };
+	CHECK(MipGenerator::GenerateRGBA8(single, 1, 1, true) == 1);
+	CHECK(single.size() == 4);
+}
+
+static void TestKaiser()
+{
+	const int width = 16;
+	const int height = 8;
+
+	// The weights are normalized, so a flat image stays flat //
+	std::vector<float> flat(width * height * 4, 0.75f);
+	int mipCount = MipGenerator::GenerateRGBA32F(flat, width, height, MipFilter::Kaiser);
+	CHECK(mipCount == 5);
+
+	for(float pixel : flat)
+	{
+		CHECK_NEAR(pixel, 0.75f, 1e-5f);
+	}
+
+	std::vector<unsigned char> flat8(width * height * 4, 200);
+	MipGenerator::GenerateRGBA8(flat8, width, height, true, MipFilter::Kaiser);
+	CHECK(std::all_of(flat8.begin(), flat8.end(), [](unsigned char pixel) { return pixel == 200; }));
+
+	// A single bright pixel rings through the negative lobes, HDR levels have to be clamped to zero //
+	std::vector<float> spike(width * height * 4, 0.0f);
+	for(int c = 0; c < 4; c++)
+	{
+		spike[((height / 2) * width + width / 2) * 4 + c] = 1000.0f;
+	}
+
+	MipGenerator::GenerateRGBA32F(spike, width, height, MipFilter::Kaiser);
+	CHECK(std::all_of(spike.begin(), spike.end(), [](float pixel) { return pixel >= 0.0f; }));
+}
+
+int main()
+{
+	TestChainLayout();
+	TestBoxAgainstReference();
+	TestRGBA8();
+	TestKaiser();
+
+	return Test::Result();
+}
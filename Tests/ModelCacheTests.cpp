@@ -0,0 +1,186 @@
+#include "Test.h"
+
+#include "Graphics/ModelCache.h"
+#include "Graphics/MipGenerator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::filesystem::path GetTestDirectory()
+{
+	return std::filesystem::temp_directory_path() / "NovaCacheTests";
+}
+
+static std::string WriteSourceFile(const std::string& name, const std::string& content)
+{
+	std::string filePath = (GetTestDirectory() / name).string();
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	file << content;
+	return filePath;
+}
+
+// A single textured triangle, the cache doesn't care whether the source file actually contains it //
+static ImportedModel CreateModel(const std::string& sourcePath)
+{
+	ImportedModel model;
+	model.FilePath = sourcePath;
+	model.Name = sourcePath.substr(sourcePath.find_last_of("/\\") + 1);
+	model.SourceFiles.push_back(sourcePath);
+
+	ImportedMesh mesh;
+	mesh.Name = "Triangle";
+	mesh.Vertices.resize(3);
+	mesh.Vertices[1].Position = glm::vec3(1.0f, 0.0f, 0.0f);
+	mesh.Vertices[2].Position = glm::vec3(0.0f, 1.0f, 0.0f);
+	mesh.Indices = { 0, 1, 2 };
+	mesh.Bounds.Min = glm::vec3(0.0f);
+	mesh.Bounds.Max = glm::vec3(1.0f, 1.0f, 0.0f);
+	mesh.Material.hasAlbedo = 1;
+	mesh.Material.Opacity = 0.75f;
+	mesh.AlbedoTexture = 0;
+	model.Meshes.push_back(mesh);
+
+	ImportedTexture texture;
+	texture.Width = 4;
+	texture.Height = 4;
+	texture.MipCount = MipGenerator::GetMipCount(4, 4);
+	texture.Pixels.resize(MipGenerator::GetMipOffset(4, 4, texture.MipCount) * 4);
+	for(size_t i = 0; i < texture.Pixels.size(); i++)
+	{
+		texture.Pixels[i] = static_cast<unsigned char>(i);
+	}
+	model.Textures.push_back(texture);
+
+	return model;
+}
+
+static std::filesystem::path FindEntry()
+{
+	for(const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(GetTestDirectory() / "Cache"))
+	{
+		if(entry.path().extension() == ".model")
+		{
+			return entry.path();
+		}
+	}
+
+	return std::filesystem::path();
+}
+
+static void TestRoundTrip(ModelCache& cache)
+{
+	std::string sourcePath = WriteSourceFile("RoundTrip.gltf", "Original");
+	ImportedModel model = CreateModel(sourcePath);
+
+	ImportedModel loaded;
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+	if(!CHECK(cache.Store(model)) || !CHECK(cache.Load(sourcePath, loaded, CompressionQuality::None)))
+	{
+		return;
+	}
+
+	CHECK(loaded.FilePath == sourcePath && loaded.Name == "RoundTrip.gltf");
+	CHECK(loaded.SourceFiles == model.SourceFiles);
+	CHECK(loaded.TextureQuality == CompressionQuality::None);
+
+	if(CHECK(loaded.Meshes.size() == 1))
+	{
+		const ImportedMesh& mesh = loaded.Meshes[0];
+		CHECK(mesh.Name == "Triangle");
+		CHECK(mesh.Indices == model.Meshes[0].Indices);
+		CHECK(mesh.Vertices.size() == 3 && mesh.Vertices[2].Position == glm::vec3(0.0f, 1.0f, 0.0f));
+		CHECK(mesh.Bounds.Max == glm::vec3(1.0f, 1.0f, 0.0f));
+		CHECK(mesh.Material.hasAlbedo == 1 && mesh.Material.Opacity == 0.75f);
+		CHECK(mesh.AlbedoTexture == 0 && mesh.NormalTexture == -1);
+	}
+
+	if(CHECK(loaded.Textures.size() == 1))
+	{
+		const ImportedTexture& texture = loaded.Textures[0];
+		CHECK(texture.Width == 4 && texture.Height == 4 && texture.MipCount == model.Textures[0].MipCount);
+		CHECK(texture.Pixels == model.Textures[0].Pixels);
+	}
+}
+
+static void TestStale(ModelCache& cache)
+{
+	std::string sourcePath = WriteSourceFile("Stale.gltf", "Original");
+	ImportedModel loaded;
+	CHECK(cache.Store(CreateModel(sourcePath)));
+	CHECK(cache.Load(sourcePath, loaded, CompressionQuality::None));
+
+	// Only compressed with the preset it was stored with //
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::Fast));
+
+	WriteSourceFile("Stale.gltf", "Changed size");
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+
+	// Missing source files never get cached //
+	ImportedModel missing = CreateModel((GetTestDirectory() / "Missing.gltf").string());
+	CHECK(!cache.Store(missing));
+}
+
+static void TestCorrupt(ModelCache& cache)
+{
+	std::string sourcePath = WriteSourceFile("Corrupt.gltf", "Original");
+	ImportedModel model = CreateModel(sourcePath);
+	ImportedModel loaded;
+
+	// Indices pointing past the vertices or textures are rejected //
+	ImportedModel badIndex = model;
+	badIndex.Meshes[0].Indices[2] = 3;
+	CHECK(cache.Store(badIndex));
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+
+	ImportedModel badTexture = model;
+	badTexture.Meshes[0].NormalTexture = 1;
+	CHECK(cache.Store(badTexture));
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+
+	// Cutting the entry short anywhere makes it unreadable //
+	CHECK(cache.Store(model));
+	std::filesystem::path entryPath = FindEntry();
+	if(!CHECK(!entryPath.empty()))
+	{
+		return;
+	}
+
+	std::uintmax_t size = std::filesystem::file_size(entryPath);
+	const std::uintmax_t cuts[] = { 0, 4, size / 2, size - 1 };
+	for(std::uintmax_t cut : cuts)
+	{
+		CHECK(cache.Store(model));
+		std::filesystem::resize_file(entryPath, cut);
+		CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+	}
+
+	// As does a texture whose size doesn't match its pixels, the last bytes are the end of its pixel data //
+	CHECK(cache.Store(model));
+	{
+		std::fstream file(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+		std::uintmax_t pixelCountOffset = size - model.Textures[0].Pixels.size() - sizeof(unsigned long long);
+		unsigned long long pixelCount = 3;
+		file.seekp(static_cast<std::streamoff>(pixelCountOffset));
+		file.write(reinterpret_cast<const char*>(&pixelCount), sizeof(pixelCount));
+	}
+	CHECK(!cache.Load(sourcePath, loaded, CompressionQuality::None));
+}
+
+int main()
+{
+	std::filesystem::remove_all(GetTestDirectory());
+	std::filesystem::create_directories(GetTestDirectory());
+
+	ModelCache cache((GetTestDirectory() / "Cache").string() + "/");
+
+	TestRoundTrip(cache);
+	TestStale(cache);
+
+	// Only the entry of the corrupt model should be in there from here on //
+	std::filesystem::remove_all(GetTestDirectory() / "Cache");
+	TestCorrupt(cache);
+
+	return Test::Result();
+}
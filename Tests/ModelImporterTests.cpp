@@ -0,0 +1,177 @@
+#include "Test.h"
+
+#include "Graphics/ModelImporter.h"
+#include "Graphics/MipGenerator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Geometry every imported mesh has to hold up to, regardless of the file it came from //
+static void CheckMesh(const ImportedMesh& mesh)
+{
+	CHECK(!mesh.Vertices.empty());
+	CHECK(!mesh.Indices.empty());
+	CHECK(mesh.Indices.size() % 3 == 0);
+
+	bool indicesInRange = true;
+	for(unsigned int index : mesh.Indices)
+	{
+		indicesInRange &= index < mesh.Vertices.size();
+	}
+	CHECK(indicesInRange);
+
+	bool insideBounds = true;
+	bool unitNormals = true;
+	bool unitTangents = true;
+	const glm::vec3 epsilon = glm::vec3(1e-4f);
+
+	for(const Vertex& vertex : mesh.Vertices)
+	{
+		insideBounds &= glm::all(glm::greaterThanEqual(vertex.Position, mesh.Bounds.Min - epsilon));
+		insideBounds &= glm::all(glm::lessThanEqual(vertex.Position, mesh.Bounds.Max + epsilon));
+		insideBounds &= glm::length(vertex.Position - mesh.Sphere.Center) <= mesh.Sphere.Radius + 1e-3f;
+
+		unitNormals &= std::fabs(glm::length(vertex.Normal) - 1.0f) < 1e-2f;
+		unitTangents &= std::fabs(glm::length(vertex.Tangent) - 1.0f) < 1e-2f;
+	}
+
+	CHECK(insideBounds);
+	CHECK(unitNormals);
+	CHECK(unitTangents);
+}
+
+static void TestImport(const std::string& filePath, size_t meshCount, size_t textureCount)
+{
+	printf("Importing %s\n", filePath.c_str());
+
+	ModelImporter importer(CompressionQuality::None);
+	ImportedModel model;
+
+	if(!CHECK(importer.Import(filePath, model)))
+	{
+		return;
+	}
+
+	CHECK(model.Meshes.size() == meshCount);
+	CHECK(model.Textures.size() == textureCount);
+	CHECK(!model.SourceFiles.empty() && model.SourceFiles[0] == filePath);
+
+	for(const ImportedMesh& mesh : model.Meshes)
+	{
+		CheckMesh(mesh);
+	}
+
+	// Uncompressed textures come with their full mip chain, tightly packed //
+	for(const ImportedTexture& texture : model.Textures)
+	{
+		CHECK(texture.Format == TextureFormat::RGBA8);
+		CHECK(texture.MipCount == MipGenerator::GetMipCount(texture.Width, texture.Height));
+		CHECK(texture.Pixels.size() == MipGenerator::GetMipOffset(texture.Width, texture.Height, texture.MipCount) * 4);
+	}
+}
+
+static const char* DefaultBufferViews = R"({ "buffer": 0, "byteOffset": 0, "byteLength": 36 }, { "buffer": 0, "byteOffset": 36, "byteLength": 8 })";
+
+// Writes a glTF with a single triangle's worth of buffer data ( 3 positions, followed by the indices 0, 1, 2, 7 & padding ), //
+// the primitives, buffer views & any other top level members are passed in as JSON so every test can break them in its own way
+static std::string WriteTestModel(const std::string& name, const std::string& primitives, bool withScene,
+	const std::string& bufferViews = DefaultBufferViews, const std::string& extra = "")
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "NovaImporterTests";
+	std::filesystem::create_directories(directory);
+
+	float positions[9] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+	unsigned short indices[4] = { 0, 1, 2, 7 };
+
+	std::ofstream buffer(directory / (name + ".bin"), std::ios::binary);
+	buffer.write(reinterpret_cast<const char*>(positions), sizeof(positions));
+	buffer.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+	buffer.close();
+
+	std::string json = R"({ "asset": { "version": "2.0" },
+		"buffers": [ { "uri": ")" + name + R"(.bin", "byteLength": 44 } ],
+		"bufferViews": [ )" + bufferViews + R"( ],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [ 0, 0, 0 ], "max": [ 1, 1, 0 ] },
+			{ "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" },
+			{ "bufferView": 1, "byteOffset": 2, "componentType": 5123, "count": 3, "type": "SCALAR" } ],
+		"meshes": [ { "name": "Test", "primitives": [ )" + primitives + R"( ] } ],
+		"nodes": [ { "mesh": 0 } ])" + extra;
+
+	json += withScene ? R"(, "scenes": [ { "nodes": [ 0 ] } ] })" : " }";
+
+	std::string filePath = (directory / (name + ".gltf")).string();
+	std::ofstream file(filePath);
+	file << json;
+	return filePath;
+}
+
+static void TestMalformedModels()
+{
+	ModelImporter importer(CompressionQuality::None);
+
+	// No material & no default scene, still a drawable triangle //
+	ImportedModel plain;
+	std::string triangle = R"({ "attributes": { "POSITION": 0 }, "indices": 1 })";
+	if(CHECK(importer.Import(WriteTestModel("Plain", triangle, true), plain)) && CHECK(plain.Meshes.size() == 1))
+	{
+		const ImportedMesh& mesh = plain.Meshes[0];
+		CHECK(mesh.Indices.size() == 3);
+		CHECK(mesh.Material.hasAlbedo == 0 && mesh.Material.hasNormal == 0);
+		CHECK(mesh.Vertices[0].Color == glm::vec3(1.0f));
+
+		// Without UVs there's no tangent to derive, but it still can't be NaN //
+		for(const Vertex& vertex : mesh.Vertices)
+		{
+			CHECK_NEAR(glm::length(vertex.Tangent), 1.0f, 1e-4f);
+		}
+	}
+
+	// Primitives that can't be drawn are left out, the rest of the model stays //
+	ImportedModel partial;
+	std::string mixed = triangle + R"(, { "attributes": { "POSITION": 0 }, "indices": 2 }, { "attributes": { "POSITION": 0 }, "mode": 0 })";
+	CHECK(importer.Import(WriteTestModel("Partial", mixed, true), partial));
+	CHECK(partial.Meshes.size() == 1);
+
+	// Nothing left to draw fails the import //
+	ImportedModel noPositions;
+	CHECK(!importer.Import(WriteTestModel("NoPositions", R"({ "attributes": { "NORMAL": 0 }, "indices": 1 })", true), noPositions));
+
+	ImportedModel noScene;
+	CHECK(!importer.Import(WriteTestModel("NoScene", triangle, false), noScene));
+
+	// Buffer views pointing at a buffer that doesn't exist can't be read //
+	ImportedModel missingBuffer;
+	std::string missingBufferViews = R"({ "buffer": 5, "byteOffset": 0, "byteLength": 36 }, { "buffer": 0, "byteOffset": 36, "byteLength": 8 })";
+	CHECK(!importer.Import(WriteTestModel("MissingBuffer", triangle, true, missingBufferViews), missingBuffer));
+
+	// An image in a buffer view that doesn't exist stays undecoded, the mesh falls back to the error texture //
+	ImportedModel missingImage;
+	std::string textured = R"({ "attributes": { "POSITION": 0 }, "indices": 1, "material": 0 })";
+	std::string images = R"(, "materials": [ { "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } } } ],
+		"textures": [ { "source": 0 } ], "images": [ { "bufferView": 7, "mimeType": "image/png" } ])";
+
+	if(CHECK(importer.Import(WriteTestModel("MissingImage", textured, true, DefaultBufferViews, images), missingImage)) &&
+		CHECK(missingImage.Textures.size() == 1))
+	{
+		CHECK(missingImage.Textures[0].Pixels.empty());
+	}
+}
+
+int main()
+{
+	TestImport("Assets/Models/Box/Box.gltf", 1, 0);
+	TestImport("Assets/Models/Sphere/sphere.gltf", 1, 0);
+	TestImport("Assets/Models/NormalTangentTest/NormalTangentTest.gltf", 1, 3);
+	TestImport("Assets/Models/DamagedHelmet/DamagedHelmet.gltf", 1, 5);
+
+	// Files that can't be read are reported, not imported //
+	ModelImporter importer;
+	ImportedModel missing;
+	CHECK(!importer.Import("Assets/Models/Missing/Missing.gltf", missing));
+
+	TestMalformedModels();
+
+	return Test::Result();
+}
@@ -0,0 +1,150 @@
+#include "Test.h"
+
+#include "Graphics/ParallelRecorder.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+// Ranges have to be non-empty, in order & cover every item exactly once //
+static bool IsContiguous(const std::vector<RecordRange>& ranges, unsigned int itemCount)
+{
+	unsigned int next = 0;
+	for(const RecordRange& range : ranges)
+	{
+		if(range.Begin != next || range.End <= range.Begin)
+		{
+			return false;
+		}
+
+		next = range.End;
+	}
+
+	return next == itemCount;
+}
+
+static uint64_t CountDraws(const std::vector<unsigned int>& drawCounts, const RecordRange& range)
+{
+	uint64_t draws = 0;
+	for(unsigned int i = range.Begin; i < range.End; i++)
+	{
+		draws += drawCounts[i];
+	}
+
+	return draws;
+}
+
+static void TestPartition()
+{
+	const unsigned int minimum = ParallelRecorder::MinimumDrawsPerList;
+
+	CHECK(ParallelRecorder::Partition({}, 8, minimum).empty());
+
+	// Too few draws to be worth splitting //
+	std::vector<unsigned int> few(100, 1);
+	std::vector<RecordRange> ranges = ParallelRecorder::Partition(few, 8, minimum);
+	CHECK(ranges.size() == 1);
+	CHECK(IsContiguous(ranges, 100));
+
+	// No list gets less than the minimum //
+	std::vector<unsigned int> some(1000, 1);
+	ranges = ParallelRecorder::Partition(some, 8, minimum);
+	CHECK(ranges.size() == 3);
+	CHECK(IsContiguous(ranges, 1000));
+	for(const RecordRange& range : ranges)
+	{
+		CHECK(CountDraws(some, range) >= minimum);
+	}
+
+	// Plenty of draws, so the range count is what limits it //
+	std::vector<unsigned int> many(10000, 1);
+	ranges = ParallelRecorder::Partition(many, 4, minimum);
+	CHECK(ranges.size() == 4);
+	CHECK(IsContiguous(ranges, 10000));
+	for(const RecordRange& range : ranges)
+	{
+		CHECK(CountDraws(many, range) == 2500);
+	}
+
+	// A range holds at least one item, & zero ranges still means one //
+	ranges = ParallelRecorder::Partition({ 5000, 5000 }, 8, 1);
+	CHECK(ranges.size() == 2);
+	CHECK(IsContiguous(ranges, 2));
+	CHECK(ParallelRecorder::Partition(many, 0, minimum).size() == 1);
+}
+
+static void TestBalance()
+{
+	// Models with wildly different mesh counts, every range stays within one model of the average //
+	std::mt19937 random(42);
+	std::uniform_int_distribution<unsigned int> meshCount(1, 64);
+
+	std::vector<unsigned int> drawCounts(5000);
+	uint64_t totalDraws = 0;
+	unsigned int largestItem = 0;
+	for(unsigned int& drawCount : drawCounts)
+	{
+		drawCount = meshCount(random);
+		totalDraws += drawCount;
+		largestItem = std::max(largestItem, drawCount);
+	}
+
+	const unsigned int maxRanges = 8;
+	std::vector<RecordRange> ranges = ParallelRecorder::Partition(drawCounts, maxRanges, ParallelRecorder::MinimumDrawsPerList);
+	CHECK(ranges.size() == maxRanges);
+	CHECK(IsContiguous(ranges, static_cast<unsigned int>(drawCounts.size())));
+
+	uint64_t average = totalDraws / ranges.size();
+	for(const RecordRange& range : ranges)
+	{
+		CHECK(CountDraws(drawCounts, range) <= average + largestItem);
+	}
+}
+
+static void TestRecord()
+{
+	// Every range records its own list, executed in order they draw what a single list would //
+	ThreadPool threadPool(4);
+
+	std::vector<unsigned int> drawCounts(3000, 1);
+	std::vector<RecordRange> ranges = ParallelRecorder::Partition(drawCounts, 6, 100);
+	CHECK(ranges.size() == 6);
+
+	std::vector<std::vector<unsigned int>> lists(ranges.size());
+	std::atomic<unsigned int> calls{ 0 };
+
+	ParallelRecorder::Record(threadPool, ranges, [&](unsigned int index, const RecordRange& range)
+	{
+		for(unsigned int i = range.Begin; i < range.End; i++)
+		{
+			lists[index].push_back(i);
+		}
+		calls++;
+	});
+
+	CHECK(calls == ranges.size());
+
+	std::vector<unsigned int> executed;
+	for(const std::vector<unsigned int>& list : lists)
+	{
+		executed.insert(executed.end(), list.begin(), list.end());
+	}
+
+	bool inOrder = executed.size() == drawCounts.size();
+	for(unsigned int i = 0; inOrder && i < executed.size(); i++)
+	{
+		inOrder = executed[i] == i;
+	}
+	CHECK(inOrder);
+}
+
+int main()
+{
+	TestPartition();
+	TestBalance();
+	TestRecord();
+
+	return Test::Result();
+}
@@ -0,0 +1,170 @@
+#include "Test.h"
+
+#include "Graphics/RenderQueue.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static void TestOpaqueKeys()
+{
+	// Pipeline first, then material //
+	CHECK(RenderQueue::MakeKey(0, false, 500, 0, 1.0f) < RenderQueue::MakeKey(1, false, 0, 0, 1.0f));
+	CHECK(RenderQueue::MakeKey(0, false, 3, 0, 100.0f) < RenderQueue::MakeKey(0, false, 4, 0, 1.0f));
+
+	// Within a material, front to back whatever the mesh is //
+	CHECK(RenderQueue::MakeKey(0, false, 3, 900, 1.0f) < RenderQueue::MakeKey(0, false, 3, 1, 2.0f));
+	CHECK(RenderQueue::MakeKey(0, false, 3, 1, 10.0f) < RenderQueue::MakeKey(0, false, 3, 0, 10.5f));
+
+	// The mesh only breaks ties between draws at the same depth //
+	CHECK(RenderQueue::MakeKey(0, false, 3, 1, 5.0f) < RenderQueue::MakeKey(0, false, 3, 2, 5.0f));
+
+	// Nothing is closer than the camera //
+	CHECK(RenderQueue::MakeKey(0, false, 3, 1, -5.0f) == RenderQueue::MakeKey(0, false, 3, 1, 0.0f));
+}
+
+static void TestBlendedKeys()
+{
+	// Back to front, no matter the material or mesh //
+	CHECK(RenderQueue::MakeKey(1, true, 7, 7, 50.0f) < RenderQueue::MakeKey(1, true, 0, 0, 10.0f));
+	CHECK(RenderQueue::MakeKey(1, true, 0, 0, 10.5f) < RenderQueue::MakeKey(1, true, 0, 0, 10.0f));
+
+	// Still after every opaque pipeline before it //
+	CHECK(RenderQueue::MakeKey(0, false, 1000, 1000, 500.0f) < RenderQueue::MakeKey(1, true, 0, 0, 500.0f));
+}
+
+static void TestQueue()
+{
+	RenderQueue queue;
+	queue.SetBlended(1, true);
+
+	queue.Add(1, 0, 0, 5.0f, 0);	// Blended, near
+	queue.Add(0, 2, 0, 1.0f, 1);
+	queue.Add(1, 0, 0, 20.0f, 2);	// Blended, far
+	queue.Add(0, 1, 4, 8.0f, 3);
+	queue.Add(0, 1, 9, 2.0f, 4);
+	queue.Add(0, 1, 9, 2.0f, 5);	// Same key as the one before
+	queue.Sort();
+
+	CHECK(queue.GetDrawCount() == 6);
+
+	const unsigned int expected[] = { 4, 5, 3, 1, 2, 0 };
+	bool ordered = true;
+	for(unsigned int i = 0; i < 6; i++)
+	{
+		ordered &= queue.GetItem(i) == expected[i];
+	}
+	CHECK(ordered);
+
+	CHECK(queue.GetPipeline(0) == 0 && queue.GetPipeline(3) == 0);
+	CHECK(queue.GetPipeline(4) == 1 && queue.GetPipeline(5) == 1);
+
+	// Pipelines can go back to being opaque //
+	queue.Clear();
+	queue.SetBlended(1, false);
+	queue.Add(1, 0, 0, 20.0f, 0);
+	queue.Add(1, 0, 0, 5.0f, 1);
+	queue.Sort();
+	CHECK(queue.GetItem(0) == 1);
+}
+
+static void TestSort()
+{
+	// Enough draws that the passes get split over the pool //
+	const unsigned int drawCount = 100000;
+
+	std::mt19937 random(1337);
+	std::uniform_int_distribution<unsigned int> pipeline(0, 3);
+	std::uniform_int_distribution<unsigned int> material(0, 511);
+	std::uniform_int_distribution<unsigned int> mesh(0, 4095);
+	std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+
+	struct Draw
+	{
+		unsigned int Pipeline;
+		unsigned int Material;
+		unsigned int Mesh;
+		float Depth;
+	};
+
+	std::vector<Draw> draws(drawCount);
+	for(Draw& draw : draws)
+	{
+		draw = { pipeline(random), material(random), mesh(random), depth(random) };
+	}
+
+	// Stable, so draws with the same key stay in the order they were added //
+	std::vector<unsigned int> reference(drawCount);
+	for(unsigned int i = 0; i < drawCount; i++)
+	{
+		reference[i] = i;
+	}
+
+	std::stable_sort(reference.begin(), reference.end(), [&](unsigned int a, unsigned int b)
+	{
+		const Draw& drawA = draws[a];
+		const Draw& drawB = draws[b];
+		return RenderQueue::MakeKey(drawA.Pipeline, drawA.Pipeline >= 2, drawA.Material, drawA.Mesh, drawA.Depth) <
+			RenderQueue::MakeKey(drawB.Pipeline, drawB.Pipeline >= 2, drawB.Material, drawB.Mesh, drawB.Depth);
+	});
+
+	ThreadPool threadPool(4);
+	ThreadPool* pools[2] = { nullptr, &threadPool };
+
+	for(ThreadPool* pool : pools)
+	{
+		RenderQueue queue;
+		queue.SetBlended(2, true);
+		queue.SetBlended(3, true);
+
+		for(unsigned int i = 0; i < drawCount; i++)
+		{
+			queue.Add(draws[i].Pipeline, draws[i].Material, draws[i].Mesh, draws[i].Depth, i);
+		}
+		queue.Sort(pool);
+
+		bool matches = queue.GetDrawCount() == drawCount;
+		for(unsigned int i = 0; matches && i < drawCount; i++)
+		{
+			matches = queue.GetItem(i) == reference[i] && queue.GetPipeline(i) == draws[reference[i]].Pipeline;
+		}
+		CHECK(matches);
+	}
+}
+
+static void TestStatistics()
+{
+	RenderQueue queue;
+
+	RenderQueueStatistics list;
+	list.Draws = 10;
+	list.PipelineBinds = 1;
+	list.PipelinesSkipped = 9;
+	list.MaterialBinds = 3;
+	list.MaterialsSkipped = 7;
+
+	// Every recording thread adds its own list //
+	queue.AddStatistics(list);
+	queue.AddStatistics(list);
+
+	RenderQueueStatistics statistics = queue.GetStatistics();
+	CHECK(statistics.Draws == 20);
+	CHECK(statistics.PipelineBinds == 2 && statistics.PipelinesSkipped == 18);
+	CHECK(statistics.MaterialBinds == 6 && statistics.MaterialsSkipped == 14);
+
+	queue.Clear();
+	CHECK(queue.GetStatistics().Draws == 0);
+	CHECK(queue.GetDrawCount() == 0);
+}
+
+int main()
+{
+	TestOpaqueKeys();
+	TestBlendedKeys();
+	TestQueue();
+	TestSort();
+	TestStatistics();
+
+	return Test::Result();
+}
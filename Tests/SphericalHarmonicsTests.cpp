@@ -0,0 +1,124 @@
+#include "Test.h"
+
+#include "Graphics/SphericalHarmonics.h"
+
+#include <algorithm>
+#include <vector>
+
+static const float PI = 3.14159265359f;
+
+// Equirectangular RGBA32F environment, v = 0 looks down like in the shaders //
+template<typename Radiance>
+static std::vector<float> CreateEnvironment(int width, int height, Radiance radiance)
+{
+	std::vector<float> pixels(static_cast<size_t>(width) * height * 4);
+	for(int y = 0; y < height; y++)
+	{
+		float directionY = -std::cos(PI * (y + 0.5f) / height);
+
+		for(int x = 0; x < width; x++)
+		{
+			glm::vec3 color = radiance(directionY);
+			float* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+			pixel[0] = color.r;
+			pixel[1] = color.g;
+			pixel[2] = color.b;
+			pixel[3] = 1.0f;
+		}
+	}
+
+	return pixels;
+}
+
+static const glm::vec3 testNormals[] =
+{
+	glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f),
+	glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.6f, 0.8f, 0.0f), glm::vec3(-0.3f, -0.5f, 0.8f)
+};
+
+static void TestConstant()
+{
+	// Uniform light of 2, irradiance / PI is that same 2 from every side //
+	const int width = 128;
+	const int height = 64;
+	std::vector<float> pixels = CreateEnvironment(width, height, [](float) { return glm::vec3(2.0f, 1.0f, 0.5f); });
+
+	SHIrradiance irradiance = SphericalHarmonics::ProjectIrradiance(pixels.data(), width, height);
+	for(const glm::vec3& normal : testNormals)
+	{
+		glm::vec3 result = SphericalHarmonics::EvaluateIrradiance(irradiance, normal);
+		CHECK_NEAR(result.r, 2.0f, 0.01f);
+		CHECK_NEAR(result.g, 1.0f, 0.005f);
+		CHECK_NEAR(result.b, 0.5f, 0.0025f);
+	}
+}
+
+static void TestGradient()
+{
+	// Sky that's brighter above the horizon. Radiance that's linear in the direction only has bands 0 & 1,
+	// so L2 holds it exactly: irradiance / PI = a + 2/3 * b * n.y
+	const int width = 128;
+	const int height = 64;
+	std::vector<float> pixels = CreateEnvironment(width, height, [](float directionY)
+	{
+		return glm::vec3(1.0f + 0.5f * directionY, 0.5f, 0.25f + 0.25f * directionY);
+	});
+
+	SHIrradiance irradiance = SphericalHarmonics::ProjectIrradiance(pixels.data(), width, height);
+	for(const glm::vec3& normal : testNormals)
+	{
+		glm::vec3 n = glm::normalize(normal);
+		glm::vec3 expected = glm::vec3(1.0f + 2.0f / 3.0f * 0.5f * n.y, 0.5f, 0.25f + 2.0f / 3.0f * 0.25f * n.y);
+		glm::vec3 result = SphericalHarmonics::EvaluateIrradiance(irradiance, normal);
+		CHECK(glm::length(result - expected) < 0.01f);
+
+		// The brute force integral the convolution pass used has to agree as well //
+		glm::vec3 integrated = SphericalHarmonics::IntegrateIrradiance(pixels.data(), width, height, normal, 0.02f);
+		CHECK(glm::length(integrated - expected) < 0.03f);
+	}
+
+	// Projecting twice gives the same coefficients, rows are summed in a fixed order //
+	SHIrradiance again = SphericalHarmonics::ProjectIrradiance(pixels.data(), width, height);
+	bool identical = true;
+	for(int k = 0; k < 9; k++)
+	{
+		identical &= irradiance.Coefficients[k] == again.Coefficients[k];
+	}
+	CHECK(identical);
+}
+
+static void TestSun()
+{
+	// A bright lobe overhead, L2 can't hold it exactly and rings a bit on the dark side. Errors are relative to //
+	// the average irradiance, like in the benchmark, since directions facing away receive almost nothing
+	const int width = 256;
+	const int height = 128;
+	std::vector<float> pixels = CreateEnvironment(width, height, [](float directionY)
+	{
+		return glm::vec3(0.2f) + glm::vec3(20.0f) * std::pow(std::max(directionY, 0.0f), 8.0f);
+	});
+
+	SHIrradiance irradiance = SphericalHarmonics::ProjectIrradiance(pixels.data(), width, height);
+
+	float averageIrradiance = 0.0f;
+	float maximumError = 0.0f;
+	for(const glm::vec3& normal : testNormals)
+	{
+		glm::vec3 projected = SphericalHarmonics::EvaluateIrradiance(irradiance, normal);
+		glm::vec3 integrated = SphericalHarmonics::IntegrateIrradiance(pixels.data(), width, height, normal, 0.01f);
+
+		averageIrradiance += glm::length(integrated) / 6.0f;
+		maximumError = std::max(maximumError, glm::length(projected - integrated));
+	}
+
+	CHECK(maximumError < 0.12f * averageIrradiance);
+}
+
+int main()
+{
+	TestConstant();
+	TestGradient();
+	TestSun();
+
+	return Test::Result();
+}
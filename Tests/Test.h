@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// Checks for the portable tests, a failed check gets reported & fails the test, but the test keeps running //
+// so a single run shows everything that's off. Every test file ends its main with 'return Test::Result();'
+
+namespace Test
+{
+	inline int& GetFailureCount()
+	{
+		static int failureCount = 0;
+		return failureCount;
+	}
+
+	inline bool Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if(!condition)
+		{
+			printf("%s(%i): check failed: %s\n", file, line, expression);
+			GetFailureCount()++;
+		}
+
+		return condition;
+	}
+
+	inline int Result()
+	{
+		if(GetFailureCount() > 0)
+		{
+			printf("%i check(s) failed\n", GetFailureCount());
+			return 1;
+		}
+
+		printf("All checks passed\n");
+		return 0;
+	}
+}
+
+#define CHECK(condition) Test::Check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(value, expected, tolerance) Test::Check(std::fabs(double(value) - double(expected)) <= double(tolerance), \
+	#value " == " #expected " (within " #tolerance ")", __FILE__, __LINE__)
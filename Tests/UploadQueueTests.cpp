@@ -0,0 +1,150 @@
+#include "Test.h"
+
+#include "Graphics/UploadQueue.h"
+
+static void TestBatching()
+{
+	NullUploadBackend backend;
+	UploadQueue queue(&backend, 1024, 4096);
+
+	// Uploads share the open batch until it's full //
+	UploadTicket first;
+	UploadTicket second;
+	StagingBuffer staging = queue.Allocate(512, first);
+	queue.Allocate(512, second);
+
+	CHECK(staging.Data != nullptr && staging.Size == 512);
+	CHECK(first.FenceValue == 1 && second.FenceValue == 1);
+	CHECK(queue.GetPendingSize() == 1024);
+	CHECK(backend.GetSubmittedValue() == 0);
+
+	// The next one doesn't fit, so the batch gets submitted first //
+	UploadTicket third;
+	queue.Allocate(256, third);
+	CHECK(third.FenceValue == 2);
+	CHECK(backend.GetSubmittedValue() == 1);
+	CHECK(queue.GetInFlightSize() == 1024);
+	CHECK(queue.GetPendingSize() == 256);
+	CHECK(!queue.IsComplete(first));
+
+	// A single upload larger than a batch gets one of its own //
+	UploadTicket large;
+	queue.Allocate(2048, large);
+	CHECK(large.FenceValue == 3);
+	CHECK(queue.GetInFlightBatchCount() == 2);
+
+	// Submitting an empty batch does nothing //
+	UploadTicket submitted = queue.Submit();
+	CHECK(submitted.FenceValue == 3);
+	CHECK(queue.Submit().FenceValue == 3);
+	CHECK(backend.GetSubmittedValue() == 3);
+
+	CHECK(queue.GetStatistics().SubmittedBatches == 3);
+	CHECK(queue.GetStatistics().SubmittedBytes == 1024 + 256 + 2048);
+}
+
+static void TestRetirement()
+{
+	NullUploadBackend backend;
+	UploadQueue queue(&backend, 1024, 1 << 20);
+
+	UploadTicket tickets[3];
+	for(UploadTicket& ticket : tickets)
+	{
+		queue.Allocate(1024, ticket);
+		queue.Submit();
+	}
+
+	CHECK(backend.GetLiveStagingCount() == 3);
+
+	// Staging memory lives until the GPU is done with its batch, in submission order //
+	backend.CompleteUpTo(2);
+	CHECK(queue.IsComplete(tickets[1]));
+	CHECK(!queue.IsComplete(tickets[2]));
+	CHECK(backend.GetLiveStagingCount() == 3);
+
+	queue.Retire();
+	CHECK(backend.GetLiveStagingCount() == 1);
+	CHECK(backend.GetLiveStagingSize() == 1024);
+	CHECK(queue.GetInFlightSize() == 1024);
+	CHECK(queue.GetStatistics().RetiredBatches == 2);
+
+	// Nothing finishes before it's submitted //
+	backend.CompleteUpTo(10);
+	CHECK(backend.GetCompletedValue() == 3);
+	queue.Retire();
+	CHECK(backend.GetLiveStagingCount() == 0);
+	CHECK(queue.GetInFlightBatchCount() == 0);
+}
+
+static void TestWaiting()
+{
+	NullUploadBackend backend;
+	UploadQueue queue(&backend, 4096, 1 << 20);
+
+	// Waiting on the open batch submits it //
+	UploadTicket ticket;
+	queue.Allocate(128, ticket);
+	queue.Wait(ticket);
+
+	CHECK(backend.GetSubmittedValue() == 1);
+	CHECK(queue.IsComplete(ticket));
+	CHECK(backend.GetLiveStagingCount() == 0);
+	CHECK(queue.GetStatistics().Stalls == 0);
+
+	// Flushing finishes everything that's pending //
+	queue.Allocate(128, ticket);
+	queue.Allocate(128, ticket);
+	queue.Flush();
+	CHECK(queue.IsComplete(ticket));
+	CHECK(queue.GetPendingSize() == 0);
+	CHECK(backend.GetLiveStagingCount() == 0);
+}
+
+static void TestInFlightBudget()
+{
+	NullUploadBackend backend;
+	UploadQueue queue(&backend, 1024, 2048);
+
+	UploadTicket tickets[2];
+	queue.Allocate(1024, tickets[0]);
+	queue.Allocate(1024, tickets[1]);
+	queue.Submit();
+	CHECK(queue.GetInFlightSize() == 2048);
+
+	// Going over the budget waits for the oldest batch, nothing more //
+	UploadTicket ticket;
+	queue.Allocate(1024, ticket);
+	CHECK(queue.GetStatistics().Stalls == 1);
+	CHECK(queue.IsComplete(tickets[0]));
+	CHECK(!queue.IsComplete(tickets[1]));
+	CHECK(queue.GetInFlightSize() + queue.GetPendingSize() <= 2048);
+}
+
+static void TestDestruction()
+{
+	NullUploadBackend backend;
+
+	{
+		UploadQueue queue(&backend);
+		UploadTicket ticket;
+		queue.Allocate(64, ticket);
+		queue.Allocate(64, ticket);
+	}
+
+	// The queue flushes on destruction, no staging memory is left behind //
+	CHECK(backend.GetSubmittedValue() == 1);
+	CHECK(backend.GetLiveStagingCount() == 0);
+	CHECK(backend.GetLiveStagingSize() == 0);
+}
+
+int main()
+{
+	TestBatching();
+	TestRetirement();
+	TestWaiting();
+	TestInFlightBudget();
+	TestDestruction();
+
+	return Test::Result();
+}